@@ -0,0 +1,95 @@
+#ifndef AXIS_H
+#define AXIS_H
+
+#include <FastAccelStepper.h>
+
+class EncoderState;
+
+// Motor axes of the head, in stepper order. Adding an axis (roll, or a slider driven from the head board) means
+// adding it here before HEAD_AXES and giving it a row in HeadAxes[] in the sketch; every array pass picks it up.
+enum HeadAxis { AXIS_TILT = 0, AXIS_PAN, AXIS_FOCUS, AXIS_ZOOM, HEAD_AXES };
+
+// Everything the motion code needs to know about one axis
+struct AxisDescriptor {
+  const char* name;
+  char key;                                       // Letter used in stored pose keys, P1_T, P1_P...
+  uint8_t step_pin;
+  uint8_t dir_pin;
+  uint8_t enable_pin;
+  bool reversed;                                  // Direction pin high counts down
+  int* limit_in;                                  // Soft limits, lens axes may have them in either order
+  int* limit_out;
+  EncoderState* encoder;                          // AS5600 with its mux channel and gear ratio, NULL if none
+  uint32_t brake_accel;                           // Deceleration when the stick is released in live mode
+  uint32_t pose_accel;                            // Acceleration of pose recalls
+  uint8_t pose_speed_divisor;                     // Slows pose recalls on axes that must not over speed
+};
+
+// The steppers of a fixed set of axes, created from their descriptors
+template<int N>
+class AxisSet {
+private:
+  const AxisDescriptor* descriptors;
+  FastAccelStepper* steppers[N];
+
+public:
+  AxisSet(const AxisDescriptor* adescriptors) : descriptors(adescriptors) {
+    for (int i = 0; i < N; i++) {
+      steppers[i] = NULL;
+    }
+  }
+
+  // Returns false if any axis could not get a stepper
+  bool connect(FastAccelStepperEngine& engine, Logger& logger) {
+    bool connected = true;
+    for (int i = 0; i < N; i++) {
+      const AxisDescriptor& d = descriptors[i];
+      steppers[i] = engine.stepperConnectToPin(d.step_pin);
+      if (steppers[i] == NULL) {
+        logger.printf("\n%s axis has no stepper on pin %d", d.name, d.step_pin);
+        connected = false;
+        continue;
+      }
+      steppers[i]->setDirectionPin(d.dir_pin, !d.reversed);
+      steppers[i]->setEnablePin(d.enable_pin);
+      steppers[i]->setAutoEnable(false);
+    }
+    return connected;
+  }
+
+  FastAccelStepper* operator[](int axis) const {
+    return steppers[axis];
+  }
+
+  const AxisDescriptor& descriptor(int axis) const {
+    return descriptors[axis];
+  }
+
+  bool isRunning() const {
+    for (int i = 0; i < N; i++) {
+      if (steppers[i] != NULL && steppers[i]->isRunning()) return true;
+    }
+    return false;
+  }
+
+  bool isAt(const long* positions) const {
+    for (int i = 0; i < N; i++) {
+      if (steppers[i] != NULL && steppers[i]->getCurrentPosition() != positions[i]) return false;
+    }
+    return true;
+  }
+
+  void setCurrentPositions(int32_t position) {
+    for (int i = 0; i < N; i++) {
+      if (steppers[i] != NULL) steppers[i]->setCurrentPosition(position);
+    }
+  }
+
+  void moveTo(const int* positions) {
+    for (int i = 0; i < N; i++) {
+      if (steppers[i] != NULL) steppers[i]->moveTo(positions[i]);
+    }
+  }
+};
+
+#endif // AXIS_H
@@ -0,0 +1,90 @@
+#ifndef AXIS_LIMITS_H
+#define AXIS_LIMITS_H
+
+#include <Preferences.h>
+#include "Axis.h"
+
+// Fastest an axis may be driven
+struct AxisLimit {
+  uint32_t speed_hz;
+  uint32_t accel;                                 // steps/s²
+};
+
+// Motion limits per axis
+//
+// They start as the defaults of the head variant given in the sketch and are replaced by what autoTune() measured
+// on this rig, kept in the "AxisLimits" namespace. Motion paths ask for their speeds and accelerations through
+// speed() and accel(), which never hand out more than the limit, so each head runs as fast as its own mechanics
+// allow and one build serves the balanced and the over the top heads.
+class AxisLimits {
+private:
+  const AxisLimit* defaults;
+  Logger& logger;
+  Preferences preferences;
+  AxisLimit limits[HEAD_AXES];
+
+  static const char* speedKey(int axis) {
+    static const char* keys[HEAD_AXES] = {"T_hz", "P_hz", "F_hz", "Z_hz"};
+    return keys[axis];
+  }
+
+  static const char* accelKey(int axis) {
+    static const char* keys[HEAD_AXES] = {"T_acc", "P_acc", "F_acc", "Z_acc"};
+    return keys[axis];
+  }
+
+public:
+  AxisLimits(const AxisLimit* adefaults, Logger& alogger) : defaults(adefaults), logger(alogger) {
+    for (int i = 0; i < HEAD_AXES; i++) {
+      limits[i] = defaults[i];
+    }
+  }
+
+  void load() {
+    preferences.begin("AxisLimits", true);
+    for (int i = 0; i < HEAD_AXES; i++) {
+      limits[i].speed_hz = preferences.getULong(speedKey(i), defaults[i].speed_hz);
+      limits[i].accel = preferences.getULong(accelKey(i), defaults[i].accel);
+      logger.printf("\nAxis %d limits %lu Hz, %lu steps/s2", i, (unsigned long)limits[i].speed_hz, (unsigned long)limits[i].accel);
+    }
+    preferences.end();
+  }
+
+  void store(int axis, const AxisLimit& limit) {
+    limits[axis] = limit;
+    preferences.begin("AxisLimits", false);
+    preferences.putULong(speedKey(axis), limit.speed_hz);
+    preferences.putULong(accelKey(axis), limit.accel);
+    preferences.end();
+  }
+
+  const AxisLimit& defaultLimit(int axis) const {
+    return defaults[axis];
+  }
+
+  uint32_t speed(int axis) const {
+    return limits[axis].speed_hz;
+  }
+
+  uint32_t accel(int axis) const {
+    return limits[axis].accel;
+  }
+
+  // What a motion path asked for, capped at the limit
+  uint32_t speed(int axis, uint32_t wanted_hz) const {
+    return wanted_hz < limits[axis].speed_hz ? wanted_hz : limits[axis].speed_hz;
+  }
+
+  uint32_t accel(int axis, uint32_t wanted) const {
+    return wanted < limits[axis].accel ? wanted : limits[axis].accel;
+  }
+
+  // Same for paths that set the step interval, larger is slower. 0 stays 0, the stepper rejects it as before
+  uint32_t intervalUs(int axis, uint32_t wanted_us) const {
+    if (wanted_us == 0) return 0;
+    uint32_t shortest = 1000000UL / limits[axis].speed_hz;
+    return wanted_us > shortest ? wanted_us : shortest;
+  }
+};
+
+#endif // AXIS_LIMITS_H
@@ -0,0 +1,114 @@
+#ifndef BACKLASH_H
+#define BACKLASH_H
+
+#include <FastAccelStepper.h>
+#include <Preferences.h>
+#include "Axis.h"
+
+// Backlash take-up
+//
+// After a reversal the motor turns through the gear or belt slack before the load follows, so a move that
+// reverses ends short by the slack. measureBacklash() in the sketch finds the slack of each geared axis against its
+// encoder and stores it here. Anything that starts a move calls takeUp() first; on a reversal it moves the stepper's
+// position back by the slack, so the move runs the slack out on top of its own distance and the positions the
+// sketch works with stay those of the load, whatever the speed. Moves that do not call takeUp() are still noticed
+// from how far the axis went since the last call.
+class BacklashCompensator {
+public:
+  static const long MAX_STEPS = 400;              // More than this is a loose belt or a slipping encoder, not slack
+
+private:
+  struct AxisSlack {
+    long steps;                                   // -1 until measured
+    int8_t direction;                             // Side the gears are loaded on, 0 if not known
+    long mark;                                    // Position at the last take-up
+  };
+
+  Logger& logger;
+  Preferences preferences;
+  AxisSlack slack[HEAD_AXES];
+  portMUX_TYPE lock;                              // loop() and the velocity task both start moves
+
+  static const char* key(int axis) {
+    static const char* keys[HEAD_AXES] = {"T", "P", "F", "Z"};
+    return keys[axis];
+  }
+
+public:
+  BacklashCompensator(Logger& alogger) : logger(alogger), lock(portMUX_INITIALIZER_UNLOCKED) {
+    for (int i = 0; i < HEAD_AXES; i++) {
+      slack[i] = AxisSlack{-1, 0, 0};
+    }
+  }
+
+  void load() {
+    preferences.begin("Backlash", true);
+    for (int i = 0; i < HEAD_AXES; i++) {
+      slack[i].steps = preferences.getLong(key(i), -1);
+      if (slack[i].steps >= 0) {
+        logger.printf("\nBacklash axis %d: %ld steps", i, slack[i].steps);
+      }
+    }
+    preferences.end();
+  }
+
+  // Stores a measured slack, -1 forgets it so the next start measures again
+  void set(int axis, long steps) {
+    slack[axis].steps = steps < 0 ? -1 : steps > MAX_STEPS ? MAX_STEPS : steps;
+    preferences.begin("Backlash", false);
+    if (slack[axis].steps < 0) {
+      preferences.remove(key(axis));
+    } else {
+      preferences.putLong(key(axis), slack[axis].steps);
+    }
+    preferences.end();
+  }
+
+  bool isMeasured(int axis) const {
+    return slack[axis].steps >= 0;
+  }
+
+  long steps(int axis) const {
+    return max(slack[axis].steps, 0L);
+  }
+
+  // Forgets which side the gears are on, after homing set a new zero
+  void reset(int axis, FastAccelStepper* stepper, int direction) {
+    portENTER_CRITICAL(&lock);
+    slack[axis].direction = direction;
+    slack[axis].mark = stepper->getCurrentPosition();
+    portEXIT_CRITICAL(&lock);
+  }
+
+  // Call before the stepper is sent in direction (+1 or -1)
+  void takeUp(int axis, FastAccelStepper* stepper, int direction) {
+    if (stepper == NULL || direction == 0) return;
+    AxisSlack& s = slack[axis];
+    portENTER_CRITICAL(&lock);
+    long pos = stepper->getCurrentPosition();
+    if (pos != s.mark) {
+      s.direction = pos > s.mark ? 1 : -1;       // Moved since the last call, the gears are loaded that way
+    }
+    if (s.steps > 0 && s.direction != 0 && s.direction != direction) {
+      pos -= direction * s.steps;
+      stepper->setCurrentPosition(pos);
+    }
+    s.direction = direction;
+    s.mark = pos;
+    portEXIT_CRITICAL(&lock);
+  }
+
+  void takeUpTo(int axis, FastAccelStepper* stepper, long target) {
+    if (stepper == NULL) return;
+    long pos = stepper->getCurrentPosition();
+    takeUp(axis, stepper, target > pos ? 1 : target < pos ? -1 : 0);
+  }
+
+  void takeUpTo(const AxisSet<HEAD_AXES>& axes, const int* targets) {
+    for (int i = 0; i < HEAD_AXES; i++) {
+      takeUpTo(i, axes[i], targets[i]);
+    }
+  }
+};
+
+#endif // BACKLASH_H
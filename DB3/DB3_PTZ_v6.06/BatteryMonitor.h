@@ -0,0 +1,264 @@
+#ifndef BATTERY_MONITOR_H
+#define BATTERY_MONITOR_H
+
+#include <Adafruit_SSD1306.h>
+#include "Logger.h"
+
+// Reading of the 2S Li-ion pack against charge left, from full to empty. These are volts as sample() reports them,
+// not pack volts: the ADC saturates at 2 x 4.182 = 8.36V and reads low below that, so a full pack tops out there
+// and the ladder this replaced called anything over 7.5V full. Its 7.5, 7.4, 7.3 and 7.2V steps still land on the
+// same battery icon.
+struct DischargePoint {
+  float volts;
+  uint8_t percent;
+};
+
+static const DischargePoint BATTERY_CURVE[] = {
+  {8.36, 100}, {7.80, 95}, {7.60, 90}, {7.50, 88}, {7.40, 63},
+  {7.30, 38}, {7.20, 13}, {7.10, 5}, {7.00, 0}
+};
+static const int BATTERY_CURVE_POINTS = sizeof(BATTERY_CURVE) / sizeof(BATTERY_CURVE[0]);
+
+// Part of the OLED the gauge redraws on its own
+struct OledRegion {
+  uint8_t x0, x1;                                 // Columns
+  uint8_t page0, page1;                           // 8 pixel rows each
+};
+
+enum BatteryRegion { REGION_RUNTIME = 0, REGION_ID, REGION_PERCENT, REGION_ICON, BATTERY_REGIONS };
+
+static const OledRegion BATTERY_REGION[BATTERY_REGIONS] = {
+  {35, 100, 1, 1},                                // Runtime, text at 35,8
+  {35, 67, 2, 2},                                 // ID, text at 35,16
+  {35, 67, 3, 3},                                 // Percent, text at 35,25
+  {68, 92, 2, 3},                                 // Battery icon, 25x10 at 68,22
+};
+
+// Battery gauge on the OLED
+//
+// A low priority task samples the pack every SAMPLE_MS and filters it over about half a minute, so a stepper
+// pulling current does not make the gauge jump. The filtered voltage goes through the discharge curve to a
+// percentage, and the rate that percentage falls gives the minutes left. The task only redraws the parts of the
+// screen whose text changed and sends just those columns and pages, in one short I2C transaction.
+class BatteryMonitor {
+private:
+  uint8_t pin;
+  const int& id;
+  Logger& logger;
+  TaskHandle_t task;
+  portMUX_TYPE lock;
+  volatile uint8_t dirty;                         // One bit per region drawn but not yet sent
+
+  float filtered;                                 // Volts, 0 until the first sample
+  float percent;
+  float rate;                                     // Percent per minute, 0 until it has been measured
+  float window_percent;
+  unsigned long window_start_ms;
+  int windows;
+
+  int shown_id;                                   // What the screen shows, -1 forces a redraw
+  int shown_percent;
+  int shown_minutes;
+  int shown_level;
+
+  static const uint32_t SAMPLE_MS = 500;
+  static const int READINGS = 8;                  // analogRead calls averaged per sample
+  static constexpr float FILTER_SAMPLES = 60.0f;  // Time constant of the voltage filter, 30s
+  static const uint32_t WINDOW_MS = 60000;        // Discharge rate is measured over a minute
+  static constexpr float RATE_SMOOTHING = 5.0f;
+  static const int MAX_MINUTES = 995;
+  static const uint8_t OLED_ADDRESS = 0x3C;
+  static const uint8_t OLED_CHUNK = 16;           // Data bytes per I2C write, the Wire buffer holds 32
+
+  static void taskEntry(void* parameter) {
+    ((BatteryMonitor*)parameter)->run();
+  }
+
+  // Same scaling the ladder used, the divider halves the pack and 4.182 trims the ADC
+  float sample() {
+    uint32_t sum = 0;
+    for (int i = 0; i < READINGS; i++) {
+      sum += analogRead(pin);
+    }
+    return ((float)sum / READINGS / 4095) * 2 * 4.182;
+  }
+
+  static float toPercent(float volts) {
+    if (volts >= BATTERY_CURVE[0].volts) return 100;
+    for (int i = 1; i < BATTERY_CURVE_POINTS; i++) {
+      const DischargePoint& hi = BATTERY_CURVE[i - 1];
+      const DischargePoint& lo = BATTERY_CURVE[i];
+      if (volts >= lo.volts) {
+        return lo.percent + (volts - lo.volts) * (hi.percent - lo.percent) / (hi.volts - lo.volts);
+      }
+    }
+    return 0;
+  }
+
+  static int toLevel(int percent) {
+    if (percent > 87) return 4;
+    if (percent > 62) return 3;
+    if (percent > 37) return 2;
+    return 1;
+  }
+
+  // Rounded to 5 minutes so the estimate does not redraw every sample, -1 while unknown
+  int minutesLeft() const {
+    if (rate < 0.01f) return -1;
+    int minutes = (int)(percent / rate);
+    return min((minutes + 2) / 5 * 5, MAX_MINUTES);
+  }
+
+  void clear(BatteryRegion r) {
+    const OledRegion& region = BATTERY_REGION[r];
+    display.fillRect(region.x0, region.page0 * 8, region.x1 - region.x0 + 1, (region.page1 - region.page0 + 1) * 8, SSD1306_BLACK);
+  }
+
+  void markDirty(BatteryRegion r) {
+    portENTER_CRITICAL(&lock);
+    dirty |= 1 << r;
+    portEXIT_CRITICAL(&lock);
+  }
+
+  void drawText(BatteryRegion r, int x, int y, const char* text) {
+    clear(r);
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    display.cp437(true);
+    display.setCursor(x, y);
+    display.write(text);
+    markDirty(r);
+  }
+
+  void draw() {
+    char text[12];
+    int displayed_id = id == 5 ? 0 : id;          // PTZ ID 0 is actually 5!
+    if (displayed_id != shown_id) {
+      shown_id = displayed_id;
+      snprintf(text, sizeof(text), "ID:%d", shown_id);
+      drawText(REGION_ID, 35, 16, text);
+    }
+    int whole = (int)(percent + 0.5f);
+    if (whole != shown_percent) {
+      shown_percent = whole;
+      snprintf(text, sizeof(text), "%d%%", whole);
+      drawText(REGION_PERCENT, 35, 25, text);
+    }
+    int minutes = minutesLeft();
+    if (minutes != shown_minutes) {
+      shown_minutes = minutes;
+      if (minutes < 0) {
+        text[0] = '\0';
+      } else {
+        snprintf(text, sizeof(text), "~%d min", minutes);
+      }
+      drawText(REGION_RUNTIME, 35, 8, text);
+    }
+    int level = toLevel(whole);
+    if (level != shown_level) {
+      shown_level = level;
+      const unsigned char* icon = level == 4 ? logo_bmp4 : level == 3 ? logo_bmp3 : level == 2 ? logo_bmp2 : logo_bmp1;
+      clear(REGION_ICON);
+      display.drawBitmap(68, 22, icon, LOGO_WIDTH, LOGO_HEIGHT, 1);
+      markDirty(REGION_ICON);
+    }
+  }
+
+  void measureRate() {
+    if (millis() - window_start_ms < WINDOW_MS) return;
+    float drop = window_percent - percent;
+    if (drop < 0) drop = 0;                       // Recovering after a load or on charge
+    rate = windows == 0 ? drop : rate + (drop - rate) / RATE_SMOOTHING;
+    windows++;
+    window_percent = percent;
+    window_start_ms = millis();
+    logger.printf("\nBattery %.2fV %d%%, ", filtered, (int)(percent + 0.5f));
+    if (minutesLeft() < 0) {
+      logger.println("runtime unknown");
+    } else {
+      logger.printf("about %d min left", minutesLeft());
+    }
+  }
+
+  void run() {
+    TickType_t last_wake = xTaskGetTickCount();
+    for (;;) {
+      float volts = sample();
+      filtered = filtered == 0 ? volts : filtered + (volts - filtered) / FILTER_SAMPLES;
+      percent = toPercent(filtered);
+      if (window_start_ms == 0) {
+        window_percent = percent;
+        window_start_ms = millis();
+      }
+      measureRate();
+      draw();
+      flush();
+      vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SAMPLE_MS));
+    }
+  }
+
+  void sendRegion(const OledRegion& r) {
+    Wire.beginTransmission(OLED_ADDRESS);
+    Wire.write((uint8_t)0x00);                    // Command stream
+    Wire.write((uint8_t)SSD1306_PAGEADDR);
+    Wire.write(r.page0);
+    Wire.write(r.page1);
+    Wire.write((uint8_t)SSD1306_COLUMNADDR);
+    Wire.write(r.x0);
+    Wire.write(r.x1);
+    Wire.endTransmission();
+    const uint8_t* buffer = display.getBuffer();
+    for (int page = r.page0; page <= r.page1; page++) {
+      for (int x = r.x0; x <= r.x1; x += OLED_CHUNK) {
+        int n = min((int)OLED_CHUNK, r.x1 - x + 1);
+        Wire.beginTransmission(OLED_ADDRESS);
+        Wire.write((uint8_t)0x40);                // Data stream, fills the window page by page
+        Wire.write(&buffer[page * SCREEN_WIDTH + x], n);
+        Wire.endTransmission();
+      }
+    }
+  }
+
+public:
+  BatteryMonitor(uint8_t apin, const int& aid, Logger& alogger)
+    : pin(apin), id(aid), logger(alogger), task(NULL), lock(portMUX_INITIALIZER_UNLOCKED), dirty(0), filtered(0), percent(0),
+      rate(0), window_percent(0), window_start_ms(0), windows(0), shown_id(-1), shown_percent(-1), shown_minutes(-2), shown_level(-1) {
+  }
+
+  void begin() {
+    {
+      I2CTransaction bus(4);                      //OLED on bus 4
+      display.clearDisplay();
+      display.display();
+    }
+    xTaskCreatePinnedToCore(taskEntry, "Battery", 3072, this, 1, &task, 0);
+  }
+
+  // Sends the regions redrawn since the last call
+  void flush() {
+    portENTER_CRITICAL(&lock);
+    uint8_t pending = dirty;
+    dirty = 0;
+    portEXIT_CRITICAL(&lock);
+    if (pending == 0) return;
+    I2CTransaction bus(4);                        //OLED on bus 4
+    for (int r = 0; r < BATTERY_REGIONS; r++) {
+      if (pending & (1 << r)) sendRegion(BATTERY_REGION[r]);
+    }
+  }
+
+  float volts() const {
+    return filtered;
+  }
+
+  int percentLeft() const {
+    return (int)(percent + 0.5f);
+  }
+
+  // Minutes to empty at the measured discharge rate, -1 until a rate is known
+  int runtimeMinutes() const {
+    return minutesLeft();
+  }
+};
+
+#endif // BATTERY_MONITOR_H
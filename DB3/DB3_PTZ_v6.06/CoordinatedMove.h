@@ -0,0 +1,60 @@
+#ifndef COORDINATED_MOVE_H
+#define COORDINATED_MOVE_H
+
+#include <FastAccelStepper.h>
+
+// One axis of a multi axis move, where it should go and the fastest it may get there
+struct AxisMove {
+  FastAccelStepper* stepper;
+  long target;
+  uint32_t max_speed;                             // Hz
+  uint32_t max_accel;                             // steps/s², the ramps get longer rather than exceed it
+};
+
+// Starts a non blocking move on all axes so they arrive at the same time.
+// The axis that needs longest at its own speed limit sets the pace. Every other axis gets speed and acceleration
+// scaled by its distance, so all axes follow the same shaped velocity profile (trapezoid, or triangle for short
+// moves) and finish together. Returns the planned duration in ms, 0 if nothing has to move.
+inline unsigned long startCoordinatedMove(AxisMove* axes, int count, float rampSeconds) {
+  float cruiseSeconds = 0;                        // Time the pacing axis would need at full speed
+  for (int i = 0; i < count; i++) {
+    if (axes[i].stepper == NULL || axes[i].max_speed == 0) continue;
+    long dist = labs(axes[i].target - axes[i].stepper->getCurrentPosition());
+    float t = (float)dist / axes[i].max_speed;
+    if (t > cruiseSeconds) {
+      cruiseSeconds = t;
+    }
+  }
+  if (cruiseSeconds <= 0) return 0;
+
+  for (int i = 0; i < count; i++) {               // Every axis shares the ramp time, so the one closest to its limit sets it
+    if (axes[i].stepper == NULL || axes[i].max_speed == 0 || axes[i].max_accel == 0) continue;
+    long dist = labs(axes[i].target - axes[i].stepper->getCurrentPosition());
+    float ramp = dist / cruiseSeconds / axes[i].max_accel;
+    if (ramp > rampSeconds) {
+      rampSeconds = ramp;
+    }
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (axes[i].stepper == NULL || axes[i].max_speed == 0) continue;
+    long dist = labs(axes[i].target - axes[i].stepper->getCurrentPosition());
+    if (dist == 0) continue;
+    float speed = dist / cruiseSeconds;           // Hz
+    uint32_t milliHz = speed * 1000;
+    int32_t accel = speed / rampSeconds;
+    axes[i].stepper->setSpeedInMilliHz(milliHz > 1000 ? milliHz : 1000);
+    axes[i].stepper->setAcceleration(accel > 1 ? accel : 1);
+    axes[i].stepper->moveTo(axes[i].target);
+  }
+
+  float totalSeconds;
+  if (cruiseSeconds >= rampSeconds) {
+    totalSeconds = cruiseSeconds + rampSeconds;   // Trapezoid, ramp up and down each take rampSeconds
+  } else {
+    totalSeconds = 2 * sqrt(cruiseSeconds * rampSeconds);  // Triangle, never reaches the planned speed
+  }
+  return totalSeconds * 1000;
+}
+
+#endif // COORDINATED_MOVE_H
@@ -67,14 +67,25 @@
 #include <Adafruit_SSD1306.h>
 #include <HardwareSerial.h>
 #include "Logger.h"
+#include "ResponseCurve.h"
 uint16_t GetUdpViscaPort();
 #include "coap_server.h" 
+#include "CoordinatedMove.h"
+#include "Axis.h"
+#include "Backlash.h"
+#include "AxisLimits.h"
+#include "VelocityController.h"
+#include "TourEngine.h"
+#include "TargetLock.h"
 #include "UDPViscaHandler.h"
+#include "WebSocketControl.h"
 #include "WifiConfigManager.h"
 
 #include "i2c.h"
 #include "oled.h"
+#include "BatteryMonitor.h"
 #include "encoders.h"
+#include "ShutterScheduler.h"
 
 
 Logger logger;
@@ -102,6 +113,7 @@ Preferences SysMemory;
 #define step4_pinDIR  5
 
 #define CAM A10                               // Pin Gpio 4 Camera trigger
+#define REC_PULSE_MS 200                      // Width of the record start/stop pulse
 #define StepD 13                              // Pin GPio 13 Activate Deactivate steppers
 
 //#define Mount_PIN A12                       //Switch Gpio 2 to mount the head
@@ -117,13 +129,12 @@ Preferences SysMemory;
 const byte pan_PIN = A6;                      // pin 34 Joy Stick input
 const byte tilt_PIN = A7;                     // Tilt 35 Joy Stick input
 const int BatPin = 39;                        //Battery monitoring pin
-float BatV;
 
 FastAccelStepperEngine engine = FastAccelStepperEngine();
-FastAccelStepper *stepper1 = NULL;
-FastAccelStepper *stepper2 = NULL;
-FastAccelStepper *stepper3 = NULL;
-FastAccelStepper *stepper4 = NULL;
+FastAccelStepper *stepper1 = NULL;                //Tilt, these name the steppers of the axis set below
+FastAccelStepper *stepper2 = NULL;                //Pan
+FastAccelStepper *stepper3 = NULL;                //Focus
+FastAccelStepper *stepper4 = NULL;                //Zoom
 
 
 //Variables
@@ -180,6 +191,8 @@ String DBFirmwareVersion = "frm V:6.06";      //Current firmware version
 //Change these valus depending on which pan tilt head you havebuilt over the top or balanced
 int Tilt_J_Speed = 150;                       //Set this to 150 for the Balanced PT 200 for the Over the Top PT
 int Pan_J_Speed = 4000;                        //Set this to 4000  for both the Balanced PT and Over the Top PT
+const float Pan_Steps_Degree = 44;              //Steps per degree, the same scales as the pan and tilt angles shown on the controller
+const float Tilt_Steps_Degree = 650;            //Make it negative if the head tilts the wrong way following the Mini Jib
 //********************************************************************************************************************
 //****************************PTZ Variables*************************************//
 int Joy_Pan_Speed;                           //PTZ variables
@@ -192,12 +205,37 @@ int Joy_Zoo_Speed;
 int Joy_Zoo_Accel;
 int Focus_Stop;
 int Zoo_Stop;
+const unsigned long PTZ_CONTROL_PERIOD_MS = 5;                  //PTZ_Control runs at 200Hz
+const AxisResponse TiltResponse = {&EXPO_CURVE, 150, TILT_COMMAND_FULL, TILT_COMMAND_FULL};        //Response curves applied to the Joy_ speeds, see ResponseCurve.h
+const AxisResponse PanResponse = {&EXPO_CURVE, 150, PAN_COMMAND_FULL, PAN_COMMAND_FULL};
+const AxisResponse FocusResponse = {&PRECISION_CURVE, 1000, LENS_COMMAND_FULL, LENS_COMMAND_FULL};  //Fine control for pulling focus
+const AxisResponse ZoomResponse = {&S_CURVE, 1000, LENS_COMMAND_FULL, LENS_COMMAND_FULL};          //Soft start and end on zooms
+const AxisResponse ControllerTiltResponse = {&EXPO_CURVE, 150, TILT_COMMAND_FULL, ESPNOW_STICK_FULL}; //The ESP-NOW controller keeps its old top speeds, one step/s per stick count
+const AxisResponse ControllerPanResponse = {&EXPO_CURVE, 150, PAN_COMMAND_FULL, ESPNOW_PAN_FULL};
+const AxisResponse ControllerFocusResponse = {&PRECISION_CURVE, 1000, LENS_COMMAND_FULL, ESPNOW_STICK_FULL};
+const AxisResponse ControllerZoomResponse = {&S_CURVE, 1000, LENS_COMMAND_FULL, ESPNOW_STICK_FULL};
+bool Joy_From_Controller;                      //Last live command came from the ESP-NOW controller, not VISCA or the browser
 
 void Home(); 
 void Stop();
-
-UDPViscaHandler udpvisca(&Joy_Pan_Speed, &Joy_Pan_Accel, &Joy_Tilt_Speed, &Joy_Tilt_Accel, logger, Home, Stop, GetUdpViscaPort);
-WiFiConfigManager wifiManager(&receiveCallback, &sentCallback, logger, udpvisca);
+void RecallPose(int pose);
+bool ViscaRecallPose(int pose);
+void ViscaMoveTo(const ViscaMoveRequest &request);
+void SetTourStop(int index, int pose, uint32_t travel_ms, uint32_t dwell_ms, uint32_t blend);
+
+BacklashCompensator backlash(logger);             //Gear slack per axis, measured against the encoders
+const AxisLimit DefaultAxisLimits[HEAD_AXES] = {  //Until autoTune() has run, high enough not to cap any existing move
+  {7200, 10000},                                  //Tilt
+  {5000, 10000},                                  //Pan
+  {20000, 20000},                                 //Focus
+  {20000, 20000},                                 //Zoom
+};
+AxisLimits limits(DefaultAxisLimits, logger);
+ShutterScheduler shutter(CAM, logger);
+VelocityController velocity(backlash, limits, logger);
+UDPViscaHandler udpvisca(&Joy_Pan_Speed, &Joy_Pan_Accel, &Joy_Tilt_Speed, &Joy_Tilt_Accel, logger, Home, Stop, GetUdpViscaPort, ViscaMoveTo, ViscaRecallPose);
+WebSocketControl wscontrol(&Joy_Pan_Speed, &Joy_Pan_Accel, &Joy_Tilt_Speed, &Joy_Tilt_Accel, &Joy_Focus_Speed, &Joy_Focus_Accel, &Joy_Zoo_Speed, &Joy_Zoo_Accel, logger, RecallPose, Stop, SetTourStop);
+WiFiConfigManager wifiManager(&receiveCallback, &sentCallback, logger, udpvisca, wscontrol);
 
 int Rec;                                      //Record request 0 -1
 int lastRecState;                             //Last Record button state for camera
@@ -205,6 +243,7 @@ int PTZ_Cam = 0;                              //Current PTZ camera defaulted to
 int PTS;                                      //Keeps track of the last selected PTZ camera
 int PTZ_ID = 5;                               //PTZ Hardwae ID defaulted to 5 cannot be used by PTZ control
 int lastPTZ_ID = PTZ_ID;                      //Stores the last known PTZ_ID
+BatteryMonitor battery(BatPin, PTZ_ID, logger);   //OLED battery gauge and ID
 int PTZ_ID_Nex;                               //incomming ID request from nection control
 int PTZ_Pose;                                 //Curent PTZ Pose key
 int PTZ_SaveP;                                //PTZ save position comand true or false
@@ -227,12 +266,22 @@ int cam_F_Out;                                //Actual value used dependant on I
 int cam_Z_In;                                //Actual value used dependant on ID
 int cam_Z_Out;                               //Actual value used dependant on ID
 
+//Axis table, one row per HeadAxis. Name, pose key, step, dir, enable, reversed, limits, encoder, brake accel, pose accel, pose speed divisor
+const AxisDescriptor HeadAxes[HEAD_AXES] = {
+  {"Tilt", 'T', step1_pinSTEP, step1_pinDIR, StepD, false, &Forward_T_In, &Forward_T_Out, &T_, 1800, 4000, 1},
+  {"Pan", 'P', step2_pinSTEP, step2_pinDIR, StepD, false, &Forward_P_In, &Forward_P_Out, &P_, 1800, 4000, 1},
+  {"Focus", 'F', step3_pinSTEP, step3_pinDIR, StepFOC, false, &cam_F_In, &cam_F_Out, &F_, 12000, 4000, 1},
+  {"Zoom", 'Z', step4_pinSTEP, step4_pinDIR, StepFOC, false, &cam_Z_In, &cam_Z_Out, &Z_, 12000, 1000, 2},  //Zoom limited to prevent over speed on heavy zoom rings
+};
+AxisSet<HEAD_AXES> axes(HeadAxes);
+
 int Z_Stop;                                   //Used to prevent the focus motor crashing into the end over and over
 int B_Stop;                                   //Used to prevent the focus motor crashing into the end over and over
-int T_position;                               //Holding variable for PTZ positions
-int P_position;
-int F_position;
-int Z_position;
+int PoseTarget[HEAD_AXES];                    //Holding variable for PTZ positions
+int& T_position = PoseTarget[AXIS_TILT];
+int& P_position = PoseTarget[AXIS_PAN];
+int& F_position = PoseTarget[AXIS_FOCUS];
+int& Z_position = PoseTarget[AXIS_ZOOM];
 
 int stopM_play;                               //Stopmotion Trigger SM
 int stopM_cancel;                             //Stopmmotion cancel SC
@@ -242,75 +291,17 @@ int stopM_frames;                             //The Total number of frames requi
 int SMC;                                    //stopmotion counter
 int But;
 
-int P1_T = 10;                        //PTZ Tilt positions
-int P2_T = 10;
-int P3_T = 10;
-int P4_T = 10;
-int P5_T = 10;
-int P6_T = 10;
-int P7_T = 10;
-int P8_T = 10;
-int P9_T = 10;
-int P10_T = 10;
-int P11_T = 10;
-int P12_T = 10;
-int P13_T = 10;
-int P14_T = 10;
-int P15_T = 10;
-int P16_T = 10;
-
-int P1_P = 10;                          //PTZ Pan positions
-int P2_P = 10;
-int P3_P = 10;
-int P4_P = 10;
-int P5_P = 10;
-int P6_P = 10;
-int P7_P = 10;
-int P8_P = 10;
-int P9_P = 10;
-int P10_P = 10;
-int P11_P = 10;
-int P12_P = 10;
-int P13_P = 10;
-int P14_P = 10;
-int P15_P = 10;
-int P16_P = 10;
-
-
-int P1_F = 10;                          //PTZ Focus positions
-int P2_F = 10;
-int P3_F = 10;
-int P4_F = 10;
-int P5_F = 10;
-int P6_F = 10;
-int P7_F = 10;
-int P8_F = 10;
-int P9_F = 10;
-int P10_F = 10;
-int P11_F = 10;
-int P12_F = 10;
-int P13_F = 10;
-int P14_F = 10;
-int P15_F = 10;
-int P16_F = 10;
-
-int P1_Z = 10;                          //PTZ Zoom positions
-int P2_Z = 10;
-int P3_Z = 10;
-int P4_Z = 10;
-int P5_Z = 10;
-int P6_Z = 10;
-int P7_Z = 10;
-int P8_Z = 10;
-int P9_Z = 10;
-int P10_Z = 10;
-int P11_Z = 10;
-int P12_Z = 10;
-int P13_Z = 10;
-int P14_Z = 10;
-int P15_Z = 10;
-int P16_Z = 10;
-
+const int POSES = 16;                          //PTZ poses 1-14, 15 A-B move, 16 sequencer move
+int Pose[POSES][HEAD_AXES];                     //Stored pose positions per axis, recovered in Load_SysMemory
+const int TOUR_START_POSE = 101;               //Pose requests that start and stop the preset tour, like 100 enters Set Limits
+const int TOUR_STOP_POSE = 102;
+const int AUTOTUNE_POSE = 103;                  //Measures how fast this head's axes can go, see autoTune()
+TourEngine tour(axes, backlash, limits, Pose, 14, logger);        //Tours visit the plain poses 1-14
+const int LOCK_MARK_POSE = 104;                 //Target lock, mark the framed subject from two slider positions, then start and stop, not over VISCA
+const int LOCK_START_POSE = 105;
+const int LOCK_STOP_POSE = 106;
+const int JIB_FOLLOW_POSE = 107;                //Tilt follows the Mini Jib's horizon or target compensation, 106 stops it too
+TargetLock lock(axes, velocity, limits, Pan_Steps_Degree, Tilt_Steps_Degree, logger);   //Keeps pan and tilt on a point while the slider moves
 
 float factor;
 int Mount = 0;                                 //Is the Mount function active 1 true 0 false
@@ -324,35 +315,40 @@ long tilt_AVG;
 long pan_AVG;
 
 
-long PANin_position = 0;                      // variable to hold IN positions for slider
-long TLTin_position = 0;
-long FOCin_position = 0;
-long ZMin_position = 0;
+long AxisIn[HEAD_AXES];                       // variable to hold IN positions for slider
+long& PANin_position = AxisIn[AXIS_PAN];
+long& TLTin_position = AxisIn[AXIS_TILT];
+long& FOCin_position = AxisIn[AXIS_FOCUS];
+long& ZMin_position = AxisIn[AXIS_ZOOM];
 
-long PANout_position = 0;                     // variable to hold OUT position for slider
-long TLTout_position = 0;
-long FOCout_position = 0;
-long ZMout_position = 0;
+long AxisOut[HEAD_AXES];                      // variable to hold OUT position for slider
+long& PANout_position = AxisOut[AXIS_PAN];
+long& TLTout_position = AxisOut[AXIS_TILT];
+long& FOCout_position = AxisOut[AXIS_FOCUS];
+long& ZMout_position = AxisOut[AXIS_ZOOM];
 
-long PANtravel_dist = 0;                        //Distance to travel
-long TLTtravel_dist = 0;
-long FOCtravel_dist = 0;
-long ZOOMtravel_dist = 0;
+long TravelDist[HEAD_AXES];                     //Distance to travel
+long& PANtravel_dist = TravelDist[AXIS_PAN];
+long& TLTtravel_dist = TravelDist[AXIS_TILT];
+long& FOCtravel_dist = TravelDist[AXIS_FOCUS];
+long& ZOOMtravel_dist = TravelDist[AXIS_ZOOM];
 
-float PANstep_speed = 0;                        // default travel speed between IN and OUT points
-float TLTstep_speed = 0;
-float FOCstep_speed = 0;
-float ZOOMstep_speed = 0;
+float StepSpeed[HEAD_AXES];                     // default travel speed between IN and OUT points
+float& PANstep_speed = StepSpeed[AXIS_PAN];
+float& TLTstep_speed = StepSpeed[AXIS_TILT];
+float& FOCstep_speed = StepSpeed[AXIS_FOCUS];
+float& ZOOMstep_speed = StepSpeed[AXIS_ZOOM];
 
 int PANfps_step_dist = 0;
 int TLTfps_step_dist = 0;
 int FOCfps_step_dist = 0;
 int Zoo_step_dist = 0;
 
-int TLTease_Value = 0;                      // Variable to hold actual Ease value used for acceleration calculation
-int PANease_Value = 0;
-int FOCease_Value = 0;
-int ZOOMease_Value = 0;
+int EaseValue[HEAD_AXES];                   // Variable to hold actual Ease value used for acceleration calculation
+int& TLTease_Value = EaseValue[AXIS_TILT];
+int& PANease_Value = EaseValue[AXIS_PAN];
+int& FOCease_Value = EaseValue[AXIS_FOCUS];
+int& ZOOMease_Value = EaseValue[AXIS_ZOOM];
 
 int  TLTTlps_step_dist;
 int  PANTlps_step_dist;
@@ -684,6 +680,41 @@ String PanPPPPP = "05C26"; //Left100
 String TiltTTTT = "1BA5"; //Up30
 int TLY = 1;
 
+//CoAP resource bodies, rendered when a client reads or observes them
+int CoapPositionJson(char* out, size_t size) {
+  int len = snprintf(out, size, "{");
+  for (int i = 0; i < HEAD_AXES && len < (int)size; i++) {
+    long position = axes[i] != NULL ? (long)axes[i]->getCurrentPosition() : 0;
+    len += snprintf(out + len, size - len, "\"%s\":%ld,", HeadAxes[i].name, position);
+  }
+  if (len < (int)size) len += snprintf(out + len, size - len, "\"moving\":%s}", axes.isRunning() ? "true" : "false");
+  return len;
+}
+
+int CoapStatusJson(char* out, size_t size) {
+  return snprintf(out, size, "{\"id\":%d,\"moving\":%s,\"tour\":%s,\"pose\":%d,\"volts\":%.2f,\"battery\":%d,\"runtime\":%d}",
+                  PTZ_ID == 5 ? 0 : PTZ_ID, axes.isRunning() ? "true" : "false", tour.isRunning() ? "true" : "false", lastPTZ_Pose,
+                  battery.volts(), battery.percentLeft(), battery.runtimeMinutes());
+}
+
+int CoapTallyJson(char* out, size_t size) {
+  return snprintf(out, size, "{\"tally\":%d,\"enabled\":%s}", tally.get(), TLY == 1 ? "true" : "false");
+}
+
+int CoapPresetsJson(char* out, size_t size) {                 //Poses 1-14, each as its axis positions in HeadAxes order
+  int len = snprintf(out, size, "{\"presets\":[");
+  for (int pose = 0; pose < 14 && len < (int)size; pose++) {
+    len += snprintf(out + len, size - len, pose == 0 ? "[" : ",[");
+    for (int i = 0; i < HEAD_AXES && len < (int)size; i++) {
+      len += snprintf(out + len, size - len, i == 0 ? "%d" : ",%d", Pose[pose][i]);
+    }
+    if (len < (int)size) len += snprintf(out + len, size - len, "]");
+  }
+  if (len < (int)size) len += snprintf(out + len, size - len, "]}");
+  return len;
+}
+
+
 
 const byte bufferSize = 32;
 char serialBuffer[bufferSize];
@@ -693,6 +724,14 @@ bool hasData = false;
 const byte numChars = 32;
 char receivedChars[numChars];   // an array to store the received data
 
+// VISCA lines an Ethernet decoder routes to this head over ESP-NOW instead of the UART, see DB3_VISCA_Decoder
+const char ESPNOW_VISCA_TAG[] = "VISCA:";
+const int ESPNOW_VISCA_LINES = 8;
+char espnowVisca[ESPNOW_VISCA_LINES][numChars];
+int espnowViscaHead = 0;
+int espnowViscaCount = 0;
+portMUX_TYPE espnowViscaLock = portMUX_INITIALIZER_UNLOCKED;
+
 String strs[4];
 int StringCount = 0;
 boolean newData = false;
@@ -780,6 +819,7 @@ int WIFIOUT[8];                                           //set up 5 element arr
 //#define TXD2 17
 
 TaskHandle_t C1;
+unsigned long I2C_Stats_ms;                   //Last time the encoder task logged the bus stats
 TaskHandle_t C2;
 
 
@@ -790,6 +830,7 @@ void setup() {
   wifiManager.setup();
 
   SetupTallyLed();
+  i2cbus.begin();
   SetupOled(logger);
   //*************************************Setup a core to run Encoder****************************
   //  xTaskCreatePinnedToCore(coreas1signments, "Core_1", 10000, NULL, 2, &C1, 0);
@@ -797,32 +838,12 @@ void setup() {
   //  disableCore1WDT();
 
   engine.init(1); // run StepperTask on CPU 1, since there is too much cpu contention on CPU 0, triggering the watchdog and causing endless reboots, see https://github.com/gin66/FastAccelStepper/issues/106
-  stepper1 = engine.stepperConnectToPin(step1_pinSTEP);
-  if (stepper1) {
-    stepper1->setDirectionPin(step1_pinDIR);
-    stepper1->setEnablePin(StepD);
-    stepper1->setAutoEnable(false);
-  }
-  stepper2 = engine.stepperConnectToPin(step2_pinSTEP);
-  if (stepper2) {
-    stepper2->setDirectionPin(step2_pinDIR);
-    stepper2->setEnablePin(StepD);
-    stepper2->setAutoEnable(false);
-  }
-  stepper3 = engine.stepperConnectToPin(step3_pinSTEP);
-  if (stepper3) {
-    stepper3->setDirectionPin(step3_pinDIR);
-    stepper3->setEnablePin(StepFOC);
-    stepper3->setAutoEnable(false);
-  }
-  stepper4 = engine.stepperConnectToPin(step4_pinSTEP);
-  if (stepper4) {
-    stepper4->setDirectionPin(step4_pinDIR);
-    stepper4->setEnablePin(StepFOC);
-    stepper4->setAutoEnable(false);
-  }
-
-  Wire.begin();
+  axes.connect(engine, logger);
+  stepper1 = axes[AXIS_TILT];
+  stepper2 = axes[AXIS_PAN];
+  stepper3 = axes[AXIS_FOCUS];
+  stepper4 = axes[AXIS_ZOOM];
+
   logger.println("\nRunning DigitalBird DB3 Pan Tilt Head software version 1.0\n");
   UARTport.begin(9600, SERIAL_8N1, 16, 17);
   
@@ -836,23 +857,22 @@ void setup() {
   pinMode(Hall_Tilt, INPUT_PULLUP);
   pinMode(tilt_PIN, INPUT);                                     //Joystick Tilt
   pinMode(pan_PIN, INPUT);                                      //Joystick pan
-  pinMode (CAM, OUTPUT);                                        //Camera Shutter
+  shutter.begin();                                              //Camera Shutter
   digitalWrite(StepD, LOW);                                     //Stepper Driver Activation
   digitalWrite(StepFOC, LOW);                                   //Enable Focus motor
-  digitalWrite(CAM, LOW);                                       //Camera Shutter
-  stepper1->setCurrentPosition(0);                              //Set all steppers to position 0
-  stepper2->setCurrentPosition(0);
-  stepper3->setCurrentPosition(0);
-  stepper4->setCurrentPosition(0);
+  axes.setCurrentPositions(0);                                  //Set all steppers to position 0
 
   //SysMemory Recover last setup
   SysMemory.begin("ID", false);                                 //Recover the last PTZ_ID from memory before shutdown
   PTZ_ID = SysMemory.getUInt("PTZ_ID", 5);
   SysMemory.end();
   lastPTZ_ID = PTZ_ID;                                          //set last PTZ_ID for comparison when changing ID
+  tally.setIndex(PTZ_ID == 5 ? 0 : PTZ_ID);                     //Network tally listens for the head's ID
   logger.printf("PTZ_ID is set to: %d \n", PTZ_ID);
   //saveIP();
   Load_SysMemory();
+  backlash.load();
+  limits.load();
   logger.printf("\ncam_F_Out: %d \n", cam_F_Out);
   logger.printf("\ncam_F_In: %d \n", cam_F_In);
   logger.printf("IP Adress: %d.%d.%d.%d %d\n", IP1, IP2, IP3, IP4, IPGW, UDP);
@@ -862,14 +882,24 @@ void setup() {
   InitialValues();                                              //onboard Joystick calobration
   SendNextionValues();
 
+  battery.begin();
   //*************************************Setup a core to run Encoder****************************
   xTaskCreatePinnedToCore(coreas1signments, "Core_1", 10000, NULL, 2, &C1, 0);
 
 
   delay(100);
   disableCore1WDT();
+  calibrateBacklash();                                          //Only on the first start, or after the keys were cleared
 
-  udpvisca.configure(stepper1, stepper2);
+  for (int i = 0; i < HEAD_AXES; i++) {
+    velocity.configure((HeadAxis)i, axes[i], HeadAxes[i].limit_in, HeadAxes[i].limit_out, HeadAxes[i].brake_accel);
+  }
+  velocity.begin();
+  tour.load();
+  lock.load();
+  lock.begin();
+  udpvisca.configure(stepper1, stepper2, stepper3, stepper4);
+  wscontrol.configure(stepper1, stepper2, stepper3, stepper4);
 
   delay(2000);
 
@@ -880,9 +910,11 @@ void setup() {
 
 
 void loop() {
+  shutter.loop();
   if (wifiManager.loop())
   {
     PTZ_Cam = PTZ_ID; //force PTZ control because movement command received over udp
+    Joy_From_Controller = false;
   }
 
   //TA=20;
@@ -895,11 +927,24 @@ void loop() {
     SendNextionValues();         //Send back the address
     IPR = 0;
   }
-  if (TLY == 1) {
-    SetTallyLed(Tally);
-  }
+  tally.setEnabled(TLY == 1);                   //The tally task only redraws on a change
 
   listenForVisca();
+  lock.loop();
+
+  if (lock.isRunning()) {                                   //As does any stick input from the target lock
+    if (abs(Joy_Pan_Speed) > PanResponse.deadband || abs(Joy_Tilt_Speed) > TiltResponse.deadband) {
+      lock.stop();
+    }
+  }
+
+  if (tour.isRunning()) {                                   //Any stick input takes the head back from the tour
+    if (abs(Joy_Pan_Speed) > PanResponse.deadband || abs(Joy_Tilt_Speed) > TiltResponse.deadband ||
+        abs(Joy_Focus_Speed) > FocusResponse.deadband || abs(Joy_Zoo_Speed) > ZoomResponse.deadband) {
+      tour.stop();
+    }
+    tour.run();
+  }
 
   //IF the Jib is present then make sure that the ease value is at least 1 for all moves.
   if (JB != 0 && ease_InOut < 1) {
@@ -909,6 +954,7 @@ void loop() {
   if ((PTZ_ID_Nex != 0) && (PTZ_ID_Nex != lastPTZ_ID)) {
     SetID();
     lastPTZ_ID = PTZ_ID;
+    tally.setIndex(PTZ_ID == 5 ? 0 : PTZ_ID);
   }
   //logger.printf("PTZ_CAM is set to: %d \n", PTZ_Cam);
   //logger.printf("PTZ_ID is set to: %d \n", PTZ_ID);
@@ -989,7 +1035,7 @@ void loop() {
 
 
   if  (Nextion_play == 1 && (PTZ_ID == 5)) {                  //Play comand receved
-    if (stepper1->getCurrentPosition() != (TLTin_position) || stepper2->getCurrentPosition() != (PANin_position) || stepper3->getCurrentPosition() != (FOCin_position) || stepper4->getCurrentPosition() != (ZMin_position) ) {
+    if (!axes.isAt(AxisIn)) {
       digitalWrite(StepFOC, LOW);
       delay(20);
       SetSpeed();
@@ -1000,9 +1046,7 @@ void loop() {
       SetSpeed();                                              // This causes reboot?????????????
       delay(20);
       if (Tps == 0) {                                          //No timelapse
-        digitalWrite(CAM, HIGH);                               //Start camera
-        delay (200);
-        digitalWrite(CAM, LOW);                                //Start camera
+        shutter.pulse(REC_PULSE_MS);                           //Start camera
         if (TLY == 1) {
           TurnOffTallyLight();          
         }
@@ -1095,14 +1139,14 @@ void loop() {
       digitalWrite(StepZOOM, LOW);
       digitalWrite(StepD, LOW);
       delay(20);
-      stepper3->setSpeedInHz(3000);
-      stepper3->setAcceleration(1000);
+      stepper3->setSpeedInHz(limits.speed(AXIS_FOCUS, 3000));
+      stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 1000));
 
-      stepper4->setSpeedInHz(1000);
-      stepper4->setAcceleration(500);
+      stepper4->setSpeedInHz(limits.speed(AXIS_ZOOM, 1000));
+      stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 500));
 
-      stepper1->setSpeedInHz(1500);
-      stepper1->setAcceleration(500);
+      stepper1->setSpeedInHz(limits.speed(AXIS_TILT, 1500));
+      stepper1->setAcceleration(limits.accel(AXIS_TILT, 500));
 
       stepper3->moveTo(cam_F_In);
       delay(10);
@@ -1208,9 +1252,7 @@ void loop() {
       delay(20);
       Start_1();                                             //Go to start
       delay(20);
-      digitalWrite(CAM, HIGH);                               //Start camera
-      delay (200);
-      digitalWrite(CAM, LOW);                                //Start camera
+      shutter.pulse(REC_PULSE_MS);                           //Start camera
       if (TLY == 1) {
         TurnOnTallyLight();
       }
@@ -1222,9 +1264,7 @@ void loop() {
 
     } else {                                                 //System is at the start and ready to play
       delay(20);
-      digitalWrite(CAM, HIGH);                               //Start camera
-      delay (200);
-      digitalWrite(CAM, LOW);                                //Start camera
+      shutter.pulse(REC_PULSE_MS);                           //Start camera
       if (TLY == 1) {
         TurnOnTallyLight();
       }
@@ -1279,7 +1319,10 @@ void coreas1signments( void * pvParameters ) {
     T_.Start_Encoder();
     P_.Start_Encoder();
     vTaskDelay(10);
-    BatCheck();
+    if (millis() - I2C_Stats_ms >= 60000) {     //Bus use per device once a minute
+      i2cbus.logStats(logger);
+      I2C_Stats_ms = millis();
+    }
   };
 }
 
@@ -1292,18 +1335,18 @@ void INpointSet() {
   delay(10);
   switch (InP) {
     case 1:                                                       //First Press: Request a new Inpoint
-      if (stepper1->getCurrentPosition() != (TLTin_position) || stepper2->getCurrentPosition() != (PANin_position) || stepper3->getCurrentPosition() != (FOCin_position) || stepper4->getCurrentPosition() != (ZMin_position)) {  //Run to In position
-        stepper1->setSpeedInHz(2000);
-        stepper1->setAcceleration(3000);
+      if (!axes.isAt(AxisIn)) {  //Run to In position
+        stepper1->setSpeedInHz(limits.speed(AXIS_TILT, 2000));
+        stepper1->setAcceleration(limits.accel(AXIS_TILT, 3000));
 
-        stepper2->setSpeedInHz(2000);
-        stepper2->setAcceleration(3000);
+        stepper2->setSpeedInHz(limits.speed(AXIS_PAN, 2000));
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, 3000));
 
-        stepper3->setSpeedInUs(50);
-        stepper3->setAcceleration(2000);
+        stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, 50));
+        stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 2000));
 
-        stepper4->setSpeedInUs(50);
-        stepper4->setAcceleration(2000);
+        stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, 50));
+        stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 2000));
 
 
 
@@ -1376,14 +1419,14 @@ void OUTpointSet() {
     case 1:                                                           //First Press: Request a new OUTpoint
       if (stepper1->getCurrentPosition() != (TLTout_position) || stepper2->getCurrentPosition() != (PANout_position) || stepper3->getCurrentPosition() != (FOCout_position) || stepper4->getCurrentPosition() != (ZMout_position)) {
 
-        stepper1->setSpeedInUs(200);                                 //Setup stepper speed and acceloration
-        stepper1->setAcceleration(3000);
-        stepper2->setSpeedInUs(200);
-        stepper2->setAcceleration(3000);
-        stepper3->setSpeedInUs(50);
-        stepper3->setAcceleration(2000);
-        stepper4->setSpeedInUs(50);
-        stepper4->setAcceleration(2000);
+        stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, 200));                                 //Setup stepper speed and acceloration
+        stepper1->setAcceleration(limits.accel(AXIS_TILT, 3000));
+        stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, 200));
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, 3000));
+        stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, 50));
+        stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 2000));
+        stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, 50));
+        stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 2000));
 
         stepper1->moveTo(TLTout_position);                            //Start moves
         delay(10);
@@ -1451,7 +1494,40 @@ void OUTpointSet() {
 
 //*********************************************************Move to pre recorded PTZ pose*************************************
 void PTZ_MoveP() {
-
+  if (lastPTZ_Pose == TOUR_START_POSE) {
+    TourStart();
+    PTZ_Pose = 0;
+    return;
+  }
+  tour.stop();                                                  //Any other pose request ends a running tour
+  if (lastPTZ_Pose == TOUR_STOP_POSE) {
+    PTZ_Pose = 0;
+    return;
+  }
+  if (lastPTZ_Pose == LOCK_MARK_POSE) {
+    lock.mark();
+    PTZ_Pose = 0;
+    return;
+  }
+  if (lastPTZ_Pose == LOCK_START_POSE || lastPTZ_Pose == JIB_FOLLOW_POSE) {
+    digitalWrite(StepD, LOW);                                   //Power up the steppers
+    pan_is_moving = false;                                      //Keep PTZ_Control from braking the lock
+    tilt_is_moving = false;
+    lock.start(lastPTZ_Pose == JIB_FOLLOW_POSE ? LOCK_JIB : LOCK_SLIDER);
+    PTZ_Pose = 0;
+    return;
+  }
+  lock.stop();                                                  //and the target lock
+  if (lastPTZ_Pose == LOCK_STOP_POSE) {
+    PTZ_Pose = 0;
+    return;
+  }
+  if (lastPTZ_Pose == AUTOTUNE_POSE) {
+    autoTune();
+    PTZ_Pose = 0;
+    return;
+  }
+  velocity.releaseAll();                                        //Take the steppers back from live control
 
   delay(10);
   int lastPTZ_Cam;
@@ -1462,143 +1538,10 @@ void PTZ_MoveP() {
 
 
 
-  switch (lastPTZ_Pose) {
-    case 1:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P1_T);
-        P_position = (P1_P);
-        F_position = (P1_F);
-        Z_position = (P1_Z);
-      }
-      break;
-    case 2:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P2_T);
-        P_position = (P2_P);
-        F_position = (P2_F);
-        Z_position = (P2_Z);
-      }
-      break;
-    case 3:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P3_T);
-        P_position = (P3_P);
-        F_position = (P3_F);
-        Z_position = (P3_Z);
-      }
-      break;
-    case 4:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P4_T);
-        P_position = (P4_P);
-        F_position = (P4_F);
-        Z_position = (P4_Z);
-      }
-      break;
-    case 5:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P5_T);
-        P_position = (P5_P);
-        F_position = (P5_F);
-        Z_position = (P5_Z);
-      }
-      break;
-    case 6:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P6_T);
-        P_position = (P6_P);
-        F_position = (P6_F);
-        Z_position = (P6_Z);
-      }
-      break;
-
-    case 7:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P7_T);
-        P_position = (P7_P);
-        F_position = (P7_F);
-        Z_position = (P7_Z);
-      }
-      break;
-    case 8:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P8_T);
-        P_position = (P8_P);
-        F_position = (P8_F);
-        Z_position = (P8_Z);
-      }
-      break;
-
-    case 9:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P9_T);
-        P_position = (P9_P);
-        F_position = (P9_F);
-        Z_position = (P9_Z);
-      }
-      break;
-    case 10:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P10_T);
-        P_position = (P10_P);
-        F_position = (P10_F);
-        Z_position = (P10_Z);
-      }
-      break;
-    case 11:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P11_T);
-        P_position = (P11_P);
-        F_position = (P11_F);
-        Z_position = (P11_Z);
-      }
-      break;
-
-    case 12:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P12_T);
-        P_position = (P12_P);
-        F_position = (P12_F);
-        Z_position = (P12_Z);
-      }
-      break;
-    case 13:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P13_T);
-        P_position = (P13_P);
-        F_position = (P13_F);
-        Z_position = (P13_Z);
-      }
-      break;
-
-    case 14:
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P14_T);
-        P_position = (P14_P);
-        F_position = (P14_F);
-        Z_position = (P14_Z);
-      }
-      break;
-    case 15:                              //A-B programed move
-      if (PTZ_Cam == PTZ_ID) {
-        T_position = (P15_T);
-        P_position = (P15_P);
-        F_position = (P15_F);
-        Z_position = (P15_Z);
-
-      }
-      break;
-
-    case 16:
-      if (PTZ_Cam == PTZ_ID) {            //Sequencer programed move
-        T_position = (P16_T);
-        P_position = (P16_P);
-        F_position = (P16_F);
-        Z_position = (P16_Z);
-
-      }
-      break;
-
+  if (lastPTZ_Pose >= 1 && lastPTZ_Pose <= POSES && PTZ_Cam == PTZ_ID) {
+    for (int i = 0; i < HEAD_AXES; i++) {
+      PoseTarget[i] = Pose[lastPTZ_Pose - 1][i];
+    }
   }
 
   if (lastPTZ_Pose <= 14) {
@@ -1607,40 +1550,14 @@ void PTZ_MoveP() {
     //Use VPoseSpeed here
     VISCA_SetPoseSpeed();                                       //Set the speeds up based on VPoseSpeed from VISCA
 
-    stepper1->setSpeedInHz(TLTstep_speed);                     //Tilt
-    stepper1->setAcceleration(4000);
-
-    stepper2->setSpeedInHz(PANstep_speed);                     //Pan
-    stepper2->setAcceleration(4000);
-
-    stepper3->setSpeedInHz(FOCstep_speed);                     //Focus
-    stepper3->setAcceleration(4000);
-
-    stepper4->setSpeedInHz(ZOOMstep_speed / 2);                  //Zoom limited to prevent over speed on heavy zoom rings
-    stepper4->setAcceleration(1000);
-
-    //    stepper1->setSpeedInHz(5000);                           //Tilt
-    //    stepper1->setAcceleration(2000);
-    //
-    //    stepper2->setSpeedInHz(3000);                           //Pan
-    //    stepper2->setAcceleration(1000);
-    //
-    //    stepper3->setSpeedInHz(6000);                           //Focus
-    //    stepper3->setAcceleration(2000);
-    //
-    //    stepper4->setSpeedInHz(6000);                           //Zoom
-    //    stepper4->setAcceleration(2000);
-
-
-    stepper1->moveTo(T_position);
-    delay(10);
-    stepper2->moveTo(P_position);
-    delay(10);
-    stepper3->moveTo(F_position);
-    delay(10);
-    stepper4->moveTo(Z_position);
+    for (int i = 0; i < HEAD_AXES; i++) {
+      axes[i]->setSpeedInHz(limits.speed(i, StepSpeed[i] / HeadAxes[i].pose_speed_divisor));
+      axes[i]->setAcceleration(limits.accel(i, HeadAxes[i].pose_accel));
+    }
+    backlash.takeUpTo(axes, PoseTarget);                        //Land on the pose from either side at full speed
+    axes.moveTo(PoseTarget);
 
-    while (stepper1->isRunning() || stepper2->isRunning() || stepper3->isRunning() || stepper4->isRunning() ) {
+    while (axes.isRunning()) {
       delay(10);
     }
     // }
@@ -1650,7 +1567,7 @@ void PTZ_MoveP() {
   }
 
   if (lastPTZ_Pose == 15) {      //A-B programed move
-    if (stepper1->getCurrentPosition() != (TLTin_position) || stepper2->getCurrentPosition() != (PANin_position) || stepper3->getCurrentPosition() != (FOCin_position) || stepper4->getCurrentPosition() != (ZMin_position) ) {
+    if (!axes.isAt(AxisIn)) {
       digitalWrite(StepFOC, LOW);
       delay(20);
       SetSpeed();
@@ -1700,249 +1617,45 @@ void PTZ_MoveP() {
 
 
 void PTZ_Save() {
+  if (lastPTZ_Pose >= 1 && lastPTZ_Pose <= POSES && PTZ_Cam == PTZ_ID) {
+    for (int i = 0; i < HEAD_AXES; i++) {
+      Pose[lastPTZ_Pose - 1][i] = axes[i]->getCurrentPosition();
+    }
+    StorePose(lastPTZ_Pose);
+  }
+}
 
-  switch (lastPTZ_Pose) {
-    case 1:
-      if (PTZ_Cam == PTZ_ID) {
-
-        P1_T = (stepper1->getCurrentPosition());
-        P1_P = (stepper2->getCurrentPosition());
-        P1_F = (stepper3->getCurrentPosition());
-        P1_Z = (stepper4->getCurrentPosition());
+//Pose n lives in memory namespace "Pnpos" with one key per axis, P1_T, P1_P...
+void StorePose(int pose) {
+  char name[12];
+  snprintf(name, sizeof(name), "P%dpos", pose);
+  SysMemory.begin(name, false);                                  //save to memory
+  for (int i = 0; i < HEAD_AXES; i++) {
+    snprintf(name, sizeof(name), "P%d_%c", pose, HeadAxes[i].key);
+    SysMemory.putUInt(name, Pose[pose - 1][i]);
+  }
+  SysMemory.end();
+}
 
-        SysMemory.begin("P1pos", false);                         //save to memory
-        SysMemory.putUInt("P1_T", P1_T);
-        SysMemory.putUInt("P1_P", P1_P);
-        SysMemory.putUInt("P1_F", P1_F);
-        SysMemory.putUInt("P1_Z", P1_Z);
-        SysMemory.end();
-      }
-      break;
-    case 2:
-      if (PTZ_Cam == PTZ_ID) {
-        P2_T = (stepper1->getCurrentPosition());
-        P2_P = (stepper2->getCurrentPosition());
-        P2_F = (stepper3->getCurrentPosition());
-        P2_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P2pos", false);                         //save to memory
-        SysMemory.putUInt("P2_T", P2_T);
-        SysMemory.putUInt("P2_P", P2_P);
-        SysMemory.putUInt("P2_F", P2_F);
-        SysMemory.putUInt("P2_Z", P2_Z);
-        SysMemory.end();
-      }
-      break;
-    case 3:
-      if (PTZ_Cam == PTZ_ID) {
-        P3_T = (stepper1->getCurrentPosition());
-        P3_P = (stepper2->getCurrentPosition());
-        P3_F = (stepper3->getCurrentPosition());
-        P3_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P3pos", false);                         //save to memory
-        SysMemory.putUInt("P3_T", P3_T);
-        SysMemory.putUInt("P3_P", P3_P);
-        SysMemory.putUInt("P3_F", P3_F);
-        SysMemory.putUInt("P3_Z", P3_Z);
-        SysMemory.end();
-      }
-      break;
-    case 4:
-      if (PTZ_Cam == PTZ_ID) {
-        P4_T = (stepper1->getCurrentPosition());
-        P4_P = (stepper2->getCurrentPosition());
-        P4_F = (stepper3->getCurrentPosition());
-        P4_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P4pos", false);                         //save to memory
-        SysMemory.putUInt("P4_T", P4_T);
-        SysMemory.putUInt("P4_P", P4_P);
-        SysMemory.putUInt("P4_F", P4_F);
-        SysMemory.putUInt("P4_Z", P4_Z);
-        SysMemory.end();
-      }
-      break;
-    case 5:
-      if (PTZ_Cam == PTZ_ID) {
-        P5_T = (stepper1->getCurrentPosition());
-        P5_P = (stepper2->getCurrentPosition());
-        P5_F = (stepper3->getCurrentPosition());
-        P5_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P5pos", false);                         //save to memory
-        SysMemory.putUInt("P5_T", P5_T);
-        SysMemory.putUInt("P5_P", P5_P);
-        SysMemory.putUInt("P5_F", P5_F);
-        SysMemory.putUInt("P5_Z", P5_Z);
-        SysMemory.end();
-      }
-      break;
-    case 6:
-      if (PTZ_Cam == PTZ_ID) {
-        P6_T = (stepper1->getCurrentPosition());
-        P6_P = (stepper2->getCurrentPosition());
-        P6_F = (stepper3->getCurrentPosition());
-        P6_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P6pos", false);                         //save to memory
-        SysMemory.putUInt("P6_T", P6_T);
-        SysMemory.putUInt("P6_P", P6_P);
-        SysMemory.putUInt("P6_F", P6_F);
-        SysMemory.putUInt("P6_Z", P6_Z);
-        SysMemory.end();
-      }
-      break;
-    case 7:
-      if (PTZ_Cam == PTZ_ID) {
-        P7_T = (stepper1->getCurrentPosition());
-        P7_P = (stepper2->getCurrentPosition());
-        P7_F = (stepper3->getCurrentPosition());
-        P7_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P7pos", false);                         //save to memory
-        SysMemory.putUInt("P7_T", P7_T);
-        SysMemory.putUInt("P7_P", P7_P);
-        SysMemory.putUInt("P7_F", P7_F);
-        SysMemory.putUInt("P7_Z", P7_Z);
-        SysMemory.end();
-      }
-      break;
-    case 8:
-      if (PTZ_Cam == PTZ_ID) {
-        P8_T = (stepper1->getCurrentPosition());
-        P8_P = (stepper2->getCurrentPosition());
-        P8_F = (stepper3->getCurrentPosition());
-        P8_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P8pos", false);                         //save to memory
-        SysMemory.putUInt("P8_T", P8_T);
-        SysMemory.putUInt("P8_P", P8_P);
-        SysMemory.putUInt("P8_F", P8_F);
-        SysMemory.putUInt("P8_Z", P8_Z);
-        SysMemory.end();
-      }
-      break;
-    case 9:
-      if (PTZ_Cam == PTZ_ID) {
-        P9_T = (stepper1->getCurrentPosition());
-        P9_P = (stepper2->getCurrentPosition());
-        P9_F = (stepper3->getCurrentPosition());
-        P9_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P9pos", false);                         //save to memory
-        SysMemory.putUInt("P9_T", P9_T);
-        SysMemory.putUInt("P9_P", P9_P);
-        SysMemory.putUInt("P9_F", P9_F);
-        SysMemory.putUInt("P9_Z", P9_Z);
-        SysMemory.end();
-      }
-      break;
-    case 10:
-      if (PTZ_Cam == PTZ_ID) {
-        P10_T = (stepper1->getCurrentPosition());
-        P10_P = (stepper2->getCurrentPosition());
-        P10_F = (stepper3->getCurrentPosition());
-        P10_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P10pos", false);                         //save to memory
-        SysMemory.putUInt("P10_T", P10_T);
-        SysMemory.putUInt("P10_P", P10_P);
-        SysMemory.putUInt("P10_F", P10_F);
-        SysMemory.putUInt("P10_Z", P10_Z);
-        SysMemory.end();
-      }
-      break;
-    case 11:
-      if (PTZ_Cam == PTZ_ID) {
-        P11_T = (stepper1->getCurrentPosition());
-        P11_P = (stepper2->getCurrentPosition());
-        P11_F = (stepper3->getCurrentPosition());
-        P11_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P11pos", false);                         //save to memory
-        SysMemory.putUInt("P11_T", P11_T);
-        SysMemory.putUInt("P11_P", P11_P);
-        SysMemory.putUInt("P11_F", P11_F);
-        SysMemory.putUInt("P11_Z", P11_Z);
-        SysMemory.end();
-      }
-      break;
-    case 12:
-      if (PTZ_Cam == PTZ_ID) {
-        P12_T = (stepper1->getCurrentPosition());
-        P12_P = (stepper2->getCurrentPosition());
-        P12_F = (stepper3->getCurrentPosition());
-        P12_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P12pos", false);                         //save to memory
-        SysMemory.putUInt("P12_T", P12_T);
-        SysMemory.putUInt("P12_P", P12_P);
-        SysMemory.putUInt("P12_F", P12_F);
-        SysMemory.putUInt("P12_Z", P12_Z);
-        SysMemory.end();
-      }
-      break;
-    case 13:
-      if (PTZ_Cam == PTZ_ID) {
-        P13_T = (stepper1->getCurrentPosition());
-        P13_P = (stepper2->getCurrentPosition());
-        P13_F = (stepper3->getCurrentPosition());
-        P13_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P13pos", false);                         //save to memory
-        SysMemory.putUInt("P13_T", P13_T);
-        SysMemory.putUInt("P13_P", P13_P);
-        SysMemory.putUInt("P13_F", P13_F);
-        SysMemory.putUInt("P13_Z", P13_Z);
-        SysMemory.end();
-      }
-      break;
-    case 14:
-      if (PTZ_Cam == PTZ_ID) {
-        P14_T = (stepper1->getCurrentPosition());
-        P14_P = (stepper2->getCurrentPosition());
-        P14_F = (stepper3->getCurrentPosition());
-        P14_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P14pos", false);                         //save to memory
-        SysMemory.putUInt("P14_T", P14_T);
-        SysMemory.putUInt("P14_P", P14_P);
-        SysMemory.putUInt("P14_F", P14_F);
-        SysMemory.putUInt("P14_Z", P14_Z);
-        SysMemory.end();
-      }
-      break;
-    case 15:
-      if (PTZ_Cam == PTZ_ID) {
-        P15_T = (stepper1->getCurrentPosition());
-        P15_P = (stepper2->getCurrentPosition());
-        P15_F = (stepper3->getCurrentPosition());
-        P15_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P15pos", false);                         //save to memory
-        SysMemory.putUInt("P15_T", P15_T);
-        SysMemory.putUInt("P15_P", P15_P);
-        SysMemory.putUInt("P15_F", P15_F);
-        SysMemory.putUInt("P15_Z", P15_Z);
-        SysMemory.end();
-      }
-      break;
-    case 16:
-      if (PTZ_Cam == PTZ_ID) {
-        P16_T = (stepper1->getCurrentPosition());
-        P16_P = (stepper2->getCurrentPosition());
-        P16_F = (stepper3->getCurrentPosition());
-        P16_Z = (stepper4->getCurrentPosition());
-
-        SysMemory.begin("P16pos", false);                         //save to memory
-        SysMemory.putUInt("P16_T", P16_T);
-        SysMemory.putUInt("P16_P", P16_P);
-        SysMemory.putUInt("P16_F", P16_F);
-        SysMemory.putUInt("P16_Z", P16_Z);
-        SysMemory.end();
-      }
-      break;
+void RecoverPose(int pose) {
+  char name[12];
+  bool missing = false;
+  snprintf(name, sizeof(name), "P%dpos", pose);
+  SysMemory.begin(name, false);
+  for (int i = 0; i < HEAD_AXES; i++) {
+    snprintf(name, sizeof(name), "P%d_%c", pose, HeadAxes[i].key);
+    missing |= !SysMemory.isKey(name);
+    Pose[pose - 1][i] = SysMemory.getUInt(name, 10);
+  }
+  SysMemory.end();
+  if (missing) {                                                 //Older firmware cleared the poses into "Pn_pos", use what is there
+    snprintf(name, sizeof(name), "P%d_pos", pose);
+    SysMemory.begin(name, true);
+    for (int i = 0; i < HEAD_AXES; i++) {
+      snprintf(name, sizeof(name), "P%d_%c", pose, HeadAxes[i].key);
+      Pose[pose - 1][i] = SysMemory.getUInt(name, Pose[pose - 1][i]);
+    }
+    SysMemory.end();
   }
 }
 
@@ -1957,20 +1670,20 @@ void k1set() {
       if (stepper1->getCurrentPosition() != (Tlt_k1_position) || stepper2->getCurrentPosition() != (Pan_k1_position) || stepper3->getCurrentPosition() != (Foc_k1_position) || stepper4->getCurrentPosition() != Zoo_k1_position) { //Run to  position
         if (Tlt_k1_position == 0 && Pan_k1_position == 0 && Foc_k1_position == 0 && Zoo_k1_position == 0) {                                 //Do not move
         } else {
-          stepper1->setSpeedInUs(200);
-          stepper1->setAcceleration(3000);
+          stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, 200));
+          stepper1->setAcceleration(limits.accel(AXIS_TILT, 3000));
           stepper1->moveTo(Tlt_k1_position);
           delay(10);
-          stepper2->setSpeedInUs(200);
-          stepper2->setAcceleration(3000);
+          stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, 200));
+          stepper2->setAcceleration(limits.accel(AXIS_PAN, 3000));
           stepper2->moveTo(Pan_k1_position);
           delay(10);
-          stepper3->setSpeedInUs(50);
-          stepper3->setAcceleration(2000);
+          stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, 50));
+          stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 2000));
           stepper3->moveTo(Foc_k1_position);
           delay(10);
-          stepper4->setSpeedInUs(50);
-          stepper4->setAcceleration(2000);
+          stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, 50));
+          stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 2000));
           stepper4->moveTo(Zoo_k1_position);
 
           while (stepper1->isRunning() || stepper2->isRunning() || stepper3->isRunning() || stepper4->isRunning()) {                      //delay until move complete
@@ -2026,20 +1739,20 @@ void k2set() {
         if (Tlt_k2_position == 0 && Pan_k2_position == 0 && Foc_k2_position == 0 && Zoo_k2_position == 0) {                                 //Do not move
         } else {
 
-          stepper1->setSpeedInUs(200);
-          stepper1->setAcceleration(3000);
+          stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, 200));
+          stepper1->setAcceleration(limits.accel(AXIS_TILT, 3000));
           stepper1->moveTo(Tlt_k2_position);
           delay(10);
-          stepper2->setSpeedInUs(200);
-          stepper2->setAcceleration(3000);
+          stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, 200));
+          stepper2->setAcceleration(limits.accel(AXIS_PAN, 3000));
           stepper2->moveTo(Pan_k2_position);
           delay(10);
-          stepper3->setSpeedInUs(50);
-          stepper3->setAcceleration(2000);
+          stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, 50));
+          stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 2000));
           stepper3->moveTo(Foc_k2_position);
           delay(10);
-          stepper4->setSpeedInUs(50);
-          stepper4->setAcceleration(2000);
+          stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, 50));
+          stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 2000));
           stepper4->moveTo(Zoo_k2_position);
 
           while (stepper1->isRunning() || stepper2->isRunning() || stepper3->isRunning() || stepper4->isRunning()) {                     //delay until move complete
@@ -2093,20 +1806,20 @@ void k3set() {
       if (stepper1->getCurrentPosition() != (Tlt_k3_position) || stepper2->getCurrentPosition() != (Pan_k3_position) || stepper3->getCurrentPosition() != (Foc_k3_position) || stepper4->getCurrentPosition() != (Zoo_k3_position)) { //Run to  position
         if (Tlt_k3_position == 0 && Pan_k3_position == 0 && Foc_k3_position == 0 && Zoo_k3_position == 0) { //Do not move
         } else {
-          stepper1->setSpeedInUs(200);
-          stepper1->setAcceleration(3000);
+          stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, 200));
+          stepper1->setAcceleration(limits.accel(AXIS_TILT, 3000));
           stepper1->moveTo(Tlt_k3_position);
           delay(10);
-          stepper2->setSpeedInUs(200);
-          stepper2->setAcceleration(3000);
+          stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, 200));
+          stepper2->setAcceleration(limits.accel(AXIS_PAN, 3000));
           stepper2->moveTo(Pan_k3_position);
           delay(10);
-          stepper3->setSpeedInUs(50);
-          stepper3->setAcceleration(2000);
+          stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, 50));
+          stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 2000));
           stepper3->moveTo(Foc_k3_position);
           delay(10);
-          stepper4->setSpeedInUs(50);
-          stepper4->setAcceleration(2000);
+          stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, 50));
+          stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 2000));
           stepper4->moveTo(Zoo_k3_position);
 
 
@@ -2162,20 +1875,20 @@ void k4set() {
       if (stepper1->getCurrentPosition() != (Tlt_k4_position) || stepper2->getCurrentPosition() != (Pan_k4_position) || stepper3->getCurrentPosition() != (Foc_k4_position) || stepper4->getCurrentPosition() != (Zoo_k4_position)) {
         if (Tlt_k4_position == 0 && Pan_k4_position == 0 && Foc_k4_position == 0 && Zoo_k4_position == 0) {           //Do not move
         } else {                                                                               //Run to  position
-          stepper1->setSpeedInUs(200);
-          stepper1->setAcceleration(3000);
+          stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, 200));
+          stepper1->setAcceleration(limits.accel(AXIS_TILT, 3000));
           stepper1->moveTo(Tlt_k4_position);
           delay(10);
-          stepper2->setSpeedInUs(200);
-          stepper2->setAcceleration(3000);
+          stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, 200));
+          stepper2->setAcceleration(limits.accel(AXIS_PAN, 3000));
           stepper2->moveTo(Pan_k4_position);
           delay(10);
-          stepper3->setSpeedInUs(50);
-          stepper3->setAcceleration(2000);
+          stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, 50));
+          stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 2000));
           stepper3->moveTo(Foc_k4_position);
           delay(10);
-          stepper4->setSpeedInUs(50);
-          stepper4->setAcceleration(2000);
+          stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, 50));
+          stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 2000));
           stepper4->moveTo(Zoo_k4_position);
 
           while (stepper1->isRunning() || stepper2->isRunning() || stepper3->isRunning() || stepper4->isRunning()) {                     //delay until move complete
@@ -2231,20 +1944,20 @@ void k5set() {
       if (stepper1->getCurrentPosition() != (Tlt_k5_position) || stepper2->getCurrentPosition() != (Pan_k5_position) || stepper3->getCurrentPosition() != (Foc_k5_position) || stepper4->getCurrentPosition() != (Zoo_k5_position)) {
         if (Tlt_k5_position == 0 && Pan_k5_position == 0 && Foc_k5_position == 0 && Zoo_k5_position == 0) {           //Do not move
         } else {                                                                               //Run to  position
-          stepper1->setSpeedInUs(200);
-          stepper1->setAcceleration(3000);
+          stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, 200));
+          stepper1->setAcceleration(limits.accel(AXIS_TILT, 3000));
           stepper1->moveTo(Tlt_k5_position);
           delay(10);
-          stepper2->setSpeedInUs(200);
-          stepper2->setAcceleration(3000);
+          stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, 200));
+          stepper2->setAcceleration(limits.accel(AXIS_PAN, 3000));
           stepper2->moveTo(Pan_k5_position);
           delay(10);
-          stepper3->setSpeedInUs(50);
-          stepper3->setAcceleration(2000);
+          stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, 50));
+          stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 2000));
           stepper3->moveTo(Foc_k5_position);
           delay(10);
-          stepper4->setSpeedInUs(50);
-          stepper4->setAcceleration(2000);
+          stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, 50));
+          stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 2000));
           stepper4->moveTo(Zoo_k5_position);
 
           while (stepper1->isRunning() || stepper2->isRunning() || stepper3->isRunning() || stepper4->isRunning()) {                      //delay until move complete
@@ -2302,20 +2015,20 @@ void k6set() {
       if (stepper1->getCurrentPosition() != (Tlt_k6_position) || stepper2->getCurrentPosition() != (Pan_k6_position) || stepper3->getCurrentPosition() != (Foc_k6_position) || stepper4->getCurrentPosition() != (Zoo_k6_position)) {
         if (Tlt_k6_position == 0 && Pan_k6_position == 0 && Foc_k6_position == 0 && Zoo_k6_position == 0) {           //Do not move
         } else {                                                                                //Run to  position
-          stepper1->setSpeedInUs(200);
-          stepper1->setAcceleration(3000);
+          stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, 200));
+          stepper1->setAcceleration(limits.accel(AXIS_TILT, 3000));
           stepper1->moveTo(Tlt_k6_position);
           delay(10);
-          stepper2->setSpeedInUs(200);
-          stepper2->setAcceleration(3000);
+          stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, 200));
+          stepper2->setAcceleration(limits.accel(AXIS_PAN, 3000));
           stepper2->moveTo(Pan_k6_position);
           delay(10);
-          stepper3->setSpeedInUs(50);
-          stepper3->setAcceleration(2000);
+          stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, 50));
+          stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 2000));
           stepper3->moveTo(Foc_k6_position);
           delay(10);
-          stepper4->setSpeedInUs(50);
-          stepper4->setAcceleration(2000);
+          stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, 50));
+          stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 2000));
           stepper4->moveTo(Zoo_k6_position);
 
           while (stepper1->isRunning() || stepper2->isRunning() || stepper3->isRunning() || stepper4->isRunning()) {                      //delay until move complete
@@ -2370,6 +2083,25 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData,  int L
   char buffer[ESP_NOW_MAX_DATA_LEN + 1];
   // int msgLen = min(ESP_NOW_MAX_DATA_LEN, dataLen);
 
+  if (lock.receive(incomingData, Len)) {       //Slider position for the target lock
+    return;
+  }
+
+  int tag = sizeof(ESPNOW_VISCA_TAG) - 1;
+  if (Len > tag && memcmp(incomingData, ESPNOW_VISCA_TAG, tag) == 0) {
+    int n = Len - tag < numChars - 1 ? Len - tag : numChars - 1;
+    portENTER_CRITICAL(&espnowViscaLock);
+    if (espnowViscaCount < ESPNOW_VISCA_LINES) {
+      char* line = espnowVisca[(espnowViscaHead + espnowViscaCount) % ESPNOW_VISCA_LINES];
+      memcpy(line, incomingData + tag, n);
+      line[n] = '\0';
+      line[strcspn(line, "\n")] = '\0';
+      espnowViscaCount++;
+    }
+    portEXIT_CRITICAL(&espnowViscaLock);
+    return;
+  }
+
   memcpy(&incomingValues, incomingData, sizeof(incomingValues));
   //memcpy(&incomingValues, Data, sizeof(incomingValues));
 
@@ -2435,12 +2167,14 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData,  int L
   switch (Snd) {                                //Only Change the Device state if the message was sent by the device
     case 2:
       Sld = int(incomingValues.Sld);            //Slider available 1 or 0
+      lock.heard(LOCK_SLIDER, macAddr);         //Where to ask for the position stream
       break;
     case 4:
       TT = int(incomingValues.TT);               //Turntable available 1 or 0
       break;
     case 5:
       JB = int(incomingValues.JB);                 //Jib available 1 or 0
+      lock.heard(LOCK_JIB, macAddr);
       break;
   }
 
@@ -2458,17 +2192,18 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData,  int L
   But_Com = int(incomingValues.But);           //playbutton pressed on Slave
   InP = int(incomingValues.InP);               //Inpoint button state 0-2
   OutP = int(incomingValues.OutP);             //Outpoint button state 0-2
-  Joy_Pan_Speed = int(incomingValues.Ps);      //Joystick Pan PTZ Controler speed
+  Joy_Pan_Speed = toCommand(int(incomingValues.Ps), ESPNOW_PAN_FULL, PAN_COMMAND_FULL);      //Joystick Pan PTZ Controler speed
   Joy_Pan_Accel = int(incomingValues.Ma) / 10 ; //Joystick Pan PTZ Controler Acceloration
 
-  Joy_Tilt_Speed = int(incomingValues.Ts);      //Joystick Pan PTZ Controler speed
+  Joy_Tilt_Speed = toCommand(int(incomingValues.Ts), ESPNOW_STICK_FULL, TILT_COMMAND_FULL);      //Joystick Pan PTZ Controler speed
   Joy_Tilt_Accel = int(incomingValues.Ma);      //Joystick Pan PTZ Controler Acceloration
 
-  Joy_Focus_Speed = int(incomingValues.Fs);      //Joystick Pan PTZ Controler speed
+  Joy_Focus_Speed = toCommand(int(incomingValues.Fs), ESPNOW_STICK_FULL, LENS_COMMAND_FULL);      //Joystick Pan PTZ Controler speed
   Joy_Focus_Accel = int(incomingValues.Ma);      //Joystick Pan PTZ Controler Acceloration
 
-  Joy_Zoo_Speed = int(incomingValues.Zs);      //Joystick Pan PTZ Controler speed
+  Joy_Zoo_Speed = toCommand(int(incomingValues.Zs), ESPNOW_STICK_FULL, LENS_COMMAND_FULL);      //Joystick Pan PTZ Controler speed
   Joy_Zoo_Accel = int(incomingValues.Ma);      //Joystick Pan PTZ Controler Acceloration
+  Joy_From_Controller = true;
 
   PTZ_ID_Nex = int(incomingValues.ID);           //PTZ messagefor ID
   PTZ_Cam = int(incomingValues.CA);              //Current PTZ camera
@@ -2650,14 +2385,14 @@ void Start_1() {
   digitalWrite(StepD, LOW);
   delay(100);
 
-  stepper1->setSpeedInHz(2000);
-  stepper1->setAcceleration(1500);
-  stepper2->setSpeedInUs(2500);
-  stepper2->setAcceleration(1000);
-  stepper3->setSpeedInUs(50);
-  stepper3->setAcceleration(2000);
-  stepper4->setSpeedInUs(50);
-  stepper4->setAcceleration(2000);
+  stepper1->setSpeedInHz(limits.speed(AXIS_TILT, 2000));
+  stepper1->setAcceleration(limits.accel(AXIS_TILT, 1500));
+  stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, 2500));
+  stepper2->setAcceleration(limits.accel(AXIS_PAN, 1000));
+  stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, 50));
+  stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 2000));
+  stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, 50));
+  stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 2000));
   if (SEQ == 0) {
     //logger.print("Stepper1 In before move =: ");
     //logger.println(TLTin_position);
@@ -2713,14 +2448,14 @@ void Start_2() {
   But_Com = 0;
   PT = 1;
 
-  stepper1->setSpeedInHz(TLTstep_speed);                           //Setup speed and acceloration values
-  stepper1->setAcceleration(TLTease_Value);
-  stepper2->setSpeedInHz(PANstep_speed);
-  stepper2->setAcceleration(PANease_Value);
-  stepper3->setSpeedInHz(FOCstep_speed);
-  stepper3->setAcceleration(FOCease_Value);
-  stepper4->setSpeedInHz(ZOOMstep_speed);
-  stepper4->setAcceleration(ZOOMease_Value);
+  stepper1->setSpeedInHz(limits.speed(AXIS_TILT, TLTstep_speed));                           //Setup speed and acceloration values
+  stepper1->setAcceleration(limits.accel(AXIS_TILT, TLTease_Value));
+  stepper2->setSpeedInHz(limits.speed(AXIS_PAN, PANstep_speed));
+  stepper2->setAcceleration(limits.accel(AXIS_PAN, PANease_Value));
+  stepper3->setSpeedInHz(limits.speed(AXIS_FOCUS, FOCstep_speed));
+  stepper3->setAcceleration(limits.accel(AXIS_FOCUS, FOCease_Value));
+  stepper4->setSpeedInHz(limits.speed(AXIS_ZOOM, ZOOMstep_speed));
+  stepper4->setAcceleration(limits.accel(AXIS_ZOOM, ZOOMease_Value));
 
   if (TLTtravel_dist != 0) {
     stepper1->moveTo(TLTout_position);                               //Move the steppers
@@ -2777,9 +2512,7 @@ void Start_2() {
     } else {
       delay(BD);
       if (PTZ_ID == 5) {
-        digitalWrite(CAM, HIGH);                              //Stop camera
-        delay (200);
-        digitalWrite(CAM, LOW);
+        shutter.pulse(REC_PULSE_MS);                          //Stop camera
         TurnOffTallyLight();        
         But_Com = 5;                                          //Tell the nextion to stop the timer
         PT = 1;
@@ -2792,9 +2525,7 @@ void Start_2() {
   } else  {
     delay(BD);
     if (PTZ_ID == 5) {
-      digitalWrite(CAM, HIGH);                                 //Stop camera
-      delay (200);
-      digitalWrite(CAM, LOW);
+      shutter.pulse(REC_PULSE_MS);                             //Stop camera
       TurnOffTallyLight();
       But_Com = 5;                                             //Tell the nextion to stop the timer
       PT = 1;
@@ -2836,14 +2567,14 @@ void Start_4() {
     //**********If Jib  is conected give slider or jib  control over timing**********
     if (JB > 0 ) {
       JB = 1;
-      stepper1->setSpeedInHz(300);
-      stepper1->setAcceleration(500);
-      stepper2->setSpeedInHz(300);
-      stepper2->setAcceleration(500);
-      stepper3->setSpeedInHz(600);
-      stepper3->setAcceleration(800);
-      stepper4->setSpeedInHz(600);
-      stepper4->setAcceleration(800);
+      stepper1->setSpeedInHz(limits.speed(AXIS_TILT, 300));
+      stepper1->setAcceleration(limits.accel(AXIS_TILT, 500));
+      stepper2->setSpeedInHz(limits.speed(AXIS_PAN, 300));
+      stepper2->setAcceleration(limits.accel(AXIS_PAN, 500));
+      stepper3->setSpeedInHz(limits.speed(AXIS_FOCUS, 600));
+      stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 800));
+      stepper4->setSpeedInHz(limits.speed(AXIS_ZOOM, 600));
+      stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 800));
 
       stepper1->moveTo(stepper1->getCurrentPosition() + TLTTlps_step_dist);    //Current position plus one fps move
       delay(5);
@@ -2862,12 +2593,11 @@ void Start_4() {
       }
 
       delay(1000);
-      digitalWrite(CAM, HIGH);                                               //Fire shutter
       if (TpsD <= 1000) {
         TpsD = 1000;
       }                                                          //Time the shutter is open for
-      delay(TpsD);
-      digitalWrite(CAM, LOW);                                                //Cose the shutter and move on
+      shutter.pulse(TpsD);                                                   //Fire shutter for TpsD, the timer closes it
+      shutter.wait();                                                        //Hold still until it is closed, then move on
 
       if (Tps != 0) {
         Tps = Tps - 1;
@@ -2880,14 +2610,14 @@ void Start_4() {
     //**********If Slider is conected give slider control over timing**********
     if (Sld > 0 ) {                                                             //If Slider or Jib  is conected give slider or jib  control over timing
       Sld = 1;
-      stepper1->setSpeedInHz(300);
-      stepper1->setAcceleration(500);
-      stepper2->setSpeedInHz(300);
-      stepper2->setAcceleration(500);
-      stepper3->setSpeedInHz(600);
-      stepper3->setAcceleration(1000);
-      stepper4->setSpeedInHz(600);
-      stepper4->setAcceleration(1000);
+      stepper1->setSpeedInHz(limits.speed(AXIS_TILT, 300));
+      stepper1->setAcceleration(limits.accel(AXIS_TILT, 500));
+      stepper2->setSpeedInHz(limits.speed(AXIS_PAN, 300));
+      stepper2->setAcceleration(limits.accel(AXIS_PAN, 500));
+      stepper3->setSpeedInHz(limits.speed(AXIS_FOCUS, 600));
+      stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 1000));
+      stepper4->setSpeedInHz(limits.speed(AXIS_ZOOM, 600));
+      stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 1000));
 
       stepper1->moveTo(stepper1->getCurrentPosition() + TLTTlps_step_dist);    //Current position plus one fps move
       delay(5);
@@ -2905,12 +2635,11 @@ void Start_4() {
       Sld = 1;
 
       delay(1000);
-      digitalWrite(CAM, HIGH);                                                 //Fire shutter
       if (TpsD <= 1000) {
         TpsD = 1000;
       }                                                                       //Time the shutter is open for
-      delay(TpsD);
-      digitalWrite(CAM, LOW);                                                 //Cose the shutter and move on
+      shutter.pulse(TpsD);                                                     //Fire shutter for TpsD, the timer closes it
+      shutter.wait();                                                          //Hold still until it is closed, then move on
 
       if (Tps != 0) {
         Tps = Tps - 1;
@@ -2927,14 +2656,14 @@ void Start_4() {
       //logger.println("Tlps Trigger from PT");
       //Trigger pantilt head timelapse move
       SendNextionValues();                                                      //Trigger pantilt head timelapse move
-      stepper1->setSpeedInHz(300);
-      stepper1->setAcceleration(500);
-      stepper2->setSpeedInHz(300);
-      stepper2->setAcceleration(500);
-      stepper3->setSpeedInUs(600);
-      stepper3->setAcceleration(800);
-      stepper4->setSpeedInUs(600);
-      stepper4->setAcceleration(800);
+      stepper1->setSpeedInHz(limits.speed(AXIS_TILT, 300));
+      stepper1->setAcceleration(limits.accel(AXIS_TILT, 500));
+      stepper2->setSpeedInHz(limits.speed(AXIS_PAN, 300));
+      stepper2->setAcceleration(limits.accel(AXIS_PAN, 500));
+      stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, 600));
+      stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 800));
+      stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, 600));
+      stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 800));
 
       stepper1->moveTo(stepper1->getCurrentPosition() + TLTTlps_step_dist);     //Current position plus one fps move
       delay(10);
@@ -2957,12 +2686,11 @@ void Start_4() {
       SendNextionValues();
       delay(1000);                                                   //Take a second to ensure camera is still
 
-      digitalWrite(CAM, HIGH);                                                  //Fire shutter
       if (TpsD <= 1000) {
         TpsD = 1000;
       }
-      delay(TpsD);                                                            //Time the shutter is open for
-      digitalWrite(CAM, LOW);                                                   //Cose the shutter and move on
+      shutter.pulse(TpsD);                                                      //Fire shutter for TpsD, the timer closes it
+      shutter.wait();                                                           //Hold still until it is closed, then move on
       delay (500);
       PT = 1;
       SendNextionValues();
@@ -3013,17 +2741,17 @@ void Start_7() {
   FOCstep_speed = (FOCtravel_dist / 5);
   ZOOMstep_speed = (ZOOMtravel_dist / 5);
 
-  stepper1->setSpeedInUs(500);
-  stepper1->setAcceleration(500);
+  stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, 500));
+  stepper1->setAcceleration(limits.accel(AXIS_TILT, 500));
 
-  stepper2->setSpeedInUs(500);
-  stepper2->setAcceleration(500);
+  stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, 500));
+  stepper2->setAcceleration(limits.accel(AXIS_PAN, 500));
 
-  stepper3->setSpeedInUs(500);
-  stepper3->setAcceleration(500);
+  stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, 500));
+  stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 500));
 
-  stepper4->setSpeedInUs(500);
-  stepper4->setAcceleration(500);
+  stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, 500));
+  stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 500));
 
   if (SMC >= 0  && stopM_cancel != 1) {                                           //Run the steppers
 
@@ -3040,12 +2768,11 @@ void Start_7() {
       delay(10);
     }
     delay (1000);                                                                     //Take a second to ensure camera is still
-    digitalWrite(CAM, HIGH);                                                          //Fire shutter
     if (TpsD <= 1000) {
       TpsD = 1000;
     }                                                                                 //Time the shutter is open for if on ball. If not on ball camera has control of shutter time and user must set this higher than shutter speed
-    delay(TpsD);
-    digitalWrite(CAM, LOW);                                                           //Cose the shutter and move on
+    shutter.pulse(TpsD);                                                              //Fire shutter for TpsD, the timer closes it
+    shutter.wait();                                                                   //Hold still until it is closed, then move on
 
     if (Sld == 0 && JB == 0) {
       But_Com = 5;
@@ -3485,8 +3212,8 @@ void  Start_5() {
           break;
       }
 
-      stepper2->setAcceleration(k1A);
-      stepper2->setSpeedInUs(s1_speed);
+      stepper2->setAcceleration(limits.accel(AXIS_PAN, k1A));
+      stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s1_speed));
 
 
       switch (Pan_move1_Dest) {                                                                     //Pick up how far the motor should move before it either stopes or changes direction
@@ -3495,22 +3222,22 @@ void  Start_5() {
           break;
         case 3:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper2->setSpeedInUs(s1_speed);
+          stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s1_speed));
           stepper2->moveTo(Pan_k3_position);
           break;
         case 4:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper2->setSpeedInUs(s1_speed);
+          stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s1_speed));
           stepper2->moveTo(Pan_k4_position);
           break;
         case 5:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper2->setSpeedInUs(s1_speed);
+          stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s1_speed));
           stepper2->moveTo(Pan_k5_position);
           break;
         case 6:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper2->setSpeedInUs(s1_speed);
+          stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s1_speed));
           stepper2->moveTo(Pan_k6_position);
           break;
       }
@@ -3555,8 +3282,8 @@ void  Start_5() {
           break;
       }
 
-      stepper1->setAcceleration(k1A);
-      stepper1->setSpeedInUs(s1_speed);
+      stepper1->setAcceleration(limits.accel(AXIS_TILT, k1A));
+      stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s1_speed));
 
 
       switch (Tlt_move1_Dest) {                                                      //Pick up how far the motor should move before it either stopes or changes direction
@@ -3565,22 +3292,22 @@ void  Start_5() {
           break;
         case 3:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper1->setSpeedInUs(s1_speed);
+          stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s1_speed));
           stepper1->moveTo(Tlt_k3_position);
           break;
         case 4:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper1->setSpeedInUs(s1_speed);
+          stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s1_speed));
           stepper1->moveTo(Tlt_k4_position);
           break;
         case 5:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper1->setSpeedInUs(s1_speed);
+          stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s1_speed));
           stepper1->moveTo(Tlt_k5_position);
           break;
         case 6:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper1->setSpeedInUs(s1_speed);
+          stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s1_speed));
           stepper1->moveTo(Tlt_k6_position);
           break;
       }
@@ -3626,8 +3353,8 @@ void  Start_5() {
           break;
       }
 
-      stepper3->setAcceleration(k1A);
-      stepper3->setSpeedInUs(s1_speed);
+      stepper3->setAcceleration(limits.accel(AXIS_FOCUS, k1A));
+      stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s1_speed));
       Base_Foc_accel =  k1A;
       Last_Foc_accel = k1A;
       Last_Foc_speed = s1_speed;
@@ -3638,22 +3365,22 @@ void  Start_5() {
           break;
         case 3:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper3->setSpeedInUs(s1_speed);
+          stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s1_speed));
           stepper3->moveTo(Foc_k3_position);
           break;
         case 4:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper3->setSpeedInUs(s1_speed);
+          stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s1_speed));
           stepper3->moveTo(Foc_k4_position);
           break;
         case 5:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper3->setSpeedInUs(s1_speed);
+          stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s1_speed));
           stepper3->moveTo(Foc_k5_position);
           break;
         case 6:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper3->setSpeedInUs(s1_speed);
+          stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s1_speed));
           stepper3->moveTo(Foc_k6_position);
           break;
       }
@@ -3696,8 +3423,8 @@ void  Start_5() {
           break;
       }
 
-      stepper4->setAcceleration(k1A);
-      stepper4->setSpeedInUs(s1_speed);
+      stepper4->setAcceleration(limits.accel(AXIS_ZOOM, k1A));
+      stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s1_speed));
       Base_Zoo_accel =  k1A;
       Last_Zoo_accel = k1A;
       Last_Zoo_speed = s1_speed;
@@ -3708,22 +3435,22 @@ void  Start_5() {
           break;
         case 3:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper4->setSpeedInUs(s1_speed);
+          stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s1_speed));
           stepper4->moveTo(Zoo_k3_position);
           break;
         case 4:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper4->setSpeedInUs(s1_speed);
+          stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s1_speed));
           stepper4->moveTo(Zoo_k4_position);
           break;
         case 5:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper4->setSpeedInUs(s1_speed);
+          stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s1_speed));
           stepper4->moveTo(Zoo_k5_position);
           break;
         case 6:
           s1_speed = s1_speed + ((s1_speed / 100) * 8);
-          stepper4->setSpeedInUs(s1_speed);
+          stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s1_speed));
           stepper4->moveTo(Zoo_k6_position);
           break;
       }
@@ -3874,15 +3601,15 @@ void  Start_5() {
           break;
       }
       if (stepper2->isRunning() && Pan_move1_Dest > 2 && Pan_move2_Rst != 1 ) {                                   //If the stepper is running on from last move
-        stepper2->setAcceleration(k2A);
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, k2A));
         s2_speed = s2_speed + ((s2_speed / 100) * 8);
-        stepper2->setSpeedInUs(s2_speed);
+        stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s2_speed));
         stepper2-> applySpeedAcceleration();
         delay(10);
       } else {
 
-        stepper2->setAcceleration(k2A);                                                              //If starting fresh Max accel to catch up on turnarround
-        stepper2->setSpeedInUs(s2_speed);
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, k2A));                                                              //If starting fresh Max accel to catch up on turnarround
+        stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s2_speed));
 
 
         switch (Pan_move2_Dest) {                                  //Pick up how far the motor should move before it either stopes or changes direction
@@ -3891,17 +3618,17 @@ void  Start_5() {
             break;
           case 4:
             s2_speed = s2_speed + ((s2_speed / 100) * 8);
-            stepper2->setSpeedInUs(s2_speed);
+            stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s2_speed));
             stepper2->moveTo(Pan_k4_position);
             break;
           case 5:
             s1_speed = s1_speed + ((s1_speed / 100) * 8);
-            stepper2->setSpeedInUs(s2_speed);
+            stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s2_speed));
             stepper2->moveTo(Pan_k5_position);
             break;
           case 6:
             s1_speed = s1_speed + ((s1_speed / 100) * 8);
-            stepper2->setSpeedInUs(s2_speed);
+            stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s2_speed));
             stepper2->moveTo(Pan_k6_position);
             break;
         }
@@ -3950,13 +3677,13 @@ void  Start_5() {
       }
 
       if (stepper1->isRunning() == true && Tlt_move1_Dest > 2 && Tlt_move2_Rst != 1 ) {                                   //If the stepper is running on from last move
-        stepper1->setAcceleration(k2A);
-        stepper1->setSpeedInUs(s2_speed);
+        stepper1->setAcceleration(limits.accel(AXIS_TILT, k2A));
+        stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s2_speed));
         stepper1-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper1->setAcceleration(k2A);                                                              //If starting fresh Max accel to catch up on turnarround
-        stepper1->setSpeedInUs(s2_speed);
+        stepper1->setAcceleration(limits.accel(AXIS_TILT, k2A));                                                              //If starting fresh Max accel to catch up on turnarround
+        stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s2_speed));
 
         switch (Tlt_move2_Dest) {                                  //Pick up how far the motor should move before it either stopes or changes direction
           case 3:
@@ -3964,17 +3691,17 @@ void  Start_5() {
             break;
           case 4:
             s2_speed = s2_speed + ((s2_speed / 100) * 8);
-            stepper1->setSpeedInUs(s2_speed);
+            stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s2_speed));
             stepper1->moveTo(Tlt_k4_position);
             break;
           case 5:
             s2_speed = s2_speed + ((s2_speed / 100) * 8);
-            stepper1->setSpeedInUs(s2_speed);
+            stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s2_speed));
             stepper1->moveTo(Tlt_k5_position);
             break;
           case 6:
             s2_speed = s2_speed + ((s2_speed / 100) * 8);
-            stepper1->setSpeedInUs(s2_speed);
+            stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s2_speed));
             stepper1->moveTo(Tlt_k6_position);
             break;
         }
@@ -4022,13 +3749,13 @@ void  Start_5() {
       }
 
       if (stepper3->isRunning() && Foc_move1_Dest > 2 && Foc_move2_Rst != 1 ) {                                   //If the stepper is running on from last move
-        stepper3->setAcceleration(k2A);
-        stepper3->setSpeedInUs(s2_speed);
+        stepper3->setAcceleration(limits.accel(AXIS_FOCUS, k2A));
+        stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s2_speed));
         stepper3-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper3->setAcceleration( k2A);                                                              //If starting fresh Max accel to catch up on turnarround
-        stepper3->setSpeedInUs(s2_speed);
+        stepper3->setAcceleration(limits.accel(AXIS_FOCUS, k2A));                                                              //If starting fresh Max accel to catch up on turnarround
+        stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s2_speed));
 
         switch (Foc_move2_Dest) {                                                                    //Pick up how far the motor should move before it either stopes or changes direction
           case 3:
@@ -4036,17 +3763,17 @@ void  Start_5() {
             break;
           case 4:
             s2_speed = s2_speed + ((s2_speed / 100) * 8);
-            stepper3->setSpeedInUs(s2_speed);
+            stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s2_speed));
             stepper3->moveTo(Foc_k4_position);
             break;
           case 5:
             s2_speed = s2_speed + ((s2_speed / 100) * 8);
-            stepper3->setSpeedInUs(s2_speed);
+            stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s2_speed));
             stepper3->moveTo(Foc_k5_position);
             break;
           case 6:
             s2_speed = s2_speed + ((s2_speed / 100) * 8);
-            stepper3->setSpeedInUs(s2_speed);
+            stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s2_speed));
             stepper3->moveTo(Foc_k6_position);
             break;
         }
@@ -4094,13 +3821,13 @@ void  Start_5() {
       }
 
       if (stepper3->isRunning() && Zoo_move1_Dest > 2 && Zoo_move2_Rst != 1 ) {                                   //If the stepper is running on from last move
-        stepper4->setAcceleration(k2A);
-        stepper4->setSpeedInUs(s2_speed);
+        stepper4->setAcceleration(limits.accel(AXIS_ZOOM, k2A));
+        stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s2_speed));
         stepper4-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper4->setAcceleration( k2A);                                                              //If starting fresh Max accel to catch up on turnarround
-        stepper4->setSpeedInUs(s2_speed);
+        stepper4->setAcceleration(limits.accel(AXIS_ZOOM, k2A));                                                              //If starting fresh Max accel to catch up on turnarround
+        stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s2_speed));
 
         switch (Zoo_move2_Dest) {                                                                    //Pick up how far the motor should move before it either stopes or changes direction
           case 3:
@@ -4108,17 +3835,17 @@ void  Start_5() {
             break;
           case 4:
             s2_speed = s2_speed + ((s2_speed / 100) * 8);
-            stepper4->setSpeedInUs(s2_speed);
+            stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s2_speed));
             stepper4->moveTo(Zoo_k4_position);
             break;
           case 5:
             s2_speed = s2_speed + ((s2_speed / 100) * 8);
-            stepper4->setSpeedInUs(s2_speed);
+            stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s2_speed));
             stepper4->moveTo(Zoo_k5_position);
             break;
           case 6:
             s2_speed = s2_speed + ((s2_speed / 100) * 8);
-            stepper4->setSpeedInUs(s2_speed);
+            stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s2_speed));
             stepper4->moveTo(Zoo_k6_position);
             break;
         }
@@ -4266,14 +3993,14 @@ void  Start_5() {
           break;
       }
       if (stepper2->isRunning() && Pan_move2_Dest > 3 && Pan_move3_Rst != 1 ) {              //If the stepper is running on from last move
-        stepper2->setAcceleration(k3A);
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, k3A));
         s3_speed = s3_speed + ((s3_speed / 100) * 8);
-        stepper2->setSpeedInUs(s3_speed);
+        stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s3_speed));
         stepper2-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper2->setAcceleration(k3A);                                                      //If starting fresh Max accel to catch up on turnarround
-        stepper2->setSpeedInUs(s3_speed);
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, k3A));                                                      //If starting fresh Max accel to catch up on turnarround
+        stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s3_speed));
 
 
         switch (Pan_move3_Dest) {                                                            //Pick up how far the motor should move before it either stopes or changes direction
@@ -4285,12 +4012,12 @@ void  Start_5() {
             break;
           case 5:
             s3_speed = s3_speed + ((s3_speed / 100) * 8);
-            stepper2->setSpeedInUs(s3_speed);
+            stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s3_speed));
             stepper2->moveTo(Pan_k5_position);
             break;
           case 6:
             s3_speed = s3_speed + ((s3_speed / 100) * 8);                                 //5% ajustement on pan if running through keys this slows pan down by 5%
-            stepper2->setSpeedInUs(s3_speed);
+            stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s3_speed));
             stepper2->moveTo(Pan_k6_position);
             break;
         }
@@ -4339,30 +4066,30 @@ void  Start_5() {
       }
 
       if (stepper1->isRunning() && Tlt_move2_Dest > 3 && Tlt_move3_Rst != 1 ) {                                           //If the stepper is running on from last move
-        stepper1->setAcceleration(k3A);
+        stepper1->setAcceleration(limits.accel(AXIS_TILT, k3A));
         s3_speed = s3_speed + ((s3_speed / 100) * 8);
-        stepper1->setSpeedInUs(s3_speed);
+        stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s3_speed));
         stepper1-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper1->setAcceleration(k3A);                                                              //If starting fresh Max accel to catch up on turnarround
-        stepper1->setSpeedInUs(s3_speed);
+        stepper1->setAcceleration(limits.accel(AXIS_TILT, k3A));                                                              //If starting fresh Max accel to catch up on turnarround
+        stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s3_speed));
 
         switch (Tlt_move3_Dest) {                                                                    //Pick up how far the motor should move before it either stopes or changes direction
 
           case 4:
             //s3_speed = s3_speed + ((s3_speed / 100) * 8);
-            stepper1->setSpeedInUs(s3_speed);
+            stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s3_speed));
             stepper1->moveTo(Tlt_k4_position);
             break;
           case 5:
             s3_speed = s3_speed + ((s3_speed / 100) * 8);
-            stepper1->setSpeedInUs(s3_speed);
+            stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s3_speed));
             stepper1->moveTo(Tlt_k5_position);
             break;
           case 6:
             s3_speed = s3_speed + ((s3_speed / 100) * 8);
-            stepper1->setSpeedInUs(s3_speed);
+            stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s3_speed));
             stepper1->moveTo(Tlt_k6_position);
             break;
         }
@@ -4411,14 +4138,14 @@ void  Start_5() {
       }
 
       if (stepper3->isRunning() && Foc_move2_Dest > 3 && Foc_move3_Rst != 1 ) {                                  //If the stepper is running on from last move
-        stepper3->setAcceleration(k3A);
+        stepper3->setAcceleration(limits.accel(AXIS_FOCUS, k3A));
         s3_speed = s3_speed + ((s3_speed / 100) * 8);
-        stepper3->setSpeedInUs(s3_speed);
+        stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s3_speed));
         stepper3-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper3->setAcceleration(k3A);                                                              //If starting fresh Max accel to catch up on turnarround
-        stepper3->setSpeedInUs(s3_speed);
+        stepper3->setAcceleration(limits.accel(AXIS_FOCUS, k3A));                                                              //If starting fresh Max accel to catch up on turnarround
+        stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s3_speed));
 
         switch (Foc_move3_Dest) {                                                                    //Pick up how far the motor should move before it either stopes or changes direction
           case 4:
@@ -4426,12 +4153,12 @@ void  Start_5() {
             break;
           case 5:
             s3_speed = s3_speed + ((s3_speed / 100) * 8);
-            stepper3->setSpeedInUs(s3_speed);
+            stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s3_speed));
             stepper3->moveTo(Foc_k5_position);
             break;
           case 6:
             s3_speed = s3_speed + ((s3_speed / 100) * 8);
-            stepper3->setSpeedInUs(s3_speed);
+            stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s3_speed));
             stepper3->moveTo(Foc_k6_position);
             break;
         }
@@ -4481,14 +4208,14 @@ void  Start_5() {
       }
 
       if (stepper4->isRunning() && Zoo_move2_Dest > 3 && Zoo_move3_Rst != 1 ) {                                  //If the stepper is running on from last move
-        stepper4->setAcceleration(k3A);
+        stepper4->setAcceleration(limits.accel(AXIS_ZOOM, k3A));
         s3_speed = s3_speed + ((s3_speed / 100) * 8);
-        stepper4->setSpeedInUs(s3_speed);
+        stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s3_speed));
         stepper4-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper4->setAcceleration(k3A);                                                              //If starting fresh Max accel to catch up on turnarround
-        stepper4->setSpeedInUs(s3_speed);
+        stepper4->setAcceleration(limits.accel(AXIS_ZOOM, k3A));                                                              //If starting fresh Max accel to catch up on turnarround
+        stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s3_speed));
 
         switch (Zoo_move3_Dest) {                                                                    //Pick up how far the motor should move before it either stopes or changes direction
           case 4:
@@ -4496,12 +4223,12 @@ void  Start_5() {
             break;
           case 5:
             s3_speed = s3_speed + ((s3_speed / 100) * 8);
-            stepper4->setSpeedInUs(s3_speed);
+            stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s3_speed));
             stepper4->moveTo(Zoo_k5_position);
             break;
           case 6:
             s3_speed = s3_speed + ((s3_speed / 100) * 8);
-            stepper4->setSpeedInUs(s3_speed);
+            stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s3_speed));
             stepper4->moveTo(Zoo_k6_position);
             break;
         }
@@ -4650,15 +4377,15 @@ void  Start_5() {
           break;
       }
       if (stepper2->isRunning() && Pan_move3_Dest > 4 && Pan_move4_Rst != 1 ) {                                   //If the stepper is running on from last move
-        stepper2->setAcceleration(k4A);
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, k4A));
         s4_speed = s4_speed + ((s4_speed / 100) * 8);
-        stepper2->setSpeedInUs(s4_speed);
+        stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s4_speed));
         stepper2-> applySpeedAcceleration();
         delay(10);
       } else {
 
-        stepper2->setAcceleration(k4A);                                                    //If starting fresh Max accel to catch up on turnarround
-        stepper2->setSpeedInUs(s4_speed);
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, k4A));                                                    //If starting fresh Max accel to catch up on turnarround
+        stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s4_speed));
 
         switch (Pan_move4_Dest) {                                                          //Pick up how far the motor should move before it either stopes or changes direction
           case 5:
@@ -4666,7 +4393,7 @@ void  Start_5() {
             break;
           case 6:
             s4_speed = s4_speed + ((s4_speed / 100) * 8);
-            stepper2->setSpeedInUs(s4_speed);
+            stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s4_speed));
             stepper2->moveTo(Pan_k6_position);
             break;
         }
@@ -4714,14 +4441,14 @@ void  Start_5() {
       }
 
       if (stepper1->isRunning() && Tlt_move3_Dest > 4 && Tlt_move4_Rst != 1) {                                           //If the stepper is running on from last move
-        stepper1->setAcceleration(k4A);
+        stepper1->setAcceleration(limits.accel(AXIS_TILT, k4A));
         s4_speed = s4_speed + ((s4_speed / 100) * 8);
-        stepper1->setSpeedInUs(s4_speed);
+        stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s4_speed));
         stepper1-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper1->setAcceleration(k4A);                                                              //If starting fresh Max accel to catch up on turnarround
-        stepper1->setSpeedInUs(s4_speed);
+        stepper1->setAcceleration(limits.accel(AXIS_TILT, k4A));                                                              //If starting fresh Max accel to catch up on turnarround
+        stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s4_speed));
 
         switch (Tlt_move4_Dest) {                                                                     //Pick up how far the motor should move before it either stopes or changes direction
           case 5:
@@ -4729,7 +4456,7 @@ void  Start_5() {
             break;
           case 6:
             s4_speed = s4_speed + ((s4_speed / 100) * 8);
-            stepper1->setSpeedInUs(s4_speed);
+            stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s4_speed));
             stepper1->moveTo(Tlt_k6_position);
             break;
         }
@@ -4777,14 +4504,14 @@ void  Start_5() {
       }
 
       if (stepper3->isRunning() && Foc_move3_Dest > 4 && Foc_move4_Rst != 1) {                                  //If the stepper is running on from last move
-        stepper3->setAcceleration(k4A);
+        stepper3->setAcceleration(limits.accel(AXIS_FOCUS, k4A));
         s4_speed = s4_speed + ((s4_speed / 100) * 8);
-        stepper3->setSpeedInUs(s4_speed);
+        stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s4_speed));
         stepper3-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper3->setAcceleration(k4A);                                                              //If starting fresh Max accel to catch up on turnarround
-        stepper3->setSpeedInUs(s4_speed);
+        stepper3->setAcceleration(limits.accel(AXIS_FOCUS, k4A));                                                              //If starting fresh Max accel to catch up on turnarround
+        stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s4_speed));
 
         switch (Foc_move4_Dest) {                                                                    //Pick up how far the motor should move before it either stopes or changes direction
 
@@ -4793,7 +4520,7 @@ void  Start_5() {
             break;
           case 6:
             s4_speed = s4_speed + ((s4_speed / 100) * 8);
-            stepper1->setSpeedInUs(s4_speed);
+            stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s4_speed));
             stepper3->moveTo(Foc_k6_position);
             break;
         }
@@ -4842,14 +4569,14 @@ void  Start_5() {
       }
 
       if (stepper4->isRunning() && Zoo_move3_Dest > 4 && Zoo_move4_Rst != 1) {                                  //If the stepper is running on from last move
-        stepper4->setAcceleration(k4A);
+        stepper4->setAcceleration(limits.accel(AXIS_ZOOM, k4A));
         s4_speed = s4_speed + ((s4_speed / 100) * 8);
-        stepper4->setSpeedInUs(s4_speed);
+        stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s4_speed));
         stepper4-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper4->setAcceleration(k4A);                                                              //If starting fresh Max accel to catch up on turnarround
-        stepper4->setSpeedInUs(s4_speed);
+        stepper4->setAcceleration(limits.accel(AXIS_ZOOM, k4A));                                                              //If starting fresh Max accel to catch up on turnarround
+        stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s4_speed));
 
         switch (Zoo_move4_Dest) {                                                                    //Pick up how far the motor should move before it either stopes or changes direction
 
@@ -4858,7 +4585,7 @@ void  Start_5() {
             break;
           case 6:
             s4_speed = s4_speed + ((s4_speed / 100) * 8);
-            stepper1->setSpeedInUs(s4_speed);
+            stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s4_speed));
             stepper4->moveTo(Zoo_k6_position);
             break;
         }
@@ -5010,14 +4737,14 @@ void  Start_5() {
           break;
       }
       if (stepper2->isRunning() && Pan_move4_Dest > 5 && Pan_move5_Rst != 1 ) {                                   //If the stepper is running on from last move
-        stepper2->setAcceleration(k5A);
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, k5A));
         s5_speed = s5_speed + ((s5_speed / 100) * 8);
-        stepper2->setSpeedInUs(s5_speed);
+        stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s5_speed));
         stepper2-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper2->setAcceleration(k5A);                                                                           //If starting fresh Max accel to catch up on turnarround
-        stepper2->setSpeedInUs(s5_speed);
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, k5A));                                                                           //If starting fresh Max accel to catch up on turnarround
+        stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, s5_speed));
         stepper2->moveTo(Pan_k6_position);
         delay(10);
       }
@@ -5065,14 +4792,14 @@ void  Start_5() {
       }
 
       if (stepper1->isRunning() && Tlt_move4_Dest > 5 && Tlt_move5_Rst != 1) {                                  //If the stepper is running on from last move
-        stepper1->setAcceleration(k5A);
+        stepper1->setAcceleration(limits.accel(AXIS_TILT, k5A));
         s5_speed = s5_speed + ((s5_speed / 100) * 8);
-        stepper1->setSpeedInUs(s5_speed);
+        stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s5_speed));
         stepper1-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper1->setAcceleration(k5A);                                                  //If starting fresh Max accel to catch up on turnarround
-        stepper1->setSpeedInUs(s5_speed);
+        stepper1->setAcceleration(limits.accel(AXIS_TILT, k5A));                                                  //If starting fresh Max accel to catch up on turnarround
+        stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, s5_speed));
         stepper1->moveTo(Tlt_k6_position);
         delay(10);
       }
@@ -5118,14 +4845,14 @@ void  Start_5() {
       }
 
       if (stepper3->isRunning() && Foc_move4_Dest > 5 && Foc_move5_Rst != 1 ) {                                   //If the stepper is running on from last move
-        stepper3->setAcceleration(k5A);
+        stepper3->setAcceleration(limits.accel(AXIS_FOCUS, k5A));
         s5_speed = s5_speed + ((s5_speed / 100) * 8);
-        stepper3->setSpeedInUs(s5_speed);
+        stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s5_speed));
         stepper3-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper3->setAcceleration(k5A);                                                  //If starting fresh Max accel to catch up on turnarround
-        stepper3->setSpeedInUs(s5_speed);
+        stepper3->setAcceleration(limits.accel(AXIS_FOCUS, k5A));                                                  //If starting fresh Max accel to catch up on turnarround
+        stepper3->setSpeedInUs(limits.intervalUs(AXIS_FOCUS, s5_speed));
         stepper3->moveTo(Foc_k6_position);
         delay(10);
       }
@@ -5171,14 +4898,14 @@ void  Start_5() {
       }
 
       if (stepper4->isRunning() && Zoo_move4_Dest > 5 && Zoo_move5_Rst != 1 ) {                                   //If the stepper is running on from last move
-        stepper4->setAcceleration(k5A);
+        stepper4->setAcceleration(limits.accel(AXIS_ZOOM, k5A));
         s5_speed = s5_speed + ((s5_speed / 100) * 8);
-        stepper4->setSpeedInUs(s5_speed);
+        stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s5_speed));
         stepper4-> applySpeedAcceleration();
         delay(10);
       } else {
-        stepper4->setAcceleration(k5A);                                                  //If starting fresh Max accel to catch up on turnarround
-        stepper4->setSpeedInUs(s5_speed);
+        stepper4->setAcceleration(limits.accel(AXIS_ZOOM, k5A));                                                  //If starting fresh Max accel to catch up on turnarround
+        stepper4->setSpeedInUs(limits.intervalUs(AXIS_ZOOM, s5_speed));
         stepper4->moveTo(Zoo_k6_position);
         delay(10);
       }
@@ -5337,9 +5064,7 @@ void  Start_5() {
 
       delay(10);
       if (PTZ_IDhld == 5) {
-        digitalWrite(CAM, HIGH);                                                     //Stop camera
-        delay (200);
-        digitalWrite(CAM, LOW);
+        shutter.pulse(REC_PULSE_MS);                                                 //Stop camera
       }
       if (TLYhld == 1 && PTZ_IDhld == 5) {
         TurnOffTallyLight();
@@ -5361,181 +5086,34 @@ void Start_6() {
 
 //******Set stepper speed based on time distance and amount od ease InOut***********
 void SetSpeed() {
-
   //logger.print("Enterring Setpeed");
-  TLTtravel_dist = abs(TLTout_position - TLTin_position);                     // Distance we have to go
-  TLTstep_speed = (TLTtravel_dist / Crono_time);
-
-
-  PANtravel_dist = abs(PANout_position - PANin_position);                     // Distance we have to go
-  PANstep_speed = (PANtravel_dist / Crono_time);
-
-
-  FOCtravel_dist = abs(FOCout_position - FOCin_position);                     // Distance we have to go
-  FOCstep_speed = (FOCtravel_dist / Crono_time);
-
-  ZOOMtravel_dist = abs(ZMout_position - ZMin_position);                      // Distance we have to go
-  ZOOMstep_speed = (ZOOMtravel_dist / Crono_time);
-
-  switch (ease_InOut) {
-    case 0:                                                                    //No ease
-      TLTease_Value = 4000;
-      PANease_Value = 4000;
-      FOCease_Value = 4000;
-      ZOOMease_Value = 4000;
-      break;
-
-    case 3:
-
-      PANtravel_dist = abs(PANout_position - PANin_position);                   // Distance we have to go in steps *3 for ramp at start and end
-      if (PANtravel_dist != 0) {
-
-        PANease_Value = (PANtravel_dist / (Crono_time * 12));                      //Calculate the Acceloration value for the ramps total distance/ time *12
-      } else {
-        PANstep_speed = 10;                                                       // If the axis is not in use 0 move you must give it some realistic values or the esp32 will crash!
-        PANease_Value = 10;
-      }
-
-      TLTtravel_dist = abs(TLTout_position - TLTin_position);
-      if (TLTtravel_dist != 0) {
-
-        TLTease_Value = (TLTtravel_dist / (Crono_time * 12));
-      } else {
-        TLTstep_speed = 10;
-        TLTease_Value = 10;
-      }
-
-      FOCtravel_dist = abs(FOCout_position - FOCin_position);
-      if (FOCtravel_dist != 0) {
-
-        FOCease_Value = (FOCtravel_dist / (Crono_time * 12));
-      } else {
-        FOCstep_speed = 10;
-        FOCease_Value = 10;
-      }
-      ZOOMtravel_dist = abs(ZMout_position - ZMin_position);
-      if (ZOOMtravel_dist != 0) {
-
-        ZOOMease_Value = (ZOOMtravel_dist / (Crono_time * 12));
-      } else {
-        ZOOMstep_speed = 10;
-        ZOOMease_Value = 10;
-      }
-
-      break;
-
-    case 2:
-      PANtravel_dist = abs(PANout_position - PANin_position);                   // Distance we have to go in steps *3 for ramp at start and end
-      if (PANtravel_dist != 0) {
-
-        PANease_Value = (PANtravel_dist / (Crono_time * 12));                      //Calculate the Acceloration value for the ramps total distance/ time *12
-        PANease_Value = ( PANease_Value * 2);
-      } else {
-        PANstep_speed = 10;                                                       // If the axis is not in use 0 move you must give it some realistic values or the esp32 will crash!
-        PANease_Value = 10;
-      }
-
-      TLTtravel_dist = abs(TLTout_position - TLTin_position);
-      if (TLTtravel_dist != 0) {
-
-        TLTease_Value = (TLTtravel_dist / (Crono_time * 12));
-        TLTease_Value = (TLTease_Value * 2);
-      } else {
-        TLTstep_speed = 10;
-        TLTease_Value = 10;
-      }
-
-      FOCtravel_dist = abs(FOCout_position - FOCin_position);
-      if (FOCtravel_dist != 0) {
-
-        FOCease_Value = (FOCtravel_dist / (Crono_time * 12));
-        FOCease_Value = (FOCease_Value * 2);
-      } else {
-        FOCstep_speed = 10;
-        FOCease_Value = 10;
-      }
-      ZOOMtravel_dist = abs(ZMout_position - ZMin_position);
-      if (ZOOMtravel_dist != 0) {
-
-        ZOOMease_Value = (ZOOMtravel_dist / (Crono_time * 12));
-        ZOOMease_Value = (ZOOMease_Value * 2);
-      } else {
-        ZOOMstep_speed = 10;
-        ZOOMease_Value = 10;
-      }
-      break;
-
-    case 1:
-      PANtravel_dist = abs(PANout_position - PANin_position);                   // Distance we have to go in steps *3 for ramp at start and end
-      if (PANtravel_dist != 0) {
-
-        PANease_Value = (PANtravel_dist / (Crono_time * 12));                      //Calculate the Acceloration value for the ramps total distance/ time *12
-        PANease_Value = ( PANease_Value * 3);
-      } else {
-        PANstep_speed = 10;                                                       // If the axis is not in use 0 move you must give it some realistic values or the esp32 will crash!
-        PANease_Value = 10;
-      }
-
-      TLTtravel_dist = abs(TLTout_position - TLTin_position);
-      if (TLTtravel_dist != 0) {
-
-        TLTease_Value = (TLTtravel_dist / (Crono_time * 12));
-        TLTease_Value = (TLTease_Value * 3);
-      } else {
-        TLTstep_speed = 10;
-        TLTease_Value = 10;
-      }
-
-      FOCtravel_dist = abs(FOCout_position - FOCin_position);
-      if (FOCtravel_dist != 0) {
-
-        FOCease_Value = (FOCtravel_dist / (Crono_time * 12));
-        FOCease_Value = (FOCease_Value * 3);
-      } else {
-        FOCstep_speed = 10;
-        FOCease_Value = 10;
-      }
-      ZOOMtravel_dist = abs(ZMout_position - ZMin_position);
-      if (ZOOMtravel_dist != 0) {
-
-        ZOOMease_Value = (ZOOMtravel_dist / (Crono_time * 12));
-        ZOOMease_Value = (ZOOMease_Value * 3);
+  for (int i = 0; i < HEAD_AXES; i++) {
+    TravelDist[i] = abs(AxisOut[i] - AxisIn[i]);                              // Distance we have to go
+    StepSpeed[i] = (TravelDist[i] / Crono_time);
+
+    if (ease_InOut == 0) {                                                     //No ease
+      EaseValue[i] = 4000;
+    } else if (ease_InOut >= 1 && ease_InOut <= 3) {
+      if (TravelDist[i] != 0) {
+        EaseValue[i] = (TravelDist[i] / (Crono_time * 12));                   //Calculate the Acceloration value for the ramps total distance/ time *12
+        EaseValue[i] = EaseValue[i] * (4 - ease_InOut);                       //Ease 1 ramps 3x harder than ease 3
       } else {
-        ZOOMstep_speed = 10;
-        ZOOMease_Value = 10;
+        StepSpeed[i] = 10;                                                     // If the axis is not in use 0 move you must give it some realistic values or the esp32 will crash!
+        EaseValue[i] = 10;
       }
-
-
-      break;
+    }
   }
-
-  return;
 }
 
 //******Set stepper speed based on current position and destination pose. Time, Distance , Ease Where Time = VPoseSpeed 1-24***********
 //This means that a short move will take the sametime asa long move but all axis do there best to arrive at the same time regardless of how much thay move indevidually
 void VISCA_SetPoseSpeed() {
-
   //logger.print("Enterring Setpeed");
-  TLTtravel_dist = abs(T_position - stepper1->getCurrentPosition());                     // Distance we have to go
-  TLTstep_speed = (TLTtravel_dist / ((VPoseSpeed - (VPoseSpeed * 2)) + 25));
-
-  PANtravel_dist = abs(P_position - stepper2->getCurrentPosition());
-  PANstep_speed = (PANtravel_dist / ((VPoseSpeed - (VPoseSpeed * 2)) + 25));
-
-  FOCtravel_dist = abs(F_position - stepper3->getCurrentPosition());
-  FOCstep_speed = (FOCtravel_dist / ((VPoseSpeed - (VPoseSpeed * 2)) + 25));
-
-  ZOOMtravel_dist = abs(Z_position - stepper4->getCurrentPosition());
-  ZOOMstep_speed = (ZOOMtravel_dist / ((VPoseSpeed - (VPoseSpeed * 2)) + 25)) ;
-
-
-
-  TLTease_Value = 4000;
-  PANease_Value = 4000;
-  FOCease_Value = 4000;
-  ZOOMease_Value = 4000;
-
+  for (int i = 0; i < HEAD_AXES; i++) {
+    TravelDist[i] = abs(PoseTarget[i] - axes[i]->getCurrentPosition());        // Distance we have to go
+    StepSpeed[i] = (TravelDist[i] / ((VPoseSpeed - (VPoseSpeed * 2)) + 25));
+    EaseValue[i] = 4000;
+  }
 }
 
 //*************************************** Joystick control********************************************
@@ -5548,15 +5126,15 @@ void ReadAnalog() {                                  //read joystick
 
 
   if (abs( TiltJoySpeed) > 250) {
-    stepper1->setSpeedInUs(Tilt_J_Speed);             //Larger value is slower! Ajust this to ajust the joystick tilt speed
-    stepper1->setAcceleration (abs(TiltJoySpeed) * 2);
+    stepper1->setSpeedInUs(limits.intervalUs(AXIS_TILT, Tilt_J_Speed));             //Larger value is slower! Ajust this to ajust the joystick tilt speed
+    stepper1->setAcceleration (limits.accel(AXIS_TILT, abs(TiltJoySpeed) * 2));
 
     if (TiltJoySpeed > 0) {
       stepper1->runBackward();
       //logger.println("TiltStepper is Backwords");
       while (stepper1->isRunning()) {                          //delay until move complete
         tilt = analogRead(tilt_PIN);
-        stepper1->setAcceleration (abs(TiltJoySpeed) * 2);
+        stepper1->setAcceleration (limits.accel(AXIS_TILT, abs(TiltJoySpeed) * 2));
         stepper1->applySpeedAcceleration();
         if (abs(tilt - tilt_AVG) < 250) {
           //logger.println("TiltStepper has been stoped");
@@ -5570,7 +5148,7 @@ void ReadAnalog() {                                  //read joystick
       //logger.println("TiltStepper is Forwards");
       while (stepper1->isRunning()) {                          //delay until move complete
         tilt = analogRead(tilt_PIN);
-        stepper1->setAcceleration (abs(TiltJoySpeed) * 2);
+        stepper1->setAcceleration (limits.accel(AXIS_TILT, abs(TiltJoySpeed) * 2));
         stepper1->applySpeedAcceleration();
         if (abs(tilt - tilt_AVG) < 250) {
           //logger.println("TiltStepper has been stoped");
@@ -5583,14 +5161,14 @@ void ReadAnalog() {                                  //read joystick
   }
 
   if (abs( PanJoySpeed) > 350) {
-    stepper2->setSpeedInUs(Pan_J_Speed);                             //Larger value is slower! Ajust this to ajust the joystick Pan speed 4000 for Gearless drive 200 or less for geared
-    stepper2->setAcceleration (abs(PanJoySpeed) / 6);       //  /6 for no gear *2 for geared
+    stepper2->setSpeedInUs(limits.intervalUs(AXIS_PAN, Pan_J_Speed));                             //Larger value is slower! Ajust this to ajust the joystick Pan speed 4000 for Gearless drive 200 or less for geared
+    stepper2->setAcceleration (limits.accel(AXIS_PAN, abs(PanJoySpeed) / 6));       //  /6 for no gear *2 for geared
     if (PanJoySpeed < 0) {
       stepper2->runBackward();
       while (stepper2->isRunning()) {                           //delay until move complete
         pan = analogRead(pan_PIN);
         PanJoySpeed = ((pan - pan_AVG));
-        stepper2->setAcceleration(abs(PanJoySpeed) / 6);       //  /6 for no gear *2 for geared
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, abs(PanJoySpeed) / 6));       //  /6 for no gear *2 for geared
         stepper2->applySpeedAcceleration();
         if (abs(pan - pan_AVG) < 250) {
           stepper2->forceStopAndNewPosition(stepper2->getCurrentPosition());
@@ -5602,7 +5180,7 @@ void ReadAnalog() {                                  //read joystick
       while (stepper2->isRunning()) {                           //delay until move complete
         pan = analogRead(pan_PIN);
         PanJoySpeed = ((pan - pan_AVG));
-        stepper2->setAcceleration(abs(PanJoySpeed) / 6);
+        stepper2->setAcceleration(limits.accel(AXIS_PAN, abs(PanJoySpeed) / 6));
         stepper2->applySpeedAcceleration();
         if (abs(pan - pan_AVG) < 250) {
           stepper2->forceStopAndNewPosition(stepper2->getCurrentPosition());
@@ -5629,15 +5207,12 @@ void InitialValues() {
   }
   tilt_AVG = temp_tilt / 50;
   pan_AVG = temp_pan / 50;
-  stepper3->setCurrentPosition(0);
-  F_.ResetEncoder();
-  stepper4->setCurrentPosition(0);
-  Z_.ResetEncoder();
-
-  stepper1->setCurrentPosition(0);
-  T_.ResetEncoder();
-  stepper2->setCurrentPosition(0);
-  P_.ResetEncoder();
+  for (int i = 0; i < HEAD_AXES; i++) {
+    axes[i]->setCurrentPosition(0);
+    if (HeadAxes[i].encoder != NULL) {
+      HeadAxes[i].encoder->ResetEncoder();
+    }
+  }
 
   return;
 }
@@ -8215,34 +7790,28 @@ void stepper4_plan() {
 
 //*****PTZ Control Function*****
 void PTZ_Control() {
-  int SpeedScale = 10;                                                           //New speed scale factor
-
- 
-  if (Joy_Tilt_Accel < 1000) {
-    SpeedScale = 14;                                                             //New speed scale factor
-    SpeedScale = 14;
-  }
-  if (Joy_Tilt_Accel > 1000 && Joy_Tilt_Accel<1500) {
-    SpeedScale =  7;                                                             //New speed scale factor
-    SpeedScale = 7;
-  }
-   if (Joy_Tilt_Accel > 1500 && Joy_Tilt_Accel<2000) {
-    SpeedScale =  5;                                                             //New speed scale factor
-    SpeedScale = 5;
+  static unsigned long lastControlMs = 0;
+  unsigned long now = millis();
+  if (now - lastControlMs < PTZ_CONTROL_PERIOD_MS) {                             //Apply the response curves at a fixed rate however often we are called
+    return;
   }
-   if (Joy_Tilt_Accel > 2000 && Joy_Tilt_Accel<3000) {
-    SpeedScale =  2;                                                             //New speed scale factor
-    SpeedScale = 2;
+  lastControlMs = now;
+
+  int range = speedRange(Joy_Tilt_Accel);                                        //Master acceleration pot picks the speed range
+  uint32_t Tilt_mHz = responseMilliHz(Joy_From_Controller ? ControllerTiltResponse : TiltResponse, Joy_Tilt_Speed, range);
+  uint32_t Pan_mHz = responseMilliHz(Joy_From_Controller ? ControllerPanResponse : PanResponse, Joy_Pan_Speed, range);
+  uint32_t Focus_mHz = responseMilliHz(Joy_From_Controller ? ControllerFocusResponse : FocusResponse, Joy_Focus_Speed, range);
+  uint32_t Zoo_mHz = responseMilliHz(Joy_From_Controller ? ControllerZoomResponse : ZoomResponse, Joy_Zoo_Speed, range);
+  if (Focus_Stop != 0) {
+    Focus_mHz = 0;
   }
-  if (Joy_Tilt_Accel > 3000 && Joy_Tilt_Accel<4500) {
-    SpeedScale =  1;                                                             //New speed scale factor
-    SpeedScale = 1;
+  if (Zoo_Stop != 0) {
+    Zoo_mHz = 0;
   }
+
   //Record State
   if (Rec != lastRecState) {
-    digitalWrite(CAM, HIGH);                                                    //Start/stop Record on camera. Switch must be flipped
-    delay (200);
-    digitalWrite(CAM, LOW);
+    shutter.pulse(REC_PULSE_MS);                                                //Start/stop Record on camera. Switch must be flipped
     if (TLY == 1) {
       ToggleTallyLight();
     }
@@ -8251,474 +7820,49 @@ void PTZ_Control() {
 
 
 
-  //***Tilt moves new with limits***
-  if (abs(Joy_Tilt_Speed) > 150 ) {
-    tilt_is_moving = true;
-    stepper1->setAcceleration(abs(Joy_Tilt_Accel ));
-    stepper1->setSpeedInHz(abs(Joy_Tilt_Speed / SpeedScale ));
+  //***Live moves, the velocity task ramps the steppers and keeps them inside the limits***
+  if (!lock.isRunning()) {                                                       //The target lock drives tilt and pan itself
+    velocity.setTarget(AXIS_TILT, Joy_Tilt_Speed < 0 ? -(int32_t)Tilt_mHz : (int32_t)Tilt_mHz, abs(Joy_Tilt_Accel));
+    velocity.setTarget(AXIS_PAN, Joy_Pan_Speed < 0 ? -(int32_t)Pan_mHz : (int32_t)Pan_mHz, abs(Joy_Pan_Accel));
+  }
+  int32_t Focus_Target = Joy_Focus_Speed < 0 ? -(int32_t)Focus_mHz : (int32_t)Focus_mHz;
+  int32_t Zoo_Target = Joy_Zoo_Speed < 0 ? -(int32_t)Zoo_mHz : (int32_t)Zoo_mHz;
+  if (cam_F_Out < cam_F_In) {                                                    //A positive stick runs towards the Out point, whichever way round the limits were set
+    Focus_Target = -Focus_Target;
+  }
+  if (cam_Z_Out < cam_Z_In) {
+    Zoo_Target = -Zoo_Target;
+  }
+  velocity.setTarget(AXIS_FOCUS, Focus_Target, abs(Joy_Focus_Accel * 2));
+  velocity.setTarget(AXIS_ZOOM, Zoo_Target, abs(Joy_Zoo_Accel / 3));
 
+  bool moving = velocity.isActive(AXIS_TILT);
+  if (tilt_is_moving && !moving) {                                               //Axis came to rest, update the positions shown on the controller
+    Tilt_Stop = 0;
+    TA = (stepper1->getCurrentPosition()) / 650;
+  }
+  tilt_is_moving = moving;
 
+  moving = velocity.isActive(AXIS_PAN);
+  if (pan_is_moving && !moving) {
+    Pan_Stop = 0;
+    PA = ((stepper2->getCurrentPosition()) / 22) / 2;
+  }
+  pan_is_moving = moving;
 
-    // Forward Move
-    if (Joy_Tilt_Speed > 150 && stepper1->getCurrentPosition() < Forward_T_Out) {
-      stepper1->setAcceleration(abs(Joy_Tilt_Accel));
-      stepper1->setSpeedInHz(abs(Joy_Tilt_Speed / SpeedScale));
-      if (stepper1->getCurrentPosition() > (Forward_T_Out - 100 ) && abs(Joy_Tilt_Speed) > 150) {
-        if (tilt_is_moving = true) {
-          stepper1->moveTo(Forward_T_Out);
-        }
-
-      } else {
-        if (tilt_is_moving = true && abs(Joy_Tilt_Speed) > 150 ) {
-          stepper1->runForward();
-        }
-      }
-      if (stepper1->getCurrentPosition() >= (Forward_T_Out) ) {
-        stepper1->forceStopAndNewPosition(Forward_T_Out);
-        tilt_is_moving = false;
-        TA = (stepper1->getCurrentPosition()) / 650;
-      }
-    }
-
-    //Backward move
-    if (Joy_Tilt_Speed < -150 && stepper1->getCurrentPosition() > Forward_T_In) {
-      stepper1->setAcceleration(abs(Joy_Tilt_Accel));
-      stepper1->setSpeedInHz(abs(Joy_Tilt_Speed / SpeedScale));
-      if (stepper1->getCurrentPosition() < (Forward_T_In + 100 ) && abs(Joy_Tilt_Speed) > 150) {
-        if (tilt_is_moving = true) {
-          stepper1->moveTo(Forward_T_In);
-        }
-      } else {
-        if (tilt_is_moving = true && abs(Joy_Tilt_Speed) > 150) {
-          stepper1->runBackward();
-        }
-      }
-      if (stepper1->getCurrentPosition() <= (Forward_T_In)) {
-        stepper1->forceStopAndNewPosition(-3500);
-        tilt_is_moving = false;
-        TA = (stepper1->getCurrentPosition()) / 650;
-      }
-    }
-  } else {                                                                          //No command but stepper is still moving
-    if (tilt_is_moving) {
-      stepper1->setAcceleration(1800);                                              //Breaking acceloration on the stick moving back to 0
-      stepper1->applySpeedAcceleration();
-      stepper1->stopMove();
-      //Joy_Tilt_Speed=0;
-      tilt_is_moving = false;
-      Tilt_Stop = 0;
-      TA = (stepper1->getCurrentPosition()) / 650;
-    }
-  }
-
-
-  //***Pan moves new with limits***
-  int SpeedHld;
-  if (abs(Joy_Pan_Speed) > 150  ) {
-    delay(20);
-    stepper2->setAcceleration(abs(Joy_Pan_Accel ));
-    stepper2->setSpeedInHz(abs(Joy_Pan_Speed / SpeedScale ));
-
-    if (abs(Joy_Pan_Speed) > (SpeedHld + 200) || abs(Joy_Pan_Speed) < (SpeedHld - 200)) {
-      pan_is_moving = true;
-    }
-
-    // Forward Move
-    if (Joy_Pan_Speed > 150 && stepper2->getCurrentPosition() < Forward_P_Out ) {
-      stepper2->setAcceleration(abs(Joy_Pan_Accel  ));
-
-      if (Joy_Pan_Speed < 300) {
-        stepper2->setSpeedInHz(abs(Joy_Pan_Speed) / SpeedScale);
-        //stepper2->applySpeedAcceleration();
-      }
-      if (Joy_Pan_Speed > 300 && Joy_Pan_Speed < 600 ) {
-        stepper2->setSpeedInHz(abs(Joy_Pan_Speed) / SpeedScale);
-        //stepper2->applySpeedAcceleration();
-      }
-      if (Joy_Pan_Speed > 600 && Joy_Pan_Speed < 800) {
-        stepper2->setSpeedInHz(abs(Joy_Pan_Speed) / SpeedScale);
-        //stepper2->applySpeedAcceleration();
-      }
-      if (Joy_Pan_Speed > 800 ) {
-        stepper2->setSpeedInHz(abs(Joy_Pan_Speed) / SpeedScale);
-        //stepper2->applySpeedAcceleration();
-      }
-      if (stepper2->getCurrentPosition() > (Forward_P_Out - 100 ) && abs(Joy_Pan_Speed) > 150) {
-
-        if (pan_is_moving = true) {
-          stepper2->moveTo(Forward_P_Out);
-          SpeedHld = abs(Joy_Pan_Speed);
-        }
-      } else {
-        if (pan_is_moving = true && abs(Joy_Pan_Speed) > 150 ) {
-          stepper2->runForward();
-          SpeedHld = abs(Joy_Pan_Speed);
-        }
-      }
-      if (stepper2->getCurrentPosition() >= (Forward_P_Out) ) {
-        stepper2->forceStopAndNewPosition(Forward_P_Out);
-        pan_is_moving = false;
-        PA = ((stepper2->getCurrentPosition()) / 22) / 2;
-        SpeedHld = 0;
-      }
-    }
-
-    //Backward move
-    if (Joy_Pan_Speed < -150 && stepper2->getCurrentPosition() > Forward_P_In) {
-      stepper2->setAcceleration(abs(Joy_Pan_Accel ));
-
-      if (Joy_Pan_Speed > -300) {
-        stepper2->setSpeedInHz(abs(Joy_Pan_Speed) / SpeedScale);
-        //stepper2->applySpeedAcceleration();
-      }
-      if (Joy_Pan_Speed < -300 && Joy_Pan_Speed > -600 ) {
-        stepper2->setSpeedInHz(abs(Joy_Pan_Speed) / SpeedScale);
-      }
-      if (Joy_Pan_Speed < -600 && Joy_Pan_Speed > -800) {
-        stepper2->setSpeedInHz(abs(Joy_Pan_Speed) / SpeedScale);
-        //stepper2->applySpeedAcceleration();
-      }
-      if (Joy_Pan_Speed < -800 ) {
-        stepper2->setSpeedInHz(abs(Joy_Pan_Speed) / SpeedScale);
-        //stepper2->applySpeedAcceleration();
-      }
-
-
-      if (stepper2->getCurrentPosition() < (Forward_P_In + 100 ) && abs(Joy_Pan_Speed) > 150) {
-        if (pan_is_moving = true) {
-          stepper2->moveTo(Forward_P_In);
-          SpeedHld = abs(Joy_Pan_Speed);
-        }
-      } else {
-        if (pan_is_moving = true && abs(Joy_Pan_Speed) > 150) {
-          stepper2->runBackward();
-          SpeedHld = abs(Joy_Pan_Speed);
-        }
-
-        if (stepper2->getCurrentPosition() <= (Forward_P_In)) {
-          stepper2->forceStopAndNewPosition(Forward_P_In);
-          pan_is_moving = false;
-          PA = ((stepper2->getCurrentPosition()) / 22) / 2;
-          SpeedHld = 0;
-        }
-      }
-    }
-  } else {                                                                               //No command but stepper is still moving
-    if (pan_is_moving) {
-      stepper2->setAcceleration(1800);                                              //Breaking acceloration on the stick moving back to 0
-      stepper2->applySpeedAcceleration();
-      stepper2->stopMove();
-      pan_is_moving = false;
-      Pan_Stop = 0;
-      PA = ((stepper2->getCurrentPosition()) / 22) / 2;
-      SpeedHld = 0;
-    }
+  moving = velocity.isActive(AXIS_FOCUS);
+  if (focus_is_moving && !moving) {
+    Focus_Stop = 0;
+    FA = stepper3->getCurrentPosition();
   }
+  focus_is_moving = moving;
 
-
-  //***FOCUS +moves***
-  if (cam_F_Out > cam_F_In) {                                                          //Check the diretion the Focus motor is working in + or -
-    if (abs(Joy_Focus_Speed) > 1000 && Focus_Stop == 0) {
-      focus_is_moving = true;
-      stepper3->setAcceleration(abs(Joy_Focus_Accel * 2));
-      stepper3->setSpeedInHz(abs(Joy_Focus_Speed / SpeedScale));
-
-      // 1 Forward Move
-      if (Joy_Focus_Speed > 1000 && stepper3->getCurrentPosition() < cam_F_Out) {
-        stepper3->setAcceleration(abs(Joy_Focus_Accel * 2));
-        stepper3->setSpeedInHz(abs(Joy_Focus_Speed / SpeedScale));
-        if (stepper3->getCurrentPosition() > (cam_F_Out - 10 ) && abs(Joy_Focus_Speed) > 1000) {
-          if (focus_is_moving = true) {
-
-            if (stepper3->getCurrentPosition() > (cam_F_Out + 50 )) {                   //If close to the end stop slow down
-              stepper3->setSpeedInHz(abs(Joy_Focus_Speed / SpeedScale));
-              stepper3->setAcceleration(abs(Joy_Focus_Accel * 2));
-            }
-            stepper3->moveTo(cam_F_Out);
-          }
-
-        } else {
-          if (focus_is_moving = true) {
-            stepper3->runForward();
-          }
-        }
-        if (stepper3->getCurrentPosition() > (cam_F_Out) ) {
-          stepper3->forceStopAndNewPosition(cam_F_Out);
-          focus_is_moving = false;
-          FA = stepper3->getCurrentPosition();
-        }
-      }
-
-      //2 Backward move
-      if (Joy_Focus_Speed < 1000 && stepper3->getCurrentPosition() > cam_F_In) {
-        stepper3->setAcceleration(abs(Joy_Focus_Accel * 2));                             //If starting fresh Max accel to catch up on turnarround
-        stepper3->setSpeedInHz(abs(Joy_Focus_Speed / SpeedScale));
-        if (stepper3->getCurrentPosition() < (cam_F_In + 10 ) && abs(Joy_Focus_Speed) > 1000) {
-          if (focus_is_moving = true) {
-            if (stepper3->getCurrentPosition() > (cam_F_In + 50 )) {                   //If close to the end stop slow down
-              stepper3->setSpeedInHz(abs(Joy_Focus_Speed / SpeedScale));
-              stepper3->setAcceleration(abs(Joy_Focus_Accel * 2));
-            }
-            stepper3->moveTo(cam_F_In);
-          }
-        } else {
-          if (focus_is_moving = true) {
-            stepper3->runBackward();
-          }
-        }
-        if (stepper3->getCurrentPosition() <= (cam_F_In)) {
-          stepper3->forceStopAndNewPosition(cam_F_In);
-          focus_is_moving = false;
-          FA = stepper3->getCurrentPosition();
-        }
-      }
-    } else {                                                                          //No command but stepper is still moving
-      if (focus_is_moving) {
-        stepper3->setAcceleration(12000);                                              //Breaking acceloration on the stick moving back to 0
-        stepper3->applySpeedAcceleration();
-        stepper3->forceStopAndNewPosition(stepper3->getCurrentPosition());
-        //stepper3->stopMove();
-        focus_is_moving = false;
-        Focus_Stop = 0;
-        FA = stepper3->getCurrentPosition();
-      }
-    }
+  moving = velocity.isActive(AXIS_ZOOM);
+  if (Zoo_is_moving && !moving) {
+    Zoo_Stop = 0;
+    ZA = stepper4->getCurrentPosition();
   }
-  //***FOCUS -moves***
-
-  if (cam_F_Out < cam_F_In) {                                                          //Check the diretion the Focus motor is working in + or -
-
-
-    if (abs(Joy_Focus_Speed) > 1000 && Focus_Stop == 0) {
-      focus_is_moving = true;
-      stepper3->setAcceleration(abs(Joy_Focus_Accel * 2));                             //If starting fresh Max accel to catch up on turnarround
-      stepper3->setSpeedInHz(abs(Joy_Focus_Speed / SpeedScale ));
-
-      // 3 Forward Move
-      if (Joy_Focus_Speed > 1000 && stepper3->getCurrentPosition() > cam_F_Out) {
-        stepper3->setAcceleration(abs(Joy_Focus_Accel * 2));                             //If starting fresh Max accel to catch up on turnarround
-        stepper3->setSpeedInHz(abs(Joy_Focus_Speed / SpeedScale));
-        if (stepper3->getCurrentPosition() < (cam_F_Out + 10 ) && abs(Joy_Focus_Speed) > 1000) {  //Close to end move to end
-          if (focus_is_moving = true) {
-
-            if (stepper3->getCurrentPosition() > (cam_F_Out + 50 )) {                   //If close to the end stop slow down
-              stepper3->setSpeedInHz(abs(Joy_Focus_Speed / SpeedScale));
-              stepper3->setAcceleration(abs(Joy_Focus_Accel * 2));
-            }
-
-
-
-
-            stepper3->moveTo(cam_F_Out);
-          }
-
-        } else {
-          if (focus_is_moving = true) {
-            stepper3->runBackward();
-          }
-        }
-        if (stepper3->getCurrentPosition() <= (cam_F_Out) ) {
-          stepper3->forceStopAndNewPosition(cam_F_Out);
-          focus_is_moving = false;
-          FA = stepper3->getCurrentPosition();
-        }
-      }
-
-      //4Backward move
-      if (Joy_Focus_Speed < 1000 && stepper3->getCurrentPosition() < cam_F_In) {
-        logger.print("Backword move");
-        stepper3->setAcceleration(abs(Joy_Focus_Accel * 2));                                      //If starting fresh Max accel to catch up on turnarround
-        stepper3->setSpeedInHz(abs(Joy_Focus_Speed / SpeedScale));
-        if (stepper3->getCurrentPosition() > (cam_F_In - 10 ) && abs(Joy_Focus_Speed) > 1000) {  // If close to end
-          if (focus_is_moving = true) {
-
-            if (stepper3->getCurrentPosition() > (cam_F_Out + 50 )) {                   //If close to the end stop slow down
-              stepper3->setSpeedInHz(abs(Joy_Focus_Speed / SpeedScale));
-              stepper3->setAcceleration(abs(Joy_Focus_Accel * 2));
-            }
-
-            stepper3->moveTo(cam_F_In);
-          }
-        } else {
-          if (focus_is_moving = true) {
-            stepper3->runForward();
-          }
-        }
-        if (stepper3->getCurrentPosition() >= (cam_F_In)) {
-          stepper3->forceStopAndNewPosition(cam_F_In);
-          focus_is_moving = false;
-          FA = stepper3->getCurrentPosition();
-        }
-      }
-    } else {                                                                          //No command but stepper is still moving
-      if (focus_is_moving) {
-        stepper3->setAcceleration(12000);                                              //Breaking acceloration on the stick moving back to 0
-        stepper3->applySpeedAcceleration();
-        stepper3->forceStopAndNewPosition(stepper3->getCurrentPosition());
-        //stepper3->stopMove();
-        focus_is_moving = false;
-        Focus_Stop = 0;
-        FA = stepper3->getCurrentPosition();
-      }
-    }
-  }
-
-
-
-
-
-
-
-
-
-  //***ZOOM +moves***
-  if (cam_Z_Out > cam_Z_In) {                                                          //Check the diretion the Focus motor is working in + or -
-    if (abs(Joy_Zoo_Speed) > 1000 && Zoo_Stop == 0) {
-      Zoo_is_moving = true;
-
-
-      // 1 Forward Move
-      if (Joy_Zoo_Speed > 1000 && stepper4->getCurrentPosition() < cam_Z_Out) {
-        stepper4->setAcceleration(abs(Joy_Zoo_Accel / 3));                            //If starting fresh Max accel to catch up on turnarround
-        stepper4->setSpeedInHz(abs(Joy_Zoo_Speed / SpeedScale));
-        if (stepper4->getCurrentPosition() > (cam_Z_Out - 500 ) && abs(Joy_Zoo_Speed) > 1000) {
-          if (Zoo_is_moving = true) {
-            if (stepper4->getCurrentPosition() > (cam_Z_Out - 2500 )) {                   //If close to the end stop slow down
-
-              stepper4->setAcceleration(abs(Joy_Zoo_Accel / 3));
-              stepper4->setSpeedInHz(abs(Joy_Zoo_Speed / SpeedScale));
-            }
-            stepper4->moveTo(cam_Z_Out);
-          }
-
-        } else {
-          if (Zoo_is_moving = true) {
-            stepper4->runForward();
-          }
-        }
-        if (stepper4->getCurrentPosition() > (cam_Z_Out) ) {
-          stepper4->forceStopAndNewPosition(cam_Z_Out);
-          Zoo_is_moving = false;
-          ZA = stepper4->getCurrentPosition();
-        }
-      }
-
-      // 2 Backward move
-      if (Joy_Zoo_Speed < 1000 && stepper4->getCurrentPosition() > cam_Z_In) {
-        stepper4->setAcceleration(abs(Joy_Zoo_Accel / 3));                            //If starting fresh Max accel to catch up on turnarround
-        stepper4->setSpeedInHz(abs(Joy_Zoo_Speed / SpeedScale));
-        if (stepper4->getCurrentPosition() < (cam_Z_In + 500 ) && abs(Joy_Zoo_Speed) > 1000) {
-          if (Zoo_is_moving = true) {
-            if (stepper4->getCurrentPosition() > (cam_Z_In - 2500 )) {                   //If close to the end stop slow down
-
-              stepper4->setAcceleration(abs(Joy_Zoo_Accel / 3));
-              stepper4->setSpeedInHz(abs(Joy_Zoo_Speed / SpeedScale));
-            }
-            stepper4->moveTo(cam_Z_In);
-          }
-        } else {
-          if (Zoo_is_moving = true) {
-            stepper4->runBackward();
-          }
-        }
-        if (stepper4->getCurrentPosition() <= (cam_Z_In)) {
-          stepper4->forceStopAndNewPosition(cam_Z_In);
-          Zoo_is_moving = false;
-          ZA = stepper4->getCurrentPosition();
-        }
-      }
-    } else {                                                                          //No command but stepper is still moving
-      if (Zoo_is_moving) {
-        stepper4->setAcceleration(12000);                                              //Breaking acceloration on the stick moving back to 0
-        stepper4->applySpeedAcceleration();
-        stepper4->forceStopAndNewPosition(stepper4->getCurrentPosition());
-        //stepper4->stopMove();
-        Zoo_is_moving = false;
-        Zoo_Stop = 0;
-        ZA = stepper4->getCurrentPosition();
-      }
-    }
-  }
-
-  //***ZOOM -moves***
-
-  if (cam_Z_Out < cam_Z_In) {                                                          //Check the diretion the Zoom motor is working in + or -
-
-
-    if (abs(Joy_Zoo_Speed) > 1000 && Zoo_Stop == 0) {
-      Zoo_is_moving = true;
-
-
-      // 3 Forward Move
-      if (Joy_Zoo_Speed > 1000 && stepper4->getCurrentPosition() > cam_Z_Out) {
-        stepper4->setAcceleration(abs(Joy_Zoo_Accel / 3));                            //If starting fresh Max accel to catch up on turnarround
-        stepper4->setSpeedInHz(abs(Joy_Zoo_Speed / SpeedScale));
-        if (stepper4->getCurrentPosition() < (cam_Z_Out + 500 ) && abs(Joy_Zoo_Speed) > 1000) {  //Close to end move to end
-          if (Zoo_is_moving = true) {
-            if (stepper4->getCurrentPosition() > (cam_Z_Out - 2500 )) {                   //If close to the end stop slow down
-
-              stepper4->setAcceleration(abs(Joy_Zoo_Accel / 3));
-              stepper4->setSpeedInHz(abs(Joy_Zoo_Speed / SpeedScale));
-            }
-
-            stepper4->moveTo(cam_Z_Out);
-          }
-
-        } else {
-          if (Zoo_is_moving = true) {
-            stepper4->runBackward();
-          }
-        }
-        if (stepper4->getCurrentPosition() <= (cam_Z_Out) ) {
-          stepper4->forceStopAndNewPosition(cam_Z_Out);
-          Zoo_is_moving = false;
-          ZA = stepper4->getCurrentPosition();
-        }
-      }
-
-      //4 Backward move
-      if (Joy_Zoo_Speed < 1000 && stepper4->getCurrentPosition() < cam_Z_In) {
-        logger.print("Backword move");
-        stepper4->setAcceleration(abs(Joy_Zoo_Accel / 3));                                     //If starting fresh Max accel to catch up on turnarround
-        stepper4->setSpeedInHz(abs(Joy_Zoo_Speed / SpeedScale));
-        if (stepper4->getCurrentPosition() > (cam_Z_In - 500 ) && abs(Joy_Zoo_Speed) > 1000) {  // If close to end
-          if (Zoo_is_moving = true) {
-            if (stepper4->getCurrentPosition() > (cam_Z_Out - 2500 )) {                   //If close to the end stop slow down
-
-              stepper4->setAcceleration(abs(Joy_Zoo_Accel / 3));
-              stepper4->setSpeedInHz(abs(Joy_Zoo_Speed / SpeedScale));
-            }
-
-            stepper4->moveTo(cam_Z_In);
-          }
-        } else {
-          if (Zoo_is_moving = true) {
-            stepper4->runForward();
-          }
-        }
-        if (stepper4->getCurrentPosition() >= (cam_Z_In)) {
-          stepper4->forceStopAndNewPosition(cam_Z_In);
-          Zoo_is_moving = false;
-          ZA = stepper4->getCurrentPosition();
-        }
-      }
-    } else {                                                                          //No command but stepper is still moving
-      if (Zoo_is_moving) {
-        stepper4->setAcceleration(12000);                                              //Breaking acceloration on the stick moving back to 0
-        stepper4->applySpeedAcceleration();
-        stepper4->forceStopAndNewPosition(stepper4->getCurrentPosition());
-        //stepper4->stopMove();
-        Zoo_is_moving = false;
-        Zoo_Stop = 0;
-        ZA = stepper3->getCurrentPosition();
-      }
-    }
-  }
-
-
-
-
-
+  Zoo_is_moving = moving;
 }
 
 
@@ -8832,117 +7976,9 @@ void Load_SysMemory() {
   Zoo_k6_position = SysMemory.getUInt("Zoo_k6_pos", 0);
   SysMemory.end();
 
-  SysMemory.begin("P1pos", false);                        //Recover PTZ Cam poses
-  P1_T = SysMemory.getUInt("P1_T", 10);
-  P1_P = SysMemory.getUInt("P1_P", 10);
-  P1_F = SysMemory.getUInt("P1_F", 10);
-  P1_Z = SysMemory.getUInt("P1_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P2pos", false);
-  P2_T = SysMemory.getUInt("P2_T", 10);
-  P2_P = SysMemory.getUInt("P2_P", 10);
-  P2_F = SysMemory.getUInt("P2_F", 10);
-  P2_Z = SysMemory.getUInt("P2_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P3pos", false);
-  P3_T = SysMemory.getUInt("P3_T", 10);
-  P3_P = SysMemory.getUInt("P3_P", 10);
-  P3_F = SysMemory.getUInt("P3_F", 10);
-  P3_Z = SysMemory.getUInt("P3_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P4pos", false);
-  P4_T = SysMemory.getUInt("P4_T", 10);
-  P4_P = SysMemory.getUInt("P4_P", 10);
-  P4_F = SysMemory.getUInt("P4_F", 10);
-  P4_Z = SysMemory.getUInt("P4_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P5pos", false);
-  P5_T = SysMemory.getUInt("P5_T", 10);
-  P5_P = SysMemory.getUInt("P5_P", 10);
-  P5_F = SysMemory.getUInt("P5_F", 10);
-  P5_Z = SysMemory.getUInt("P5_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P6pos", false);
-  P6_T = SysMemory.getUInt("P6_T", 10);
-  P6_P = SysMemory.getUInt("P6_P", 10);
-  P6_F = SysMemory.getUInt("P6_F", 10);
-  P6_Z = SysMemory.getUInt("P6_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P7pos", false);
-  P7_T = SysMemory.getUInt("P7_T", 10);
-  P7_P = SysMemory.getUInt("P7_P", 10);
-  P7_F = SysMemory.getUInt("P7_F", 10);
-  P7_Z = SysMemory.getUInt("P7_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P8pos", false);
-  P8_T = SysMemory.getUInt("P8_T", 10);
-  P8_P = SysMemory.getUInt("P8_P", 10);
-  P8_F = SysMemory.getUInt("P8_F", 10);
-  P8_Z = SysMemory.getUInt("P8_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P9pos", false);
-  P9_T = SysMemory.getUInt("P9_T", 10);
-  P9_P = SysMemory.getUInt("P9_P", 10);
-  P9_F = SysMemory.getUInt("P9_F", 10);
-  P9_Z = SysMemory.getUInt("P9_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P10pos", false);
-  P10_T = SysMemory.getUInt("P10_T", 10);
-  P10_P = SysMemory.getUInt("P10_P", 10);
-  P10_F = SysMemory.getUInt("P10_F", 10);
-  P10_Z = SysMemory.getUInt("P10_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P11pos", false);
-  P11_T = SysMemory.getUInt("P11_T", 10);
-  P11_P = SysMemory.getUInt("P11_P", 10);
-  P11_F = SysMemory.getUInt("P11_F", 10);
-  P11_Z = SysMemory.getUInt("P11_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P12pos", false);
-  P12_T = SysMemory.getUInt("P12_T", 10);
-  P12_P = SysMemory.getUInt("P12_P", 10);
-  P12_F = SysMemory.getUInt("P12_F", 10);
-  P12_Z = SysMemory.getUInt("P12_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P13pos", false);
-  P13_T = SysMemory.getUInt("P13_T", 10);
-  P13_P = SysMemory.getUInt("P13_P", 10);
-  P13_F = SysMemory.getUInt("P13_F", 10);
-  P13_Z = SysMemory.getUInt("P13_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P14pos", false);
-  P14_T = SysMemory.getUInt("P14_T", 10);
-  P14_P = SysMemory.getUInt("P14_P", 10);
-  P14_F = SysMemory.getUInt("P14_F", 10);
-  P14_Z = SysMemory.getUInt("P14_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P15pos", false);
-  P15_T = SysMemory.getUInt("P15_T", 10);
-  P15_P = SysMemory.getUInt("P15_P", 10);
-  P15_F = SysMemory.getUInt("P15_F", 10);
-  P15_Z = SysMemory.getUInt("P15_Z", 10);
-  SysMemory.end();
-
-  SysMemory.begin("P16pos", false);
-  P16_T = SysMemory.getUInt("P16_T", 10);
-  P16_P = SysMemory.getUInt("P16_P", 10);
-  P16_F = SysMemory.getUInt("P16_F", 10);
-  P16_Z = SysMemory.getUInt("P16_Z", 10);
-  SysMemory.end();
+  for (int pose = 1; pose <= POSES; pose++) {                    //Recover PTZ Cam poses
+    RecoverPose(pose);
+  }
 
 
 
@@ -9052,212 +8088,24 @@ void ClearKeys() {                                                //Function to
 
 
 
-  SysMemory.begin("P1_pos", false);
-  P1_T = 10;
-  P1_P = 10;
-  P1_F = 10;
-  P1_Z = 10;
-  SysMemory.putUInt("P1_T", P1_T);
-  SysMemory.putUInt("P1_P", P1_P);
-  SysMemory.putUInt("P1_F", P1_F);
-  SysMemory.putUInt("P1_Z", P1_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P2_pos", false);
-  P2_T = 10;
-  P2_P = 10;
-  P2_F = 10;
-  P2_Z = 10;
-  SysMemory.putUInt("P2_T", P2_T);
-  SysMemory.putUInt("P2_P", P2_P);
-  SysMemory.putUInt("P2_F", P2_F);
-  SysMemory.putUInt("P2_Z", P2_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P3_pos", false);
-  P3_T = 10;
-  P3_P = 10;
-  P3_F = 10;
-  P3_Z = 10;
-  SysMemory.putUInt("P3_T", P3_T);
-  SysMemory.putUInt("P3_P", P3_P);
-  SysMemory.putUInt("P3_F", P3_F);
-  SysMemory.putUInt("P3_Z", P3_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P4_pos", false);
-  P4_T = 10;
-  P4_P = 10;
-  P4_F = 10;
-  P4_Z = 10;
-  SysMemory.putUInt("P4_T", P4_T);
-  SysMemory.putUInt("P4_P", P4_P);
-  SysMemory.putUInt("P4_F", P4_F);
-  SysMemory.putUInt("P4_Z", P4_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P5_pos", false);
-  P5_T = 10;
-  P5_P = 10;
-  P5_F = 10;
-  P5_Z = 10;
-  SysMemory.putUInt("P5_T", P5_T);
-  SysMemory.putUInt("P5_P", P5_P);
-  SysMemory.putUInt("P5_F", P5_F);
-  SysMemory.putUInt("P5_Z", P5_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P6_pos", false);
-  P6_T = 10;
-  P6_P = 10;
-  P6_F = 10;
-  P6_Z = 10;
-  SysMemory.putUInt("P6_T", P6_T);
-  SysMemory.putUInt("P6_P", P6_P);
-  SysMemory.putUInt("P6_F", P6_F);
-  SysMemory.putUInt("P6_Z", P6_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P7_pos", false);
-  P7_T = 10;
-  P7_P = 10;
-  P7_F = 10;
-  P7_Z = 10;
-  SysMemory.putUInt("P7_T", P7_T);
-  SysMemory.putUInt("P7_P", P7_P);
-  SysMemory.putUInt("P7_F", P7_F);
-  SysMemory.putUInt("P7_Z", P7_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P8_pos", false);
-  P8_T = 10;
-  P8_P = 10;
-  P8_F = 10;
-  P8_Z = 10;
-  SysMemory.putUInt("P8_T", P8_T);
-  SysMemory.putUInt("P8_P", P8_P);
-  SysMemory.putUInt("P8_F", P8_F);
-  SysMemory.putUInt("P8_Z", P8_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P9_pos", false);
-  P9_T = 10;
-  P9_P = 10;
-  P9_F = 10;
-  P9_Z = 10;
-  SysMemory.putUInt("P9_T", P9_T);
-  SysMemory.putUInt("P9_P", P9_P);
-  SysMemory.putUInt("P9_F", P9_F);
-  SysMemory.putUInt("P9_Z", P9_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P10_pos", false);
-  P10_T = 10;
-  P10_P = 10;
-  P10_F = 10;
-  P10_Z = 10;
-  SysMemory.putUInt("P10_T", P10_T);
-  SysMemory.putUInt("P10_P", P10_P);
-  SysMemory.putUInt("P10_F", P10_F);
-  SysMemory.putUInt("P10_Z", P10_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P11_pos", false);
-  P11_T = 10;
-  P11_P = 10;
-  P11_F = 10;
-  P11_Z = 10;
-  SysMemory.putUInt("P11_T", P11_T);
-  SysMemory.putUInt("P11_P", P11_P);
-  SysMemory.putUInt("P11_F", P11_F);
-  SysMemory.putUInt("P11_Z", P11_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P12_pos", false);
-  P12_T = 10;
-  P12_P = 10;
-  P12_F = 10;
-  P12_Z = 10;
-  SysMemory.putUInt("P12_T", P12_T);
-  SysMemory.putUInt("P12_P", P12_P);
-  SysMemory.putUInt("P12_F", P12_F);
-  SysMemory.putUInt("P12_Z", P12_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P13_pos", false);
-  P13_T = 10;
-  P13_P = 10;
-  P13_F = 10;
-  P13_Z = 10;
-  SysMemory.putUInt("P13_T", P13_T);
-  SysMemory.putUInt("P13_P", P13_P);
-  SysMemory.putUInt("P13_F", P13_F);
-  SysMemory.putUInt("P13_Z", P13_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P14_pos", false);
-  P14_T = 10;
-  P14_P = 10;
-  P14_F = 10;
-  P14_Z = 10;
-  SysMemory.putUInt("P14_T", P14_T);
-  SysMemory.putUInt("P14_P", P14_P);
-  SysMemory.putUInt("P14_F", P14_F);
-  SysMemory.putUInt("P14_Z", P14_Z);
-  SysMemory.end();
-
-  SysMemory.begin("P15_pos", false);
-  P15_T = 10;
-  P15_P = 10;
-  P15_F = 10;
-  P15_Z = 10;
-  SysMemory.putUInt("P15_T", P15_T);
-  SysMemory.putUInt("P15_P", P15_P);
-  SysMemory.putUInt("P15_F", P15_F);
-  SysMemory.putUInt("P15_Z", P15_Z);
-  SysMemory.end();
+  for (int pose = 1; pose <= POSES; pose++) {
+    for (int i = 0; i < HEAD_AXES; i++) {
+      Pose[pose - 1][i] = 10;
+    }
+    StorePose(pose);
+  }
 
-  SysMemory.begin("P16_pos", false);
-  P16_T = 10;
-  P16_P = 10;
-  P16_F = 10;
-  P16_Z = 10;
-  SysMemory.putUInt("P16_T", P16_T);
-  SysMemory.putUInt("P16_P", P16_P);
-  SysMemory.putUInt("P16_F", P16_F);
-  SysMemory.putUInt("P16_Z", P16_Z);
-  SysMemory.end();
+  backlash.set(AXIS_TILT, -1);                                      //Measure the slack again on the next start
+  backlash.set(AXIS_PAN, -1);
 
   clrK = 0;
-  T_.ResetEncoder();
-  P_.ResetEncoder();
-  F_.ResetEncoder();
-  Z_.ResetEncoder();
-
-
-}
-
-
-void BatCheck() {
-  BatV = analogRead(BatPin);
-  BatV = ((BatV / 4095) * 2) * 4.182;
-  if (BatV > 7.5) {
-    Percent_100(PTZ_ID);
-  } else {
-    if (BatV > 7.4) {
-      Percent_75(PTZ_ID);
-    } else {
-      if (BatV > 7.3) {
-        Percent_50(PTZ_ID);
-      } else {
-        if (BatV > 7.2) {
-          Percent_25(PTZ_ID);
-        } else {
-          Percent_0(PTZ_ID);
-        }
-      }
+  for (int i = 0; i < HEAD_AXES; i++) {
+    if (HeadAxes[i].encoder != NULL) {
+      HeadAxes[i].encoder->ResetEncoder();
     }
   }
+
+
 }
 
 
@@ -9289,6 +8137,15 @@ void  listenForVisca() {
       }
     }
   }  
+  if (newData == false && ndx == 0 && espnowViscaCount > 0) {       //Not while a UART line is half read into the buffer
+    portENTER_CRITICAL(&espnowViscaLock);
+    strcpy(receivedChars, espnowVisca[espnowViscaHead]);
+    espnowViscaHead = (espnowViscaHead + 1) % ESPNOW_VISCA_LINES;
+    espnowViscaCount--;
+    portEXIT_CRITICAL(&espnowViscaLock);
+    newData = true;
+    logger.printf("\nReceived Visca command '%s' over ESP-NOW", receivedChars);
+  }
   
   showNewData();
 }
@@ -9306,7 +8163,7 @@ void showNewData() {
       StrTokIndx = strtok(receivedChars, ",");
       ViscaComand = atoi(StrTokIndx);
       StrTokIndx = strtok(NULL, ",");
-      Tally = atoi(StrTokIndx) + 1;
+      SetTallyLed(atoi(StrTokIndx) + 1);
 
     }
     if (ViscaComand  == 137) {     //Pose Speed
@@ -9365,6 +8222,9 @@ void showNewData() {
 
 void Stop(){
  logger.println("\nPT Stop ");
+  tour.stop();
+  lock.stop();
+  udpvisca.cancelMove();                                          //A VISCA positioning move runs on its own until braked
   if (pan_is_moving) {
     Joy_Pan_Speed = (0);
   }
@@ -9382,6 +8242,7 @@ void Stop(){
 
 void parseVISCA() {
   PTZ_Cam = PTZ_ID;                                      //While reading VISA over IP force the system to egnore ID setup
+  Joy_From_Controller = false;
   char buffer[50];
   switch (ViscaComand)  {
     case 64: logger.println("PT Home ");
@@ -9473,48 +8334,24 @@ void parseVISCA() {
 
     case 13: logger.printf("\nPan Left %d", VPanSpeed);
       Joy_Pan_Accel = 2000;
-      if (VPanSpeed < 3) {
-        Joy_Pan_Speed = (VPanSpeed * 200);
-        Joy_Pan_Speed = (Joy_Pan_Speed - (Joy_Pan_Speed * 2));   //Posative to negative value
-      } else {
-        Joy_Pan_Speed = (VPanSpeed * 150);
-        Joy_Pan_Speed = (Joy_Pan_Speed - (Joy_Pan_Speed * 2));   //Posative to negative value
-      }
+      Joy_Pan_Speed = -toCommand(VPanSpeed, VISCA_PAN_SPEED_MAX, PAN_COMMAND_FULL);
       logger.printf(" -> Joy_Pan_Speed %d", Joy_Pan_Speed);
       break;
 
     case 23: logger.printf("\nPan Right %d", VPanSpeed);
       Joy_Pan_Accel = 2000;
-      if (VPanSpeed < 3) {
-        Joy_Pan_Speed = (VPanSpeed * 200);
-
-      } else {
-        Joy_Pan_Speed = (VPanSpeed * 150);
-
-      }
+      Joy_Pan_Speed = toCommand(VPanSpeed, VISCA_PAN_SPEED_MAX, PAN_COMMAND_FULL);
       logger.printf(" -> Joy_Pan_Speed %d", Joy_Pan_Speed);      
       break;
 
     case 31: logger.printf("\nTilt Up %d ", VTiltSpeed);
-      if (VTiltSpeed < 3) {
-        Joy_Tilt_Speed = (VTiltSpeed * 200);
-      } else {
-        Joy_Tilt_Speed = (VTiltSpeed * 150);
-      }
-      Joy_Tilt_Speed = Joy_Tilt_Speed * 2;
+      Joy_Tilt_Speed = toCommand(VTiltSpeed, VISCA_TILT_SPEED_MAX, TILT_COMMAND_FULL);
       logger.printf(" -> Joy_Tilt_Speed %d", Joy_Tilt_Speed);      
       break;
 
     case 32: logger.printf("\nTilt Down %d", VTiltSpeed);
       logger.println(VTiltSpeed);
-      if (VTiltSpeed < 3) {
-        Joy_Tilt_Speed = (VTiltSpeed * 200);
-        Joy_Tilt_Speed = (Joy_Tilt_Speed - (Joy_Tilt_Speed * 2));   //Posative to negative value
-      } else {
-        Joy_Tilt_Speed = (VTiltSpeed * 150);
-        Joy_Tilt_Speed = (Joy_Tilt_Speed - (Joy_Tilt_Speed * 2));   //Posative to negative value
-      }
-      Joy_Tilt_Speed = Joy_Tilt_Speed * 2;
+      Joy_Tilt_Speed = -toCommand(VTiltSpeed, VISCA_TILT_SPEED_MAX, TILT_COMMAND_FULL);
       logger.printf(" -> Joy_Tilt_Speed %d", Joy_Tilt_Speed);      
       break;
 
@@ -9522,74 +8359,30 @@ void parseVISCA() {
 
     case 11: logger.printf("\nUp Left %d, %d", VPanSpeed, VTiltSpeed);
       Joy_Pan_Accel = 2000;
-      if (VPanSpeed < 3) {
-        Joy_Pan_Speed = (VPanSpeed * 200);
-        Joy_Pan_Speed = (Joy_Pan_Speed - (Joy_Pan_Speed * 2));   //Posative to negative value
-      } else {
-        Joy_Pan_Speed = (VPanSpeed * 150);
-        Joy_Pan_Speed = (Joy_Pan_Speed - (Joy_Pan_Speed * 2));   //Posative to negative value
-      }
-      if (VTiltSpeed < 3) {
-        Joy_Tilt_Speed = (VTiltSpeed * 200);
-      } else {
-        Joy_Tilt_Speed = (VTiltSpeed * 150);
-      }
+      Joy_Pan_Speed = -toCommand(VPanSpeed, VISCA_PAN_SPEED_MAX, PAN_COMMAND_FULL);
+      Joy_Tilt_Speed = toCommand(VTiltSpeed, VISCA_TILT_SPEED_MAX, TILT_COMMAND_FULL);
       logger.printf(" -> Joy_Pan_Speed %d, Joy_Tilt_Speed %d", Joy_Pan_Speed, Joy_Tilt_Speed); 
       break;
 
     case 21: logger.printf("\nUp Right  %d, %d", VPanSpeed, VTiltSpeed);
       Joy_Pan_Accel = 2000;
-      if (VPanSpeed < 3) {
-        Joy_Pan_Speed = (VPanSpeed * 200);
-
-      } else {
-        Joy_Pan_Speed = (VPanSpeed * 150);
-
-      }
-      if (VTiltSpeed < 3) {
-        Joy_Tilt_Speed = (VTiltSpeed * 200);
-      } else {
-        Joy_Tilt_Speed = (VTiltSpeed * 150);
-      }
+      Joy_Pan_Speed = toCommand(VPanSpeed, VISCA_PAN_SPEED_MAX, PAN_COMMAND_FULL);
+      Joy_Tilt_Speed = toCommand(VTiltSpeed, VISCA_TILT_SPEED_MAX, TILT_COMMAND_FULL);
       logger.printf(" -> Joy_Pan_Speed %d, Joy_Tilt_Speed %d", Joy_Pan_Speed, Joy_Tilt_Speed); 
 
       break;
 
     case 12: logger.printf("\nDown Left  %d, %d", VPanSpeed, VTiltSpeed);
       Joy_Pan_Accel = 2000;
-      if (VPanSpeed < 3) {
-        Joy_Pan_Speed = (VPanSpeed * 200);
-        Joy_Pan_Speed = (Joy_Pan_Speed - (Joy_Pan_Speed * 2));   //Posative to negative value
-      } else {
-        Joy_Pan_Speed = (VPanSpeed * 150);
-        Joy_Pan_Speed = (Joy_Pan_Speed - (Joy_Pan_Speed * 2));   //Posative to negative value
-      }
-      if (VTiltSpeed < 3) {
-        Joy_Tilt_Speed = (VTiltSpeed * 200);
-        Joy_Tilt_Speed = (Joy_Tilt_Speed - (Joy_Tilt_Speed * 2));   //Posative to negative value
-      } else {
-        Joy_Tilt_Speed = (VTiltSpeed * 150);
-        Joy_Tilt_Speed = (Joy_Tilt_Speed - (Joy_Tilt_Speed * 2));   //Posative to negative value
-      } 
+      Joy_Pan_Speed = -toCommand(VPanSpeed, VISCA_PAN_SPEED_MAX, PAN_COMMAND_FULL);
+      Joy_Tilt_Speed = -toCommand(VTiltSpeed, VISCA_TILT_SPEED_MAX, TILT_COMMAND_FULL);
       logger.printf(" -> Joy_Pan_Speed %d, Joy_Tilt_Speed %d", Joy_Pan_Speed, Joy_Tilt_Speed); 
       break;
 
     case 22: logger.printf("\nDown Right %d, %d", VPanSpeed, VTiltSpeed);
       Joy_Pan_Accel = 2000;
-      if (VPanSpeed < 3) {
-        Joy_Pan_Speed = (VPanSpeed * 200);
-
-      } else {
-        Joy_Pan_Speed = (VPanSpeed * 150);
-
-      }
-      if (VTiltSpeed < 3) {
-        Joy_Tilt_Speed = (VTiltSpeed * 200);
-        Joy_Tilt_Speed = (Joy_Tilt_Speed - (Joy_Tilt_Speed * 2));   //Posative to negative value
-      } else {
-        Joy_Tilt_Speed = (VTiltSpeed * 150);
-        Joy_Tilt_Speed = (Joy_Tilt_Speed - (Joy_Tilt_Speed * 2));   //Posative to negative value
-      }
+      Joy_Pan_Speed = toCommand(VPanSpeed, VISCA_PAN_SPEED_MAX, PAN_COMMAND_FULL);
+      Joy_Tilt_Speed = -toCommand(VTiltSpeed, VISCA_TILT_SPEED_MAX, TILT_COMMAND_FULL);
       logger.printf(" -> Joy_Pan_Speed %d, Joy_Tilt_Speed %d", Joy_Pan_Speed, Joy_Tilt_Speed); 
 
       break;
@@ -9821,201 +8614,11 @@ void parseVISCA() {
 }
 
 void PTZ_ClearP() {
-  int mem0;
-  switch (PTZ_Pose) {
-    case 1:
-      P1_T = 0;
-      P1_P = 0;
-      P1_F = 0;
-      P1_Z = 0;
-      SysMemory.begin("P1pos", false);                         //save to memory
-      SysMemory.putUInt("P1_T", mem0);
-      SysMemory.putUInt("P1_P", mem0);
-      SysMemory.putUInt("P1_F", mem0);
-      SysMemory.putUInt("P1_Z", mem0);
-      SysMemory.end();
-      break;
-    case 2:
-      P2_T = 0;
-      P2_P = 0;
-      P2_F = 0;
-      P2_Z = 0;
-      SysMemory.begin("P2pos", false);                         //save to memory
-      SysMemory.putUInt("P2_T", mem0);
-      SysMemory.putUInt("P2_P", mem0);
-      SysMemory.putUInt("P2_F", mem0);
-      SysMemory.putUInt("P2_Z", mem0);
-      SysMemory.end();
-      break;
-    case 3:
-      P3_T = 0;
-      P3_P = 0;
-      P3_F = 0;
-      P3_Z = 0;
-      SysMemory.begin("P3pos", false);                         //save to memory
-      SysMemory.putUInt("P3_T", mem0);
-      SysMemory.putUInt("P3_P", mem0);
-      SysMemory.putUInt("P3_F", mem0);
-      SysMemory.putUInt("P3_Z", mem0);
-      SysMemory.end();
-      break;
-    case 4:
-      P4_T = 0;
-      P4_P = 0;
-      P4_F = 0;
-      P4_Z = 0;
-      SysMemory.begin("P4pos", false);                         //save to memory
-      SysMemory.putUInt("P4_T", mem0);
-      SysMemory.putUInt("P4_P", mem0);
-      SysMemory.putUInt("P4_F", mem0);
-      SysMemory.putUInt("P4_Z", mem0);
-      SysMemory.end();
-      break;
-    case 5:
-      P5_T = 0;
-      P5_P = 0;
-      P5_F = 0;
-      P5_Z = 0;
-      SysMemory.begin("P5pos", false);                         //save to memory
-      SysMemory.putUInt("P5_T", mem0);
-      SysMemory.putUInt("P5_P", mem0);
-      SysMemory.putUInt("P5_F", mem0);
-      //SysMemory.putUInt("P5_Z",mem0);
-      SysMemory.end();
-      break;
-    case 6:
-      P6_T = 0;
-      P6_P = 0;
-      P6_F = 0;
-      P6_Z = 0;
-      SysMemory.begin("P6pos", false);                         //save to memory
-      SysMemory.putUInt("P6_T", mem0);
-      SysMemory.putUInt("P6_P", mem0);
-      SysMemory.putUInt("P6_F", mem0);
-      SysMemory.putUInt("P6_Z", mem0);
-      SysMemory.end();
-      break;
-    case 7:
-      P7_T = 0;
-      P7_P = 0;
-      P7_F = 0;
-      P7_Z = 0;
-      SysMemory.begin("P7pos", false);                         //save to memory
-      SysMemory.putUInt("P7_T", mem0);
-      SysMemory.putUInt("P7_P", mem0);
-      SysMemory.putUInt("P7_F", mem0);
-      SysMemory.putUInt("P7_Z", mem0);
-      SysMemory.end();
-      break;
-    case 8:
-      P8_T = 0;
-      P8_P = 0;
-      P8_F = 0;
-      P8_Z = 0;
-      SysMemory.begin("P8pos", false);                         //save to memory
-      SysMemory.putUInt("P8_T", mem0);
-      SysMemory.putUInt("P8_P", mem0);
-      SysMemory.putUInt("P8_F", mem0);
-      SysMemory.putUInt("P8_Z", mem0);
-      SysMemory.end();
-      break;
-    case 9:
-      P9_T = 0;
-      P9_P = 0;
-      P9_F = 0;
-      P9_Z = 0;
-      SysMemory.begin("P9pos", false);                         //save to memory
-      SysMemory.putUInt("P9_T", mem0);
-      SysMemory.putUInt("P9_P", mem0);
-      SysMemory.putUInt("P9_F", mem0);
-      SysMemory.putUInt("P9_Z", mem0);
-      SysMemory.end();
-      break;
-    case 10:
-      P10_T = 0;
-      P10_P = 0;
-      P10_F = 0;
-      P10_Z = 0;
-      SysMemory.begin("P10pos", false);                         //save to memory
-      SysMemory.putUInt("P10_T", mem0);
-      SysMemory.putUInt("P10_P", mem0);
-      SysMemory.putUInt("P10_F", mem0);
-      SysMemory.putUInt("P10_Z", mem0);
-      SysMemory.end();
-      break;
-    case 11:
-      P11_T = 0;
-      P11_P = 0;
-      P11_F = 0;
-      P11_Z = 0;
-      SysMemory.begin("P11pos", false);                         //save to memory
-      SysMemory.putUInt("P11_T", mem0);
-      SysMemory.putUInt("P11_P", mem0);
-      SysMemory.putUInt("P11_F", mem0);
-      SysMemory.putUInt("P11_Z", mem0);
-      SysMemory.end();
-      break;
-    case 12:
-      P12_T = 0;
-      P12_P = 0;
-      P12_F = 0;
-      P12_Z = 0;
-      SysMemory.begin("P12pos", false);                         //save to memory
-      SysMemory.putUInt("P12_T", mem0);
-      SysMemory.putUInt("P12_P", mem0);
-      SysMemory.putUInt("P12_F", mem0);
-      SysMemory.putUInt("P12_Z", mem0);
-      SysMemory.end();
-      break;
-    case 13:
-      P13_T = 0;
-      P13_P = 0;
-      P13_F = 0;
-      P13_Z = 0;
-      SysMemory.begin("P13pos", false);                         //save to memory
-      SysMemory.putUInt("P13_T", mem0);
-      SysMemory.putUInt("P13_P", mem0);
-      SysMemory.putUInt("P13_F", mem0);
-      SysMemory.putUInt("P13_Z", mem0);
-      SysMemory.end();
-      break;
-    case 14:
-      P14_T = 0;
-      P14_P = 0;
-      P14_F = 0;
-      P14_Z = 0;
-      SysMemory.begin("P14pos", false);                         //save to memory
-      SysMemory.putUInt("P14_T", mem0);
-      SysMemory.putUInt("P14_P", mem0);
-      SysMemory.putUInt("P14_F", mem0);
-      SysMemory.putUInt("P14_Z", mem0);
-      SysMemory.end();
-      break;
-    case 15:
-      P15_T = 0;
-      P15_P = 0;
-      P15_F = 0;
-      P15_Z = 0;
-      SysMemory.begin("P15pos", false);                         //save to memory
-      SysMemory.putUInt("P15_T", mem0);
-      SysMemory.putUInt("P15_P", mem0);
-      SysMemory.putUInt("P15_F", mem0);
-      SysMemory.putUInt("P15_Z", mem0);
-      SysMemory.end();
-      break;
-    case 16:
-      P16_T = 0;
-      P16_P = 0;
-      P16_F = 0;
-      P16_Z = 0;
-      SysMemory.begin("P16pos", false);                         //save to memory
-      SysMemory.putUInt("P16_T", mem0);
-      SysMemory.putUInt("P16_P", mem0);
-      SysMemory.putUInt("P16_F", mem0);
-      SysMemory.putUInt("P16_Z", mem0);
-      SysMemory.end();
-      break;
-
+  if (PTZ_Pose >= 1 && PTZ_Pose <= POSES) {
+    for (int i = 0; i < HEAD_AXES; i++) {
+      Pose[PTZ_Pose - 1][i] = 0;
+    }
+    StorePose(PTZ_Pose);
   }
 }
 
@@ -10048,20 +8651,20 @@ void VISCApose() {
 
 
 
-    stepper1->setSpeedInHz(TLTstep_speed);                     //Tilt
-    stepper1->setAcceleration(500);
+    stepper1->setSpeedInHz(limits.speed(AXIS_TILT, TLTstep_speed));                     //Tilt
+    stepper1->setAcceleration(limits.accel(AXIS_TILT, 500));
 
-    stepper2->setSpeedInHz(PANstep_speed);                     //Pan
-    stepper2->setAcceleration(1000);
+    stepper2->setSpeedInHz(limits.speed(AXIS_PAN, PANstep_speed));                     //Pan
+    stepper2->setAcceleration(limits.accel(AXIS_PAN, 1000));
 
-    stepper3->setSpeedInHz(FOCstep_speed);                     //Focus
-    stepper3->setAcceleration(1000);
+    stepper3->setSpeedInHz(limits.speed(AXIS_FOCUS, FOCstep_speed));                     //Focus
+    stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 1000));
 
     //stepper4->setSpeedInHz(50);                            //Zoom Fixed speed to prevent over speed
     //stepper4->setAcceleration(300);
 
-    stepper4->setSpeedInHz(ZOOMstep_speed / 4);                   //Matched speed Zoom removed to prevent zoom overspeed
-    stepper4->setAcceleration(500);
+    stepper4->setSpeedInHz(limits.speed(AXIS_ZOOM, ZOOMstep_speed / 4));                   //Matched speed Zoom removed to prevent zoom overspeed
+    stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 500));
 
     stepper1->moveTo(T_position);
     delay(10);
@@ -10084,6 +8687,107 @@ void VISCApose() {
 
 
 
+//******Absolute and relative moves received over UDP/TCP VISCA. Non blocking, all axes arrive at the same time*********
+void ViscaMoveTo(const ViscaMoveRequest &request) {
+  tour.stop();
+  lock.stop();
+  velocity.releaseAll();                                        //Take the steppers back from live control
+  digitalWrite(StepFOC, LOW);                                   //Power up the steppers
+  digitalWrite(StepD, LOW);
+  Joy_Pan_Speed = 0;                                            //A positioning move replaces any joystick drive
+  Joy_Tilt_Speed = 0;
+  Joy_Focus_Speed = 0;
+  Joy_Zoo_Speed = 0;
+  pan_is_moving = false;                                        //Keep PTZ_Control from braking the planned move
+  tilt_is_moving = false;
+  focus_is_moving = false;
+  Zoo_is_moving = false;
+
+  long T_target = stepper1->getCurrentPosition();
+  long P_target = stepper2->getCurrentPosition();
+  long F_target = stepper3->getCurrentPosition();
+  long Z_target = stepper4->getCurrentPosition();
+
+  if (request.pan_tilt) {                                       //VISCA tilt is reported inverted, see UDPViscaHandler::sendPositionPacket
+    if (request.relative) {
+      P_target += request.pan;
+      T_target -= request.tilt;
+    } else {
+      P_target = request.pan;
+      T_target = -request.tilt;
+    }
+    P_target = constrain(P_target, Forward_P_In, Forward_P_Out);
+    T_target = constrain(T_target, Forward_T_In, Forward_T_Out);
+  }
+  if (request.zoom) {                                           //VISCA 0x0000-0x4000 spans the set zoom limits
+    Z_target = cam_Z_In + ((long)(cam_Z_Out - cam_Z_In) * constrain(request.zoom_position, 0L, 0x4000L)) / 0x4000;
+  }
+  if (request.focus) {
+    F_target = cam_F_In + ((long)(cam_F_Out - cam_F_In) * constrain(request.focus_position, 0L, 0x4000L)) / 0x4000;
+  }
+
+  AxisMove moves[4] = {
+    {stepper1, T_target, limits.speed(AXIS_TILT, (uint32_t)constrain(request.tilt_speed, 1, 0x17) * 300), limits.accel(AXIS_TILT)},   //Same top speeds as the VISCA joystick drive
+    {stepper2, P_target, limits.speed(AXIS_PAN, (uint32_t)constrain(request.pan_speed, 1, 0x18) * 150), limits.accel(AXIS_PAN)},
+    {stepper3, F_target, limits.speed(AXIS_FOCUS, 3000), limits.accel(AXIS_FOCUS)},
+    {stepper4, Z_target, limits.speed(AXIS_ZOOM, 1000), limits.accel(AXIS_ZOOM)},                        //Zoom limited to prevent over speed on heavy zoom rings
+  };
+  for (int i = 0; i < 4; i++) {
+    backlash.takeUpTo(i, moves[i].stepper, moves[i].target);     //Before planning, so the slack is part of the distance
+  }
+  unsigned long duration = startCoordinatedMove(moves, 4, 0.5);
+  PA = (P_target / 22) / 2;
+  TA = T_target / 650;
+  logger.printf("\nVISCA move to P %ld T %ld F %ld Z %ld, planned %lu ms", P_target, T_target, F_target, Z_target, duration);
+}
+
+bool KnownPose(int pose) {
+  return (pose >= 1 && pose <= POSES) || pose == TOUR_START_POSE || pose == TOUR_STOP_POSE || pose == AUTOTUNE_POSE ||
+         pose == LOCK_MARK_POSE || pose == LOCK_START_POSE || pose == LOCK_STOP_POSE || pose == JIB_FOLLOW_POSE;
+}
+
+void RecallPose(int pose) {                                   //Pose recall from the browser UI, actioned by loop() like a controller request
+  if (KnownPose(pose)) {
+    PTZ_Pose = pose;
+  }
+}
+
+//VISCA memory recall. Autotune swings the axes to their limits, and target lock and jib follow take the head over
+//until told to stop, so stray presets 102-104 and 106 must not start them. Preset 105 stops the lock, which is harmless
+bool ViscaRecallPose(int pose) {
+  if (pose == AUTOTUNE_POSE || pose == LOCK_MARK_POSE || pose == LOCK_START_POSE || pose == JIB_FOLLOW_POSE || !KnownPose(pose)) {
+    return false;
+  }
+  PTZ_Pose = pose;
+  return true;
+}
+
+void TourStart() {
+  lock.stop();
+  velocity.releaseAll();                                        //Take the steppers back from live control
+  digitalWrite(StepFOC, LOW);                                   //Power up the steppers
+  digitalWrite(StepD, LOW);
+  pan_is_moving = false;                                        //Keep PTZ_Control from braking the tour
+  tilt_is_moving = false;
+  focus_is_moving = false;
+  Zoo_is_moving = false;
+  tour.start();
+}
+
+void SetTourStop(int index, int pose, uint32_t travel_ms, uint32_t dwell_ms, uint32_t blend) {   //index -1 clears the tour
+  tour.stop();
+  if (index < 0) {
+    tour.clear();
+  } else {
+    TourStop stop = {(uint8_t)pose, travel_ms, dwell_ms, blend};
+    if (!tour.setStop(index, stop)) {
+      logger.printf("\nTour stop %d rejected, pose %d travel %lu ms", index + 1, pose, (unsigned long)travel_ms);
+      return;
+    }
+  }
+  tour.save();
+}
+
 void saveIP() {
   logger.printf("Saving IP Adress: %d.%d.%d.%d %d\n", IP1, IP2, IP3, IP4, IPGW, UDP);
   SysMemory.begin("IPvalues", false);                         //save to memory
@@ -10098,19 +8802,22 @@ void saveIP() {
 
 void Home() {
   logger.print("Running HOME ");
+  tour.stop();
+  lock.stop();
+  velocity.releaseAll();
   digitalWrite(StepFOC, LOW);                                   //Power up the steppers
   digitalWrite(StepD, LOW);
-  stepper1->setSpeedInHz(5000);                                 //Tilt
-  stepper1->setAcceleration(2000);
+  stepper1->setSpeedInHz(limits.speed(AXIS_TILT, 5000));                                 //Tilt
+  stepper1->setAcceleration(limits.accel(AXIS_TILT, 2000));
 
-  stepper2->setSpeedInHz(1500);                                  //Pan
-  stepper2->setAcceleration(1000);
+  stepper2->setSpeedInHz(limits.speed(AXIS_PAN, 1500));                                  //Pan
+  stepper2->setAcceleration(limits.accel(AXIS_PAN, 1000));
 
-  stepper3->setSpeedInHz(2000);                                  //Focus
-  stepper3->setAcceleration(1000);
+  stepper3->setSpeedInHz(limits.speed(AXIS_FOCUS, 2000));                                  //Focus
+  stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 1000));
 
-  stepper4->setSpeedInHz(2000);                                  //Zoom
-  stepper4->setAcceleration(1000);
+  stepper4->setSpeedInHz(limits.speed(AXIS_ZOOM, 2000));                                  //Zoom
+  stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 1000));
 
 
   stepper1->moveTo(0);
@@ -10140,7 +8847,7 @@ bool calibrateStepperPosition(char* name,uint sensor, FastAccelStepper *stepper,
   while (digitalRead(sensor) == HIGH) {             // Make the Stepper move CCW until the switch is activated
     delay(20);   
     long currentPosition=stepper->getCurrentPosition();
-    long encoderPosition=encoder.getRawPosition();
+    long encoderPosition=encoder.readRawPosition();
     long delta=currentPosition-lastPosition;
     logger.printf("\nStepper %s pos %d (%d) corresponding encoder at %d",name, currentPosition,currentPosition-lastPosition, encoderPosition);
     lastPosition=currentPosition;
@@ -10172,10 +8879,193 @@ bool calibrateStepperPosition(char* name,uint sensor, FastAccelStepper *stepper,
   }                
 }
 
+void settleStepper(FastAccelStepper *stepper, long steps) {
+  stepper->move(steps);
+  delay(20);
+  while (stepper->isRunning()) {
+    delay(10);
+  }
+  delay(200);                                                   //Give the encoder task a few fresh readings
+}
+
+//Swings a geared axis back and forth and compares the steps sent with how far its encoder saw the load go.
+//Each reversal loses the slack, so the average shortfall is the backlash. Returns -1 if the encoder can not tell
+long measureBacklash(int axis) {
+  const char* name = HeadAxes[axis].name;
+  FastAccelStepper *stepper = axes[axis];
+  const long swing = 600;
+  const int reversals = 6;
+  if (HeadAxes[axis].encoder == NULL || !HeadAxes[axis].encoder->IsOperational()) {
+    logger.printf("\nNo %s encoder, backlash not measured", name);
+    return -1;
+  }
+  EncoderState &encoder = *HeadAxes[axis].encoder;
+  stepper->setSpeedInHz(800);
+  stepper->setAcceleration(2000);
+  settleStepper(stepper, swing);                                //Load the gears one way first
+  long last = encoder.get_sposition();
+  long lost = 0;
+  for (int i = 0; i < reversals; i++) {
+    settleStepper(stepper, i % 2 == 0 ? -swing : swing);
+    long now = encoder.get_sposition();
+    long moved = labs(now - last);
+    last = now;
+    if (moved < swing / 2 || moved > swing * 3 / 2) {
+      logger.printf("\n%s encoder saw %ld of %ld steps, backlash not measured", name, moved, swing);
+      settleStepper(stepper, i % 2 == 0 ? 0 : -swing);
+      return -1;
+    }
+    lost += swing - moved;
+  }
+  settleStepper(stepper, -swing);                               //Back where it started
+  long backlash_steps = max(lost / reversals, 0L);
+  logger.printf("\n%s backlash %ld steps", name, backlash_steps);
+  return backlash_steps;
+}
+
+void calibrateBacklash() {
+  for (int axis = AXIS_TILT; axis <= AXIS_PAN; axis++) {        //The geared axes
+    if (!backlash.isMeasured(axis)) {
+      long steps = measureBacklash(axis);
+      if (steps < 0) {                                          //Store no compensation rather than swing on every start
+        logger.printf("\n%s backlash stored as 0, clear the keys to measure again", HeadAxes[axis].name);
+        steps = 0;
+      }
+      backlash.set(axis, steps);
+      backlash.reset(axis, axes[axis], -1);
+    }
+  }
+}
+
+//Steps a tuning move may come up short before it counts as a stall, encoder noise and 2%
+long tuneTolerance(long steps) {
+  return 20 + labs(steps) / 50;
+}
+
+//Moves an axis from gears loaded the same way and returns how many steps the load fell short by, going by its
+//encoder. If it stalled the stepper is set back to where the encoder found it
+long tuneMove(FastAccelStepper *stepper, EncoderState &encoder, long steps, uint32_t speed, uint32_t accel) {
+  long start = stepper->getCurrentPosition();
+  long encoder_start = encoder.get_sposition();
+  stepper->setSpeedInHz(speed);
+  stepper->setAcceleration(accel);
+  settleStepper(stepper, steps);
+  long travelled = labs(encoder.get_sposition() - encoder_start);
+  long lost = labs(steps) - travelled;
+  if (lost > tuneTolerance(steps)) {
+    stepper->setCurrentPosition(start + (steps > 0 ? travelled : -travelled));
+  }
+  return lost;
+}
+
+//Slowly back to the low end of the test travel, then a short way up so the next test starts with the slack taken up
+void tuneStart(FastAccelStepper *stepper, long low, long preload) {
+  stepper->setSpeedInHz(1000);
+  stepper->setAcceleration(1000);
+  settleStepper(stepper, low - preload - stepper->getCurrentPosition());
+  settleStepper(stepper, preload);
+}
+
+//Drives an axis up its soft limit travel at rising speed, then at rising acceleration, until the encoder shows lost
+//steps. What still ran clean, less a margin, becomes the axis limit. A test that no longer fits in the travel ends
+//the search without a stall, which says nothing about where the limit is, so the stored limit is kept
+AxisLimit tuneAxis(int axis) {
+  const AxisDescriptor &d = HeadAxes[axis];
+  const char* name = d.name;
+  FastAccelStepper *stepper = axes[axis];
+  const uint32_t ceiling_hz = 40000;
+  const uint32_t ceiling_accel = 100000;
+  const int margin = 80;                                        //Percent of the stall speed and acceleration kept
+  AxisLimit tuned = {limits.speed(axis), limits.accel(axis)};
+  if (d.encoder == NULL || !d.encoder->IsOperational()) {
+    logger.printf("\nNo %s encoder, limits not tuned", name);
+    return tuned;
+  }
+  EncoderState &encoder = *d.encoder;
+  long home = stepper->getCurrentPosition();
+  long low = min(*d.limit_in, *d.limit_out) + 200;
+  long high = max(*d.limit_in, *d.limit_out) - 200;
+  long preload = backlash.steps(axis) + 50;
+  if (high - low < 1000) {
+    logger.printf("\n%s travel too short to tune", name);
+    return tuned;
+  }
+
+  uint32_t accel = limits.defaultLimit(axis).accel;
+  uint32_t good_speed = 0;
+  bool stalled = false;
+  for (uint32_t speed = 1000; speed <= ceiling_hz; speed = speed * 5 / 4) {
+    long steps = (long)((uint64_t)speed * speed / accel) + speed / 5;   //Both ramps and 200ms at speed
+    if (steps > high - low) break;
+    tuneStart(stepper, low, preload);
+    long lost = tuneMove(stepper, encoder, steps, speed, accel);
+    logger.printf("\n%s %lu Hz: %ld steps lost", name, (unsigned long)speed, lost);
+    if (lost > tuneTolerance(steps)) {
+      stalled = true;
+      break;
+    }
+    good_speed = speed;
+  }
+  if (good_speed == 0) {
+    logger.printf("\n%s lost steps at the slowest test, limits not tuned", name);
+    tuneStart(stepper, home, 0);
+    return tuned;
+  }
+  uint32_t test_speed = good_speed;                             //Acceleration is tested at the speed that will be used
+  if (stalled) {
+    tuned.speed_hz = good_speed * margin / 100;
+    test_speed = tuned.speed_hz;
+  } else {
+    logger.printf("\n%s ran clean up to %lu Hz, travel too short to find its speed limit", name, (unsigned long)good_speed);
+  }
+
+  uint32_t good_accel = 0;
+  stalled = false;
+  for (uint32_t test = 1000; test <= ceiling_accel; test = test * 3 / 2) {
+    long steps = (long)((uint64_t)test_speed * test_speed / test) + test_speed / 5;
+    if (steps > high - low) continue;                           //Low accelerations need more travel than there is
+    tuneStart(stepper, low, preload);
+    long lost = tuneMove(stepper, encoder, steps, test_speed, test);
+    logger.printf("\n%s %lu steps/s2: %ld steps lost", name, (unsigned long)test, lost);
+    if (lost > tuneTolerance(steps)) {
+      stalled = true;
+      break;
+    }
+    good_accel = test;
+  }
+  if (good_accel > 0 && stalled) {
+    tuned.accel = good_accel * margin / 100;
+  } else {
+    logger.printf("\n%s acceleration limit not found, kept", name);
+  }
+
+  tuneStart(stepper, home, 0);
+  backlash.reset(axis, stepper, -1);
+  logger.printf("\n%s tuned to %lu Hz, %lu steps/s2", name, (unsigned long)tuned.speed_hz, (unsigned long)tuned.accel);
+  return tuned;
+}
+
+//Pose request 103, from the controller or browser only. Tilt and pan get the fastest speed and acceleration they run without lost steps on this rig
+void autoTune() {
+  logger.println("Auto tuning tilt and pan");
+  lock.stop();
+  velocity.releaseAll();
+  digitalWrite(StepD, LOW);                                     //Power up the steppers
+  delay(20);
+  SetTallyLed(1);
+  calibrateBacklash();                                          //Slack is taken out of the results
+  limits.store(AXIS_TILT, tuneAxis(AXIS_TILT));
+  limits.store(AXIS_PAN, tuneAxis(AXIS_PAN));
+  SetTallyLed(0);
+  SendNextionValues();
+}
+
 void homeStepper() {
   SetTallyLed(1);
   bool tilt_ok=calibrateStepperPosition("Tilt", Hall_Tilt, stepper1, 1500, 700, 8000, -1900, T_);
   bool pan_ok=calibrateStepperPosition("Pan", Hall_Pan,  stepper2,  300, 300, 3000, -700, P_);
+  backlash.reset(AXIS_TILT, stepper1, -1);                          //Both homing runs end moving down
+  backlash.reset(AXIS_PAN, stepper2, -1);
   if (!tilt_ok || !pan_ok){
      SetTallyLed(3);
   }
@@ -10208,14 +9098,14 @@ void End_V_Limits() {
   digitalWrite(StepZOOM, LOW);
   digitalWrite(StepD, LOW);
   delay(20);
-  stepper3->setSpeedInHz(3000);
-  stepper3->setAcceleration(1000);
+  stepper3->setSpeedInHz(limits.speed(AXIS_FOCUS, 3000));
+  stepper3->setAcceleration(limits.accel(AXIS_FOCUS, 1000));
 
-  stepper4->setSpeedInHz(3000);
-  stepper4->setAcceleration(1000);
+  stepper4->setSpeedInHz(limits.speed(AXIS_ZOOM, 3000));
+  stepper4->setAcceleration(limits.accel(AXIS_ZOOM, 1000));
 
-  stepper1->setSpeedInHz(1500);
-  stepper1->setAcceleration(500);
+  stepper1->setSpeedInHz(limits.speed(AXIS_TILT, 1500));
+  stepper1->setAcceleration(limits.accel(AXIS_TILT, 500));
 
   stepper3->moveTo(cam_F_In);
   delay(10);
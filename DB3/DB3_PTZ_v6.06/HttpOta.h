@@ -0,0 +1,366 @@
+#ifndef HTTP_OTA_H
+#define HTTP_OTA_H
+
+#include <WebServer.h>
+#include <Update.h>
+#include <esp32/rom/miniz.h>                      // tinfl, the inflater in the ROM
+#include <esp_rom_crc.h>
+
+// Compressed, resumable firmware update over HTTP
+//
+// ArduinoOTA sends the whole uncompressed image in one go and starts over when the connection drops. Here the image
+// is PUT to /ota gzip compressed (a plain .bin is taken too), in as many pieces as the client likes, each carrying a
+// "Content-Range: bytes first-last/total" header. Every piece is inflated as it arrives and written straight into the
+// inactive partition, so neither image is ever held in RAM. The inflate state stays between requests: after a dropped
+// connection GET /ota tells the client how far it got and it goes on from there, a piece that does not start there
+// is answered 416 with that offset. Once the last byte is in, the gzip CRC and length, the MD5 given in X-Image-MD5
+// if any and the image itself are checked before the head boots into it. ota/ota_upload.py does all this for a list
+// of heads. The user is "ota", the password is the one of the access point and ArduinoOTA.
+class HttpOta {
+private:
+  static const size_t WINDOW_SIZE = TINFL_LZ_DICT_SIZE;  // Inflate output, also the dictionary, written out as it fills
+  static const unsigned long SESSION_TIMEOUT_MS = 600000; // An update left this long is dropped to free its buffers
+  static const uint8_t IMAGE_MAGIC = 0xE9;        // First byte of an uncompressed firmware image
+  static const uint8_t GZ_FHCRC = 0x02, GZ_FEXTRA = 0x04, GZ_FNAME = 0x08, GZ_FCOMMENT = 0x10;
+
+  enum class Stage { Idle, Header, Inflate, Trailer, Raw, Verified, Failed };
+
+  WebServer& server;
+  Logger& logger;
+  String password;
+  bool enabled;
+  Stage stage;
+  const char* error;
+  size_t received;                                // Bytes of the upload taken, where the next piece has to start
+  size_t total;                                   // Size of the upload from Content-Range
+  size_t written;                                 // Image bytes written to the partition
+  uint32_t crc;                                   // Of the image, as in the gzip trailer
+  tinfl_decompressor* inflator;
+  uint8_t* window;
+  size_t window_pos;
+  size_t header_pos;
+  uint8_t gz_flags;                               // Optional gzip header fields still to skip
+  uint8_t extra_len_bytes;
+  size_t skip;
+  uint8_t trailer[8];
+  size_t trailer_pos;
+  size_t piece_skip;                              // Start of the current piece we already have
+  int piece_status;                               // Answer to the current piece, 0 while it is being taken
+  unsigned long last_piece_ms;
+  unsigned long restart_at;
+
+  bool fail(const char* why) {
+    if (stage != Stage::Failed) {
+      logger.printf("\nOTA failed at %u bytes: %s", (unsigned)received, why);
+    }
+    error = why;
+    stage = Stage::Failed;
+    return false;
+  }
+
+  void release() {
+    free(inflator);
+    free(window);
+    inflator = NULL;
+    window = NULL;
+  }
+
+  void abort() {
+    if (Update.isRunning()) {
+      Update.abort();
+    }
+    release();
+    stage = Stage::Idle;
+  }
+
+  bool start(size_t size, const String& md5) {
+    abort();
+    received = 0;
+    total = size;
+    written = 0;
+    crc = 0;
+    error = "";
+    window_pos = 0;
+    header_pos = 0;
+    gz_flags = 0;
+    extra_len_bytes = 0;
+    skip = 0;
+    trailer_pos = 0;
+    if (!Update.begin(UPDATE_SIZE_UNKNOWN)) {
+      return fail(Update.errorString());
+    }
+    if (md5.length() == 32) {
+      Update.setMD5(md5.c_str());
+    }
+    stage = Stage::Header;
+    logger.printf("\nOTA started, %u bytes", (unsigned)total);
+    return true;
+  }
+
+  bool writeImage(uint8_t* data, size_t len) {
+    if (Update.write(data, len) != len) {
+      return fail(Update.errorString());
+    }
+    crc = esp_rom_crc32_le(crc, data, len);
+    written += len;
+    return true;
+  }
+
+  // One byte of the gzip header, true once the deflate data starts after it
+  bool headerByte(uint8_t b) {
+    static const uint8_t magic[3] = {0x1f, 0x8b, 8};   // gzip, deflate
+    if (header_pos < 10) {
+      if (header_pos < 3 && b != magic[header_pos]) {
+        return fail("not a gzip or firmware image");
+      }
+      if (header_pos == 3) {
+        gz_flags = b & (GZ_FHCRC | GZ_FEXTRA | GZ_FNAME | GZ_FCOMMENT);
+      }
+      header_pos++;
+    } else if (gz_flags & GZ_FEXTRA) {
+      if (extra_len_bytes < 2) {
+        skip |= (size_t)b << (8 * extra_len_bytes++);
+        if (extra_len_bytes == 2 && skip == 0) gz_flags &= ~GZ_FEXTRA;
+      } else if (--skip == 0) {
+        gz_flags &= ~GZ_FEXTRA;
+      }
+    } else if (gz_flags & GZ_FNAME) {
+      if (b == 0) gz_flags &= ~GZ_FNAME;
+    } else if (gz_flags & GZ_FCOMMENT) {
+      if (b == 0) gz_flags &= ~GZ_FCOMMENT;
+    } else if (gz_flags & GZ_FHCRC) {
+      if (++skip == 2) gz_flags &= ~GZ_FHCRC;
+    }
+    return header_pos == 10 && gz_flags == 0;
+  }
+
+  bool trailerByte(uint8_t b) {
+    if (trailer_pos < sizeof(trailer)) {
+      trailer[trailer_pos++] = b;
+    }
+    if (trailer_pos == sizeof(trailer)) {
+      uint32_t want_crc = trailer[0] | trailer[1] << 8 | trailer[2] << 16 | (uint32_t)trailer[3] << 24;
+      uint32_t want_size = trailer[4] | trailer[5] << 8 | trailer[6] << 16 | (uint32_t)trailer[7] << 24;
+      if (want_crc != crc || want_size != (uint32_t)written) {
+        return fail("gzip CRC or length mismatch");
+      }
+      stage = Stage::Verified;
+    }
+    return true;
+  }
+
+  bool inflate(const uint8_t*& data, size_t& len) {
+    while (true) {
+      size_t in = len;
+      size_t out = WINDOW_SIZE - window_pos;
+      tinfl_status status = tinfl_decompress(inflator, data, &in, window, window + window_pos, &out, TINFL_FLAG_HAS_MORE_INPUT);
+      data += in;
+      len -= in;
+      if (out > 0) {
+        if (!writeImage(window + window_pos, out)) return false;
+        window_pos = (window_pos + out) & (WINDOW_SIZE - 1);
+      }
+      if (status == TINFL_STATUS_DONE) {
+        // The ROM inflater may have read a few bytes past the end of the deflate data into its bit buffer, they
+        // are the start of the trailer. It only skips the padding up to the next byte boundary for a zlib stream,
+        // so drop it here or a last block ending mid-byte shifts every trailer byte
+        stage = Stage::Trailer;
+        inflator->m_bit_buf >>= (inflator->m_num_bits & 7);
+        inflator->m_num_bits &= ~7;
+        for (; inflator->m_num_bits >= 8; inflator->m_num_bits -= 8) {
+          trailerByte(inflator->m_bit_buf & 0xff);
+          inflator->m_bit_buf >>= 8;
+        }
+        return true;
+      }
+      if (status < 0) {
+        return fail("corrupt deflate data");
+      }
+      if (status == TINFL_STATUS_NEEDS_MORE_INPUT) {
+        return true;
+      }
+    }
+  }
+
+  void take(const uint8_t* data, size_t len) {
+    received += len;
+    while (len > 0 && stage != Stage::Failed) {
+      switch (stage) {
+        case Stage::Header:
+          if (header_pos == 0 && data[0] == IMAGE_MAGIC) {
+            stage = Stage::Raw;                   // Not compressed
+            break;
+          }
+          len--;
+          if (headerByte(*data++)) {
+            inflator = (tinfl_decompressor*)malloc(sizeof(tinfl_decompressor));
+            window = (uint8_t*)malloc(WINDOW_SIZE);
+            if (inflator == NULL || window == NULL) {
+              fail("out of memory");
+              break;
+            }
+            tinfl_init(inflator);
+            stage = Stage::Inflate;
+          }
+          break;
+        case Stage::Inflate:
+          inflate(data, len);
+          break;
+        case Stage::Trailer:
+          len--;
+          trailerByte(*data++);
+          break;
+        case Stage::Raw:
+          writeImage((uint8_t*)data, len);
+          len = 0;
+          break;
+        default:                                  // Anything after the trailer is ignored
+          len = 0;
+          break;
+      }
+    }
+    if (stage == Stage::Verified) {
+      release();
+    }
+  }
+
+  // Takes the image, true if the head is about to restart into it
+  bool finish() {
+    if (stage != Stage::Verified && stage != Stage::Raw) {
+      return fail("upload ended inside the image");
+    }
+    if (!Update.end(true)) {
+      return fail(Update.errorString());
+    }
+    release();
+    stage = Stage::Idle;
+    logger.printf("\nOTA done, %u bytes written, restarting", (unsigned)written);
+    restart_at = millis() + 1000;
+    return true;
+  }
+
+  const char* stageName() const {
+    switch (stage) {
+      case Stage::Header: return "header";
+      case Stage::Inflate: return "inflate";
+      case Stage::Trailer: return "trailer";
+      case Stage::Raw: return "raw";
+      case Stage::Verified: return "verified";
+      case Stage::Failed: return "failed";
+      default: return restart_at != 0 ? "restarting" : "idle";
+    }
+  }
+
+  void sendState(int code) {
+    char json[192];
+    snprintf(json, sizeof(json), "{\"state\":\"%s\",\"offset\":%u,\"total\":%u,\"written\":%u,\"error\":\"%s\"}",
+             stageName(), (unsigned)received, (unsigned)total, (unsigned)written, error);
+    server.send(code, "application/json", json);
+  }
+
+public:
+  HttpOta(WebServer& aserver, Logger& alogger)
+    : server(aserver), logger(alogger), enabled(false), stage(Stage::Idle), error(""), received(0), total(0),
+      written(0), crc(0), inflator(NULL), window(NULL), window_pos(0), piece_skip(0), piece_status(0),
+      last_piece_ms(0), restart_at(0) {
+  }
+
+  void begin(const String& apassword) {
+    password = apassword;
+    enabled = true;
+  }
+
+  void end() {
+    if (stage != Stage::Idle) {
+      logger.println("OTA update abandoned");
+    }
+    abort();
+    enabled = false;
+  }
+
+  // Body of a PUT /ota, called by the server for every buffer it reads
+  void handleRaw() {
+    HTTPRaw& raw = server.raw();
+    if (raw.status == RAW_START) {
+      piece_status = 0;
+      piece_skip = 0;
+      if (!enabled) {
+        piece_status = 403;
+        return;
+      }
+      if (!server.authenticate("ota", password.c_str())) {
+        piece_status = 401;
+        return;
+      }
+      unsigned first = 0, last = 0, size = raw.totalSize;
+      String range = server.header("Content-Range");
+      if (range.length() > 0 && sscanf(range.c_str(), "bytes %u-%u/%u", &first, &last, &size) != 3) {
+        piece_status = 400;
+        return;
+      }
+      if (first == 0) {
+        if (!start(size, server.header("X-Image-MD5"))) piece_status = 500;
+      } else if (stage == Stage::Idle || stage == Stage::Failed || size != total) {
+        piece_status = 409;                       // Nothing to resume, start again from 0
+      } else if (first > received) {
+        piece_status = 416;
+      } else {
+        piece_skip = received - first;
+      }
+      last_piece_ms = millis();
+    } else if (raw.status == RAW_WRITE && piece_status == 0) {
+      size_t skipped = piece_skip < raw.currentSize ? piece_skip : raw.currentSize;
+      piece_skip -= skipped;
+      take(raw.buf + skipped, raw.currentSize - skipped);
+      last_piece_ms = millis();
+    } else if (raw.status == RAW_ABORTED && piece_status == 0) {
+      logger.printf("\nOTA piece interrupted, %u of %u bytes taken", (unsigned)received, (unsigned)total);
+    }
+  }
+
+  // Answer to a PUT /ota once its body is in
+  void handlePut() {
+    if (piece_status == 401) {
+      server.requestAuthentication();
+      return;
+    }
+    if (piece_status != 0) {
+      sendState(piece_status);
+      return;
+    }
+    if (stage == Stage::Failed) {
+      sendState(500);
+      abort();
+      return;
+    }
+    if (received >= total && !finish()) {
+      sendState(500);
+      abort();
+      return;
+    }
+    sendState(200);
+  }
+
+  // Where to resume
+  void handleGet() {
+    if (!enabled) {
+      sendState(403);
+    } else if (!server.authenticate("ota", password.c_str())) {
+      server.requestAuthentication();
+    } else {
+      sendState(200);
+    }
+  }
+
+  void loop() {
+    if (restart_at != 0 && (long)(millis() - restart_at) >= 0) {
+      ESP.restart();
+    }
+    if (stage != Stage::Idle && millis() - last_piece_ms > SESSION_TIMEOUT_MS) {
+      logger.println("OTA update timed out");
+      abort();
+    }
+  }
+};
+
+#endif // HTTP_OTA_H
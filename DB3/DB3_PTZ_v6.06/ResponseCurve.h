@@ -0,0 +1,106 @@
+#ifndef RESPONSE_CURVE_H
+#define RESPONSE_CURVE_H
+
+// Joystick response curves for live control
+//
+// Every control source (ESP-NOW controller, serial/UDP/TCP VISCA, WebSocket) writes its command into the
+// Joy_*_Speed globals on the common per axis scale below. PTZ_Control turns the command into a step rate with
+// responseMilliHz(), so an operator gets the same feel whatever is driving the head. The curve tables are generated
+// by the compiler, the control loop only does a lookup and one interpolation.
+
+// Command full scale per axis, the value a source sends at full deflection
+static const int PAN_COMMAND_FULL = 3600;
+static const int TILT_COMMAND_FULL = 7200;
+static const int LENS_COMMAND_FULL = 5000;
+
+// Source ranges mapped onto the command scale. The ESP-NOW controller used to drive the steppers at one step/s per
+// stick count, so its full stick still tops out at these rates (see the Controller*Response curves in the sketch)
+static const int ESPNOW_PAN_FULL = 1024;           // The controller sends the pan stick halved or quartered
+static const int ESPNOW_STICK_FULL = 2048;         // 12 bit ADC minus the centre value
+static const int VISCA_PAN_SPEED_MAX = 0x18;
+static const int VISCA_TILT_SPEED_MAX = 0x17;
+
+enum CurveShape { CURVE_LINEAR, CURVE_EXPO, CURVE_S, CURVE_PRECISION };
+
+static const int CURVE_POINTS = 64;                // Table covers centre..full deflection in 64 steps
+static const int CURVE_OUT = 1000;                 // Table output in 1/1000 of the top speed
+
+// Shapes map 0..1 deflection to 0..1 speed. Kept to single expressions so they are constexpr under C++11
+constexpr float curveExpo(float x) { return 0.25f * x + 0.75f * x * x * x; }
+constexpr float curveS(float x) { return x * x * (3.0f - 2.0f * x); }
+constexpr float curvePrecision(float x) { return x < 0.4f ? x * 0.25f : 0.1f + (x - 0.4f) * 1.5f; }  // First 40% of travel gives 10% speed
+constexpr float curveValue(CurveShape shape, float x) {
+  return shape == CURVE_EXPO ? curveExpo(x) : shape == CURVE_S ? curveS(x) : shape == CURVE_PRECISION ? curvePrecision(x) : x;
+}
+
+struct CurveTable {
+  uint16_t value[CURVE_POINTS + 1];
+};
+
+template<int... I> struct CurveIndex {};
+template<int N, int... I> struct MakeCurveIndex : MakeCurveIndex<N - 1, N - 1, I...> {};
+template<int... I> struct MakeCurveIndex<0, I...> {
+  typedef CurveIndex<I...> type;
+};
+
+template<int... I>
+constexpr CurveTable buildCurveTable(CurveShape shape, CurveIndex<I...>) {
+  return CurveTable{{ (uint16_t)(curveValue(shape, (float)I / CURVE_POINTS) * CURVE_OUT + 0.5f)... }};
+}
+
+constexpr CurveTable makeCurveTable(CurveShape shape) {
+  return buildCurveTable(shape, MakeCurveIndex<CURVE_POINTS + 1>::type());
+}
+
+constexpr CurveTable LINEAR_CURVE = makeCurveTable(CURVE_LINEAR);
+constexpr CurveTable EXPO_CURVE = makeCurveTable(CURVE_EXPO);
+constexpr CurveTable S_CURVE = makeCurveTable(CURVE_S);
+constexpr CurveTable PRECISION_CURVE = makeCurveTable(CURVE_PRECISION);
+
+static_assert(EXPO_CURVE.value[0] == 0 && EXPO_CURVE.value[CURVE_POINTS] == CURVE_OUT, "Expo curve must span 0..full");
+static_assert(PRECISION_CURVE.value[CURVE_POINTS] == CURVE_OUT, "Precision curve must reach full speed");
+
+// Speed ranges picked with the master acceleration pot on the controller, top speed is divided by these
+static const int SPEED_RANGES = 5;
+static const uint8_t SPEED_RANGE_DIVISOR[SPEED_RANGES] = {14, 7, 5, 2, 1};
+
+struct AxisResponse {
+  const CurveTable* curve;
+  int deadband;                                    // Commands up to this are centre stick
+  int full_scale;                                  // Command at full deflection
+  uint32_t max_hz;                                 // Step rate at full deflection in the fastest range
+};
+
+inline int speedRange(int masterAccel) {
+  if (masterAccel < 1000) return 0;
+  if (masterAccel < 1500) return 1;
+  if (masterAccel < 2000) return 2;
+  if (masterAccel < 3000) return 3;
+  return 4;
+}
+
+// Step rate in mHz for a command, 0 inside the dead band. Direction is left to the caller
+inline uint32_t responseMilliHz(const AxisResponse& axis, int command, int range) {
+  int magnitude = abs(command);
+  if (magnitude <= axis.deadband) return 0;
+  if (magnitude > axis.full_scale) magnitude = axis.full_scale;
+  range = constrain(range, 0, SPEED_RANGES - 1);
+
+  // Position along the whole travel in 1/256 of a table step, the dead band only cuts the centre off
+  uint32_t pos = (uint32_t)magnitude * CURVE_POINTS * 256 / axis.full_scale;
+  int index = pos >> 8;
+  uint32_t permille = axis.curve->value[index];
+  if (index < CURVE_POINTS) {
+    permille += ((uint32_t)(axis.curve->value[index + 1] - axis.curve->value[index]) * (pos & 0xFF)) >> 8;
+  }
+  uint32_t mhz = (uint32_t)((uint64_t)axis.max_hz * 1000 * permille / CURVE_OUT / SPEED_RANGE_DIVISOR[range]);
+  return mhz < 1 ? 1 : mhz;
+}
+
+// Scale a source value with range -source_full..source_full onto the command scale
+inline int toCommand(int value, int source_full, int command_full) {
+  value = constrain(value, -source_full, source_full);
+  return (int)((long)value * command_full / source_full);
+}
+
+#endif // RESPONSE_CURVE_H
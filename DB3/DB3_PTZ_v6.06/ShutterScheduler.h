@@ -0,0 +1,154 @@
+#ifndef SHUTTER_SCHEDULER_H
+#define SHUTTER_SCHEDULER_H
+
+#include <esp_timer.h>
+
+// Camera shutter and record output
+//
+// pulse() raises the trigger line at once and a one-shot esp_timer drops it again after the width asked for, so a
+// record toggle no longer holds the control loop for 200 ms and a bulb exposure is timed to the microsecond instead
+// of by delay(). Pulses asked for while one is out are queued and fired one after another, MIN_GAP_MS apart so the
+// camera sees each release. The start and length of every pulse are logged from loop().
+class ShutterScheduler {
+public:
+  static const uint32_t MIN_GAP_MS = 200;         // Line low between queued pulses
+
+private:
+  static const int QUEUE = 8;
+
+  struct Exposure {
+    uint32_t number;
+    int64_t start_us;
+    uint32_t width_us;
+  };
+
+  uint8_t pin;
+  Logger& logger;
+  esp_timer_handle_t timer;
+  portMUX_TYPE lock;
+  uint32_t queued[QUEUE];                         // Widths waiting, in us
+  int queue_head;
+  int queue_count;
+  bool high;
+  bool waiting;                                   // In the gap after a pulse, the next starts when it ends
+  uint32_t exposures;
+  Exposure current;
+  Exposure done[QUEUE];                           // Finished pulses not logged yet
+  int done_count;
+  uint32_t dropped;                               // Pulses not fired, the queue was full
+  uint32_t unlogged;                              // Pulses fired but not logged, done[] was full
+
+  static void onTimer(void* arg) {
+    ((ShutterScheduler*)arg)->timerEnded();
+  }
+
+  // With the lock held
+  void startPulse(uint32_t width_us) {
+    digitalWrite(pin, HIGH);
+    high = true;
+    current = Exposure{++exposures, esp_timer_get_time(), width_us};
+    esp_timer_start_once(timer, width_us);
+  }
+
+  void timerEnded() {
+    portENTER_CRITICAL(&lock);
+    if (high) {
+      digitalWrite(pin, LOW);
+      high = false;
+      current.width_us = (uint32_t)(esp_timer_get_time() - current.start_us);
+      if (done_count < QUEUE) {
+        done[done_count++] = current;
+      } else {
+        unlogged++;
+      }
+      if (queue_count > 0) {
+        waiting = true;
+        esp_timer_start_once(timer, MIN_GAP_MS * 1000);
+      }
+    } else if (queue_count > 0) {
+      waiting = false;
+      uint32_t width_us = queued[queue_head];
+      queue_head = (queue_head + 1) % QUEUE;
+      queue_count--;
+      startPulse(width_us);
+    } else {
+      waiting = false;
+    }
+    portEXIT_CRITICAL(&lock);
+  }
+
+public:
+  ShutterScheduler(uint8_t apin, Logger& alogger)
+    : pin(apin), logger(alogger), timer(NULL), lock(portMUX_INITIALIZER_UNLOCKED), queue_head(0), queue_count(0),
+      high(false), waiting(false), exposures(0), done_count(0), dropped(0), unlogged(0) {
+  }
+
+  void begin() {
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, LOW);
+    esp_timer_create_args_t args = {};
+    args.callback = onTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "shutter";
+    esp_timer_create(&args, &timer);
+  }
+
+  // Fires the trigger for width_ms, right now if the line is free, otherwise once the pulses before it are done
+  void pulse(uint32_t width_ms) {
+    if (timer == NULL || width_ms == 0) return;
+    uint32_t width_us = width_ms * 1000;
+    portENTER_CRITICAL(&lock);
+    if (!high && !waiting && queue_count == 0) {
+      startPulse(width_us);
+    } else if (queue_count < QUEUE) {
+      queued[(queue_head + queue_count) % QUEUE] = width_us;
+      queue_count++;
+    } else {
+      dropped++;
+    }
+    portEXIT_CRITICAL(&lock);
+  }
+
+  // True while a pulse is out, waiting or queued
+  bool busy() {
+    portENTER_CRITICAL(&lock);
+    bool result = high || waiting || queue_count > 0;
+    portEXIT_CRITICAL(&lock);
+    return result;
+  }
+
+  // For the timelapse, which has to hold still until the shutter closed
+  void wait() {
+    while (busy()) {
+      delay(1);
+    }
+  }
+
+  void loop() {
+    Exposure finished[QUEUE];
+    portENTER_CRITICAL(&lock);
+    int count = done_count;
+    for (int i = 0; i < count; i++) {
+      finished[i] = done[i];
+    }
+    done_count = 0;
+    uint32_t lost = dropped;
+    dropped = 0;
+    uint32_t missed = unlogged;
+    unlogged = 0;
+    portEXIT_CRITICAL(&lock);
+    for (int i = 0; i < count; i++) {
+      logger.printf("\nExposure %lu at %lld us, %lu us", (unsigned long)finished[i].number, (long long)finished[i].start_us,
+                    (unsigned long)finished[i].width_us);
+    }
+    if (lost > 0) {
+      logger.printf("\nShutter queue full, %lu pulses dropped", (unsigned long)lost);
+    }
+    if (missed > 0) {
+      logger.printf("\n%lu more exposures fired but not logged", (unsigned long)missed);
+    }
+  }
+};
+
+#endif // SHUTTER_SCHEDULER_H
@@ -0,0 +1,418 @@
+#ifndef TARGET_LOCK_H
+#define TARGET_LOCK_H
+
+#include <FastAccelStepper.h>
+#include <Preferences.h>
+#include <esp_now.h>
+#include <esp_timer.h>
+#include "Axis.h"
+#include "AxisLimits.h"
+#include "VelocityController.h"
+
+// ESP-NOW messages between the head and the slider or jib, must match their sketches. They are sent to one peer
+// only, never broadcast, as older devices read any message as a struct_message
+#define SLIDER_SUBSCRIBE_TAG "SSUB"               // Head -> slider or jib, stream to me for the next 3s
+#define SLIDER_SAMPLE_TAG "SPOS"                  // Slider -> head
+#define JIB_SAMPLE_TAG "JPOS"                     // Jib -> head
+
+struct SliderSample {
+  char tag[4];
+  uint32_t sequence;
+  float position_mm;                              // Carriage position from home
+  float velocity_mm_s;                            // Signed, as the stepper is being driven
+};
+
+struct JibSample {
+  char tag[4];
+  uint32_t sequence;
+  float tilt_deg;                                 // Head tilt the jib's path asks for, up to a constant
+  float tilt_deg_s;
+};
+
+enum LockSource { LOCK_SLIDER = 0, LOCK_JIB, LOCK_SOURCES };
+
+// Point of interest lock
+//
+// Keeps the camera on one point in space while the head rides the slider. The slider streams its carriage position
+// at ~50Hz while it moves. A task polls at 200Hz, extrapolates the carriage to now and works out in closed form the
+// pan and tilt that look at the point from there, with their rates for the carriage speed. The rates go to the
+// velocity controller as feed forward, plus a small correction for the position error, so the head turns with the
+// slider instead of chasing it.
+//
+// The point is found from two marks. Frame the subject, mark(), move the slider at least 50mm, frame it again and
+// mark() again. The rail is the x axis and pan 0 has to look square across it, as it does when the head is mounted
+// straight on the carriage. The point is kept in the "TargetLock" namespace.
+//
+// On the Mini Jib the jib works out the compensation itself, as it knows its arm and path (JibHeadTilt() in the jib
+// sketch). It streams the tilt that holds the horizon or the target, and the head follows the changes in it from
+// where it was framed when the lock started. Pan is left alone, the arm only swings up and down.
+class TargetLock {
+private:
+  struct Mark {
+    float slider_mm;
+    long pan;
+    long tilt;
+  };
+
+  AxisSet<HEAD_AXES>& axes;
+  VelocityController& velocity;
+  const AxisLimits& limits;
+  float pan_steps_degree;
+  float tilt_steps_degree;
+  Logger& logger;
+  Preferences preferences;
+  TaskHandle_t task;
+  portMUX_TYPE lock;
+  uint8_t macs[LOCK_SOURCES][6];
+  bool known[LOCK_SOURCES];
+  volatile LockSource source;
+  uint32_t sample_sequence;                       // Latest from the source, with the time it came in
+  float sample_value;                             // Carriage mm or jib tilt degrees
+  float sample_rate;
+  int64_t sample_us;
+  uint32_t samples;
+  uint32_t samples_lost;
+  Mark marks[2];
+  int mark_count;
+  bool calibrated;
+  float target_x;                                 // mm along the rail, across it and above the tilt axis
+  float target_y;
+  float target_z;
+  bool origin_set;                                // Jib tilt and head tilt when following started
+  float origin_value;
+  long origin_tilt;
+  volatile bool running;
+  volatile bool in_tick;
+  volatile bool stale;                            // Slider went quiet, holding on its last position
+  bool reported_stale;
+  unsigned long subscribed_ms;
+  uint32_t ticks;
+  float max_pan_error;
+  float max_tilt_error;
+
+  static const uint32_t PERIOD_MS = 5;           // 200Hz
+  static const uint32_t SUBSCRIBE_MS = 1000;     // Renewed well inside the slider's 3s timeout
+  static const int64_t EXTRAPOLATE_US = 100000;  // Never guess further ahead than this
+  static const int64_t STALE_US = 500000;        // No sample for this long and the carriage is taken to have stopped
+  static constexpr float KP = 5.0f;              // Steps/s of correction per step of error, closes the gap in ~0.2s
+  static constexpr float DEADBAND_STEPS = 2.0f;  // Error left alone while the carriage stands still
+  static constexpr float MIN_BASELINE_MM = 50.0f;
+
+  static void taskEntry(void* parameter) {
+    ((TargetLock*)parameter)->run();
+  }
+
+  int64_t lastSampleUs() {
+    portENTER_CRITICAL(&lock);
+    int64_t at = sample_us;
+    portEXIT_CRITICAL(&lock);
+    return at;
+  }
+
+  static const char* sourceName(LockSource s) {
+    return s == LOCK_JIB ? "jib" : "slider";
+  }
+
+  void subscribe() {
+    portENTER_CRITICAL(&lock);
+    bool heard = known[source];
+    uint8_t mac[6];
+    memcpy(mac, macs[source], 6);
+    portEXIT_CRITICAL(&lock);
+    if (!heard) return;
+    if (!esp_now_is_peer_exist(mac)) {
+      esp_now_peer_info_t peer = {};
+      memcpy(peer.peer_addr, mac, 6);
+      esp_now_add_peer(&peer);
+    }
+    esp_now_send(mac, (const uint8_t*)SLIDER_SUBSCRIBE_TAG, 4);
+    subscribed_ms = millis();
+  }
+
+  // Slider position or jib tilt now, from the last sample and its rate
+  float sourceValue(float& rate) {
+    portENTER_CRITICAL(&lock);
+    float value = sample_value;
+    float r = sample_rate;
+    int64_t at = sample_us;
+    portEXIT_CRITICAL(&lock);
+    int64_t age = esp_timer_get_time() - at;
+    stale = age > STALE_US;
+    if (stale) {
+      rate = 0;
+      return value;
+    }
+    rate = r;
+    if (age > EXTRAPOLATE_US) age = EXTRAPOLATE_US;
+    return value + r * (age / 1000000.0f);
+  }
+
+  // Pan and tilt in steps that look at the target from carriage position s, and their rates in steps per mm of travel
+  void aim(float s, float& pan, float& tilt, float& pan_per_mm, float& tilt_per_mm) {
+    float dx = target_x - s;
+    float u = dx / target_y;
+    pan = degrees(atanf(u)) * pan_steps_degree;
+    pan_per_mm = degrees(-1.0f / (target_y * (1.0f + u * u))) * pan_steps_degree;
+    float d2 = dx * dx + target_y * target_y;
+    float d = sqrtf(d2);
+    tilt = degrees(atan2f(target_z, d)) * tilt_steps_degree;
+    tilt_per_mm = degrees(target_z * dx / (d * (d2 + target_z * target_z))) * tilt_steps_degree;
+  }
+
+  int32_t command(HeadAxis axis, float target, float feed_forward, float& max_error) {
+    float error = target - axes[axis]->getCurrentPosition();
+    if (fabsf(error) > max_error) max_error = fabsf(error);
+    if (feed_forward == 0 && fabsf(error) <= DEADBAND_STEPS) {
+      return 0;
+    }
+    return (int32_t)((feed_forward + KP * error) * 1000.0f);
+  }
+
+  // Tilt follows the jib's compensation from where the head was framed, pan holds
+  void followJib() {
+    float rate;
+    float value = sourceValue(rate);
+    if (!origin_set) {
+      if (stale) return;                          // Nothing from the jib yet
+      origin_value = value;
+      origin_tilt = axes[AXIS_TILT]->getCurrentPosition();
+      origin_set = true;
+    }
+    float tilt = origin_tilt + (value - origin_value) * tilt_steps_degree;
+    velocity.setTarget(AXIS_PAN, 0, limits.accel(AXIS_PAN));
+    velocity.setTarget(AXIS_TILT, command(AXIS_TILT, tilt, rate * tilt_steps_degree, max_tilt_error), limits.accel(AXIS_TILT));
+    ticks++;
+  }
+
+  void tick() {
+    if (source == LOCK_JIB) {
+      followJib();
+      return;
+    }
+    float v;
+    float s = sourceValue(v);
+    float pan, tilt, pan_per_mm, tilt_per_mm;
+    aim(s, pan, tilt, pan_per_mm, tilt_per_mm);
+    velocity.setTarget(AXIS_PAN, command(AXIS_PAN, pan, pan_per_mm * v, max_pan_error), limits.accel(AXIS_PAN));
+    velocity.setTarget(AXIS_TILT, command(AXIS_TILT, tilt, tilt_per_mm * v, max_tilt_error), limits.accel(AXIS_TILT));
+    ticks++;
+  }
+
+  void run() {
+    TickType_t last_wake = xTaskGetTickCount();
+    for (;;) {
+      vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(PERIOD_MS));
+      in_tick = true;
+      if (running) {
+        tick();
+      }
+      in_tick = false;
+    }
+  }
+
+  // Closed form from two bearings taken off the rail: x - s = y·tan(pan) at both marks
+  bool solve() {
+    const Mark& a = marks[0];
+    const Mark& b = marks[1];
+    if (fabsf(b.slider_mm - a.slider_mm) < MIN_BASELINE_MM) {
+      logger.printf("\nTarget lock marks only %.0f mm apart, move the slider further", fabsf(b.slider_mm - a.slider_mm));
+      return false;
+    }
+    float tan_a = tanf(radians(a.pan / pan_steps_degree));
+    float tan_b = tanf(radians(b.pan / pan_steps_degree));
+    if (fabsf(tan_a - tan_b) < 0.01f) {
+      logger.print("\nTarget lock marks look the same way, the target is too far away to place");
+      return false;
+    }
+    float y = (b.slider_mm - a.slider_mm) / (tan_a - tan_b);
+    float x = a.slider_mm + y * tan_a;
+    float da = sqrtf((x - a.slider_mm) * (x - a.slider_mm) + y * y);
+    float db = sqrtf((x - b.slider_mm) * (x - b.slider_mm) + y * y);
+    float z = (da * tanf(radians(a.tilt / tilt_steps_degree)) + db * tanf(radians(b.tilt / tilt_steps_degree))) / 2;
+    target_x = x;
+    target_y = y;
+    target_z = z;
+    calibrated = true;
+    logger.printf("\nTarget lock point at %.0f mm along the rail, %.0f mm across, %.0f mm up", x, y, z);
+    return true;
+  }
+
+  void logStats() {
+    if (ticks == 0) return;
+    logger.printf("\nTarget lock: %lu ticks, %lu %s samples, %lu lost, max error pan %.0f tilt %.0f steps",
+                  (unsigned long)ticks, (unsigned long)samples, sourceName(source), (unsigned long)samples_lost, max_pan_error, max_tilt_error);
+  }
+
+public:
+  TargetLock(AxisSet<HEAD_AXES>& aaxes, VelocityController& avelocity, const AxisLimits& alimits, float apan_steps_degree,
+             float atilt_steps_degree, Logger& alogger)
+    : axes(aaxes), velocity(avelocity), limits(alimits), pan_steps_degree(apan_steps_degree), tilt_steps_degree(atilt_steps_degree),
+      logger(alogger), task(NULL), lock(portMUX_INITIALIZER_UNLOCKED), source(LOCK_SLIDER), sample_sequence(0), sample_value(0),
+      sample_rate(0), sample_us(0), samples(0), samples_lost(0), mark_count(0), calibrated(false), target_x(0), target_y(0),
+      target_z(0), origin_set(false), origin_value(0), origin_tilt(0), running(false), in_tick(false),
+      stale(true), reported_stale(false), subscribed_ms(0), ticks(0), max_pan_error(0), max_tilt_error(0) {
+    for (int i = 0; i < LOCK_SOURCES; i++) {
+      known[i] = false;
+    }
+  }
+
+  void load() {
+    preferences.begin("TargetLock", true);
+    calibrated = preferences.getBool("valid", false);
+    target_x = preferences.getFloat("x", 0);
+    target_y = preferences.getFloat("y", 0);
+    target_z = preferences.getFloat("z", 0);
+    preferences.end();
+    if (calibrated) {
+      logger.printf("\nTarget lock point at %.0f mm along the rail, %.0f mm across, %.0f mm up", target_x, target_y, target_z);
+    }
+  }
+
+  void begin() {
+    xTaskCreatePinnedToCore(taskEntry, "TargetLock", 4096, this, 2, &task, 1);
+  }
+
+  // From the ESP-NOW receive callback, for every struct_message the slider or jib sent
+  void heard(LockSource from, const uint8_t* mac) {
+    portENTER_CRITICAL(&lock);
+    memcpy(macs[from], mac, 6);
+    known[from] = true;
+    portEXIT_CRITICAL(&lock);
+  }
+
+  // From the ESP-NOW receive callback. True if the message was a slider or jib sample and has been taken
+  bool receive(const uint8_t* data, int len) {
+    LockSource from;
+    if (len == sizeof(SliderSample) && memcmp(data, SLIDER_SAMPLE_TAG, 4) == 0) {
+      from = LOCK_SLIDER;
+    } else if (len == sizeof(JibSample) && memcmp(data, JIB_SAMPLE_TAG, 4) == 0) {
+      from = LOCK_JIB;
+    } else {
+      return false;
+    }
+    if (from != source) {
+      return true;                                // Left over from before a switch of source
+    }
+    uint32_t sequence;
+    float value, rate;
+    if (from == LOCK_SLIDER) {
+      const SliderSample* s = (const SliderSample*)data;
+      sequence = s->sequence;
+      value = s->position_mm;
+      rate = s->velocity_mm_s;
+    } else {
+      const JibSample* j = (const JibSample*)data;
+      sequence = j->sequence;
+      value = j->tilt_deg;
+      rate = j->tilt_deg_s;
+    }
+    portENTER_CRITICAL(&lock);
+    if (samples > 0 && sequence > sample_sequence + 1) {
+      samples_lost += sequence - sample_sequence - 1;
+    }
+    sample_sequence = sequence;
+    sample_value = value;
+    sample_rate = rate;
+    sample_us = esp_timer_get_time();
+    samples++;
+    portEXIT_CRITICAL(&lock);
+    return true;
+  }
+
+  // Records where the head looks from the current carriage position. Solves for the target once there are two
+  bool mark() {
+    if (running && source != LOCK_SLIDER) {
+      logger.print("\nTarget lock mark ignored while following the jib");
+      return false;
+    }
+    source = LOCK_SLIDER;
+    if (!known[LOCK_SLIDER]) {
+      logger.print("\nTarget lock mark ignored, no slider heard yet");
+      return false;
+    }
+    int64_t asked = esp_timer_get_time();
+    subscribe();
+    while (lastSampleUs() < asked && esp_timer_get_time() - asked < 500000) {
+      delay(10);                                  // The slider answers a subscription with a sample straight away
+    }
+    if (lastSampleUs() < asked) {
+      logger.print("\nTarget lock mark ignored, the slider did not answer");
+      return false;
+    }
+    float v;
+    Mark m = {sourceValue(v), axes[AXIS_PAN]->getCurrentPosition(), axes[AXIS_TILT]->getCurrentPosition()};
+    marks[0] = marks[1];                          // Two most recent marks, so a bad one is fixed by marking again
+    marks[1] = m;
+    if (mark_count < 2) mark_count++;
+    logger.printf("\nTarget lock mark at %.0f mm, pan %ld tilt %ld", m.slider_mm, m.pan, m.tilt);
+    if (mark_count < 2 || !solve()) {
+      return false;
+    }
+    preferences.begin("TargetLock", false);
+    preferences.putBool("valid", true);
+    preferences.putFloat("x", target_x);
+    preferences.putFloat("y", target_y);
+    preferences.putFloat("z", target_z);
+    preferences.end();
+    return true;
+  }
+
+  bool start(LockSource from) {
+    stop();
+    if (from == LOCK_SLIDER && !calibrated) {
+      logger.print("\nTarget lock has no point yet, mark it from two slider positions first");
+      return false;
+    }
+    if (!known[from]) {
+      logger.printf("\nTarget lock needs the %s, none heard yet", sourceName(from));
+      return false;
+    }
+    source = from;
+    origin_set = false;
+    portENTER_CRITICAL(&lock);
+    sample_us = 0;                                // Nothing from before counts, it may be from the other source
+    portEXIT_CRITICAL(&lock);
+    subscribe();
+    ticks = 0;
+    samples = 0;
+    samples_lost = 0;
+    max_pan_error = 0;
+    max_tilt_error = 0;
+    reported_stale = false;
+    running = true;
+    logger.printf("\nTarget lock on, following the %s", sourceName(from));
+    return true;
+  }
+
+  // Lets the axes ramp down through the velocity controller
+  void stop() {
+    if (!running) return;
+    running = false;
+    while (in_tick) {
+      vTaskDelay(1);                              // So the task cannot set one more target after ours
+    }
+    velocity.setTarget(AXIS_PAN, 0, limits.accel(AXIS_PAN));
+    velocity.setTarget(AXIS_TILT, 0, limits.accel(AXIS_TILT));
+    logStats();
+    logger.print("\nTarget lock off");
+  }
+
+  bool isRunning() {
+    return running;
+  }
+
+  // Keeps the slider or jib streaming while the lock is on
+  void loop() {
+    if (!running) return;
+    if (millis() - subscribed_ms >= SUBSCRIBE_MS) {
+      subscribe();
+    }
+    if (stale != reported_stale && ticks > 0) {
+      reported_stale = stale;
+      logger.printf(reported_stale ? "\nTarget lock lost the %s, holding on its last position" : "\nTarget lock has the %s again",
+                    sourceName(source));
+    }
+  }
+};
+
+#endif // TARGET_LOCK_H
@@ -0,0 +1,209 @@
+#ifndef TOUR_ENGINE_H
+#define TOUR_ENGINE_H
+
+#include <FastAccelStepper.h>
+#include <Preferences.h>
+#include "Axis.h"
+#include "Backlash.h"
+#include "AxisLimits.h"
+
+// One stop of a preset tour
+struct TourStop {
+  uint8_t pose;                                   // Stored pose to visit, 1 based
+  uint32_t travel_ms;                             // Time to get here from the previous stop
+  uint32_t dwell_ms;                              // Time to hold here, 0 blends into the next leg
+  uint32_t blend;                                 // Steps short of the stop at which the next leg takes over, 0 always stops
+};
+
+// Preset tour
+//
+// Runs an ordered list of stored poses round and round without a controller. start() plans every leg up front into
+// a queue, per axis target, cruise speed and ramp so all axes arrive together after the leg's travel time. run() is
+// polled from loop() and only walks the queue. A stop without dwell and with a blend radius hands over to the next
+// leg while the head is still moving; FastAccelStepper retargets the running ramp, so the head flows through it.
+class TourEngine {
+public:
+  static const int MAX_STOPS = 16;
+
+private:
+  struct TourLeg {
+    long target[HEAD_AXES];
+    uint32_t speed_mhz[HEAD_AXES];                // 0 if the axis does not move on this leg
+    uint32_t accel[HEAD_AXES];
+  };
+  enum TourState { TOUR_IDLE, TOUR_MOVING, TOUR_DWELL };
+
+  AxisSet<HEAD_AXES>& axes;
+  BacklashCompensator& backlash;
+  const AxisLimits& limits;
+  int (*poses)[HEAD_AXES];
+  int pose_count;
+  Logger& logger;
+  Preferences preferences;
+  TourStop stops[MAX_STOPS];
+  TourLeg legs[MAX_STOPS];
+  int count;
+  int current;
+  TourState state;
+  unsigned long dwell_start_ms;
+  uint32_t laps;
+
+  static constexpr float RAMP_FRACTION = 0.25f;   // Share of a leg's travel time spent on each ramp
+  static const uint32_t MIN_TRAVEL_MS = 500;
+
+  // Trapezoid over travel time T with ramps of r = T/4: cruise v = d/(T-r) and accel v/r finish in exactly T
+  void planLeg(int index, const long* from) {
+    TourLeg& leg = legs[index];
+    float travel = stops[index].travel_ms / 1000.0f;
+    for (int i = 0; i < HEAD_AXES; i++) {         // A leg that would ask more of an axis than its limits takes longer
+      long dist = labs(poses[stops[index].pose - 1][i] - from[i]);
+      float by_speed = dist / ((1.0f - RAMP_FRACTION) * limits.speed(i));
+      float by_accel = sqrtf(dist / ((1.0f - RAMP_FRACTION) * RAMP_FRACTION * limits.accel(i)));
+      travel = max(travel, max(by_speed, by_accel));
+    }
+    float ramp = travel * RAMP_FRACTION;
+    for (int i = 0; i < HEAD_AXES; i++) {
+      leg.target[i] = poses[stops[index].pose - 1][i];
+      long dist = labs(leg.target[i] - from[i]);
+      if (dist == 0) {
+        leg.speed_mhz[i] = 0;
+        leg.accel[i] = 0;
+        continue;
+      }
+      float speed = dist / (travel - ramp);
+      leg.speed_mhz[i] = max((uint32_t)(speed * 1000), (uint32_t)1000);
+      leg.accel[i] = max((uint32_t)(speed / ramp), (uint32_t)1);
+    }
+  }
+
+  void startLeg(int index) {
+    const TourLeg& leg = legs[index];
+    for (int i = 0; i < HEAD_AXES; i++) {
+      if (axes[i] == NULL || leg.speed_mhz[i] == 0) continue;
+      axes[i]->setSpeedInMilliHz(leg.speed_mhz[i]);
+      axes[i]->setAcceleration(leg.accel[i]);
+      backlash.takeUpTo(i, axes[i], leg.target[i]);
+      axes[i]->moveTo(leg.target[i]);
+    }
+    current = index;
+    state = TOUR_MOVING;
+  }
+
+  // Largest distance any axis still has to go to the current stop
+  long remaining() {
+    long furthest = 0;
+    for (int i = 0; i < HEAD_AXES; i++) {
+      if (axes[i] == NULL) continue;
+      long dist = labs(legs[current].target[i] - axes[i]->getCurrentPosition());
+      if (dist > furthest) furthest = dist;
+    }
+    return furthest;
+  }
+
+  void advance() {
+    int next = (current + 1) % count;
+    if (next == 0) {
+      laps++;
+      planLeg(0, legs[count - 1].target);         // The first leg was planned from wherever the head started
+    }
+    startLeg(next);
+  }
+
+public:
+  TourEngine(AxisSet<HEAD_AXES>& aaxes, BacklashCompensator& abacklash, const AxisLimits& alimits, int (*aposes)[HEAD_AXES],
+             int apose_count, Logger& alogger)
+    : axes(aaxes), backlash(abacklash), limits(alimits), poses(aposes), pose_count(apose_count), logger(alogger), count(0), current(0), state(TOUR_IDLE),
+      dwell_start_ms(0), laps(0) {
+  }
+
+  bool isRunning() const {
+    return state != TOUR_IDLE;
+  }
+
+  int stopCount() const {
+    return count;
+  }
+
+  // Sets stop index, or appends when index is the current count. The tour must not be running
+  bool setStop(int index, const TourStop& stop) {
+    if (isRunning() || index < 0 || index > count || index >= MAX_STOPS) return false;
+    if (stop.pose < 1 || stop.pose > pose_count || stop.travel_ms < MIN_TRAVEL_MS) return false;
+    stops[index] = stop;
+    if (index == count) count++;
+    return true;
+  }
+
+  void clear() {
+    if (isRunning()) return;
+    count = 0;
+  }
+
+  void load() {
+    preferences.begin("tour", true);
+    count = preferences.getUChar("count", 0);
+    if (count > MAX_STOPS || preferences.getBytes("stops", stops, sizeof(stops)) != count * sizeof(TourStop)) {
+      count = 0;
+    }
+    preferences.end();
+    logger.printf("\nTour with %d stops loaded", count);
+  }
+
+  void save() {
+    preferences.begin("tour", false);
+    preferences.putUChar("count", count);
+    preferences.putBytes("stops", stops, count * sizeof(TourStop));
+    preferences.end();
+  }
+
+  bool start() {
+    if (count == 0) {
+      logger.println("Tour has no stops");
+      return false;
+    }
+    long from[HEAD_AXES];
+    for (int i = 0; i < HEAD_AXES; i++) {
+      from[i] = axes[i] != NULL ? axes[i]->getCurrentPosition() : 0;
+    }
+    planLeg(0, from);
+    for (int i = 1; i < count; i++) {
+      planLeg(i, legs[i - 1].target);
+    }
+    laps = 0;
+    startLeg(0);
+    logger.printf("\nTour started, %d stops", count);
+    return true;
+  }
+
+  // Ramps every axis down where it is
+  void stop() {
+    if (!isRunning()) return;
+    for (int i = 0; i < HEAD_AXES; i++) {
+      if (axes[i] != NULL) axes[i]->stopMove();
+    }
+    state = TOUR_IDLE;
+    logger.printf("\nTour stopped at stop %d after %lu laps", current + 1, (unsigned long)laps);
+  }
+
+  // Polled from loop()
+  void run() {
+    if (state == TOUR_IDLE) return;
+    const TourStop& stop = stops[current];
+    if (state == TOUR_DWELL) {
+      if (millis() - dwell_start_ms >= stop.dwell_ms) advance();
+      return;
+    }
+    if (stop.dwell_ms == 0 && stop.blend > 0 && count > 1) {
+      if (remaining() <= (long)stop.blend) advance();
+      return;
+    }
+    if (axes.isRunning()) return;
+    if (stop.dwell_ms > 0) {
+      state = TOUR_DWELL;
+      dwell_start_ms = millis();
+      return;
+    }
+    advance();
+  }
+};
+
+#endif // TOUR_ENGINE_H
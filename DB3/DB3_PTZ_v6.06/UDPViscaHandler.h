@@ -2,11 +2,47 @@
 #define UDP_PACKET_HANDLER_H
 
 #include <WiFiUdp.h>
+#include <WiFi.h>
+#include <Preferences.h>
+
+// Absolute or relative positioning request decoded from VISCA, in VISCA units
+// (pan/tilt as reported by the position inquiry, zoom/focus 0x0000-0x4000)
+struct ViscaMoveRequest {
+  bool relative;
+  bool pan_tilt;
+  bool zoom;
+  bool focus;
+  long pan;
+  long tilt;
+  long zoom_position;
+  long focus_position;
+  uint8_t pan_speed;                              // VISCA speed bytes 0x01-0x18 / 0x01-0x17
+  uint8_t tilt_speed;
+};
+
+// One entry per control surface (OBS, vMix, Companion...) talking to the head, keyed by its UDP endpoint
+// or by its TCP connection
+struct ViscaSession {
+  bool in_use;
+  IPAddress ip;
+  uint16_t port;
+  int8_t tcp_slot;              // Index of the TCP connection, -1 for UDP clients
+  bool sony_framing;            // Client wraps VISCA in the 8 byte Sony VISCA over IP header
+  uint32_t last_sequence;       // Last sequence number received from this client (Sony framing only)
+  uint8_t priority;             // Higher priority clients may take control from lower ones at any time
+  uint32_t packets_received;
+  uint32_t packets_rejected;    // Drive commands refused because another client owns control
+  uint32_t duplicates;          // Retransmitted sequence numbers that were dropped
+  uint32_t replies_sent;
+  unsigned long last_seen_ms;
+};
 
 class UDPViscaHandler {
 private:
   WiFiUDP udp;
+  WiFiServer tcpServer;
   Logger& logger;
+  Preferences preferences;
   // Pointers to global variables
   int* pJoy_Pan_Speed;
   int* pJoy_Pan_Accel;
@@ -15,37 +51,372 @@ private:
   void (*pHome)();
   void (*pStop)();
   uint16_t (*pGetUdpViscaPort)();
+  void (*pMoveTo)(const ViscaMoveRequest&);
+  bool (*pRecallPose)(int);                      // False if the pose may not be recalled over VISCA
   FastAccelStepper *stepper1;
   FastAccelStepper *stepper2;
+  FastAccelStepper *stepper3;
+  FastAccelStepper *stepper4;
   // Buffer for incoming packets
   uint8_t packetBuffer[255];
   
+  static const int MAX_SESSIONS = 8;
+  static const int MAX_PRIORITY_RULES = 4;
+  static const uint8_t DEFAULT_PRIORITY = 1;
+  static const int SONY_HEADER_SIZE = 8;
+  static const int MAX_TCP_CLIENTS = 4;
+  static const uint16_t TCP_PORT = 5678;
+  static const int TCP_BUFFER_SIZE = 64;
+
+  // Persistent TCP connections, bytes are reassembled per connection until a full VISCA message is available
+  struct TcpConnection {
+    WiFiClient client;
+    ViscaSession* session;
+    uint8_t buffer[TCP_BUFFER_SIZE];
+    int length;
+  };
+  TcpConnection tcp[MAX_TCP_CLIENTS];
+
+  ViscaSession sessions[MAX_SESSIONS];
+  ViscaSession* owner;          // Session currently driving the head
+  unsigned long owner_last_ms;  // Last drive command from the owner
+  bool owner_released;          // Owner sent a stop, anyone may take over
+  ViscaSession* pending_move;   // Session waiting for the Completion of a positioning move
+  ViscaMoveRequest pending_request;
+  // Configurable priorities per client IP, everybody else gets DEFAULT_PRIORITY
+  uint32_t priority_ip[MAX_PRIORITY_RULES];
+  uint8_t priority_level[MAX_PRIORITY_RULES];
+  unsigned long takeover_timeout_ms;
+
+  uint8_t priorityFor(const IPAddress& ip) {
+    for (int i = 0; i < MAX_PRIORITY_RULES; i++) {
+      if (priority_ip[i] != 0 && priority_ip[i] == (uint32_t)ip) {
+        return priority_level[i];
+      }
+    }
+    return DEFAULT_PRIORITY;
+  }
+
+  ViscaSession* findSession(const IPAddress& ip, uint16_t port, int8_t tcp_slot) {
+    ViscaSession* oldest = NULL;
+    for (int i = 0; i < MAX_SESSIONS; i++) {
+      ViscaSession& s = sessions[i];
+      if (s.in_use && s.ip == ip && s.port == port && s.tcp_slot == tcp_slot) {
+        return &s;
+      }
+      if (s.in_use && s.tcp_slot >= 0) {
+        continue;                                     // Sessions of open TCP connections are never recycled
+      }
+      if (oldest == NULL || !s.in_use || (oldest->in_use && s.last_seen_ms < oldest->last_seen_ms)) {
+        oldest = &s;
+      }
+    }
+    if (oldest == NULL) {
+      logger.printf("\nVisca session table full of TCP connections, refusing %s:%d", ip.toString().c_str(), port);
+      return NULL;
+    }
+    // New client, recycle a free or the least recently seen slot
+    if (oldest->in_use) {
+      logger.printf("\nUDP Visca session table full, dropping %s:%d", oldest->ip.toString().c_str(), oldest->port);
+    }
+    if (owner == oldest) {
+      owner = NULL;
+    }
+    if (pending_move == oldest) {
+      pending_move = NULL;
+    }
+    memset(oldest, 0, sizeof(ViscaSession));
+    oldest->in_use = true;
+    oldest->ip = ip;
+    oldest->port = port;
+    oldest->tcp_slot = tcp_slot;
+    oldest->priority = priorityFor(ip);
+    logger.printf("\nVisca new %s session %s:%d priority %d", tcp_slot >= 0 ? "TCP" : "UDP", ip.toString().c_str(), port, oldest->priority);
+    return oldest;
+  }
+
+  // Decides if the current session may drive the head, conflicting surfaces are refused instead of interleaved
+  bool acquireControl(ViscaSession& s) {
+    if (owner == &s) {
+      return true;
+    }
+    unsigned long now = millis();
+    if (owner == NULL || owner_released || (now - owner_last_ms) > takeover_timeout_ms || s.priority > owner->priority) {
+      if (owner != NULL) {
+        logger.printf("\nUDP Visca control taken over by %s:%d from %s:%d", s.ip.toString().c_str(), s.port, owner->ip.toString().c_str(), owner->port);
+      }
+      owner = &s;
+      return true;
+    }
+    return false;
+  }
+
+  // Sends one reply to the session over the transport it used, header may be NULL for raw VISCA
+  void transmit(ViscaSession& s, const uint8_t* header, int headerLen, const uint8_t* data, int len) {
+    if (s.tcp_slot >= 0) {
+      WiFiClient& client = tcp[s.tcp_slot].client;
+      if (header != NULL) {
+        uint8_t frame[SONY_HEADER_SIZE + 16];         // One write per reply so TCP_NODELAY sends a single segment
+        memcpy(frame, header, headerLen);
+        memcpy(frame + headerLen, data, len);
+        client.write(frame, headerLen + len);
+      } else {
+        client.write(data, len);
+      }
+    } else {
+      udp.beginPacket(s.ip, s.port);
+      if (header != NULL) {
+        udp.write(header, headerLen);
+      }
+      udp.write(data, len);
+      udp.endPacket();
+    }
+    s.replies_sent++;
+  }
+
+  void sendReply(ViscaSession& s, const uint8_t* data, int len) {
+    if (s.sony_framing) {
+      uint8_t header[SONY_HEADER_SIZE] = {
+        0x01, 0x11,                                   // VISCA reply
+        (uint8_t)(len >> 8), (uint8_t)(len & 0xFF),
+        (uint8_t)(s.last_sequence >> 24), (uint8_t)(s.last_sequence >> 16), (uint8_t)(s.last_sequence >> 8), (uint8_t)s.last_sequence
+      };
+      transmit(s, header, SONY_HEADER_SIZE, data, len);
+    } else {
+      transmit(s, NULL, 0, data, len);
+    }
+  }
+
+  void sendAck(ViscaSession& s) {
+    const uint8_t ack[3] = {0x90, 0x41, 0xFF};
+    sendReply(s, ack, 3);
+  }
+
+  void sendCompletion(ViscaSession& s) {
+    const uint8_t completion[3] = {0x90, 0x51, 0xFF};
+    sendReply(s, completion, 3);
+  }
+
+  void sendNotExecutable(ViscaSession& s) {
+    const uint8_t error[4] = {0x90, 0x61, 0x41, 0xFF};
+    sendReply(s, error, 4);
+  }
+
+  void sendSyntaxError(ViscaSession& s) {
+    const uint8_t error[4] = {0x90, 0x60, 0x02, 0xFF};
+    sendReply(s, error, 4);
+  }
+
+  void sendCanceled(ViscaSession& s) {
+    const uint8_t canceled[4] = {0x90, 0x61, 0x04, 0xFF};
+    sendReply(s, canceled, 4);
+  }
+
+  static void stopAxis(FastAccelStepper* stepper) {
+    if (stepper != NULL && stepper->isRunning()) {
+      stepper->stopMove();
+    }
+  }
+
+  // Any new drive command replaces a positioning move that has not completed yet, its axes are braked first
+  void cancelPendingMove() {
+    if (pending_move != NULL) {
+      if (pending_request.pan_tilt) {
+        stopAxis(stepper1);
+        stopAxis(stepper2);
+      }
+      if (pending_request.focus) {
+        stopAxis(stepper3);
+      }
+      if (pending_request.zoom) {
+        stopAxis(stepper4);
+      }
+      sendCanceled(*pending_move);
+      pending_move = NULL;
+    }
+  }
+
+  bool axesRunning() {
+    return (stepper1 != NULL && stepper1->isRunning()) || (stepper2 != NULL && stepper2->isRunning()) ||
+           (stepper3 != NULL && stepper3->isRunning()) || (stepper4 != NULL && stepper4->isRunning());
+  }
+
+  // Reads count nibbles (0p 0q 0r 0s...) as a two's complement number
+  long decodeNibbles(const uint8_t* buffer, int count, bool is_signed) {
+    long value = 0;
+    for (int i = 0; i < count; i++) {
+      value = (value << 4) | (buffer[i] & 0x0F);
+    }
+    int bits = count * 4;
+    if (is_signed && (value & (1L << (bits - 1)))) {
+      value -= (1L << bits);
+    }
+    return value;
+  }
+
+  bool startMove(ViscaSession& s, const ViscaMoveRequest& request) {
+    if (!acquireControl(s)) {
+      s.packets_rejected++;
+      sendNotExecutable(s);
+      return false;
+    }
+    owner_last_ms = millis();
+    owner_released = true;                        // The move runs to its end by itself, nobody has to be locked out
+    cancelPendingMove();
+    sendAck(s);
+    pMoveTo(request);
+    pending_move = &s;
+    pending_request = request;                            // Completion is sent from processPackets() once every axis stopped
+    return true;
+  }
+
+  // Pan-tiltDrive Absolute/Relative: 81 01 06 02|03 VV WW 0Y 0Y 0Y 0Y (0Y) 0Z 0Z 0Z 0Z FF
+  bool processPositionCommand(ViscaSession& s, uint8_t* buffer, int packetSize) {
+    int panNibbles = packetSize - 11;             // 4 nibbles as in our position reply, 5 as sent by Sony style clients
+    if (panNibbles != 4 && panNibbles != 5) {
+      logger.printf("\nUDP Received invalid position command with length %d", packetSize);
+      return false;
+    }
+    ViscaMoveRequest request = {};
+    request.relative = buffer[3] == 0x03;
+    request.pan_tilt = true;
+    request.pan_speed = buffer[4];
+    request.tilt_speed = buffer[5];
+    request.pan = decodeNibbles(buffer + 6, panNibbles, true);
+    request.tilt = decodeNibbles(buffer + 6 + panNibbles, 4, true);
+    logger.printf("\nUDP %s move pan %ld tilt %ld speed %d,%d", request.relative ? "Relative" : "Absolute", request.pan, request.tilt, request.pan_speed, request.tilt_speed);
+    return startMove(s, request);
+  }
+
+  // CAM_Zoom/CAM_Focus Direct: 81 01 04 47|48 0p 0q 0r 0s FF, or 81 01 04 47 zoom(4 nibbles) focus(4 nibbles) FF
+  bool processLensCommand(ViscaSession& s, uint8_t* buffer, int packetSize) {
+    ViscaMoveRequest request = {};
+    if (buffer[3] == 0x47 && packetSize == 13) {
+      request.zoom = true;
+      request.focus = true;
+      request.zoom_position = decodeNibbles(buffer + 4, 4, false);
+      request.focus_position = decodeNibbles(buffer + 8, 4, false);
+    } else if (packetSize == 9) {
+      request.zoom = buffer[3] == 0x47;
+      request.focus = buffer[3] == 0x48;
+      request.zoom_position = decodeNibbles(buffer + 4, 4, false);
+      request.focus_position = request.zoom_position;
+    } else {
+      logger.printf("\nUDP Received invalid lens command with length %d", packetSize);
+      return false;
+    }
+    logger.printf("\nUDP Direct zoom %ld focus %ld", request.zoom ? request.zoom_position : -1, request.focus ? request.focus_position : -1);
+    return startMove(s, request);
+  }
+
+  // Strips the Sony VISCA over IP header if present, returns the offset of the VISCA payload or -1 to drop the packet
+  int unwrap(ViscaSession& s, uint8_t* buffer, int packetSize) {
+    bool wrapped = (buffer[0] == 0x01 && (buffer[1] == 0x00 || buffer[1] == 0x10 || buffer[1] == 0x20)) ||
+                   (buffer[0] == 0x02 && buffer[1] == 0x00);
+    if (packetSize >= SONY_HEADER_SIZE + 1 && wrapped) {
+      uint16_t payloadType = (buffer[0] << 8) | buffer[1];
+      uint32_t sequence = ((uint32_t)buffer[4] << 24) | ((uint32_t)buffer[5] << 16) | ((uint32_t)buffer[6] << 8) | buffer[7];
+      s.sony_framing = true;
+      if (payloadType == 0x0200) {                    // Control command, sequence number reset
+        s.last_sequence = sequence;
+        const uint8_t reset_ack[1] = {0x01};
+        const uint8_t header[SONY_HEADER_SIZE] = {0x02, 0x01, 0x00, 0x01, buffer[4], buffer[5], buffer[6], buffer[7]};
+        transmit(s, header, SONY_HEADER_SIZE, reset_ack, 1);
+        logger.printf("\nUDP Visca %s:%d reset sequence number", s.ip.toString().c_str(), s.port);
+        return -1;
+      }
+      if (s.packets_received > 1 && sequence == s.last_sequence) {
+        s.duplicates++;
+        return -1;                                    // Retransmission of a packet we already executed
+      }
+      s.last_sequence = sequence;
+      return SONY_HEADER_SIZE;
+    }
+    s.sony_framing = false;
+    return 0;
+  }
+
   // Process command based on the two bytes before 0xFF
-  bool processCommand(uint8_t* buffer, int packetSize) {
+  bool processCommand(ViscaSession& s, uint8_t* buffer, int packetSize) {
     if (packetSize < 5 || buffer[0] != 0x81 || buffer[packetSize - 1] != 0xFF) {
       logger.printf("\nUDP Received invalid packet with length %d", packetSize);
       return false; // Invalid packet
     }
+
+    // Positioning commands first, their trailing nibbles could look like drive commands
+    if (packetSize >= 15 && buffer[1] == 0x01 && buffer[2] == 0x06 && (buffer[3] == 0x02 || buffer[3] == 0x03)) {
+      return processPositionCommand(s, buffer, packetSize);
+    }
+    if (packetSize >= 9 && buffer[1] == 0x01 && buffer[2] == 0x04 && (buffer[3] == 0x47 || buffer[3] == 0x48)) {
+      return processLensCommand(s, buffer, packetSize);
+    }
+
+    // Memory recall 81 01 04 3F 02 pp FF, presets 0-15 are poses 1-16. Presets 100 and 101 start and stop the tour
+    if (packetSize == 7 && buffer[1] == 0x01 && buffer[2] == 0x04 && buffer[3] == 0x3F && buffer[4] == 0x02) {
+      logger.printf("\nUDP Received recall preset %d", buffer[5]);
+      if (!acquireControl(s)) {
+        s.packets_rejected++;
+        sendNotExecutable(s);
+        return false;
+      }
+      if (!pRecallPose(buffer[5] + 1)) {
+        logger.printf("\nPreset %d can not be recalled over VISCA", buffer[5]);
+        s.packets_rejected++;
+        sendNotExecutable(s);
+        return false;
+      }
+      owner_last_ms = millis();
+      owner_released = true;                          // The head runs the recall or tour on its own
+      cancelPendingMove();
+      sendAck(s);
+      sendCompletion(s);
+      return true;
+    }
     
     uint8_t cmd1 = buffer[packetSize - 3];
     uint8_t cmd2 = buffer[packetSize - 2];
     
     if (cmd1 == 0x06 && cmd2 == 0x04) {
       logger.printf("\nUDP Received Home command");
+      if (!acquireControl(s)) {
+        s.packets_rejected++;
+        sendNotExecutable(s);
+        return false;
+      }
+      owner_last_ms = millis();
+      owner_released = false;
+      cancelPendingMove();
+      sendAck(s);
       pHome();
+      sendCompletion(s);
       return true;
     }
     else if (cmd1 == 0x06 && cmd2 == 0x12) {
       logger.printf("\nUDP Received position request");
       // Get absolute position command
-      sendPositionPacket();
+      sendPositionPacket(s);
       return false;
     }
     else if ((cmd1 == 0x01 || cmd1 == 0x02 || cmd1 == 0x03) &&
              (cmd2 == 0x01 || cmd2 == 0x02 || cmd2 == 0x03)) {
       // Movement commands
       logger.printf("\nUDP Received move command %X %X", cmd1, cmd2);
-      return processMovementCommand(cmd1, cmd2, buffer, packetSize);
+      if (packetSize < 6) {                           // No room for the speeds
+        sendSyntaxError(s);
+        return false;
+      }
+      if (!acquireControl(s)) {
+        s.packets_rejected++;
+        sendNotExecutable(s);
+        return false;
+      }
+      owner_last_ms = millis();
+      owner_released = (cmd1 == 0x03 && cmd2 == 0x03);  // A full stop hands control back
+      cancelPendingMove();
+      processMovementCommand(cmd1, cmd2, buffer, packetSize);
+      sendAck(s);
+      sendCompletion(s);
+      return true;
     }
     return false;
   }
@@ -63,13 +434,7 @@ private:
       pan_factor=1;
     }
     *pJoy_Pan_Accel = 2000;
-    if (VPanSpeed < 3) {
-      *pJoy_Pan_Speed = pan_factor * (VPanSpeed * 200);
-
-    } else {
-      *pJoy_Pan_Speed = pan_factor * (VPanSpeed * 150);
-
-    }
+    *pJoy_Pan_Speed = pan_factor * toCommand(VPanSpeed, VISCA_PAN_SPEED_MAX, PAN_COMMAND_FULL);
     int8_t VTiltSpeed = buffer[5]; // 5th byte (index 4)
     int tilt_factor = 0; // Default stop
     // Tilt direction
@@ -78,21 +443,14 @@ private:
     } else if (cmd2 == 0x02) { // Positive direction
       tilt_factor=-1;
     }
-
-    if (VTiltSpeed < 3) {
-      *pJoy_Tilt_Speed = VTiltSpeed * tilt_factor * 200 * 2;
-    } 
-    else {
-      *pJoy_Tilt_Speed = VTiltSpeed * tilt_factor * 150 * 2;
-    }
-
+    *pJoy_Tilt_Speed = tilt_factor * toCommand(VTiltSpeed, VISCA_TILT_SPEED_MAX, TILT_COMMAND_FULL);
 
     logger.printf("\nUDP PanTilt to %d , %d (%d,%d)", *pJoy_Pan_Speed, *pJoy_Tilt_Speed, VPanSpeed, VTiltSpeed);
     return true;
   }
   
   // Send 11-byte position packet
-  void sendPositionPacket() {
+  void sendPositionPacket(ViscaSession& s) {
     if (stepper1==NULL || stepper2==NULL){
       logger.printf("\nUDP Visca skipping requested position report because not yet connected to steppers");
       return;
@@ -122,42 +480,259 @@ private:
     logger.printf("\nUDP Pan %d (%x): 0x%02X 0x%02X 0x%02X 0x%02X", pan, pan, response[2],response[3],response[4],response[5]);
     logger.printf("\nUDP Tilt %d (%x): 0x%02X 0x%02X 0x%02X 0x%02X", tilt, tilt, response[6],response[7],response[8],response[9]);
 
-    udp.beginPacket(udp.remoteIP(), udp.remotePort());
-    udp.write(response, 11);
-    udp.endPacket();
+    sendReply(s, response, 11);
+  }
+
+  bool handleMessage(ViscaSession& s, uint8_t* buffer, int len) {
+    s.packets_received++;
+    s.last_seen_ms = millis();
+    int offset = unwrap(s, buffer, len);
+    if (offset < 0) {
+      return false;
+    }
+    return processCommand(s, buffer + offset, len - offset);
+  }
+
+  bool processUdp() {
+    int packetSize = udp.parsePacket();
+    if (packetSize) {
+      int len = udp.read(packetBuffer, sizeof(packetBuffer));
+      ViscaSession* session = findSession(udp.remoteIP(), udp.remotePort(), -1);
+      if (session == NULL) {
+        return false;
+      }
+      ViscaSession& s = *session;
+      logger.printf("\nUDP Received packet len %d from %s:%d", len, s.ip.toString().c_str(), s.port);
+      return handleMessage(s, packetBuffer, len);
+    }
+    return false;
+  }
+
+  void acceptTcp() {
+    WiFiClient incoming = tcpServer.available();
+    if (!incoming) return;
+    for (int i = 0; i < MAX_TCP_CLIENTS; i++) {
+      if (!tcp[i].client.connected()) {
+        if (tcp[i].session != NULL) {
+          closeTcp(i);                                // Dropped since the last poll, release its session and stop its moves first
+        }
+        ViscaSession* session = findSession(incoming.remoteIP(), incoming.remotePort(), i);
+        if (session == NULL) {
+          incoming.stop();
+          return;
+        }
+        tcp[i].client = incoming;
+        tcp[i].client.setNoDelay(true);               // Replies and ACKs must not wait for Nagle
+        tcp[i].length = 0;
+        tcp[i].session = session;
+        logger.printf("\nTCP Visca connection %d from %s:%d", i, incoming.remoteIP().toString().c_str(), incoming.remotePort());
+        return;
+      }
+    }
+    logger.println("TCP Visca connection refused, all slots in use");
+    incoming.stop();
+  }
+
+  void closeTcp(int slot) {
+    TcpConnection& c = tcp[slot];
+    logger.printf("\nTCP Visca connection %d closed", slot);
+    c.client.stop();
+    if (c.session != NULL) {
+      if (owner == c.session) {
+        // The controlling surface dropped off, never leave the axes running on a command nobody can cancel
+        logger.println("TCP Visca owner disconnected, stopping");
+        *pJoy_Pan_Speed = 0;
+        *pJoy_Tilt_Speed = 0;
+        pStop();
+        owner = NULL;
+      }
+      if (pending_move == c.session) {
+        pending_move = NULL;
+      }
+      c.session->in_use = false;
+      c.session = NULL;
+    }
+    c.length = 0;
+  }
+
+  // Length of the first complete message in the buffer, 0 if more bytes are needed, -1 if the data is garbage
+  int frameLength(const uint8_t* buffer, int length) {
+    if (length == 0) return 0;
+    bool wrapped = buffer[0] == 0x01 || buffer[0] == 0x02;
+    if (wrapped) {
+      if (length < SONY_HEADER_SIZE) return 0;
+      int total = SONY_HEADER_SIZE + ((buffer[2] << 8) | buffer[3]);
+      if (total > TCP_BUFFER_SIZE) return -1;
+      return length >= total ? total : 0;
+    }
+    if ((buffer[0] & 0xF0) != 0x80) return -1;
+    for (int i = 1; i < length; i++) {
+      if (buffer[i] == 0xFF) return i + 1;
+    }
+    return length >= TCP_BUFFER_SIZE ? -1 : 0;
+  }
+
+  bool processTcp() {
+    acceptTcp();
+    bool moved = false;
+    for (int i = 0; i < MAX_TCP_CLIENTS; i++) {
+      TcpConnection& c = tcp[i];
+      if (c.session == NULL) continue;
+      if (!c.client.connected()) {
+        closeTcp(i);
+        continue;
+      }
+      int available = c.client.available();
+      if (available <= 0) continue;
+      int room = TCP_BUFFER_SIZE - c.length;
+      int got = c.client.read(c.buffer + c.length, available < room ? available : room);
+      if (got <= 0) continue;
+      c.length += got;
+      // A segment may carry several pipelined commands, execute every complete one
+      int frame;
+      while ((frame = frameLength(c.buffer, c.length)) != 0) {
+        if (frame < 0) {
+          logger.printf("\nTCP Visca connection %d out of sync, dropping %d bytes", i, c.length);
+          c.length = 0;
+          break;
+        }
+        moved |= handleMessage(*c.session, c.buffer, frame);
+        c.length -= frame;
+        memmove(c.buffer, c.buffer + frame, c.length);
+      }
+    }
+    return moved;
+  }
+
+  void loadControlSettings() {
+    preferences.begin("visca-ctl", true);
+    takeover_timeout_ms = preferences.getUInt("takeover", 2000);
+    char key[8];
+    for (int i = 0; i < MAX_PRIORITY_RULES; i++) {
+      snprintf(key, sizeof(key), "ip%d", i);
+      priority_ip[i] = preferences.getUInt(key, 0);
+      snprintf(key, sizeof(key), "prio%d", i);
+      priority_level[i] = preferences.getUChar(key, DEFAULT_PRIORITY);
+    }
+    preferences.end();
+  }
+
+  void saveControlSettings() {
+    preferences.begin("visca-ctl", false);
+    preferences.putUInt("takeover", takeover_timeout_ms);
+    char key[8];
+    for (int i = 0; i < MAX_PRIORITY_RULES; i++) {
+      snprintf(key, sizeof(key), "ip%d", i);
+      preferences.putUInt(key, priority_ip[i]);
+      snprintf(key, sizeof(key), "prio%d", i);
+      preferences.putUChar(key, priority_level[i]);
+    }
+    preferences.end();
   }
 
 public:
-  UDPViscaHandler(int* panspeed, int* panaccel, int* tiltspeed, int* tiltaccel, Logger & alogger, void (*apHome)(),  void (*apStop)(), uint16_t (*pViscaPort)()) 
-    : logger(alogger), pJoy_Pan_Speed(panspeed), pJoy_Pan_Accel(panaccel), 
-      pJoy_Tilt_Speed(tiltspeed), pJoy_Tilt_Accel(tiltaccel), pHome(apHome), pStop(apStop), pGetUdpViscaPort(pViscaPort) {
+  UDPViscaHandler(int* panspeed, int* panaccel, int* tiltspeed, int* tiltaccel, Logger & alogger, void (*apHome)(),  void (*apStop)(), uint16_t (*pViscaPort)(),
+                  void (*apMoveTo)(const ViscaMoveRequest&), bool (*apRecallPose)(int))
+    : tcpServer(TCP_PORT), logger(alogger), pJoy_Pan_Speed(panspeed), pJoy_Pan_Accel(panaccel),
+      pJoy_Tilt_Speed(tiltspeed), pJoy_Tilt_Accel(tiltaccel), pHome(apHome), pStop(apStop), pGetUdpViscaPort(pViscaPort), pMoveTo(apMoveTo),
+      pRecallPose(apRecallPose) {
         stepper1 = NULL;
         stepper2 = NULL;
+        stepper3 = NULL;
+        stepper4 = NULL;
+        pending_move = NULL;
+        owner = NULL;
+        owner_last_ms = 0;
+        owner_released = true;
+        takeover_timeout_ms = 2000;
+        for (int i = 0; i < MAX_TCP_CLIENTS; i++) {
+          tcp[i].session = NULL;
+          tcp[i].length = 0;
+        }
+        memset(sessions, 0, sizeof(sessions));
+        memset(priority_ip, 0, sizeof(priority_ip));
+        memset(priority_level, DEFAULT_PRIORITY, sizeof(priority_level));
       }
   
   // Initialize UDP
   void begin() {
     uint16_t port=pGetUdpViscaPort();
-    logger.printf("\nUDP Visca starts listening on port %d", port);    
+    loadControlSettings();
+    logger.printf("\nUDP Visca starts listening on port %d, takeover timeout %lu ms", port, takeover_timeout_ms);
     udp.begin(port);
+    logger.printf("\nTCP Visca starts listening on port %d", TCP_PORT);
+    tcpServer.begin();
+    tcpServer.setNoDelay(true);
   }
 
   // Initialize UDP
-  void configure(FastAccelStepper *astepper1, FastAccelStepper *astepper2) {
+  void configure(FastAccelStepper *astepper1, FastAccelStepper *astepper2, FastAccelStepper *astepper3, FastAccelStepper *astepper4) {
     stepper1=astepper1;
     stepper2=astepper2;
+    stepper3=astepper3;
+    stepper4=astepper4;
     logger.println("UDP Visca connected to steppers");
   }
   
-  // Check for and process incoming packets
+  // Set a control priority for a client IP (0 clears the rule) and the idle time after which another client may take over,
+  // a takeover of 0 keeps the current one
+  bool setControlPriority(int rule, const IPAddress& ip, uint8_t priority, unsigned long takeoverMs) {
+    if (rule < 0 || rule >= MAX_PRIORITY_RULES) return false;
+    priority_ip[rule] = (uint32_t)ip;
+    priority_level[rule] = priority;
+    if (takeoverMs > 0) {
+      takeover_timeout_ms = takeoverMs;
+    }
+    saveControlSettings();
+    for (int i = 0; i < MAX_SESSIONS; i++) {
+      if (sessions[i].in_use) {
+        sessions[i].priority = priorityFor(sessions[i].ip);
+      }
+    }
+    logger.printf("\nUDP Visca priority rule %d: %s priority %d, takeover %lu ms", rule, ip.toString().c_str(), priority, takeover_timeout_ms);
+    return true;
+  }
+
+  // Brakes a positioning move that has not completed yet, its client gets the canceled reply
+  void cancelMove() {
+    cancelPendingMove();
+  }
+
+  unsigned long getTakeoverTimeout() {
+    return takeover_timeout_ms;
+  }
+
+  // HTML table rows with the per-client counters for the status page
+  String getSessionStatus() {
+    String html;
+    html.reserve(160 + MAX_SESSIONS * 160);
+    char row[192];
+    snprintf(row, sizeof(row), "<p>VISCA takeover timeout %lu ms</p><table align='center'><tr><th>Client</th><th>Prio</th><th>Rx</th><th>Rejected</th><th>Dup</th><th>Tx</th><th>Seen</th></tr>", takeover_timeout_ms);
+    html += row;
+    unsigned long now = millis();
+    for (int i = 0; i < MAX_SESSIONS; i++) {
+      ViscaSession& s = sessions[i];
+      if (!s.in_use) continue;
+      snprintf(row, sizeof(row), "<tr><td>%s %s:%d%s%s</td><td>%d</td><td>%lu</td><td>%lu</td><td>%lu</td><td>%lu</td><td>%lus ago</td></tr>",
+               s.tcp_slot >= 0 ? "TCP" : "UDP", s.ip.toString().c_str(), s.port, s.sony_framing ? " (IP)" : "", owner == &s ? " *" : "", s.priority,
+               (unsigned long)s.packets_received, (unsigned long)s.packets_rejected, (unsigned long)s.duplicates,
+               (unsigned long)s.replies_sent, (now - s.last_seen_ms) / 1000);
+      html += row;
+    }
+    html += "</table>";
+    return html;
+  }
+
+  // Check for and process incoming packets on both transports
   bool processPackets() {
-    int packetSize = udp.parsePacket();
-    if (packetSize) {
-      int len = udp.read(packetBuffer, sizeof(packetBuffer));
-      logger.printf("\nUDP Received packet len %d", len);    
-      return processCommand(packetBuffer, len);
+    bool moved = processUdp();
+    moved |= processTcp();
+    if (pending_move != NULL && !axesRunning()) {
+      logger.printf("\nVisca move completed for %s:%d", pending_move->ip.toString().c_str(), pending_move->port);
+      sendCompletion(*pending_move);
+      pending_move = NULL;
     }
-    return false;
+    return moved;
   }
 };
 
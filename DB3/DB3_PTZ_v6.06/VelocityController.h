@@ -0,0 +1,283 @@
+#ifndef VELOCITY_CONTROLLER_H
+#define VELOCITY_CONTROLLER_H
+
+#include <FastAccelStepper.h>
+#include <esp_timer.h>
+#include "Axis.h"
+#include "Backlash.h"
+#include "AxisLimits.h"
+
+// Live mode velocity control
+//
+// PTZ_Control only decides the target velocity of each axis. A task running at a fixed 500Hz owns the steppers
+// of the engaged axes and slews them towards their target with bounded acceleration and jerk. The stepper only
+// gets a new speed when the commanded speed changed noticeably, so slow pans see a steady pulse train instead of
+// a restart every time loop() comes around. Every start and reversal takes up the axis backlash first, and no
+// target or ramp goes past the axis limits.
+class VelocityController {
+private:
+  struct AxisState {
+    HeadAxis axis;
+    FastAccelStepper* stepper;
+    const int* limit_a;                           // Soft limits, in either order
+    const int* limit_b;
+    uint32_t brake_accel;                         // Deceleration when the target drops back to 0
+    volatile int32_t target_mhz;                  // Written by PTZ_Control
+    volatile uint32_t accel;
+    volatile bool release_request;
+    bool engaged;                                 // Only touched by the task from here on
+    bool landing;                                 // Stepper is decelerating onto a soft limit by itself
+    float velocity;                               // Commanded velocity, steps/s
+    float acceleration;                           // Current rate of change, steps/s²
+    int32_t applied_mhz;                          // Last speed handed to the stepper
+  };
+
+  BacklashCompensator& backlash;
+  const AxisLimits& limits;
+  Logger& logger;
+  AxisState axes[HEAD_AXES];
+  TaskHandle_t task;
+  bool was_active;
+  uint32_t updates;                               // Ticks and stepper updates since the axes went live
+  uint32_t stepper_updates;
+  uint64_t busy_us;
+  uint32_t max_us;
+
+  static const uint32_t PERIOD_MS = 2;           // 500Hz
+  static constexpr float DT = PERIOD_MS / 1000.0f;
+  static constexpr float JERK_PER_ACCEL = 5.0f;  // Full acceleration is reached in 1/5s
+  static const int32_t APPLY_MIN_MHZ = 250;      // Smallest speed change worth a stepper update
+  static const int32_t APPLY_RATIO = 200;        // or 0.5% of the running speed, whichever is larger
+  static constexpr float GUARD_LATENCY = 0.01f;  // Seconds of travel added to the stopping distance for tick and queue delay
+
+  static void taskEntry(void* parameter) {
+    ((VelocityController*)parameter)->run();
+  }
+
+  void resetAxis(AxisState& a) {
+    a.engaged = false;
+    a.landing = false;
+    a.velocity = 0;
+    a.acceleration = 0;
+    a.applied_mhz = 0;
+  }
+
+  void engage(AxisState& a) {
+    a.engaged = true;
+    a.velocity = a.stepper->getCurrentSpeedInMilliHz() / 1000.0f;   // Pick up a move that is still running
+    a.applied_mhz = a.stepper->getCurrentSpeedInMilliHz();
+    a.acceleration = 0;
+    uint32_t accel = a.accel;
+    a.stepper->setAcceleration(max(accel, a.brake_accel) * 2);       // Stepper ramp must be steeper than ours to follow
+  }
+
+  // Pushes the commanded velocity to the stepper if it moved far enough from the last one
+  void apply(AxisState& a, int32_t target_mhz) {
+    int32_t mhz = (int32_t)(a.velocity * 1000.0f);
+    if (mhz == 0) {
+      if (a.applied_mhz != 0) {
+        a.stepper->stopMove();
+        a.applied_mhz = 0;
+        stepper_updates++;
+      }
+      if (target_mhz == 0 && !a.stepper->isRunning()) {
+        resetAxis(a);                             // Standing still, hand the axis back
+      }
+      return;
+    }
+    bool start = a.applied_mhz == 0 || (mhz > 0) != (a.applied_mhz > 0);
+    int32_t threshold = abs(a.applied_mhz) / APPLY_RATIO;
+    if (threshold < APPLY_MIN_MHZ) threshold = APPLY_MIN_MHZ;
+    if (!start && abs(mhz - a.applied_mhz) < threshold) {
+      return;
+    }
+    if (start) {
+      backlash.takeUp(a.axis, a.stepper, mhz > 0 ? 1 : -1);
+    }
+    a.stepper->setSpeedInMilliHz(abs(mhz));
+    if (start) {
+      if (mhz > 0) {
+        a.stepper->runForward();
+      } else {
+        a.stepper->runBackward();
+      }
+    } else {
+      a.stepper->applySpeedAcceleration();
+    }
+    a.applied_mhz = mhz;
+    stepper_updates++;
+  }
+
+  void updateAxis(AxisState& a) {
+    if (a.release_request) {
+      resetAxis(a);
+      a.release_request = false;
+      return;
+    }
+    int32_t max_mhz = (int32_t)(limits.speed(a.axis) * 1000);
+    int32_t target_mhz = constrain(a.target_mhz, -max_mhz, max_mhz);
+    if (!a.engaged) {
+      if (target_mhz == 0) return;
+      engage(a);
+    }
+
+    long pos = a.stepper->getCurrentPosition();
+    long lo = min(*a.limit_a, *a.limit_b);
+    long hi = max(*a.limit_a, *a.limit_b);
+    uint32_t accel = limits.accel(a.axis, a.accel);
+    float brake = limits.accel(a.axis, max(accel, a.brake_accel));
+    if (a.landing) {
+      if ((a.velocity > 0 && target_mhz > 0) || (a.velocity < 0 && target_mhz < 0)) {
+        a.velocity = a.stepper->getCurrentSpeedInMilliHz() / 1000.0f;
+        if (!a.stepper->isRunning()) {
+          a.velocity = 0;                         // Parked on the limit, wait for the stick to let go or reverse
+          a.applied_mhz = 0;
+        }
+        return;
+      }
+      a.landing = false;                          // Stick released or reversed, take the axis back
+      a.velocity = a.stepper->getCurrentSpeedInMilliHz() / 1000.0f;
+      a.applied_mhz = a.stepper->getCurrentSpeedInMilliHz();
+      a.stepper->setAcceleration(brake * 2);
+    }
+    if ((a.velocity > 0 && pos > hi) || (a.velocity < 0 && pos < lo)) {
+      a.stepper->forceStop();                     // Only when a limit was moved onto a running axis
+      resetAxis(a);
+      return;
+    }
+    if ((target_mhz > 0 && pos >= hi) || (target_mhz < 0 && pos <= lo)) {
+      target_mhz = 0;                             // Never drive further into a limit
+    }
+
+    // Stopping distance v²/2a at braking deceleration. Once it reaches the limit the stepper gets a moveTo onto
+    // the limit, its own ramp then lands there exactly
+    if (a.velocity != 0) {
+      float speed = fabsf(a.velocity);
+      float stopping = speed * speed / (2.0f * brake) + speed * GUARD_LATENCY;
+      long distance = a.velocity > 0 ? hi - pos : pos - lo;
+      if (stopping >= distance) {
+        a.landing = true;
+        a.acceleration = 0;
+        a.stepper->setAcceleration((uint32_t)brake);
+        a.stepper->moveTo(a.velocity > 0 ? hi : lo);
+        stepper_updates++;
+        return;
+      }
+    }
+
+    float target = target_mhz / 1000.0f;
+    float accel_limit = target_mhz == 0 ? brake : accel;
+    float jerk = accel_limit * JERK_PER_ACCEL;
+    float error = target - a.velocity;
+    // Acceleration that still lets us ease into the target under the jerk limit
+    float wanted = min(accel_limit, sqrtf(2.0f * jerk * fabsf(error)));
+    if (error < 0) wanted = -wanted;
+    float jerk_step = jerk * DT;
+    a.acceleration += constrain(wanted - a.acceleration, -jerk_step, jerk_step);
+    float next = a.velocity + a.acceleration * DT;
+    if ((error >= 0 && next >= target) || (error <= 0 && next <= target)) {
+      next = target;
+      a.acceleration = 0;
+    }
+    a.velocity = next;
+    apply(a, target_mhz);
+  }
+
+  void run() {
+    TickType_t last_wake = xTaskGetTickCount();
+    for (;;) {
+      vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(PERIOD_MS));
+      int64_t start = esp_timer_get_time();
+      bool active = false;
+      for (int i = 0; i < HEAD_AXES; i++) {
+        if (axes[i].stepper == NULL) {
+          axes[i].release_request = false;
+          continue;
+        }
+        updateAxis(axes[i]);
+        active |= axes[i].engaged;
+      }
+      if (!active) {
+        if (was_active) {
+          logStats();
+          was_active = false;
+        }
+        continue;
+      }
+      was_active = true;
+      uint32_t used = (uint32_t)(esp_timer_get_time() - start);
+      updates++;
+      busy_us += used;
+      if (used > max_us) max_us = used;
+    }
+  }
+
+  void logStats() {
+    if (updates == 0) return;
+    logger.printf("\nVelocity control: %lu ticks, %lu stepper updates, avg %lu us, max %lu us per tick",
+                  (unsigned long)updates, (unsigned long)stepper_updates, (unsigned long)(busy_us / updates), (unsigned long)max_us);
+    updates = 0;
+    stepper_updates = 0;
+    busy_us = 0;
+    max_us = 0;
+  }
+
+public:
+  VelocityController(BacklashCompensator& abacklash, const AxisLimits& alimits, Logger& alogger)
+    : backlash(abacklash), limits(alimits), logger(alogger), task(NULL), was_active(false), updates(0), stepper_updates(0), busy_us(0), max_us(0) {
+    for (int i = 0; i < HEAD_AXES; i++) {
+      axes[i].axis = (HeadAxis)i;
+      axes[i].stepper = NULL;
+      axes[i].target_mhz = 0;
+      axes[i].accel = 1000;
+      axes[i].release_request = false;
+      resetAxis(axes[i]);
+    }
+  }
+
+  void configure(HeadAxis axis, FastAccelStepper* stepper, const int* limit_a, const int* limit_b, uint32_t brake_accel) {
+    axes[axis].stepper = stepper;
+    axes[axis].limit_a = limit_a;
+    axes[axis].limit_b = limit_b;
+    axes[axis].brake_accel = brake_accel;
+  }
+
+  void begin() {
+    xTaskCreatePinnedToCore(taskEntry, "Velocity", 4096, this, 2, &task, 1);
+    logger.printf("\nVelocity control running at %d Hz", (int)(1000 / PERIOD_MS));
+  }
+
+  // Signed target velocity in mHz and the acceleration allowed to get there. 0 ramps the axis down and releases it
+  void setTarget(HeadAxis axis, int32_t target_mhz, uint32_t accel) {
+    axes[axis].accel = max(accel, (uint32_t)100);
+    axes[axis].target_mhz = target_mhz;
+  }
+
+  // True while the task drives the axis, including the ramp down after the target went to 0
+  bool isActive(HeadAxis axis) {
+    return axes[axis].engaged || axes[axis].target_mhz != 0;
+  }
+
+  // Hands all axes back without touching the steppers, for code that is about to command them directly.
+  // Waits for the task to let go so it cannot issue one more speed update on top of the new move.
+  void releaseAll() {
+    for (int i = 0; i < HEAD_AXES; i++) {
+      axes[i].target_mhz = 0;
+      axes[i].release_request = true;
+    }
+    if (task == NULL) {
+      for (int i = 0; i < HEAD_AXES; i++) {
+        resetAxis(axes[i]);
+        axes[i].release_request = false;
+      }
+      return;
+    }
+    for (int i = 0; i < HEAD_AXES; i++) {
+      while (axes[i].release_request) {
+        vTaskDelay(1);
+      }
+    }
+  }
+};
+
+#endif // VELOCITY_CONTROLLER_H
@@ -0,0 +1,208 @@
+#ifndef WEBSOCKET_CONTROL_H
+#define WEBSOCKET_CONTROL_H
+
+#include <WebSocketsServer.h>  // WebSockets library from https://github.com/Links2004/arduinoWebSockets
+
+// Live control channel for the browser UI served from webui_gz.h
+//
+// Browser -> head (text frames):
+//   J,<pan>,<tilt>,<focus>,<zoom>   joystick velocities in percent -100..100, resent at ~30Hz while held
+//   P,<n>                           recall pose n (1-16)
+//   X                               stop all axes
+//   T,<n>,<pose>,<travel ms>,<dwell ms>,<blend steps>   set or append tour stop n (1 based), T,0 clears the tour.
+//                                   P,101 starts the tour and P,102 stops it, P,103 tunes the tilt and pan limits
+//                                   P,104 marks the target lock point, P,105 and P,106 start and stop the lock,
+//                                   P,107 follows the Mini Jib instead
+// Head -> browser (text frames, ~30Hz while a client is connected):
+//   S,<pan>,<tilt>,<focus>,<zoom>,<moving>
+class WebSocketControl {
+private:
+  WebSocketsServer ws;
+  Logger& logger;
+  // Pointers to global variables
+  int* pJoy_Pan_Speed;
+  int* pJoy_Pan_Accel;
+  int* pJoy_Tilt_Speed;
+  int* pJoy_Tilt_Accel;
+  int* pJoy_Focus_Speed;
+  int* pJoy_Focus_Accel;
+  int* pJoy_Zoo_Speed;
+  int* pJoy_Zoo_Accel;
+  void (*pRecallPose)(int);
+  void (*pStop)();
+  void (*pSetTourStop)(int, int, uint32_t, uint32_t, uint32_t);
+  FastAccelStepper *stepper1;
+  FastAccelStepper *stepper2;
+  FastAccelStepper *stepper3;
+  FastAccelStepper *stepper4;
+  bool is_started;
+  bool command_received;
+  bool joystick_active;
+  unsigned long last_joystick_ms;
+  unsigned long last_status_ms;
+
+  static const uint16_t WS_PORT = 81;
+  static const unsigned long STATUS_INTERVAL_MS = 33;    // ~30Hz position updates
+  static const unsigned long JOYSTICK_TIMEOUT_MS = 300;  // Stop if the browser stops streaming while the stick is held
+
+  void stopJoystick() {
+    *pJoy_Pan_Speed = 0;
+    *pJoy_Tilt_Speed = 0;
+    *pJoy_Focus_Speed = 0;
+    *pJoy_Zoo_Speed = 0;
+    joystick_active = false;
+  }
+
+  void processJoystick(char* payload) {
+    int pan = 0, tilt = 0, focus = 0, zoom = 0;
+    if (sscanf(payload, "J,%d,%d,%d,%d", &pan, &tilt, &focus, &zoom) != 4) {
+      logger.printf("\nWS invalid joystick message '%s'", payload);
+      return;
+    }
+    *pJoy_Pan_Accel = 2000;
+    *pJoy_Tilt_Accel = 2000;
+    *pJoy_Focus_Accel = 2000;
+    *pJoy_Zoo_Accel = 2000;
+    *pJoy_Pan_Speed = toCommand(pan, 100, PAN_COMMAND_FULL);     // Same command scale as the VISCA and ESP-NOW joystick paths
+    *pJoy_Tilt_Speed = toCommand(tilt, 100, TILT_COMMAND_FULL);
+    *pJoy_Focus_Speed = toCommand(focus, 100, LENS_COMMAND_FULL);
+    *pJoy_Zoo_Speed = toCommand(zoom, 100, LENS_COMMAND_FULL);
+
+    joystick_active = (pan != 0 || tilt != 0 || focus != 0 || zoom != 0);
+    last_joystick_ms = millis();
+    command_received = true;
+  }
+
+  void processMessage(uint8_t num, char* payload, size_t length) {
+    if (length == 0) return;
+    switch (payload[0]) {
+      case 'J':
+        processJoystick(payload);
+        break;
+      case 'P': {
+        int pose = atoi(payload + 2);
+        logger.printf("\nWS client %d recalls pose %d", num, pose);
+        stopJoystick();
+        pRecallPose(pose);
+        command_received = true;
+        break;
+      }
+      case 'T': {
+        int index = 0, pose = 0;
+        unsigned long travel = 0, dwell = 0, blend = 0;
+        int fields = sscanf(payload, "T,%d,%d,%lu,%lu,%lu", &index, &pose, &travel, &dwell, &blend);
+        if (fields == 1 && index == 0) {
+          logger.printf("\nWS client %d cleared the tour", num);
+          pSetTourStop(-1, 0, 0, 0, 0);
+        } else if (fields == 5 && index > 0) {
+          logger.printf("\nWS client %d sets tour stop %d to pose %d", num, index, pose);
+          pSetTourStop(index - 1, pose, travel, dwell, blend);
+        } else {
+          logger.printf("\nWS invalid tour message '%s'", payload);
+        }
+        break;
+      }
+      case 'X':
+        logger.printf("\nWS client %d requested stop", num);
+        stopJoystick();
+        pStop();
+        command_received = true;
+        break;
+      default:
+        logger.printf("\nWS unknown message '%s'", payload);
+        break;
+    }
+  }
+
+  void onEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+    switch (type) {
+      case WStype_CONNECTED:
+        logger.printf("\nWS client %d connected from %s", num, ws.remoteIP(num).toString().c_str());
+        break;
+      case WStype_DISCONNECTED:
+        logger.printf("\nWS client %d disconnected", num);
+        if (joystick_active) {
+          stopJoystick();                    // Never leave the head running after the controlling tablet drops off
+        }
+        break;
+      case WStype_TEXT:
+        processMessage(num, (char*)payload, length);
+        break;
+      default:
+        break;
+    }
+  }
+
+  void sendStatus() {
+    if (stepper1 == NULL || stepper2 == NULL || stepper3 == NULL || stepper4 == NULL) return;
+    char status[64];
+    bool moving = stepper1->isRunning() || stepper2->isRunning() || stepper3->isRunning() || stepper4->isRunning();
+    int len = snprintf(status, sizeof(status), "S,%ld,%ld,%ld,%ld,%d",
+                       (long)stepper2->getCurrentPosition(), (long)stepper1->getCurrentPosition(),
+                       (long)stepper3->getCurrentPosition(), (long)stepper4->getCurrentPosition(), moving ? 1 : 0);
+    ws.broadcastTXT(status, len);
+  }
+
+public:
+  WebSocketControl(int* panspeed, int* panaccel, int* tiltspeed, int* tiltaccel, int* focusspeed, int* focusaccel, int* zoomspeed, int* zoomaccel,
+                   Logger& alogger, void (*apRecallPose)(int), void (*apStop)(), void (*apSetTourStop)(int, int, uint32_t, uint32_t, uint32_t))
+    : ws(WS_PORT), logger(alogger), pJoy_Pan_Speed(panspeed), pJoy_Pan_Accel(panaccel), pJoy_Tilt_Speed(tiltspeed),
+      pJoy_Tilt_Accel(tiltaccel), pJoy_Focus_Speed(focusspeed), pJoy_Focus_Accel(focusaccel), pJoy_Zoo_Speed(zoomspeed), pJoy_Zoo_Accel(zoomaccel),
+      pRecallPose(apRecallPose), pStop(apStop), pSetTourStop(apSetTourStop), is_started(false), command_received(false), joystick_active(false),
+      last_joystick_ms(0), last_status_ms(0) {
+    stepper1 = NULL;
+    stepper2 = NULL;
+    stepper3 = NULL;
+    stepper4 = NULL;
+  }
+
+  uint16_t getPort() {
+    return WS_PORT;
+  }
+
+  void begin() {
+    logger.printf("\nWebSocket control starts listening on port %d", WS_PORT);
+    ws.onEvent([this](uint8_t num, WStype_t type, uint8_t* payload, size_t length) { onEvent(num, type, payload, length); });
+    ws.begin();
+    is_started = true;
+  }
+
+  void end() {
+    if (is_started) {
+      ws.close();
+      is_started = false;
+    }
+  }
+
+  void configure(FastAccelStepper *astepper1, FastAccelStepper *astepper2, FastAccelStepper *astepper3, FastAccelStepper *astepper4) {
+    stepper1 = astepper1;
+    stepper2 = astepper2;
+    stepper3 = astepper3;
+    stepper4 = astepper4;
+    logger.println("WebSocket control connected to steppers");
+  }
+
+  // Returns true when a control command was received since the last call
+  bool loop() {
+    if (!is_started) return false;
+    ws.loop();
+
+    unsigned long now = millis();
+    if (joystick_active && now - last_joystick_ms > JOYSTICK_TIMEOUT_MS) {
+      logger.println("WS joystick stream timed out, stopping");
+      stopJoystick();
+    }
+    if (now - last_status_ms >= STATUS_INTERVAL_MS) {
+      last_status_ms = now;
+      if (ws.connectedClients() > 0) {
+        sendStatus();
+      }
+    }
+
+    bool received = command_received;
+    command_received = false;
+    return received;
+  }
+};
+
+#endif // WEBSOCKET_CONTROL_H
@@ -9,13 +9,17 @@
 #include <esp_now.h>
 #include <ArduinoOTA.h>
 #include "coap_server.h"
+#include "HttpOta.h"
+#include "webui_gz.h"
 
 class WiFiConfigManager {
 private:
   enum class Mode { Station, AP, ESPNOW };
   WebServer server;
   CoapServer coap_server;
+  HttpOta http_ota;
   UDPViscaHandler& visca;
+  WebSocketControl& websocket;
   Preferences preferences;
   String station_ssid;
   String station_password;
@@ -132,13 +136,17 @@ private:
     if (!serverActive) {
       register_mdns();
       logger.println("Starting web server...");
+      const char* headerKeys[] = {"If-None-Match", "Content-Range", "X-Image-MD5"};
+      server.collectHeaders(headerKeys, 3);
       server.begin();
       serverActive = true;
       logger.println("Web server started successfully.");
       coap_server.begin();
       visca.begin();
+      websocket.begin();
       if (otaEnabled) {
         initOTA();
+        http_ota.begin(ap_password);
       }
     }
   }
@@ -151,7 +159,9 @@ private:
       serverActive = false;
       logger.println("Web server stopped.");
       coap_server.end();
+      websocket.end();
       ArduinoOTA.end();
+      http_ota.end();
     }
   }
 
@@ -165,44 +175,65 @@ private:
     return String("Station IP: ") + stationIP  + stationSSID + String(" | AP IP: ") + apIP + extra;
   }
 
+  // The UI is a prebuilt gzipped page in flash (see webui/), so serving it costs no heap. The ETag lets
+  // browsers revalidate with a 304 instead of downloading it again.
   void handleRoot() {
     logger.println("Handling root page request...");
-    String html;
-    html.reserve(1600);
-    html += "<!DOCTYPE html><html><head><title>ESP32 WiFi Config</title>";
-    html += "<style>body {font-family: Arial, sans-serif; text-align: center; margin-top: 50px;}";
-    html += "form {margin: 20px auto; width: 300px; padding: 20px; border: 1px solid #ccc;}";
-    html += "input, button {margin: 10px; padding: 5px;}";
-    html += "button {background-color: #4CAF50; color: white; border: none; cursor: pointer; width: 200px;}";
-    html += "a {margin: 10px;} label {display: block; text-align: left;}";
-    html += "#stationFields {display: none;} .checkbox-container {text-align: left; margin-left: 50px;}";
-    html += "</style><script>";
-    html += "function toggleStationFields() {";
-    html += "  var checkBox = document.getElementById('stationMode');";
-    html += "  var fields = document.getElementById('stationFields');";
-    html += "  fields.style.display = checkBox.checked ? 'block' : 'none';";
-    html += "}</script></head>";
-    html += "<body><h1>DB3 WiFi Configuration</h1>";
-    html += "<h2>";
-    html += get_status();
-    html += "</h2>";
-    html += "<p><a href='/logs'>View Logs</a> | <a href='/status'>View Status</a></p>";
-    html += "<form action='/configure' method='POST'>";
-    html += "<h3>Configure WiFi Modes</h3>";
-    html += "<div class='checkbox-container'>";
-    html += "<label><input type='checkbox' name='station' id='stationMode' " + String(stationEnabled ? "checked" : "") + " onchange='toggleStationFields()'> Station Mode</label>";
-    html += "<div id='stationFields' " + String(stationEnabled ? "style='display:block;'" : "") + ">";
-    html += "SSID: <input type='text' name='station_ssid' value='" + station_ssid + "'><br>";
-    html += "password: <input type='password' name='station_password' value='" + station_password + "'><br>";
-    html += "</div>";
-    html += "<label><input type='checkbox' name='ap' " + String(apEnabled ? "checked" : "") + "> Access Point Mode (SSID: " + ap_ssid + ", password: " + ap_password + ")</label>";
-    html += "<label><input type='checkbox' name='espnow' " + String(espnowEnabled ? "checked" : "") + "> ESPNOW Mode</label>";
-    html += "<label><input type='checkbox' name='ota' " + String(otaEnabled ? "checked" : "") + "> Enable OTA Updates</label>";
-    html += "</div>";
-    html += "<button type='submit'>Apply Configuration</button></form>";
-    html += "</body></html>";
-    server.send(200, "text/html", html);
-    logger.printf("Default page sent to client. %d bytes\n", html.length());
+    server.sendHeader("ETag", WEBUI_ETAG);
+    server.sendHeader("Cache-Control", "no-cache");
+    if (server.header("If-None-Match") == WEBUI_ETAG) {
+      server.send(304);
+      logger.println("Default page not modified, 304 sent to client.");
+      return;
+    }
+    server.sendHeader("Content-Encoding", "gzip");
+    server.send_P(200, "text/html", (const char*)WEBUI_HTML_GZ, WEBUI_HTML_GZ_LEN);
+    logger.printf("Default page sent to client. %d bytes\n", WEBUI_HTML_GZ_LEN);
+  }
+
+  // Quoted JSON string, SSIDs may hold quotes, backslashes or control characters
+  static String jsonString(const String& value) {
+    String out;
+    out.reserve(value.length() + 8);
+    out += '"';
+    for (unsigned int i = 0; i < value.length(); i++) {
+      char c = value[i];
+      if (c == '"' || c == '\\') {
+        out += '\\';
+        out += c;
+      } else if ((uint8_t)c < 0x20) {
+        char escaped[8];
+        snprintf(escaped, sizeof(escaped), "\\u%04x", (uint8_t)c);
+        out += escaped;
+      } else {
+        out += c;
+      }
+    }
+    out += '"';
+    return out;
+  }
+
+  void handleConfigJson() {
+    String json;
+    json.reserve(512);
+    json += "{\"station\":";
+    json += stationEnabled ? "true" : "false";
+    json += ",\"ssid\":";
+    json += jsonString(station_ssid);
+    json += ",\"ap\":";
+    json += apEnabled ? "true" : "false";
+    json += ",\"ap_ssid\":";
+    json += jsonString(ap_ssid);
+    json += ",\"espnow\":";
+    json += espnowEnabled ? "true" : "false";
+    json += ",\"ota\":";
+    json += otaEnabled ? "true" : "false";
+    json += ",\"ws_port\":";
+    json += websocket.getPort();
+    json += ",\"status\":";
+    json += jsonString(get_status());
+    json += "}";
+    server.send(200, "application/json", json);
   }
 
   void handleLogs() {
@@ -225,7 +256,7 @@ private:
   void handleStatus() {
     logger.println("Handling status page request...");
     String html;
-    html.reserve(512);
+    html.reserve(2048);
     html += "<!DOCTYPE html><html><head><title>ESP32 Status</title>";
     html += "<style>body {font-family: Arial, sans-serif; text-align: center; margin-top: 50px;}</style>";
     html += "</head><body><h1>ESP32 Status</h1>";
@@ -233,11 +264,31 @@ private:
     html += "<p>";
     html += get_status();
     html += "</p>";
+    html += visca.getSessionStatus();
+    html += "<form action='/visca' method='POST'><h3>VISCA control priority</h3>";
+    html += "Rule (0-3): <input type='number' name='rule' min='0' max='3' value='0'><br>";
+    html += "Client IP: <input type='text' name='ip'><br>";
+    html += "Priority: <input type='number' name='priority' min='0' max='9' value='2'><br>";
+    html += "Takeover timeout ms: <input type='number' name='takeover' min='0' value='";
+    html += visca.getTakeoverTimeout();
+    html += "'><br>";
+    html += "<button type='submit'>Apply</button></form>";
     html += "</body></html>";
     server.send(200, "text/html", html);
     logger.printf("Status page sent to client. %d bytes\n", html.length());
   }
 
+  void handleViscaPriority() {
+    logger.println("Handling VISCA priority request...");
+    IPAddress ip;
+    if (!ip.fromString(server.arg("ip").c_str())) {
+      ip = IPAddress(0, 0, 0, 0);                       //An empty or invalid address clears the rule
+    }
+    visca.setControlPriority(server.arg("rule").toInt(), ip, server.arg("priority").toInt(), server.arg("takeover").toInt());
+    server.sendHeader("Location", "/status");
+    server.send(303);
+  }
+
   void handleConfigure() {
     logger.println("Handling configuration request...");
     bool newStationEnabled = server.hasArg("station");
@@ -257,8 +308,10 @@ private:
     espnowEnabled = newESPNOWEnabled;
     otaEnabled = newOTAEnabled;
     if (stationEnabled) {
+      if (newstation_password.length() > 0 || newstation_ssid != station_ssid) {
+        station_password = newstation_password;           //The UI does not echo the stored password, keep it if left empty
+      }
       station_ssid = newstation_ssid;
-      station_password = newstation_password;
     } else {
       station_ssid = "";
       station_password = "";
@@ -433,11 +486,11 @@ private:
   }
 
 public:
-  WiFiConfigManager(esp_now_recv_cb_t receiveCb, esp_now_send_cb_t sendCb, Logger& log, UDPViscaHandler& visca_handler)
+  WiFiConfigManager(esp_now_recv_cb_t receiveCb, esp_now_send_cb_t sendCb, Logger& log, UDPViscaHandler& visca_handler, WebSocketControl& websocket_control)
     : server(80), station_ssid(""), station_password(""), stationEnabled(false), apEnabled(true), 
       espnowEnabled(false), espnowActive(false), serverActive(false), otaEnabled(false),
       receiveCallback(receiveCb), sentCallback(sendCb), logger(log),
-      coap_server(log), visca(visca_handler), config_applied(false), loop_counter(0) {
+      coap_server(log), http_ota(server, log), visca(visca_handler), websocket(websocket_control), config_applied(false), loop_counter(0) {
     ap_ssid = getUniqueName();
   }
 
@@ -469,9 +522,13 @@ public:
       if (serverActive) {
         logger.println("Configuring server routes...");
         server.on("/", [this]() { handleRoot(); });
+        server.on("/api/config", [this]() { handleConfigJson(); });
         server.on("/configure", HTTP_POST, [this]() { handleConfigure(); });
         server.on("/logs", [this]() { handleLogs(); });
         server.on("/status", [this]() { handleStatus(); });
+        server.on("/visca", HTTP_POST, [this]() { handleViscaPriority(); });
+        server.on("/ota", HTTP_GET, [this]() { http_ota.handleGet(); });
+        server.on("/ota", HTTP_PUT, [this]() { http_ota.handlePut(); }, [this]() { http_ota.handleRaw(); });
       }
       config_applied = true;
     }
@@ -480,8 +537,10 @@ public:
       coap_server.loop();
       if (otaEnabled) {
         ArduinoOTA.handle();
+        http_ota.loop();
       }
-      return visca.processPackets();
+      bool websocket_command = websocket.loop();
+      return visca.processPackets() || websocket_command;
     }
     return false;
   }
@@ -6,11 +6,45 @@
 
 
 void coap_callback_discovery(CoapPacket &packet, IPAddress ip, int port);
+void coap_callback_position(CoapPacket &packet, IPAddress ip, int port);
+void coap_callback_status(CoapPacket &packet, IPAddress ip, int port);
+void coap_callback_tally(CoapPacket &packet, IPAddress ip, int port);
+void coap_callback_presets(CoapPacket &packet, IPAddress ip, int port);
+void coap_callback_ack(CoapPacket &packet, IPAddress ip, int port);
 
+// Resource bodies as JSON, filled in by the sketch. They return the length written
+int CoapPositionJson(char* out, size_t size);
+int CoapStatusJson(char* out, size_t size);
+int CoapTallyJson(char* out, size_t size);
+int CoapPresetsJson(char* out, size_t size);
+
+enum CoapResource { COAP_RES_POSITION = 0, COAP_RES_STATUS, COAP_RES_TALLY, COAP_RES_PRESETS, COAP_RESOURCES };
+
+struct CoapResourceConfig {
+    const char* path;
+    int (*render)(char* out, size_t size);
+    uint32_t min_interval_ms;                     // Fastest a change is pushed to observers
+};
+
+static const CoapResourceConfig COAP_RESOURCE_CONFIG[COAP_RESOURCES] = {
+    {"position", CoapPositionJson, 100},
+    {"status", CoapStatusJson, 1000},
+    {"tally", CoapTallyJson, 20},
+    {"presets", CoapPresetsJson, 1000},
+};
+
+// CoAP discovery and observable head state
+//
+// Discovery still answers on the multicast group. /position, /status, /tally and /presets can be read with a GET
+// or observed (RFC 7641): a GET with Observe 0 registers the client, and loop() then renders each observed resource
+// at most every min_interval_ms and notifies only when the body changed. Notifications are non-confirmable, except
+// one every CON_INTERVAL_MS per observer; a client that did not acknowledge the previous one by then is dropped.
+// The library has no way to add options to a response, so resource replies are encoded here and sent on its socket.
 class CoapServer {
 public:
-    CoapServer(Logger &alogger):is_started(false),coap(coapudp),logger(alogger){
+    CoapServer(Logger &alogger):is_started(false),logger(alogger),coap(coapudp, COAP_BUFFER),next_mid(0){
         instance=this;
+        clearObservers();
     }
 
     void begin() {
@@ -21,14 +55,21 @@ public:
         // Register server callbacks
         logger.println("Setting up CoAP callbacks");
         coap.server(coap_callback_discovery, ".well-known/core");
+        coap.server(coap_callback_position, COAP_RESOURCE_CONFIG[COAP_RES_POSITION].path);
+        coap.server(coap_callback_status, COAP_RESOURCE_CONFIG[COAP_RES_STATUS].path);
+        coap.server(coap_callback_tally, COAP_RESOURCE_CONFIG[COAP_RES_TALLY].path);
+        coap.server(coap_callback_presets, COAP_RESOURCE_CONFIG[COAP_RES_PRESETS].path);
+        coap.response(coap_callback_ack);       // ACKs of confirmable notifications
 
         // Start CoAP
         // coap.start(); dont do this, it will overwrite the beginMulticast
+        next_mid = (uint16_t)esp_random();
         is_started=true;
     }
 
     void end() {
-        coap=Coap(coapudp);
+        coap=Coap(coapudp, COAP_BUFFER);
+        clearObservers();
 
         is_started=false;
     }
@@ -37,6 +78,7 @@ public:
         // Process incoming CoAP packets
         if (is_started) {
             coap.loop();
+            notifyObservers();
         }
     }
 
@@ -52,8 +94,17 @@ public:
         logger.println("Received CoAP request, responding...");
         if (packet.code == COAP_GET) {
         logger.println("Received CoAP discovery request, responding...");
-        char payload[512];
-        snprintf(payload, sizeof(payload), "</gimbal>;title=\"DigitalBird DB3 Wifi\";rt=\"gimbal\";if=\"VISCA\";ct=0;anchor=\"visca://%s:%d\"", getCurrentIP().toString().c_str(),GetUdpViscaPort()  );
+        char payload[COAP_BUFFER];
+        int len = snprintf(payload, sizeof(payload), "</gimbal>;title=\"DigitalBird DB3 Wifi\";rt=\"gimbal\";if=\"VISCA\";ct=0;anchor=\"visca://%s:%d\"", getCurrentIP().toString().c_str(),GetUdpViscaPort()  );
+        for (int r = 0; r < COAP_RESOURCES && len < (int)sizeof(payload); r++) {
+            len += snprintf(payload + len, sizeof(payload) - len, ",</%s>;rt=\"gimbal.%s\";ct=50;obs", COAP_RESOURCE_CONFIG[r].path, COAP_RESOURCE_CONFIG[r].path);
+        }
+        if (len > DISCOVERY_MAX) {            // The library would write past its packet buffer
+            logger.printf("\nCoAP discovery reply of %d bytes does not fit the %d byte buffer", len, (int)COAP_BUFFER);
+            coap.sendResponse(ip, port, packet.messageid, NULL, 0,
+                                COAP_INTERNAL_SERVER_ERROR, COAP_NONE, packet.token, packet.tokenlen);
+            return;
+        }
         coap.sendResponse(ip, port, packet.messageid, payload, strlen(payload),
                             COAP_CONTENT, COAP_APPLICATION_LINK_FORMAT, packet.token, packet.tokenlen);
         } else {
@@ -62,14 +113,221 @@ public:
                             COAP_METHOD_NOT_ALLOWD, COAP_NONE, packet.token, packet.tokenlen);
         }
     }
+
+    void callback_resource(CoapResource resource, CoapPacket &packet, IPAddress ip, int port) {
+        if (packet.code != COAP_GET) {
+            coap.sendResponse(ip, port, packet.messageid, NULL, 0,
+                                COAP_METHOD_NOT_ALLOWD, COAP_NONE, packet.token, packet.tokenlen);
+            return;
+        }
+        int len = render(resource);
+        int32_t observe = -1;                   // No Observe option in the reply, the client is not registered
+        long request = observeOption(packet);
+        if (request == 0) {
+            if (addObserver(resource, packet, ip, port)) {
+                observe = sequence[resource];
+                if (observerCount(resource) == 1) last_hash[resource] = hash(body, len);
+            }
+        } else if (request == 1) {
+            removeObserver(resource, packet, ip, port);
+        }
+        bool confirmable = packet.type == COAP_CON;
+        send(ip, port, confirmable ? COAP_ACK : COAP_NONCON, confirmable ? packet.messageid : next_mid++,
+             packet.token, packet.tokenlen, observe, len);
+    }
+
+    void callback_ack(CoapPacket &packet, IPAddress ip, int port) {
+        for (int i = 0; i < MAX_OBSERVERS; i++) {
+            Observer& o = observers[i];
+            if (o.active && o.con_pending && o.con_mid == packet.messageid && o.ip == ip && o.port == port) {
+                o.con_pending = false;
+            }
+        }
+    }
+
 private:
+    struct Observer {
+        bool active;
+        CoapResource resource;
+        IPAddress ip;
+        int port;
+        uint8_t token[8];
+        uint8_t tokenlen;
+        unsigned long last_con_ms;
+        uint16_t con_mid;
+        bool con_pending;                       // Confirmable notification not acknowledged yet
+    };
+
+    static const int COAP_BUFFER = 512;              // Library packet buffer, its 128 byte default is too small for discovery
+    static const int DISCOVERY_MAX = COAP_BUFFER - 32;   // Room left for the header, token and options
+    static const int MAX_OBSERVERS = 8;
+    static const uint32_t CON_INTERVAL_MS = 30000;   // Also refreshes clients before the default Max-Age of 60s runs out
+    static const size_t BODY_MAX = 1024;
+    static const uint8_t CONTENT_FORMAT_JSON = 50;
+
     bool is_started;
     WiFiUDP coapudp;
     Logger &logger;
     Coap coap;
+    uint16_t next_mid;
+    Observer observers[MAX_OBSERVERS];
+    uint32_t sequence[COAP_RESOURCES];          // Observe sequence numbers, 24 bit
+    uint32_t last_hash[COAP_RESOURCES];         // Body the observers have now
+    unsigned long last_check_ms[COAP_RESOURCES];
+    char body[BODY_MAX];
+    uint8_t packet_buffer[BODY_MAX + 32];
+
+    void clearObservers() {
+        for (int i = 0; i < MAX_OBSERVERS; i++) {
+            observers[i].active = false;
+        }
+        for (int r = 0; r < COAP_RESOURCES; r++) {
+            sequence[r] = 0;
+            last_hash[r] = 0;
+            last_check_ms[r] = 0;
+        }
+    }
+
+    static uint32_t hash(const char* text, int len) {
+        uint32_t h = 2166136261UL;              // FNV-1a
+        for (int i = 0; i < len; i++) {
+            h = (h ^ (uint8_t)text[i]) * 16777619UL;
+        }
+        return h;
+    }
+
+    int render(CoapResource resource) {
+        int len = COAP_RESOURCE_CONFIG[resource].render(body, sizeof(body));
+        if (len < 0) len = 0;
+        if (len >= (int)sizeof(body)) len = sizeof(body) - 1;
+        return len;
+    }
+
+    // Value of the Observe option, -1 if the request has none
+    static long observeOption(const CoapPacket &packet) {
+        for (int i = 0; i < packet.optionnum; i++) {
+            const CoapOption &option = packet.options[i];
+            if (option.number != COAP_OBSERVE) continue;
+            long value = 0;
+            for (int b = 0; b < option.length && b < 3; b++) {
+                value = (value << 8) | option.buffer[b];
+            }
+            return value;
+        }
+        return -1;
+    }
+
+    int observerCount(CoapResource resource) const {
+        int count = 0;
+        for (int i = 0; i < MAX_OBSERVERS; i++) {
+            if (observers[i].active && observers[i].resource == resource) count++;
+        }
+        return count;
+    }
+
+    // A client observes a resource once, registering again only updates its token
+    bool addObserver(CoapResource resource, const CoapPacket &packet, IPAddress ip, int port) {
+        Observer* slot = NULL;
+        for (int i = 0; i < MAX_OBSERVERS; i++) {
+            Observer& o = observers[i];
+            if (o.active && o.resource == resource && o.ip == ip && o.port == port) {
+                slot = &o;
+                break;
+            }
+            if (!o.active && slot == NULL) slot = &o;
+        }
+        if (slot == NULL || packet.tokenlen > sizeof(slot->token)) {
+            logger.printf("\nCoAP observer table full, %s not registered for /%s", ip.toString().c_str(), COAP_RESOURCE_CONFIG[resource].path);
+            return false;
+        }
+        if (!slot->active) {
+            logger.printf("\nCoAP %s:%d observes /%s", ip.toString().c_str(), port, COAP_RESOURCE_CONFIG[resource].path);
+        }
+        slot->active = true;
+        slot->resource = resource;
+        slot->ip = ip;
+        slot->port = port;
+        memcpy(slot->token, packet.token, packet.tokenlen);
+        slot->tokenlen = packet.tokenlen;
+        slot->last_con_ms = millis();
+        slot->con_pending = false;
+        return true;
+    }
+
+    void removeObserver(CoapResource resource, const CoapPacket &packet, IPAddress ip, int port) {
+        for (int i = 0; i < MAX_OBSERVERS; i++) {
+            Observer& o = observers[i];
+            if (o.active && o.resource == resource && o.ip == ip && o.port == port) {
+                logger.printf("\nCoAP %s:%d stops observing /%s", ip.toString().c_str(), port, COAP_RESOURCE_CONFIG[resource].path);
+                o.active = false;
+            }
+        }
+    }
+
+    void notifyObservers() {
+        unsigned long now = millis();
+        for (int r = 0; r < COAP_RESOURCES; r++) {
+            CoapResource resource = (CoapResource)r;
+            if (observerCount(resource) == 0 || now - last_check_ms[r] < COAP_RESOURCE_CONFIG[r].min_interval_ms) continue;
+            last_check_ms[r] = now;
+            int len = render(resource);
+            uint32_t h = hash(body, len);
+            bool changed = h != last_hash[r];
+            if (changed) {
+                last_hash[r] = h;
+                sequence[r] = (sequence[r] + 1) & 0xFFFFFF;
+            }
+            for (int i = 0; i < MAX_OBSERVERS; i++) {
+                Observer& o = observers[i];
+                if (!o.active || o.resource != resource) continue;
+                bool confirm = now - o.last_con_ms >= CON_INTERVAL_MS;
+                if (!changed && !confirm) continue;
+                if (confirm) {
+                    if (o.con_pending) {
+                        logger.printf("\nCoAP %s:%d stopped answering, dropped from /%s", o.ip.toString().c_str(), o.port, COAP_RESOURCE_CONFIG[r].path);
+                        o.active = false;
+                        continue;
+                    }
+                    o.last_con_ms = now;
+                    o.con_mid = next_mid;
+                    o.con_pending = true;
+                }
+                send(o.ip, o.port, confirm ? COAP_CON : COAP_NONCON, next_mid++, o.token, o.tokenlen, sequence[r], len);
+            }
+        }
+    }
+
+    // 2.05 Content with the JSON body, and the Observe option when observe is not negative
+    void send(IPAddress ip, int port, COAP_TYPE type, uint16_t mid, const uint8_t* token, uint8_t tokenlen, int32_t observe, int len) {
+        uint8_t* p = packet_buffer;
+        *p++ = 0x40 | (type << 4) | tokenlen;   // Version 1
+        *p++ = COAP_CONTENT;
+        *p++ = mid >> 8;
+        *p++ = mid & 0xFF;
+        memcpy(p, token, tokenlen);
+        p += tokenlen;
+        uint8_t last_option = 0;
+        if (observe >= 0) {
+            uint8_t length = observe == 0 ? 0 : observe < 0x100 ? 1 : observe < 0x10000 ? 2 : 3;
+            *p++ = ((COAP_OBSERVE - last_option) << 4) | length;
+            for (int b = length - 1; b >= 0; b--) {
+                *p++ = (observe >> (8 * b)) & 0xFF;
+            }
+            last_option = COAP_OBSERVE;
+        }
+        *p++ = ((COAP_CONTENT_FORMAT - last_option) << 4) | 1;
+        *p++ = CONTENT_FORMAT_JSON;
+        *p++ = 0xFF;                            // Payload marker
+        memcpy(p, body, len);
+        p += len;
+        coapudp.beginPacket(ip, port);
+        coapudp.write(packet_buffer, p - packet_buffer);
+        coapudp.endPacket();
+    }
+
 public:
     static CoapServer* instance;
-    
+
 };
 
 CoapServer* CoapServer::instance = nullptr;
@@ -78,6 +336,26 @@ void coap_callback_discovery(CoapPacket &packet, IPAddress ip, int port) {
     CoapServer::instance->callback_discovery(packet, ip, port);
 }
 
+void coap_callback_position(CoapPacket &packet, IPAddress ip, int port) {
+    CoapServer::instance->callback_resource(COAP_RES_POSITION, packet, ip, port);
+}
+
+void coap_callback_status(CoapPacket &packet, IPAddress ip, int port) {
+    CoapServer::instance->callback_resource(COAP_RES_STATUS, packet, ip, port);
+}
+
+void coap_callback_tally(CoapPacket &packet, IPAddress ip, int port) {
+    CoapServer::instance->callback_resource(COAP_RES_TALLY, packet, ip, port);
+}
+
+void coap_callback_presets(CoapPacket &packet, IPAddress ip, int port) {
+    CoapServer::instance->callback_resource(COAP_RES_PRESETS, packet, ip, port);
+}
+
+void coap_callback_ack(CoapPacket &packet, IPAddress ip, int port) {
+    CoapServer::instance->callback_ack(packet, ip, port);
+}
+
 
 
-#endif // COAP_SERVER_H
\ No newline at end of file
+#endif // COAP_SERVER_H
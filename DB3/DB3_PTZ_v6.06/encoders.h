@@ -52,8 +52,12 @@ public:
 int getRawPosition(){
  return encoder.getPosition();
 }
+int readRawPosition(){                         // getRawPosition() for callers that do not hold the bus yet
+  I2CTransaction bus(i2c_bus);
+  return getRawPosition();
+}
 void checkEncoder(Logger & logger) {                                              //This function checks to see if the zoom and or Focus motors are available before running the encoder script for them
-    TCA9548A(i2c_bus);
+    I2CTransaction bus(i2c_bus);
     Wire.beginTransmission(0x36); //connect to the sensor
     Wire.write(0x0B); //figure 21 - register map: Status: MD ML MH
     Wire.endTransmission(); //end transmission
@@ -89,11 +93,11 @@ void checkEncoder(Logger & logger) {
   EncoderState(char* anid, uint8_t abus, double aratio, bool reverse):id(anid),i2c_bus(abus),gear_ratio(aratio),should_reverse(reverse),resetEncoder(1), revolutions(0), E_position(0), E_outputPos(0), S_position(0), E_Trim(0), E_Current(0), E_Turn(0),
   E_outputTurn(0),E_outputHold(32728),loopcount(0), S_lastPosition(0), encoder_available(false)
   {
-    
+    i2cbus.setName(abus, anid);
   }
 
   void Start_Encoder() {
-    TCA9548A(i2c_bus);
+    I2CTransaction bus(i2c_bus);
     handle_reset_request();
     
     output = encoder.getPosition();           // get the raw value of the encoder
@@ -1,8 +1,130 @@
-// Select I2C BUS
-void TCA9548A(uint8_t bus) {
-  Wire.beginTransmission(0x70);  // TCA9548A address
-  Wire.write(1 << bus);          // send byte to select bus
-  Wire.endTransmission();
-  //logger.print(bus);
-}
+#ifndef I2C_H
+#define I2C_H
 
+#include <Wire.h>
+#include <esp_timer.h>
+#include "Logger.h"
+
+// Owner of Wire and the TCA9548A mux
+//
+// The encoders sit on mux channels 0-3 and the OLED on 4. They are used from setup(), the encoder task and the
+// battery task, so nothing may touch Wire outside an I2CTransaction. A transaction takes the bus, switches the mux
+// only if the last select was for another channel, and adds its time on the bus to that channel's stats.
+class I2CArbiter {
+public:
+  static const uint8_t CHANNELS = 8;
+
+private:
+  struct ChannelStats {
+    const char* name;
+    uint32_t transactions;
+    uint32_t selects;                             // Transactions that had to switch the mux
+    uint64_t busy_us;
+    uint32_t max_us;
+  };
+
+  SemaphoreHandle_t mutex;
+  int selected;                                   // Mux channel last selected, -1 if unknown
+  ChannelStats stats[CHANNELS];
+  unsigned long stats_start_ms;
+
+  static const uint8_t MUX_ADDRESS = 0x70;
+  static const uint32_t CLOCK_HZ = 400000;        // Mux, AS5600 and SSD1306 all do fast mode
+
+public:
+  I2CArbiter() : mutex(NULL), selected(-1), stats_start_ms(0) {
+    for (int i = 0; i < CHANNELS; i++) {
+      stats[i] = ChannelStats{NULL, 0, 0, 0, 0};
+    }
+  }
+
+  // First thing in setup(), before anything talks to the bus
+  void begin() {
+    mutex = xSemaphoreCreateRecursiveMutex();
+    Wire.begin();
+    Wire.setClock(CLOCK_HZ);
+    stats_start_ms = millis();
+  }
+
+  void setName(uint8_t channel, const char* name) {
+    stats[channel].name = name;
+  }
+
+  void lock() {
+    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+  }
+
+  void unlock() {
+    xSemaphoreGiveRecursive(mutex);
+  }
+
+  // Bus must be held. Returns false if the mux did not answer
+  bool select(uint8_t channel) {
+    if (channel == selected) return true;
+    Wire.beginTransmission(MUX_ADDRESS);
+    Wire.write(1 << channel);
+    if (Wire.endTransmission() != 0) {
+      selected = -1;                              // Make the next transaction select again
+      return false;
+    }
+    selected = channel;
+    stats[channel].selects++;
+    return true;
+  }
+
+  void record(uint8_t channel, uint32_t us) {
+    ChannelStats& s = stats[channel];
+    s.transactions++;
+    s.busy_us += us;
+    if (us > s.max_us) s.max_us = us;
+  }
+
+  // Per channel transaction count, mux switches and time on the bus since the last call
+  void logStats(Logger& logger) {
+    lock();
+    unsigned long elapsed = millis() - stats_start_ms;
+    for (int i = 0; i < CHANNELS; i++) {
+      ChannelStats& s = stats[i];
+      if (s.transactions == 0) continue;
+      logger.printf("\nI2C %d %s: %lu transactions, %lu selects, avg %lu us, max %lu us, %lu%% of the bus",
+                    i, s.name != NULL ? s.name : "", (unsigned long)s.transactions, (unsigned long)s.selects,
+                    (unsigned long)(s.busy_us / s.transactions), (unsigned long)s.max_us,
+                    elapsed > 0 ? (unsigned long)(s.busy_us / 10 / elapsed) : 0UL);
+      s.transactions = 0;
+      s.selects = 0;
+      s.busy_us = 0;
+      s.max_us = 0;
+    }
+    stats_start_ms = millis();
+    unlock();
+  }
+};
+
+I2CArbiter i2cbus;
+
+// Holds the bus and the mux channel for its scope
+class I2CTransaction {
+private:
+  uint8_t channel;
+  bool selected;
+  int64_t start;
+
+public:
+  I2CTransaction(uint8_t achannel) : channel(achannel) {
+    i2cbus.lock();
+    start = esp_timer_get_time();
+    selected = i2cbus.select(channel);
+  }
+
+  ~I2CTransaction() {
+    i2cbus.record(channel, (uint32_t)(esp_timer_get_time() - start));
+    i2cbus.unlock();
+  }
+
+  // False if the mux did not switch, the device is then not reachable
+  bool ok() const {
+    return selected;
+  }
+};
+
+#endif // I2C_H
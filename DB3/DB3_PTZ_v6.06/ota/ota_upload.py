@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+# Sends a firmware image to one or more heads over HTTP, gzip compressed and in pieces (see HttpOta.h). A dropped
+# piece is resumed from the offset the head reports, so a weak link only costs the piece that was lost:
+#   python3 ota_upload.py DB3_PTZ_v6.06.ino.bin 192.168.1.50 192.168.1.51 DB_A1B2C3.local
+# OTA has to be enabled in the head's web page. Add --password if the access point password was changed.
+import argparse
+import base64
+import gzip
+import hashlib
+import http.client
+import json
+import sys
+import threading
+import time
+
+parser = argparse.ArgumentParser()
+parser.add_argument('image', help='firmware .bin as exported by the Arduino IDE, or already gzipped')
+parser.add_argument('heads', nargs='+', help='head addresses or mDNS names')
+parser.add_argument('--password', default='arduino1')
+parser.add_argument('--piece', type=int, default=32768, help='bytes per request')
+parser.add_argument('--retries', type=int, default=20)
+args = parser.parse_args()
+
+data = open(args.image, 'rb').read()
+if data[:2] == b'\x1f\x8b':
+    image = gzip.decompress(data)
+else:
+    image = data
+    data = gzip.compress(image, 9, mtime=0)
+md5 = hashlib.md5(image).hexdigest()
+auth = 'Basic ' + base64.b64encode(('ota:' + args.password).encode()).decode()
+print('%s: %d bytes, %d gzipped, MD5 %s' % (args.image, len(image), len(data), md5))
+
+
+def request(head, method, body=None, headers={}):
+    conn = http.client.HTTPConnection(head, 80, timeout=30)
+    try:
+        conn.request(method, '/ota', body, dict(headers, Authorization=auth))
+        response = conn.getresponse()
+        text = response.read().decode()
+        return response.status, json.loads(text) if text.startswith('{') else {}
+    finally:
+        conn.close()
+
+
+def update(head, results):
+    offset, failures = 0, 0
+    while offset < len(data):
+        last = min(offset + args.piece, len(data)) - 1
+        headers = {'Content-Range': 'bytes %d-%d/%d' % (offset, last, len(data)),
+                   'Content-Type': 'application/octet-stream', 'X-Image-MD5': md5}
+        try:
+            status, state = request(head, 'PUT', data[offset:last + 1], headers)
+            if status == 409:
+                offset = 0                        # The head lost the update, start again
+                continue
+            if status == 416:
+                status, state = request(head, 'GET')
+            if status != 200:
+                results[head] = 'failed: %d %s' % (status, state.get('error', ''))
+                return
+            offset = state['offset']
+        except (OSError, http.client.HTTPException, ValueError) as e:
+            failures += 1
+            if failures > args.retries:
+                results[head] = 'failed: %s' % e
+                return
+            time.sleep(2)
+            try:
+                offset = request(head, 'GET')[1].get('offset', 0)
+            except (OSError, http.client.HTTPException, ValueError):
+                pass
+            print('%s: resuming at %d' % (head, offset))
+            continue
+        print('%s: %d%%' % (head, 100 * offset // len(data)))
+    results[head] = 'done, restarting'
+
+
+results = {}
+threads = [threading.Thread(target=update, args=(head, results)) for head in args.heads]
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+for head in args.heads:
+    print('%s: %s' % (head, results.get(head, 'failed')))
+sys.exit(0 if all(r.startswith('done') for r in results.values()) and len(results) == len(args.heads) else 1)
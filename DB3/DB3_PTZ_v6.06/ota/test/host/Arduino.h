@@ -0,0 +1,31 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Just enough of the Arduino core for HttpOta.h to build on a PC
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+class String {
+public:
+  String(const char* s = "") : text(s) {}
+  const char* c_str() const { return text.c_str(); }
+  unsigned length() const { return text.length(); }
+
+private:
+  std::string text;
+};
+
+inline unsigned long millis() {
+  return 0;
+}
+
+struct EspClass {
+  bool restarted = false;
+  void restart() { restarted = true; }
+};
+extern EspClass ESP;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,38 @@
+#ifndef HOST_UPDATE_H
+#define HOST_UPDATE_H
+
+// Collects what would be written to the inactive partition
+#include <vector>
+#include "Arduino.h"
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+class UpdateClass {
+public:
+  std::vector<uint8_t> image;
+  bool running = false;
+  bool ended = false;
+
+  bool begin(size_t) {
+    image.clear();
+    running = true;
+    ended = false;
+    return true;
+  }
+  size_t write(uint8_t* data, size_t len) {
+    image.insert(image.end(), data, data + len);
+    return len;
+  }
+  bool end(bool) {
+    running = false;
+    ended = true;
+    return true;
+  }
+  bool setMD5(const char*) { return true; }
+  void abort() { running = false; }
+  bool isRunning() { return running; }
+  const char* errorString() { return "update error"; }
+};
+extern UpdateClass Update;
+
+#endif // HOST_UPDATE_H
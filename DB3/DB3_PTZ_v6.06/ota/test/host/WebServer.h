@@ -0,0 +1,35 @@
+#ifndef HOST_WEBSERVER_H
+#define HOST_WEBSERVER_H
+
+// A WebServer the test drives by hand: it fills raw() as the real one does while reading a body, and keeps the
+// last answer sent
+#include "Arduino.h"
+
+#define HTTP_RAW_BUFLEN 1436
+
+enum HTTPRawStatus { RAW_START, RAW_WRITE, RAW_END, RAW_ABORTED };
+
+struct HTTPRaw {
+  HTTPRawStatus status;
+  size_t totalSize;
+  size_t currentSize;
+  uint8_t buf[HTTP_RAW_BUFLEN];
+};
+
+class WebServer {
+public:
+  HTTPRaw raw_state = {};
+  int code = 0;
+  std::string body;
+
+  HTTPRaw& raw() { return raw_state; }
+  bool authenticate(const char*, const char*) { return true; }
+  void requestAuthentication() { code = 401; }
+  String header(const char*) { return String(); }
+  void send(int acode, const char*, const char* abody) {
+    code = acode;
+    body = abody;
+  }
+};
+
+#endif // HOST_WEBSERVER_H
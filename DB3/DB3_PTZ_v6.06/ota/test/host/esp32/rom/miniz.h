@@ -0,0 +1,9 @@
+#ifndef HOST_ROM_MINIZ_H
+#define HOST_ROM_MINIZ_H
+
+// The inflater in the ESP32 ROM is tinfl from miniz 1.15, the Makefile builds the same one from source
+#define MINIZ_HEADER_FILE_ONLY
+#include "miniz.c"
+#undef MINIZ_HEADER_FILE_ONLY
+
+#endif // HOST_ROM_MINIZ_H
@@ -2,58 +2,181 @@
 #define DATA_PIN 19
 CRGB leds[NUM_LEDS];
 
-int Tally;
+// Tally codes, as VISCA sends them plus one
+enum TallyState { TALLY_OFF = 0, TALLY_PREVIEW_FLASH, TALLY_PREVIEW, TALLY_PROGRAM, TALLY_CLEAR, TALLY_STATES };
 
-void SetupTallyLed(){
-    //Setup for Tally LED
-  FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
-  FastLED.setBrightness(90);
-}
+struct TallyPattern {
+  uint32_t colour;
+  bool flashing;
+};
+
+static const TallyPattern TallyPatterns[TALLY_STATES] = {
+  {CRGB::Black, false},                           //Off
+  {CRGB::Blue, true},                             //Flashing (in prevue)
+  {CRGB::Blue, false},                            //Prevue
+  {CRGB::Red, false},                             //Light always on (Live)
+  {CRGB::Black, false},                           //Normal or (off inactive)
+};
+
+// Tally light
+//
+// Everyone only sets the state; a task owns the LEDs and pushes them through FastLED only when the colour they
+// should show changed. Setting a state wakes the task at once, otherwise it wakes every POLL_MS to run the flash
+// pattern and read TSL UMD v5 packets, so a switcher on the network drives the tally directly.
+class TallyEngine {
+private:
+  Logger& logger;
+  TaskHandle_t task;
+  WiFiUDP udp;
+  volatile int state;
+  volatile bool enabled;                          // TLY from the controller, the LEDs stay dark while it is off
+  volatile int index;                             // TSL display index of this head
+  bool listening;
+  unsigned long network_check_ms;
+  uint32_t shown;                                 // Colour on the LEDs now
+  uint32_t shows;
+  uint32_t tsl_packets;
+
+  static const uint32_t POLL_MS = 10;
+  static const uint32_t FLASH_MS = 250;           // Half a flash period
+  static const uint16_t TSL_PORT = 8900;
+  static const uint16_t TSL_BROADCAST = 0xFFFF;
+  static const uint32_t NETWORK_CHECK_MS = 1000;
+
+  static void taskEntry(void* parameter) {
+    ((TallyEngine*)parameter)->run();
+  }
+
+  static bool networkUp() {
+    return WiFi.status() == WL_CONNECTED || ((WiFi.getMode() & WIFI_AP) && WiFi.softAPIP() != IPAddress(0, 0, 0, 0));
+  }
+
+  void checkNetwork() {
+    if (millis() - network_check_ms < NETWORK_CHECK_MS) return;
+    network_check_ms = millis();
+    bool up = networkUp();
+    if (up && !listening) {
+      listening = udp.begin(TSL_PORT);
+      if (listening) logger.printf("\nListening for TSL UMD v5 tally on UDP %d, index %d", TSL_PORT, index);
+    } else if (!up && listening) {
+      udp.stop();
+      listening = false;
+    }
+  }
+
+  // TSL UMD v5: PBC(2) VER(1) FLAGS(1) SCREEN(2), then per display INDEX(2) CONTROL(2) LENGTH(2) TEXT, all little endian.
+  // CONTROL bits 0-1, 2-3 and 4-5 are the RH, text and LH tallies, 1 red, 2 green, 3 amber
+  void readTsl() {
+    uint8_t packet[256];
+    int size;
+    while ((size = udp.parsePacket()) > 0) {
+      int len = udp.read(packet, sizeof(packet));
+      if (len < 6) continue;
+      uint8_t flags = packet[3];
+      if (flags & 0x02) continue;                 // Screen control data, no tally in it
+      int offset = 6;
+      while (offset + 6 <= len) {
+        uint16_t display = packet[offset] | (packet[offset + 1] << 8);
+        uint16_t control = packet[offset + 2] | (packet[offset + 3] << 8);
+        uint16_t length = packet[offset + 4] | (packet[offset + 5] << 8);
+        offset += 6 + length;
+        if (control & 0x8000) continue;           // Display control data
+        if (display != index && display != TSL_BROADCAST) continue;
+        bool program = false;
+        bool preview = false;
+        for (int shift = 0; shift <= 4; shift += 2) {
+          int lamp = (control >> shift) & 0x03;
+          if (lamp == 1 || lamp == 3) program = true;
+          if (lamp == 2) preview = true;
+        }
+        tsl_packets++;
+        set(program ? TALLY_PROGRAM : preview ? TALLY_PREVIEW : TALLY_OFF);
+      }
+    }
+  }
+
+  void render() {
+    int current = state;
+    if (current < 0 || current >= TALLY_STATES) current = TALLY_OFF;
+    const TallyPattern& p = TallyPatterns[current];
+    bool lit = enabled && (!p.flashing || (millis() / FLASH_MS) % 2 == 0);
+    uint32_t colour = lit ? p.colour : (uint32_t)CRGB::Black;
+    if (colour == shown) return;
+    for (int i = 0; i < NUM_LEDS; i++) {
+      leds[i] = colour;
+    }
+    FastLED.show();
+    shown = colour;
+    shows++;
+  }
 
-void SetTallyLed(int tally){
-    switch (tally) {
-      case 0:
-        leds[0] = CRGB::Black;
-        leds[1] = CRGB::Black;
-        FastLED.show(); break;
-      case 1:
-        leds[0] = CRGB::Blue;
-        leds[1] = CRGB::Blue;
-        FastLED.show(); break;
-      case 2:
-        leds[0] = CRGB::Blue;
-        leds[1] = CRGB::Blue;
-        FastLED.show(); break;
-      case 3:
-        leds[0] = CRGB::Red;
-        leds[1] = CRGB::Red;
-        FastLED.show(); break;
-
-      case 4:
-        leds[0] = CRGB::Black;
-        leds[1] = CRGB::Black;
-        FastLED.show(); break;
+  void run() {
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POLL_MS));
+      checkNetwork();
+      if (listening) readTsl();
+      render();
     }
+  }
 
+public:
+  TallyEngine(Logger& alogger)
+    : logger(alogger), task(NULL), state(TALLY_OFF), enabled(true), index(0), listening(false), network_check_ms(0),
+      shown(0xFFFFFFFF), shows(0), tsl_packets(0) {
+  }
+
+  void begin() {
+    FastLED.addLeds<WS2812B, DATA_PIN, GRB>(leds, NUM_LEDS);
+    FastLED.setBrightness(90);
+    xTaskCreatePinnedToCore(taskEntry, "Tally", 4096, this, 1, &task, 0);
+  }
+
+  void set(int astate) {
+    if (astate == state) return;
+    state = astate;
+    if (task != NULL) xTaskNotifyGive(task);
+  }
+
+  int get() const {
+    return state;
+  }
+
+  void setEnabled(bool aenabled) {
+    if (aenabled == enabled) return;
+    enabled = aenabled;
+    if (task != NULL) xTaskNotifyGive(task);
+  }
+
+  // Head ID as the switcher numbers its displays
+  void setIndex(int aindex) {
+    index = aindex;
+  }
+
+  void logStats() {
+    logger.printf("\nTally %d, %lu LED updates, %lu TSL messages for index %d", (int)state, (unsigned long)shows, (unsigned long)tsl_packets, (int)index);
+  }
+};
+
+TallyEngine tally(logger);
+
+void SetupTallyLed(){
+  tally.begin();
+}
+
+void SetTallyLed(int state){
+  tally.set(state);
 }
 
 void TurnOffTallyLight(){
- Tally = 0;                                            //Turn off the tally light
-        leds[0] = CRGB::Black;
-        leds[1] = CRGB::Black;
-        FastLED.show();
+  tally.set(TALLY_OFF);                                 //Turn off the tally light
 }
 
 void TurnOnTallyLight(){
-            Tally = 3;                                            //Turn on the tally light
-        leds[0] = CRGB::Red;
-        leds[1] = CRGB::Red;
-        FastLED.show();
-
+  tally.set(TALLY_PROGRAM);                             //Turn on the tally light
 }
 
 void ToggleTallyLight(){
-    if (Tally==0) {
+    if (tally.get() == TALLY_OFF) {
         TurnOnTallyLight();
     }else{
         TurnOffTallyLight();
@@ -61,11 +184,5 @@ void ToggleTallyLight(){
 }
 
 void LogTallyLightState(Logger & logger){
-    switch (Tally) {
-        case 0: logger.println("\nTally 0"); break; //Flashing (in prevue)
-        case 1: logger.println("\nTally 1"); break; //Flashing (in prevue)
-        case 2: logger.println("\nTally 2"); break; //Light Always on (Live)
-        case 3: logger.println("\nTally 3"); break; //Normal or (off inactive)
-        case 4: logger.println("\nTally 4"); break; //Normal or (off inactive)
-      }
-}
\ No newline at end of file
+  tally.logStats();
+}
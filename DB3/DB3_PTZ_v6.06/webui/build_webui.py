@@ -0,0 +1,26 @@
+#!/usr/bin/env python3
+# Regenerates ../webui_gz.h from index.html. Run from the webui folder after editing the page:
+#   python3 build_webui.py
+import gzip
+import os
+import zlib
+
+here = os.path.dirname(os.path.abspath(__file__))
+src = open(os.path.join(here, 'index.html'), 'rb').read()
+gz = gzip.compress(src, 9, mtime=0)             # mtime=0 keeps the output (and ETag) stable between builds
+etag = zlib.crc32(gz) & 0xffffffff
+
+rows = []
+for i in range(0, len(gz), 16):
+    rows.append('  ' + ', '.join('0x%02x' % b for b in gz[i:i + 16]) + ',')
+
+with open(os.path.join(here, '..', 'webui_gz.h'), 'w') as f:
+    f.write('#ifndef WEBUI_GZ_H\n#define WEBUI_GZ_H\n\n')
+    f.write('// Generated by webui/build_webui.py from webui/index.html, do not edit by hand.\n\n')
+    f.write('#define WEBUI_ETAG "\\"%08x\\""\n' % etag)
+    f.write('#define WEBUI_HTML_GZ_LEN %d\n\n' % len(gz))
+    f.write('const uint8_t WEBUI_HTML_GZ[WEBUI_HTML_GZ_LEN] PROGMEM = {\n')
+    f.write('\n'.join(rows))
+    f.write('\n};\n\n#endif // WEBUI_GZ_H\n')
+
+print('index.html %d bytes -> webui_gz.h %d bytes gzipped, ETag %08x' % (len(src), len(gz), etag))
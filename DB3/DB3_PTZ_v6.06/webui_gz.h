@@ -0,0 +1,131 @@
+#ifndef WEBUI_GZ_H
+#define WEBUI_GZ_H
+
+// Generated by webui/build_webui.py from webui/index.html, do not edit by hand.
+
+#define WEBUI_ETAG "\"c402cd05\""
+#define WEBUI_HTML_GZ_LEN 1895
+
+const uint8_t WEBUI_HTML_GZ[WEBUI_HTML_GZ_LEN] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x57, 0x6b, 0x73, 0xdb, 0xb6,
+  0x12, 0xfd, 0xae, 0x5f, 0xc1, 0x4b, 0xb7, 0x21, 0x19, 0xbd, 0xad, 0x38, 0x93, 0x2b, 0x8a, 0xec,
+  0x38, 0x4e, 0x3c, 0x93, 0x4e, 0x5b, 0x6b, 0x6a, 0xf7, 0xa6, 0x8d, 0xc7, 0xd3, 0x81, 0x48, 0x50,
+  0xc2, 0x35, 0x05, 0xf0, 0x12, 0xa0, 0x1e, 0x51, 0xf4, 0xdf, 0xbb, 0x0b, 0x80, 0x12, 0xa5, 0x4e,
+  0x6e, 0xf3, 0xc1, 0x22, 0x1e, 0x8b, 0x7d, 0x9c, 0x3d, 0xd8, 0x85, 0x27, 0xff, 0x7a, 0x77, 0x77,
+  0xf3, 0xf0, 0xc7, 0xf4, 0xbd, 0xb3, 0x50, 0xcb, 0x3c, 0x6e, 0x4d, 0xf4, 0x67, 0xb2, 0xa0, 0x24,
+  0x8d, 0x27, 0x4b, 0xaa, 0x88, 0x93, 0x2c, 0x48, 0x29, 0xa9, 0x8a, 0xdc, 0x4a, 0x65, 0xdd, 0x37,
+  0xae, 0x5d, 0xe5, 0x64, 0x49, 0x23, 0x77, 0xc5, 0xe8, 0xba, 0x10, 0xa5, 0x72, 0x9d, 0x44, 0x70,
+  0x45, 0x39, 0x48, 0xad, 0x59, 0xaa, 0x16, 0x51, 0x4a, 0x57, 0x2c, 0xa1, 0x5d, 0x3d, 0xe9, 0x30,
+  0xce, 0x14, 0x23, 0x79, 0x57, 0x26, 0x24, 0xa7, 0xd1, 0xd0, 0x05, 0x2b, 0x8a, 0xa9, 0x9c, 0xc6,
+  0xef, 0xde, 0x8e, 0x9c, 0xe9, 0xc3, 0xa7, 0x49, 0xdf, 0x4c, 0x5b, 0x13, 0xa9, 0xb6, 0xf8, 0x9d,
+  0x89, 0x74, 0xbb, 0xcb, 0x40, 0x63, 0x37, 0x23, 0x4b, 0x96, 0x6f, 0xc7, 0xd7, 0x25, 0x9c, 0xef,
+  0x48, 0xc2, 0x65, 0x57, 0xd2, 0x92, 0x65, 0xa1, 0xa2, 0x1b, 0xd5, 0x25, 0x39, 0x9b, 0xf3, 0x71,
+  0x02, 0x66, 0x69, 0x19, 0x2e, 0x49, 0x39, 0x67, 0x7c, 0x7c, 0x39, 0x28, 0x36, 0xe1, 0x8c, 0x24,
+  0xcf, 0xf3, 0x52, 0x54, 0x3c, 0x1d, 0x5f, 0x5c, 0x5e, 0x5e, 0x86, 0x89, 0xc8, 0x45, 0x39, 0xbe,
+  0xa0, 0x94, 0xee, 0x5b, 0x64, 0x67, 0x67, 0x6f, 0x92, 0xac, 0x3e, 0x34, 0x84, 0x43, 0xfb, 0x56,
+  0x6f, 0x26, 0x36, 0xbb, 0x7a, 0xe5, 0xaa, 0xd8, 0x38, 0xa4, 0x52, 0x02, 0x44, 0x36, 0x26, 0x8c,
+  0xf1, 0x2b, 0xad, 0xbb, 0x20, 0x69, 0xca, 0xf8, 0x5c, 0x4b, 0x84, 0x33, 0x51, 0xa6, 0xb4, 0x1c,
+  0x0f, 0x41, 0x58, 0x8a, 0x9c, 0xa5, 0xce, 0xc5, 0xd5, 0xd5, 0xd5, 0xbe, 0x75, 0x01, 0x42, 0x3b,
+  0x73, 0xe8, 0xf2, 0x35, 0x1e, 0x5a, 0x50, 0x36, 0x5f, 0x28, 0x3b, 0x69, 0x18, 0x35, 0x26, 0x8c,
+  0x96, 0x6e, 0x49, 0x52, 0x56, 0xc9, 0xf1, 0xd5, 0xe0, 0xfb, 0x93, 0x00, 0x46, 0xa3, 0x51, 0x58,
+  0x08, 0x09, 0x10, 0x0a, 0x3e, 0x2e, 0x69, 0x4e, 0x14, 0x5b, 0xd1, 0x50, 0x89, 0x2a, 0x59, 0x74,
+  0x49, 0xa2, 0x57, 0xb9, 0xe0, 0x10, 0xd9, 0xc5, 0x33, 0x17, 0x33, 0x6b, 0xb6, 0x69, 0x55, 0x8f,
+  0xff, 0xbf, 0x8d, 0x57, 0x37, 0xd7, 0xb7, 0x57, 0x83, 0xa3, 0x19, 0x32, 0x83, 0x70, 0x2a, 0x45,
+  0xc3, 0x9c, 0x66, 0x0a, 0x3c, 0x45, 0x0d, 0x4a, 0x14, 0x66, 0xb4, 0x6f, 0x31, 0x5e, 0x54, 0xea,
+  0x51, 0x6d, 0x0b, 0x1a, 0x95, 0x84, 0xcf, 0xe9, 0x93, 0xb5, 0xfa, 0xef, 0xc1, 0xf7, 0xfb, 0xd6,
+  0xac, 0x52, 0x4a, 0xf0, 0x1a, 0xc8, 0x57, 0x0d, 0xc8, 0xde, 0x60, 0xf0, 0x8c, 0xd7, 0x70, 0xbe,
+  0x39, 0xcb, 0x94, 0x75, 0xc2, 0xa6, 0x27, 0xcb, 0xb2, 0x1a, 0x5e, 0x0c, 0x2f, 0x4c, 0xaa, 0x52,
+  0xc2, 0x7a, 0x21, 0x18, 0xa6, 0x1b, 0xa2, 0x95, 0xe0, 0xd0, 0xae, 0x79, 0x3e, 0x01, 0xa0, 0x2c,
+  0xe8, 0xc6, 0xcd, 0x9c, 0xcc, 0x68, 0xbe, 0x4b, 0x99, 0x2c, 0x72, 0xb2, 0x1d, 0xcf, 0x72, 0x91,
+  0x3c, 0x37, 0x89, 0x83, 0xb1, 0xd5, 0xc9, 0x78, 0x0d, 0xb9, 0x18, 0xe9, 0x43, 0xa0, 0x97, 0x20,
+  0x06, 0xb7, 0x8c, 0xe6, 0xa9, 0x3c, 0x9c, 0xb6, 0x10, 0x03, 0x42, 0x27, 0xc4, 0x5c, 0x0a, 0x2e,
+  0x64, 0x41, 0x12, 0xd8, 0x9b, 0xf4, 0x0d, 0x7b, 0x27, 0x7d, 0x7d, 0x79, 0x5a, 0x13, 0x64, 0x31,
+  0x5e, 0xa8, 0x61, 0xfc, 0x8e, 0xcd, 0x99, 0x22, 0xf9, 0x5b, 0x56, 0xa6, 0x0e, 0x70, 0x1e, 0x24,
+  0x86, 0xb0, 0x51, 0x38, 0x2c, 0x8d, 0x5c, 0x34, 0x57, 0x49, 0x37, 0x7e, 0xc1, 0x67, 0xb2, 0x08,
+  0x27, 0xfd, 0x02, 0x77, 0xe2, 0x09, 0x71, 0x16, 0x25, 0xcd, 0x22, 0xb7, 0x9f, 0x8b, 0x39, 0xec,
+  0xfe, 0x07, 0x2e, 0x9a, 0xf3, 0x13, 0x0c, 0x27, 0x7d, 0x12, 0x3b, 0x5f, 0x9c, 0xe3, 0x7e, 0x7d,
+  0x5e, 0x4b, 0xdc, 0xeb, 0x09, 0xca, 0x18, 0x45, 0x29, 0x5b, 0x39, 0x49, 0x4e, 0xa4, 0x8c, 0x5c,
+  0x20, 0x37, 0x5e, 0xbc, 0xc5, 0x28, 0xfe, 0x09, 0xf8, 0xe3, 0xdc, 0x40, 0x10, 0xa5, 0xc8, 0x9d,
+  0x09, 0x78, 0xcf, 0xb5, 0x23, 0x6b, 0x50, 0x22, 0xb2, 0x2c, 0x67, 0x9c, 0x42, 0x28, 0xb0, 0x8a,
+  0x91, 0x8c, 0xac, 0x12, 0x14, 0x80, 0x34, 0xc2, 0xed, 0xaf, 0x67, 0x48, 0x36, 0x98, 0xf6, 0x61,
+  0x6e, 0x7f, 0x5b, 0xb7, 0x22, 0xa9, 0xa4, 0x33, 0xd1, 0xec, 0x70, 0x34, 0x3b, 0x5c, 0x4d, 0x0f,
+  0x57, 0x1f, 0xc8, 0x70, 0xd7, 0x75, 0x80, 0x00, 0x91, 0xdb, 0x05, 0x22, 0xc1, 0x90, 0x6c, 0x22,
+  0x57, 0x8f, 0x56, 0x24, 0xaf, 0x40, 0x7a, 0x00, 0x1e, 0x7e, 0x12, 0x62, 0xf9, 0x55, 0x1d, 0x9f,
+  0x61, 0xf3, 0x9f, 0x55, 0x1c, 0x3d, 0x16, 0x92, 0xca, 0xda, 0x49, 0x48, 0x88, 0x66, 0xa6, 0x45,
+  0x5d, 0x14, 0x6e, 0x7c, 0xff, 0x70, 0x37, 0x9d, 0xf4, 0xcd, 0xf2, 0x21, 0x21, 0x70, 0xc8, 0x8d,
+  0xa7, 0xce, 0xc0, 0x79, 0x80, 0xbf, 0x5b, 0xf8, 0xfb, 0xe4, 0x0c, 0x0c, 0x9a, 0x56, 0x4d, 0x26,
+  0xca, 0x65, 0x13, 0x55, 0xc7, 0xdc, 0x42, 0xc8, 0x05, 0x14, 0xc1, 0x8c, 0xcd, 0xab, 0x12, 0xbc,
+  0x85, 0x22, 0xb9, 0x10, 0xa0, 0x6d, 0x7a, 0x77, 0xff, 0x60, 0x71, 0xbf, 0xa9, 0x77, 0x9d, 0x8f,
+  0xec, 0x96, 0x39, 0x3f, 0x8b, 0x94, 0x4a, 0x0b, 0xb1, 0x66, 0x6a, 0x7c, 0x12, 0x75, 0xb2, 0xa0,
+  0xc9, 0xb3, 0x56, 0x6f, 0x4a, 0xad, 0xa5, 0xa5, 0x7b, 0x20, 0x0d, 0x4e, 0x62, 0x9d, 0x71, 0x18,
+  0x69, 0x6d, 0x93, 0xbe, 0xd1, 0x73, 0x04, 0xe0, 0x84, 0xcb, 0xe0, 0xc6, 0xfd, 0xfd, 0x87, 0x77,
+  0xe3, 0x53, 0x74, 0xf1, 0x42, 0x9c, 0xd9, 0xf8, 0x53, 0x4a, 0x96, 0x9e, 0x18, 0x32, 0x2b, 0xf1,
+  0x64, 0x56, 0xc6, 0xad, 0x02, 0x02, 0x5f, 0xc3, 0xc5, 0x3c, 0xd3, 0x53, 0x2f, 0x9f, 0xeb, 0x3a,
+  0xae, 0x37, 0xf5, 0x1d, 0x56, 0x8d, 0xce, 0x1a, 0xda, 0x6f, 0xc0, 0x81, 0x14, 0x46, 0x13, 0x7c,
+  0x63, 0xe7, 0x3a, 0x49, 0xa8, 0x94, 0xce, 0x14, 0x8b, 0x82, 0x86, 0xa0, 0xc1, 0x67, 0x52, 0xd4,
+  0x5e, 0xd7, 0x6c, 0xae, 0xd1, 0xf9, 0x06, 0x2b, 0x54, 0x16, 0x5c, 0xac, 0x8d, 0x25, 0x3b, 0x8e,
+  0x9d, 0xf7, 0xf7, 0xd3, 0x5f, 0xee, 0x3e, 0x9e, 0x41, 0xfd, 0x0d, 0xca, 0x84, 0x22, 0x46, 0x13,
+  0x0e, 0x40, 0x0d, 0x27, 0xb3, 0x9c, 0x3a, 0x77, 0x0f, 0xd7, 0xce, 0x6f, 0x45, 0x4a, 0x14, 0xb2,
+  0xa0, 0xd6, 0x66, 0x29, 0x6a, 0xf4, 0xc8, 0x6a, 0xb6, 0x64, 0xca, 0x8d, 0xaf, 0x8b, 0x22, 0xdf,
+  0x3a, 0x35, 0x7d, 0x34, 0x80, 0x0d, 0xd6, 0xf6, 0x91, 0x8f, 0xd8, 0x3b, 0x93, 0x92, 0x15, 0x2a,
+  0x6e, 0xad, 0x48, 0xe9, 0x7c, 0x17, 0x65, 0x15, 0xd7, 0xac, 0xf4, 0x59, 0xb0, 0x2b, 0xa9, 0xaa,
+  0x4a, 0xee, 0xa4, 0x70, 0x01, 0x97, 0xd0, 0x2c, 0x7b, 0x73, 0xaa, 0xde, 0xe7, 0x14, 0x87, 0x6f,
+  0xb7, 0x1f, 0x52, 0x90, 0xd8, 0x87, 0xad, 0x5a, 0xde, 0x51, 0x62, 0x3e, 0xcf, 0xa9, 0xa5, 0x95,
+  0x1f, 0xec, 0xbe, 0xf3, 0xbd, 0x13, 0x16, 0x79, 0x41, 0x4f, 0xd7, 0xb9, 0x9e, 0xad, 0x8c, 0xd1,
+  0x51, 0x00, 0xb6, 0x74, 0xe8, 0x34, 0xfd, 0xc1, 0xd3, 0xd5, 0xd6, 0x1b, 0x7b, 0x58, 0x37, 0xbd,
+  0x7d, 0xeb, 0x44, 0x48, 0x70, 0x78, 0x53, 0xc0, 0x9d, 0x8e, 0x4e, 0x6c, 0x81, 0x0f, 0x54, 0x25,
+  0x0b, 0xdf, 0xeb, 0x93, 0x82, 0xd9, 0xab, 0x04, 0xc2, 0x6a, 0x41, 0xb9, 0x7f, 0x88, 0xa6, 0x3c,
+  0x44, 0x53, 0xf6, 0xfe, 0x2b, 0xd1, 0xc1, 0xfd, 0xb9, 0x48, 0x12, 0xec, 0x5a, 0x8e, 0xb5, 0x57,
+  0xa1, 0xbb, 0xc8, 0xf0, 0x1b, 0xfb, 0x3c, 0x49, 0x7a, 0x66, 0x39, 0x6c, 0x39, 0x8f, 0x07, 0x8f,
+  0x3a, 0x1e, 0x29, 0xe0, 0xc7, 0xe4, 0x19, 0x06, 0x90, 0x26, 0xef, 0xa9, 0x07, 0xb0, 0xbe, 0x27,
+  0xe0, 0xcf, 0x41, 0xf1, 0x33, 0x82, 0xf1, 0x7c, 0x88, 0x31, 0x4a, 0x1e, 0x9f, 0x9f, 0xf6, 0x41,
+  0x78, 0x30, 0x56, 0xdf, 0x13, 0x30, 0x69, 0x8a, 0x11, 0x18, 0x83, 0x69, 0x08, 0xdb, 0x96, 0x8b,
+  0x67, 0xce, 0x78, 0xbe, 0xb9, 0x8f, 0x5e, 0x3b, 0xe9, 0x59, 0x89, 0xb6, 0x17, 0x78, 0xa0, 0xf1,
+  0x2c, 0x09, 0xd0, 0x13, 0x39, 0xa7, 0x89, 0xf2, 0x93, 0xde, 0x5a, 0xfe, 0x89, 0x0f, 0x2e, 0x30,
+  0x8b, 0xa6, 0x31, 0xd7, 0x12, 0x80, 0x8e, 0x78, 0x95, 0xe7, 0x9d, 0x55, 0xb4, 0x2b, 0xc6, 0x83,
+  0x8e, 0x82, 0xbf, 0x0c, 0xfe, 0x3e, 0x8f, 0x07, 0xfb, 0x4e, 0xca, 0x4a, 0xb5, 0x8d, 0x32, 0x92,
+  0x4b, 0xda, 0x48, 0x72, 0xad, 0x4f, 0xab, 0x02, 0xb8, 0x8c, 0x0e, 0x68, 0x20, 0x1f, 0xe9, 0xec,
+  0x1e, 0xc6, 0x54, 0xf9, 0xde, 0x5a, 0x8e, 0xfb, 0x7d, 0xaf, 0x0d, 0x79, 0xd4, 0x5e, 0xf4, 0x16,
+  0x42, 0x2a, 0xe4, 0x73, 0x1b, 0xb2, 0xda, 0xc6, 0x83, 0x6d, 0xaf, 0xef, 0x61, 0xf8, 0x78, 0x18,
+  0x72, 0x2a, 0x0a, 0xca, 0x8f, 0xb4, 0xd3, 0xc4, 0x59, 0x9f, 0xc3, 0xef, 0x09, 0x8e, 0xfd, 0xc5,
+  0xdb, 0x1f, 0x8f, 0x25, 0x39, 0x14, 0xe9, 0x7f, 0x3e, 0x67, 0x1a, 0x93, 0x17, 0xc2, 0x4b, 0xf4,
+  0x81, 0x2d, 0xa9, 0xa8, 0x94, 0xdf, 0x38, 0x73, 0x12, 0xcf, 0xbe, 0x03, 0x0d, 0x61, 0x10, 0x34,
+  0x6c, 0x2c, 0xa1, 0x48, 0x90, 0x79, 0xc3, 0x0a, 0x0d, 0x76, 0x1a, 0xba, 0x08, 0x68, 0x4c, 0x14,
+  0xe9, 0x01, 0x93, 0x19, 0x84, 0xdc, 0x81, 0x78, 0x58, 0xe6, 0xcb, 0xc7, 0xc1, 0x53, 0x14, 0x79,
+  0xf7, 0x5e, 0x00, 0xbe, 0x40, 0x3b, 0x38, 0x77, 0x66, 0x0a, 0x19, 0x93, 0x8f, 0xc3, 0xa7, 0xb6,
+  0x07, 0x3d, 0x02, 0x87, 0x97, 0x38, 0xbc, 0xd5, 0xc3, 0x11, 0x0e, 0x3f, 0xe9, 0xe1, 0xab, 0xa7,
+  0x36, 0xa8, 0xba, 0x42, 0x55, 0x43, 0xef, 0x07, 0xcf, 0x59, 0x8a, 0x15, 0xbc, 0x82, 0x00, 0x3d,
+  0x0f, 0x7d, 0xdb, 0x1f, 0xb3, 0x21, 0x29, 0x4f, 0xfd, 0x65, 0xb0, 0x43, 0xd3, 0xe0, 0xf0, 0x8b,
+  0x17, 0xda, 0xed, 0x12, 0x5e, 0x11, 0x5b, 0xa4, 0x00, 0x8d, 0xa2, 0x61, 0xa0, 0x97, 0xac, 0xe0,
+  0xbe, 0x05, 0x28, 0x7c, 0xc0, 0x67, 0x10, 0xf0, 0xac, 0x09, 0x03, 0x28, 0xd0, 0xf9, 0x0e, 0x76,
+  0x5a, 0xd2, 0xfb, 0xb1, 0xe3, 0xb5, 0x57, 0xbd, 0xa2, 0xed, 0xe9, 0xaf, 0xb2, 0xdf, 0xcc, 0x7e,
+  0x3f, 0x07, 0xa1, 0x61, 0x07, 0x88, 0x7c, 0xf9, 0x02, 0xfb, 0xf8, 0x93, 0xe1, 0xcf, 0xe7, 0xfd,
+  0xbe, 0x33, 0x1a, 0x59, 0x7e, 0x41, 0xdb, 0xc7, 0x3b, 0x0e, 0x1f, 0x2f, 0xe8, 0x60, 0xd7, 0xc7,
+  0x19, 0x7e, 0x31, 0xf9, 0x87, 0x18, 0x20, 0x38, 0x5a, 0xc3, 0x5a, 0x46, 0x20, 0x8c, 0x55, 0xe6,
+  0x2d, 0x3e, 0xcc, 0x20, 0xe6, 0x9b, 0x9c, 0x01, 0x70, 0xbf, 0x62, 0x86, 0x82, 0xce, 0x06, 0x40,
+  0x4f, 0xf4, 0xc2, 0xef, 0xdd, 0xb2, 0x87, 0x8f, 0xb0, 0xee, 0x70, 0x34, 0xe8, 0x6c, 0x0f, 0xcb,
+  0x7f, 0xc0, 0x32, 0xb4, 0x67, 0xbd, 0x9a, 0x46, 0x3f, 0x13, 0xb5, 0xe8, 0xc9, 0xff, 0x95, 0xca,
+  0xdf, 0xbc, 0xdc, 0xb4, 0xb7, 0x2f, 0xb7, 0x48, 0x39, 0x0c, 0x34, 0x86, 0x2c, 0x07, 0xbb, 0xcd,
+  0xcb, 0x08, 0xbe, 0xfd, 0x34, 0xdc, 0xda, 0xc1, 0x1e, 0x5d, 0xb3, 0x25, 0x0a, 0x95, 0x47, 0xfe,
+  0xa6, 0x8d, 0x92, 0x6d, 0xaf, 0xd8, 0x78, 0x61, 0x63, 0x13, 0x4c, 0x44, 0xfe, 0xb6, 0xb1, 0x07,
+  0x30, 0x18, 0x6b, 0xfa, 0x3d, 0xe9, 0x6f, 0x02, 0x58, 0x51, 0xcd, 0x95, 0xee, 0xb6, 0x46, 0x4c,
+  0x95, 0x15, 0x6d, 0x24, 0x10, 0x5e, 0xe5, 0x94, 0x48, 0x0a, 0x19, 0x38, 0x37, 0xee, 0xe9, 0x17,
+  0xf3, 0xdf, 0xec, 0xd6, 0xcb, 0x68, 0x72, 0xa0, 0xcd, 0x0c, 0x4e, 0x34, 0x23, 0x7e, 0x82, 0xdb,
+  0xb7, 0x6e, 0x2a, 0xd6, 0xfc, 0x84, 0xba, 0xb8, 0x0b, 0x0c, 0x98, 0x9a, 0xed, 0x1b, 0x52, 0x40,
+  0x41, 0x04, 0xf0, 0x7b, 0x56, 0xfe, 0x43, 0x1a, 0x84, 0x36, 0x1d, 0xc0, 0xb3, 0x13, 0x55, 0xb8,
+  0x7c, 0xa2, 0x0a, 0x80, 0xa4, 0x3d, 0xd3, 0x4a, 0x64, 0xf0, 0x95, 0x43, 0x55, 0x11, 0xd9, 0x00,
+  0xc3, 0x93, 0xf5, 0x84, 0xf0, 0x84, 0xe6, 0x87, 0xbd, 0xd6, 0xa3, 0xa7, 0x9f, 0x78, 0x40, 0x2e,
+  0x7c, 0xa6, 0x7d, 0xa5, 0x82, 0x9a, 0x6b, 0x87, 0x75, 0x34, 0x94, 0xa0, 0x4a, 0xb7, 0xcd, 0xe6,
+  0xed, 0x5f, 0x3d, 0x3e, 0xc3, 0xed, 0x7b, 0x8a, 0xda, 0xd2, 0x14, 0xd1, 0x26, 0x2c, 0xfa, 0x84,
+  0x6d, 0x1d, 0x8d, 0x23, 0x56, 0x12, 0x81, 0xb4, 0x87, 0x4f, 0xc0, 0xc4, 0x3a, 0x09, 0x9e, 0xf8,
+  0x68, 0x99, 0x45, 0xc3, 0x90, 0x4d, 0xa2, 0xe1, 0xeb, 0x90, 0xb5, 0xdb, 0xc1, 0xee, 0xe8, 0x19,
+  0x37, 0x9e, 0xcd, 0xa2, 0x43, 0x93, 0x4c, 0xe0, 0xfe, 0x29, 0x6a, 0xfb, 0xa4, 0xef, 0x19, 0x8c,
+  0x80, 0xf2, 0xb3, 0x93, 0x5a, 0xc0, 0x71, 0x8e, 0xcd, 0xba, 0x16, 0x80, 0x39, 0xd6, 0x34, 0x06,
+  0xf5, 0xb4, 0xe9, 0xa2, 0xbe, 0x8e, 0x53, 0xb8, 0x76, 0x1c, 0xe0, 0x35, 0x55, 0x85, 0x62, 0x5d,
+  0x21, 0x05, 0x54, 0xcd, 0xf4, 0x66, 0xc1, 0xf2, 0xd4, 0x9f, 0x41, 0x2f, 0xc3, 0x66, 0x6c, 0x9a,
+  0xa5, 0x28, 0x4c, 0xa7, 0x3c, 0x57, 0x75, 0xe0, 0x5a, 0x68, 0x94, 0xfe, 0xae, 0xab, 0x09, 0xbc,
+  0x71, 0x6c, 0xfb, 0x87, 0x97, 0x01, 0xfe, 0xdf, 0x01, 0x0f, 0x4b, 0xfd, 0xff, 0xfc, 0x5f, 0x14,
+  0x7e, 0xdc, 0x9d, 0xe0, 0x0f, 0x00, 0x00,
+};
+
+#endif // WEBUI_GZ_H
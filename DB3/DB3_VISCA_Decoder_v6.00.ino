@@ -39,10 +39,19 @@
 #include <WebServer_WT32_ETH01.h>
 #include <HardwareSerial.h>
 HardwareSerial UARTport(2); // use UART2
+HardwareSerial UARTport1(1); // second head, if routed there
 #include <Arduino.h>
 #include <SPI.h>
 #include <SD.h>
 #include <WiFiClient.h>
+#include <AsyncUDP.h>
+#include <esp_now.h>
+
+// Serial debug output: 0 off, 1 each command, 2 also every packet and the position conversions. Printing holds up
+// forwarding, leave it at 0 on a rig in use
+#define VISCA_DEBUG 0
+#define DEBUG_PRINT(level, ...) do { if (VISCA_DEBUG >= (level)) Serial.print(__VA_ARGS__); } while (0)
+#define DEBUG_PRINTLN(level, ...) do { if (VISCA_DEBUG >= (level)) Serial.println(__VA_ARGS__); } while (0)
 
 
 
@@ -52,19 +61,82 @@ IPAddress myGW(192, 168, 137, 1);
 IPAddress mySN(255, 255, 255, 0);
 IPAddress myDNS(192, 168, 137, 1);   //Adress to send out on
 
-char timeServer[]         = "time.nist.gov";  // NTP server
 unsigned int localPort    = 1259;             // local port to listen for UDP packets
 
-const int NTP_PACKET_SIZE = 48;       // NTP timestamp is in the first 48 bytes of the message
-const int UDP_TIMEOUT     = 10;     // timeout in miliseconds to wait for an UDP packet to arrive
-
-byte packetBuffer[NTP_PACKET_SIZE];   // buffer to hold incoming and outgoing packets
-
-// A UDP instance to let us send and receive packets over UDP
-WiFiUDP Udp;
-
-// send an NTP request to the time server at the given address
-
+// Where commands go. A packet goes to the first route that matches its VISCA camera address (1-7 from the 0x81-0x87
+// byte) and the UDP port it came in on, 0 matches anything. Keep one route per head: each has its own queue and
+// task, so a slow head never holds up the others, and answers position inquiries from what its own head last
+// reported. An ESP-NOW head has to be on the decoder's WiFi channel (1 unless it is connected to a network).
+enum RouteOutput { ROUTE_UART, ROUTE_ESPNOW };
+
+struct ViscaRoute {
+  uint8_t address;
+  uint16_t port;
+  RouteOutput output;
+  HardwareSerial* uart;
+  int8_t rx_pin;                      // For a UART other than UARTport, which setup() starts anyway
+  int8_t tx_pin;
+  uint8_t peer[6];                    // MAC of an ESP-NOW head
+};
+
+ViscaRoute Routes[] = {
+  //{2, 0, ROUTE_UART, &UARTport1, 35, 4, {0}},                                    //Camera 2 on UART1
+  //{3, 0, ROUTE_ESPNOW, NULL, -1, -1, {0x24, 0x6F, 0x28, 0x00, 0x00, 0x00}},       //Camera 3 over ESP-NOW
+  {0, 0, ROUTE_UART, &UARTport, 14, 15, {0}},                                      //Everything else to the head on UART2
+};
+const int ROUTES = sizeof(Routes) / sizeof(Routes[0]);
+
+const int VISCA_MAX_PACKET = 24;      // 8 byte VISCA over IP header and the longest VISCA message (16 bytes)
+const int VISCA_QUEUE = 16;           // Packets waiting for loop(), any more arriving are dropped
+const int HEAD_QUEUE = 16;            // Command lines waiting for a head
+const char ESPNOW_VISCA_TAG[] = "VISCA:";   // Starts a command line sent to a head over ESP-NOW
+const unsigned long LATENCY_REPORT_MS = 30000;
+
+// A packet as the UDP task hands it to loop()
+struct ViscaPacket {
+  uint8_t data[VISCA_MAX_PACKET];
+  uint8_t size;
+  uint32_t ip;
+  uint16_t port;
+  uint16_t local_port;
+  uint8_t listener;                   // Udp[] it arrived on, the reply leaves from the same port
+  uint32_t received_us;
+};
+
+// A command line for a head, an empty one asks the head for its position
+struct HeadLine {
+  char text[50];
+  uint32_t received_us;
+};
+
+// Run time side of a route
+struct RouteState {
+  QueueHandle_t queue = NULL;
+  portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+  byte PTposition[12];                // Inquiry replies, from the position the head reported after its last stop
+  byte ZoomPosition[7];
+  byte FocusPosition[7];
+  uint32_t latencyCount = 0;          // Packet arrival to the head, since the last report
+  uint32_t latencyTotal = 0;
+  uint32_t latencyMax = 0;
+  uint32_t dropped = 0;
+};
+
+RouteState States[ROUTES];
+
+byte packetBuffer[VISCA_MAX_PACKET];  // Packet being decoded
+ViscaPacket current;                  // Where it came from, for the replies
+int currentRoute;                     // Route it takes, -1 if none
+uint8_t currentAddress;               // Its camera address, 1 if it has none
+
+// Receive in their own task and call OnViscaPacket(), loop() sleeps on the queue until there is something to do.
+// One listens on localPort, the others on the ports routes ask for
+AsyncUDP Udp[ROUTES + 1];
+QueueHandle_t packetQueue;
+volatile uint32_t droppedPackets = 0;
+uint32_t unroutedPackets = 0;
+SemaphoreHandle_t queryLock;          // listenForUART() works in the globals below, one head at a time
+unsigned long latencyReportMs = 0;
 
 //Example return codes
 byte acknowledge[3] = {0x90, 0x41, 0xFF}; // Return for accept command
@@ -172,7 +244,7 @@ void setup() {
   while (!Serial);
 
 
-  Serial.print("\nStarting UdpNTPClient on " + String(ARDUINO_BOARD));
+  Serial.print("\nStarting VISCA decoder on " + String(ARDUINO_BOARD));
   Serial.println(" with " + String(SHIELD_TYPE));
   Serial.println(WEBSERVER_WT32_ETH01_VERSION);
 
@@ -181,7 +253,14 @@ void setup() {
   ETH.begin(ETH_PHY_ADDR, ETH_PHY_POWER);
   ETH.config(myIP, myGW, mySN, myDNS);
   WT32_ETH01_waitForConnect();
-  Udp.begin(localPort);
+  StartRoutes();
+  packetQueue = xQueueCreate(VISCA_QUEUE, sizeof(ViscaPacket));
+  Listen(localPort);
+  for (int i = 0; i < ROUTES; i++) {
+    if (Routes[i].port != 0) {
+      Listen(Routes[i].port);
+    }
+  }
 
 
 
@@ -193,62 +272,34 @@ void loop() {
   // listenForUART();
   //}
 
-  // wait for a reply for UDP_TIMEOUT miliseconds
-  unsigned long startMs = millis();
-  while (!Udp.available() && (millis() - startMs) < UDP_TIMEOUT) {}
-
-
+  ReportLatency();
 
+  ViscaPacket packet;
+  if (xQueueReceive(packetQueue, &packet, pdMS_TO_TICKS(1000)) != pdTRUE) {
+    return;                                               //Nothing arrived, the CPU was idle meanwhile
+  }
+  current = packet;
+  uint8_t address = PacketAddress(packet.data, packet.size);
+  currentAddress = address ? address : 1;
+  currentRoute = FindRoute(address, packet.local_port);
+  if (currentRoute < 0) {
+    unroutedPackets++;
+    return;
+  }
 
-  int packetSize = Udp.parsePacket();                     // if there's data available, read a packet
+  int packetSize = packet.size;
   if (packetSize) {
 
-    Udp.read(packetBuffer, NTP_PACKET_SIZE);
-    Serial.println();
+    memcpy(packetBuffer, packet.data, packetSize);
     ViscaPacketSize = packetSize;
 
-
-    Serial.print(", Last Paket count: ");
-    Serial.println (ViscaPacketSize);
-    Serial.print(packetBuffer[0]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[1]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[2]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[3]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[4]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[5]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[6]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[7]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[8]);
-    Serial.println("");
-    Serial.print (packetBuffer[9]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[10]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[11]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[12]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[13]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[14]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[15]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[16]);
-    Serial.print(", ");
-    Serial.print(packetBuffer[17]);
-    Serial.println("");
-
-
-
+    DEBUG_PRINT(2, "\nLast Paket count: ");
+    DEBUG_PRINTLN(2, ViscaPacketSize);
+    for (int i = 0; i < ViscaPacketSize; i++) {
+      DEBUG_PRINT(2, packetBuffer[i]);
+      DEBUG_PRINT(2, ", ");
+    }
+    DEBUG_PRINTLN(2);
 
     //*********************Establish a DB move code fron the two packets before FF using Decimal Values********************
     if (ViscaPacketSize == 5) {
@@ -369,23 +420,17 @@ void loop() {
     //                          delay(200);
     //                        }
     if (ViscaComand == 111) {                                         //Zoom Position request
-      Udp.beginPacket(Udp.remoteIP(), Udp.remotePort());
-      Udp.write(ZoomPosition, 7);
-      Udp.endPacket();
-      Serial.println ("Zoom position requested");
+      SendInquiryReply(States[currentRoute].ZoomPosition, 7);
+      DEBUG_PRINTLN(1, "Zoom position requested");
 
       //delay(200);
     }
     if (ViscaComand == 112) {                                         //Focus position request
-      Udp.beginPacket(Udp.remoteIP(), Udp.remotePort());
-      Udp.write(FocusPosition, 7);
-      Udp.endPacket();
-      Serial.println ("Focus position requested");
+      SendInquiryReply(States[currentRoute].FocusPosition, 7);
+      DEBUG_PRINTLN(1, "Focus position requested");
       //delay(200);
-      Udp.beginPacket(Udp.remoteIP(), Udp.remotePort());
-      Udp.write(Confirm, 3);
-      Udp.endPacket();
-      Serial.println ("Confirm sent");
+      SendCommandReply(Confirm, 3);
+      DEBUG_PRINTLN(1, "Confirm sent");
     }
 
 
@@ -396,358 +441,306 @@ void loop() {
   char buffer[50];
   switch (ViscaComand)  {
 
-    case 3802: Serial.println ("AKA");
-      Udp.beginPacket(myGW, UDP);
-      Udp.write(Confirm, 3);
-      Udp.endPacket();
-      Serial.println ("Confirm sent");
+    case 3802: DEBUG_PRINTLN(1, "AKA");
+      SendCommandReply(Confirm, 3);
+      DEBUG_PRINTLN(1, "Confirm sent");
       break;
 
-    case 14: Serial.println ("Tally light command:");
+    case 14: DEBUG_PRINTLN(1, "Tally light command:");
       sprintf(buffer, "%d,%d\n", ViscaComand, Tally);
-      UARTport.print(buffer);
-      Serial.print (Tally); break;
+      ForwardToHead(buffer);
+      DEBUG_PRINT(1, Tally); break;
 
-    case 76: Serial.println ("Zoom/Focus Absolute position move request");
+    case 76: DEBUG_PRINTLN(1, "Zoom/Focus Absolute position move request");
       ReadInZoomFocus();
-      Serial.print("PanSpeed: ");
-      Serial.println(PanSpeed);
-      Serial.print("TiltSpeed: ");
-      Serial.println(TiltSpeed);
-      Serial.print("PAngleIn: ");
-      Serial.println(PAngleIn);
-      Serial.print("TAngleIn: ");
-      Serial.println(TAngleIn);
-      Serial.print("FAngleIn: ");
-      Serial.println(FAngleIn);
-      Serial.print("ZAngleIn: ");
-      Serial.println(ZAngleIn);
-      Serial.println("Sending vMix Absolute position request to PTZ head");
+      DEBUG_PRINT(1, "PanSpeed: ");
+      DEBUG_PRINTLN(1, PanSpeed);
+      DEBUG_PRINT(1, "TiltSpeed: ");
+      DEBUG_PRINTLN(1, TiltSpeed);
+      DEBUG_PRINT(1, "PAngleIn: ");
+      DEBUG_PRINTLN(1, PAngleIn);
+      DEBUG_PRINT(1, "TAngleIn: ");
+      DEBUG_PRINTLN(1, TAngleIn);
+      DEBUG_PRINT(1, "FAngleIn: ");
+      DEBUG_PRINTLN(1, FAngleIn);
+      DEBUG_PRINT(1, "ZAngleIn: ");
+      DEBUG_PRINTLN(1, ZAngleIn);
+      DEBUG_PRINTLN(1, "Sending vMix Absolute position request to PTZ head");
       ViscaComand = 9;
       sprintf(buffer, "%d,%d,%d,%d,%d,%d,%d\n", ViscaComand, PanSpeed, TiltSpeed, PAngleIn, TAngleIn, FAngleIn, ZAngleIn );
-      UARTport.print(buffer);
+      ForwardToHead(buffer);
       break;
 
-    case 77: Serial.println ("Focus Absolute position move request");
+    case 77: DEBUG_PRINTLN(1, "Focus Absolute position move request");
       //Read in the Focus request here
-      Udp.beginPacket(myGW, 1259);
-      Udp.write(Confirm, 3);
-      Udp.endPacket();
-      Serial.println ("Confirm sent");
+      SendCommandReply(Confirm, 3);
+      DEBUG_PRINTLN(1, "Confirm sent");
       break;
 
-    case 9: Serial.println ("PT Absolute position move request from vMix");
+    case 9: DEBUG_PRINTLN(1, "PT Absolute position move request from vMix");
       ReadInPTpos();
       sprintf(buffer, "%d,%d,%d,%d,%d,%d,%d\n", ViscaComand, PanSpeed, TiltSpeed, PAngleIn, TAngleIn, FAngleIn, ZAngleIn );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
       break;
 
-    case 5603: Serial.println("Manual focus");
-      Udp.beginPacket(myGW, 1259);
-      Udp.write(Confirm, 3);
-      Udp.endPacket();
-      Serial.println ("Confirm sent");
+    case 5603: DEBUG_PRINTLN(1, "Manual focus");
+      SendCommandReply(Confirm, 3);
+      DEBUG_PRINTLN(1, "Confirm sent");
       break;
 
     case 71: ("Send focus home");
-      Udp.beginPacket(myGW, 1259);
-      Udp.write(Confirm, 3);
-      Udp.endPacket(); break;
+      SendCommandReply(Confirm, 3); break;
 
-    case 78:  Serial.println ("PT position requested1");
+    case 78:  DEBUG_PRINTLN(1, "PT position requested1");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer);                //Send request to PTZ head
-      int Request;
-      if (Request = 0) {
-        Serial.println ("CHECKING FOR UART reply");
-        listenForUART();
-        Serial.print("PAngle: ");
-        Serial.println(PAngle);
-        Serial.print("TAngle: ");
-        Serial.println(TAngle);
-        Serial.print("ZAngle: ");
-        Serial.println(ZAngle);
-        Serial.print("FAngle: ");
-        Serial.println(FAngle);
-        Serial.println(PTposition[0]);
-        Serial.println(PTposition[1]);
-        Serial.println(PTposition[10]);
-
-        Udp.beginPacket(Udp.remoteIP(), Udp.remotePort());
-        Udp.write(PTposition, 11);
-        Udp.endPacket();
-        //delay(200);
-        Request = 2;
-      } else {
-        //PTposition[2] = 0x00; PTposition[3] = 0x05; PTposition[4] = 0x02; PTposition[5] = 0x0E; PTposition[6] = 0x0F; break;
-        Udp.beginPacket(Udp.remoteIP(), Udp.remotePort());
-        Udp.write(PTposition, 11);
-        Udp.endPacket();
-        //delay(200);
-        Request = 0;
-        Serial.println(PTposition[0] );
-        Serial.println(PTposition[1]);
-        Serial.println(PTposition[2]);
-        Serial.println(PTposition[3]);
-        Serial.println(PTposition[4]);
-        Serial.println(PTposition[5]);
-        Serial.println(PTposition[6]);
-        Serial.println(PTposition[7]);
-        Serial.println(PTposition[8]);
-        Serial.println(PTposition[9]);
-        Serial.println(PTposition[10]);
-        Serial.println(PTposition[11]);
-      }
+      ForwardToHead(buffer);                //Send request to PTZ head
+      SendInquiryReply(States[currentRoute].PTposition, 11);    //From the position the head reported after its last stop
       break;
 
 
 
 
-    case 64: Serial.print(", PT Home ");
+    case 64: DEBUG_PRINT(1, ", PT Home ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
 
 
 
-    case 33: Serial.print(", PT Stop ");
+    case 33: DEBUG_PRINT(1, ", PT Stop ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer);
-      delay(20);
-      listenForUART();
-      Serial.print("IP4 ");
-      Serial.print(IP4);
+      ForwardToHead(buffer);
+      RequestPosition();                                    //The head reports where it stopped
+      DEBUG_PRINT(1, "IP4 ");
+      DEBUG_PRINT(1, IP4);
       break;
 
-    case 700: Serial.print(", Zoom Stop ");
+    case 700: DEBUG_PRINT(1, ", Zoom Stop ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer);
-      delay(20);
-      listenForUART();
+      ForwardToHead(buffer);
+      RequestPosition();                                    //The head reports where it stopped
       break;
 
-    case 800: Serial.print(", Focus Stop 1 ");
-      Serial.print(ViscaComand);
+    case 800: DEBUG_PRINT(1, ", Focus Stop 1 ");
+      DEBUG_PRINT(1, ViscaComand);
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer);
-      delay(20);
-      listenForUART();
+      ForwardToHead(buffer);
+      RequestPosition();                                    //The head reports where it stopped
       break;
-    case 13: Serial.print(", Pan Left ");
+    case 13: DEBUG_PRINT(1, ", Pan Left ");
       sprintf(buffer, "%d,%d,%d\n", ViscaComand, PanSpeed, TiltSpeed );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
 
-    case 23: Serial.print(", Pan Right ");
+    case 23: DEBUG_PRINT(1, ", Pan Right ");
       sprintf(buffer, "%d,%d,%d\n", ViscaComand, PanSpeed, TiltSpeed );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 31: Serial.print(", Tilt Up ");
+    case 31: DEBUG_PRINT(1, ", Tilt Up ");
       sprintf(buffer, "%d,%d,%d\n", ViscaComand, PanSpeed, TiltSpeed );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 32: Serial.print(", Tilt Down ");
+    case 32: DEBUG_PRINT(1, ", Tilt Down ");
       sprintf(buffer, "%d,%d,%d\n", ViscaComand, PanSpeed, TiltSpeed );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 11: Serial.print(", Up Left ");
+    case 11: DEBUG_PRINT(1, ", Up Left ");
       sprintf(buffer, "%d,%d,%d\n", ViscaComand, PanSpeed, TiltSpeed );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 21: Serial.print(", Up Right ");
+    case 21: DEBUG_PRINT(1, ", Up Right ");
       sprintf(buffer, "%d,%d,%d\n", ViscaComand, PanSpeed, TiltSpeed );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 12: Serial.print(", Down Left ");
+    case 12: DEBUG_PRINT(1, ", Down Left ");
       sprintf(buffer, "%d,%d,%d\n", ViscaComand, PanSpeed, TiltSpeed );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 22: Serial.print(", Down Right ");
+    case 22: DEBUG_PRINT(1, ", Down Right ");
       sprintf(buffer, "%d,%d,%d\n", ViscaComand, PanSpeed, TiltSpeed );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 748: Serial.print(", Zoom out p1  ");
+    case 748: DEBUG_PRINT(1, ", Zoom out p1  ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 749: Serial.print(", Zoom out p2  ");
+    case 749: DEBUG_PRINT(1, ", Zoom out p2  ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 750: Serial.print(", Zoom out p3  ");
+    case 750: DEBUG_PRINT(1, ", Zoom out p3  ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 751: Serial.print(", Zoom out p4  ");
+    case 751: DEBUG_PRINT(1, ", Zoom out p4  ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 752: Serial.print(", Zoom out p5  ");
+    case 752: DEBUG_PRINT(1, ", Zoom out p5  ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 753: Serial.print(", Zoom out p6  ");
+    case 753: DEBUG_PRINT(1, ", Zoom out p6  ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 754: Serial.print(", Zoom out p7  ");
+    case 754: DEBUG_PRINT(1, ", Zoom out p7  ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 755: Serial.print(", Zoom out p8  ");
+    case 755: DEBUG_PRINT(1, ", Zoom out p8  ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 756: Serial.print(", Zoom out p9  ");
+    case 756: DEBUG_PRINT(1, ", Zoom out p9  ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 732: Serial.print(", Zoom in p1 ");
+    case 732: DEBUG_PRINT(1, ", Zoom in p1 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 733: Serial.print(", Zoom in p2 ");
+    case 733: DEBUG_PRINT(1, ", Zoom in p2 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 734: Serial.print(", Zoom in p3 ");
+    case 734: DEBUG_PRINT(1, ", Zoom in p3 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 735: Serial.print(", Zoom in p4 ");
+    case 735: DEBUG_PRINT(1, ", Zoom in p4 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 736: Serial.print(", Zoom in p5 ");
+    case 736: DEBUG_PRINT(1, ", Zoom in p5 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 737: Serial.print(", Zoom in p6 ");
+    case 737: DEBUG_PRINT(1, ", Zoom in p6 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 738: Serial.print(", Zoom in p7 ");
+    case 738: DEBUG_PRINT(1, ", Zoom in p7 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 739: Serial.print(", Zoom in p8 ");
+    case 739: DEBUG_PRINT(1, ", Zoom in p8 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 2402: Serial.print(", Focus Stop ");
-      Serial.print(ViscaComand);
+    case 2402: DEBUG_PRINT(1, ", Focus Stop ");
+      DEBUG_PRINT(1, ViscaComand);
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer);
-      delay(20);
-      listenForUART();
+      ForwardToHead(buffer);
+      RequestPosition();                                    //The head reports where it stopped
       break;
-    case 832: Serial.print(", Focus Near p1 ");
+    case 832: DEBUG_PRINT(1, ", Focus Near p1 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 833: Serial.print(", Focus Near p2 ");
+    case 833: DEBUG_PRINT(1, ", Focus Near p2 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 834: Serial.print(", Focus Near p3 ");
+    case 834: DEBUG_PRINT(1, ", Focus Near p3 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 835: Serial.print(", Focus Near p4 ");
+    case 835: DEBUG_PRINT(1, ", Focus Near p4 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 836: Serial.print(", Focus Near p5 ");
+    case 836: DEBUG_PRINT(1, ", Focus Near p5 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 837: Serial.print(", Focus Near p6 ");
+    case 837: DEBUG_PRINT(1, ", Focus Near p6 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 838: Serial.print(", Focus Near p7 ");
+    case 838: DEBUG_PRINT(1, ", Focus Near p7 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 839: Serial.print(", Focus Near p8 ");
+    case 839: DEBUG_PRINT(1, ", Focus Near p8 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 848: Serial.print(", Focus Far p1 ");
+    case 848: DEBUG_PRINT(1, ", Focus Far p1 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 849: Serial.print(", Focus Far p2 ");
+    case 849: DEBUG_PRINT(1, ", Focus Far p2 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 850: Serial.print(", Focus Far p3 ");
+    case 850: DEBUG_PRINT(1, ", Focus Far p3 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 851: Serial.print(", Focus Far p4 ");
+    case 851: DEBUG_PRINT(1, ", Focus Far p4 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 852: Serial.print(", Focus Far p5 ");
+    case 852: DEBUG_PRINT(1, ", Focus Far p5 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 853: Serial.print(", Focus Far p6 ");
+    case 853: DEBUG_PRINT(1, ", Focus Far p6 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 854: Serial.print(", Focus Far p7 ");
+    case 854: DEBUG_PRINT(1, ", Focus Far p7 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 855: Serial.print(", Focus Far p8 ");
+    case 855: DEBUG_PRINT(1, ", Focus Far p8 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 4901: Serial.print(", Ramp/EaseValue=1 ");
+    case 4901: DEBUG_PRINT(1, ", Ramp/EaseValue=1 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 4902: Serial.print(", Ramp/EaseValue=2 ");
+    case 4902: DEBUG_PRINT(1, ", Ramp/EaseValue=2 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 4903: Serial.print(", Ramp/EaseValue=3 ");
+    case 4903: DEBUG_PRINT(1, ", Ramp/EaseValue=3 ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 2: Serial.print(", Start Recore ");
+    case 2: DEBUG_PRINT(1, ", Start Recore ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 3: Serial.print(", Stop Record ");
+    case 3: DEBUG_PRINT(1, ", Stop Record ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 41: Serial.print(", Save Pose ");
-      Serial.print(Pose);
+    case 41: DEBUG_PRINT(1, ", Save Pose ");
+      DEBUG_PRINT(1, Pose);
       sprintf(buffer, "%d,%d\n", ViscaComand, Pose );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 42: Serial.print(", Move to pose ");
-      Serial.print(Pose);
+    case 42: DEBUG_PRINT(1, ", Move to pose ");
+      DEBUG_PRINT(1, Pose);
       sprintf(buffer, "%d,%d\n", ViscaComand, Pose );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 40: Serial.print(", Reset Pose do Defaults ");
-      Serial.print(Pose);
+    case 40: DEBUG_PRINT(1, ", Reset Pose do Defaults ");
+      DEBUG_PRINT(1, Pose);
       sprintf(buffer, "%d,%d\n", ViscaComand, Pose );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
 
-    case 126: Serial.print(", Record Mode setting ");
+    case 126: DEBUG_PRINT(1, ", Record Mode setting ");
       sprintf(buffer, "%d\n", ViscaComand );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
-    case 137: Serial.print(", Pose speed ");
+    case 137: DEBUG_PRINT(1, ", Pose speed ");
       sprintf(buffer, "%d,%d\n", ViscaComand, PoseSpeed );
-      UARTport.print(buffer); break;
+      ForwardToHead(buffer); break;
 
 
 
@@ -755,7 +748,19 @@ void loop() {
   }
   ViscaComand = 0;                                          //Clear the Comand ready to start fresh
 }
-void  listenForUART() {
+// Asks the head on a route where it is and keeps the inquiry replies of the route up to date. Runs in the route's task
+void  listenForUART(int route) {
+  HardwareSerial& port = *Routes[route].uart;
+  RouteState& state = States[route];
+  xSemaphoreTake(queryLock, portMAX_DELAY);
+  portENTER_CRITICAL(&state.lock);
+  memcpy(PTposition, state.PTposition, sizeof(PTposition));
+  memcpy(ZoomPosition, state.ZoomPosition, sizeof(ZoomPosition));
+  memcpy(FocusPosition, state.FocusPosition, sizeof(FocusPosition));
+  portEXIT_CRITICAL(&state.lock);
+  while (port.available()) {
+    port.read();                                          //Drop what the head said since, e.g. to a forwarded 78
+  }
   //Serial.println ("Listening");
   char buffer[30];
   int PP = 78;
@@ -773,11 +778,11 @@ void  listenForUART() {
   char rc;
 
   sprintf(buffer, "%d\n", PP );//First Pass get PP
-  UARTport.print(buffer);
-  UARTport.flush();
+  port.print(buffer);
+  port.flush();
   newData = false;
   delay(50);
-  GetUARTdata();
+  GetUARTdata(port);
   if (newData == true) {
     PAngle = atoi(receivedChars);
     PAngle = PAngle * 2;
@@ -786,59 +791,59 @@ void  listenForUART() {
     //    if (PAngle < 0) {
     //      PAngle = abs(PAngle) + 1000;
     //    }
-    Serial.print("\n");
-    Serial.print("PAngle: ");
-    Serial.println(PAngle);
+    DEBUG_PRINT(2, "\n");
+    DEBUG_PRINT(2, "PAngle: ");
+    DEBUG_PRINTLN(2, PAngle);
     if (PAngle < 0) {
-      Serial.print("PAngle is negative ");
+      DEBUG_PRINT(2, "PAngle is negative ");
     } else {
-      Serial.print("PAngle is Posative ");
+      DEBUG_PRINT(2, "PAngle is Posative ");
     }
   }
 
   sprintf(buffer, "%d\n", TT );   //Second pass get TT
   delay(100);
-  UARTport.print(buffer);
-  UARTport.flush();
+  port.print(buffer);
+  port.flush();
   newData = false;
   delay(50);
-  GetUARTdata();
+  GetUARTdata(port);
   if (newData == true) {
     TAngle = atoi(receivedChars) * 2;
     //TAngle = 10 * ((TAngle + 5) / 10);  //Round to nearest 10
     //    if (TAngle < 0) {
     //      TAngle = abs(TAngle) + 1000;
     //    }
-    Serial.print("TAngle: ");
-    Serial.println(TAngle);
+    DEBUG_PRINT(2, "TAngle: ");
+    DEBUG_PRINTLN(2, TAngle);
   }
 
   sprintf(buffer, "%d\n", FF );     //Third pass get FF
   delay(100);
-  UARTport.print(buffer);
-  UARTport.flush();
+  port.print(buffer);
+  port.flush();
   newData = false;
   delay(50);
-  GetUARTdata();
+  GetUARTdata(port);
   if (newData == true) {
     FAngle = atoi(receivedChars);
     FAngle = abs(FAngle);
-    Serial.print("FAngle=: ");  //This gets past back to VISCA position save
-    Serial.println(FAngle);
+    DEBUG_PRINT(2, "FAngle=: ");  //This gets past back to VISCA position save
+    DEBUG_PRINTLN(2, FAngle);
   }
 
   sprintf(buffer, "%d\n", ZZ );     //Forth pass get ZZ
   delay(100);
-  UARTport.print(buffer);
-  UARTport.flush();
+  port.print(buffer);
+  port.flush();
   newData = false;
   delay(50);
-  GetUARTdata();
+  GetUARTdata(port);
   if (newData == true) {
     ZAngle = atoi(receivedChars);
     ZAngle = abs(ZAngle);
-    Serial.print("ZAngle: ");
-    Serial.println(ZAngle);
+    DEBUG_PRINT(2, "ZAngle: ");
+    DEBUG_PRINTLN(2, ZAngle);
   }
   //Convert to uint8 for output
 
@@ -851,16 +856,16 @@ void  listenForUART() {
 
   TAngle = TAngle * 235.9;
 
-  Serial.print("PAngle: ");
-  Serial.println(PAngle);
+  DEBUG_PRINT(2, "PAngle: ");
+  DEBUG_PRINTLN(2, PAngle);
   if (PAngle < 0) {
-    Serial.print("PAngle is negative ");
+    DEBUG_PRINT(2, "PAngle is negative ");
   } else {
-    Serial.print("PAngle is Posative ");
+    DEBUG_PRINT(2, "PAngle is Posative ");
   }
   if (PAngle < 0) {           //If Pangle negative
     PTposition[2] = {0x0F};
-    Serial.print("PAngle negative");
+    DEBUG_PRINT(2, "PAngle negative");
   } else {
     PTposition[2] = {0x00};
   }
@@ -925,30 +930,30 @@ void  listenForUART() {
 
   }
 
-  Serial.print("PTpos0: ");
-  Serial.println(PTposition[0]);
-  Serial.print("PTpos1: ");
-  Serial.println(PTposition[1]);
-  Serial.print("PTpos2: ");
-  Serial.println(PTposition[2]);
-  Serial.print("PTpos3: ");
-  Serial.println(PTposition[3]);
-  Serial.print("PTpos4: ");
-  Serial.println(PTposition[4]);
-  Serial.print("PTpos5: ");
-  Serial.println(PTposition[5]);
-  Serial.print("PTpos6: ");
-  Serial.println(PTposition[6]);
-  Serial.print("PTpos7: ");
-  Serial.println(PTposition[7]);
-  Serial.print("PTpos8: ");
-  Serial.println(PTposition[8]);
-  Serial.print("PTpos9: ");
-  Serial.println(PTposition[9]);
-  Serial.print("PTpos10: ");
-  Serial.println(PTposition[10]);
-  Serial.print("PTpos11: ");
-  Serial.println(PTposition[11]); //Closing termonator
+  DEBUG_PRINT(2, "PTpos0: ");
+  DEBUG_PRINTLN(2, PTposition[0]);
+  DEBUG_PRINT(2, "PTpos1: ");
+  DEBUG_PRINTLN(2, PTposition[1]);
+  DEBUG_PRINT(2, "PTpos2: ");
+  DEBUG_PRINTLN(2, PTposition[2]);
+  DEBUG_PRINT(2, "PTpos3: ");
+  DEBUG_PRINTLN(2, PTposition[3]);
+  DEBUG_PRINT(2, "PTpos4: ");
+  DEBUG_PRINTLN(2, PTposition[4]);
+  DEBUG_PRINT(2, "PTpos5: ");
+  DEBUG_PRINTLN(2, PTposition[5]);
+  DEBUG_PRINT(2, "PTpos6: ");
+  DEBUG_PRINTLN(2, PTposition[6]);
+  DEBUG_PRINT(2, "PTpos7: ");
+  DEBUG_PRINTLN(2, PTposition[7]);
+  DEBUG_PRINT(2, "PTpos8: ");
+  DEBUG_PRINTLN(2, PTposition[8]);
+  DEBUG_PRINT(2, "PTpos9: ");
+  DEBUG_PRINTLN(2, PTposition[9]);
+  DEBUG_PRINT(2, "PTpos10: ");
+  DEBUG_PRINTLN(2, PTposition[10]);
+  DEBUG_PRINT(2, "PTpos11: ");
+  DEBUG_PRINTLN(2, PTposition[11]); //Closing termonator
 
   // Solve for Focus
 
@@ -960,20 +965,20 @@ void  listenForUART() {
     }
     FAngle = (FAngle - FocusPosition[i - 2]) / 16;   //Process the next part
   }
-  Serial.print("Fpos0: ");
-  Serial.println(FocusPosition[0]);
-  Serial.print("Fpos1: ");
-  Serial.println(FocusPosition[1]);
-  Serial.print("Fpos2: ");
-  Serial.println(FocusPosition[2]);
-  Serial.print("Fpos3: ");
-  Serial.println(FocusPosition[3]);
-  Serial.print("Fpos4: ");
-  Serial.println(FocusPosition[4]);
-  Serial.print("Fpos5: ");
-  Serial.println(FocusPosition[5]);
-  Serial.print("Fpos6 -Should be 255: ");
-  Serial.println(FocusPosition[6]);
+  DEBUG_PRINT(2, "Fpos0: ");
+  DEBUG_PRINTLN(2, FocusPosition[0]);
+  DEBUG_PRINT(2, "Fpos1: ");
+  DEBUG_PRINTLN(2, FocusPosition[1]);
+  DEBUG_PRINT(2, "Fpos2: ");
+  DEBUG_PRINTLN(2, FocusPosition[2]);
+  DEBUG_PRINT(2, "Fpos3: ");
+  DEBUG_PRINTLN(2, FocusPosition[3]);
+  DEBUG_PRINT(2, "Fpos4: ");
+  DEBUG_PRINTLN(2, FocusPosition[4]);
+  DEBUG_PRINT(2, "Fpos5: ");
+  DEBUG_PRINTLN(2, FocusPosition[5]);
+  DEBUG_PRINT(2, "Fpos6 -Should be 255: ");
+  DEBUG_PRINTLN(2, FocusPosition[6]);
 
 
 
@@ -989,20 +994,20 @@ void  listenForUART() {
     ZAngle = (ZAngle - ZoomPosition[i - 2]) / 16;   //Process the next part
   }
   ZoomPosition[6] = {0xFF};
-  Serial.print("ZPos0: ");
-  Serial.println(ZoomPosition[0]);
-  Serial.print("ZPos1: ");
-  Serial.println(ZoomPosition[1]);
-  Serial.print("ZPos2: ");
-  Serial.println(ZoomPosition[2]);
-  Serial.print("ZPos3: ");
-  Serial.println(ZoomPosition[3]);
-  Serial.print("ZPos4: ");
-  Serial.println(ZoomPosition[4]);
-  Serial.print("ZPos5: ");
-  Serial.println(ZoomPosition[5]);
-  Serial.print("ZPos6 should be 255: ");
-  Serial.println(ZoomPosition[6]);
+  DEBUG_PRINT(2, "ZPos0: ");
+  DEBUG_PRINTLN(2, ZoomPosition[0]);
+  DEBUG_PRINT(2, "ZPos1: ");
+  DEBUG_PRINTLN(2, ZoomPosition[1]);
+  DEBUG_PRINT(2, "ZPos2: ");
+  DEBUG_PRINTLN(2, ZoomPosition[2]);
+  DEBUG_PRINT(2, "ZPos3: ");
+  DEBUG_PRINTLN(2, ZoomPosition[3]);
+  DEBUG_PRINT(2, "ZPos4: ");
+  DEBUG_PRINTLN(2, ZoomPosition[4]);
+  DEBUG_PRINT(2, "ZPos5: ");
+  DEBUG_PRINTLN(2, ZoomPosition[5]);
+  DEBUG_PRINT(2, "ZPos6 should be 255: ");
+  DEBUG_PRINTLN(2, ZoomPosition[6]);
 
 
 
@@ -1091,16 +1096,22 @@ void  listenForUART() {
 
 
 
+  portENTER_CRITICAL(&state.lock);
+  memcpy(state.PTposition, PTposition, sizeof(PTposition));
+  memcpy(state.ZoomPosition, ZoomPosition, sizeof(ZoomPosition));
+  memcpy(state.FocusPosition, FocusPosition, sizeof(FocusPosition));
+  portEXIT_CRITICAL(&state.lock);
+  xSemaphoreGive(queryLock);
 }
 
 
-void GetUARTdata() {
+void GetUARTdata(HardwareSerial& port) {
   static byte ndx = 0;
   char endMarker = '\n';
   char rc;
 
-  while (UARTport.available() ) {
-    rc = UARTport.read();
+  while (port.available() ) {
+    rc = port.read();
     if (rc != endMarker) {
       receivedChars[ndx] = rc;
       ndx++;
@@ -1119,7 +1130,7 @@ void GetUARTdata() {
 
 //At startup get the current IP adress from rthe main processor
 void  GetIP() {
-  Serial.println ("Listening");
+  DEBUG_PRINTLN(1, "Listening");
   char buffer[30];
   delay(500);
   int SYS1 = 665;
@@ -1137,48 +1148,48 @@ void  GetIP() {
   UARTport.flush();
   newData = false;
   delay(50);
-  GetUARTdata();
+  GetUARTdata(UARTport);
   if (newData == true) {
     IP1 = atoi(receivedChars);
 
-    Serial.print("IP1: ");
-    Serial.println(IP1);
+    DEBUG_PRINT(1, "IP1: ");
+    DEBUG_PRINTLN(1, IP1);
   }
   sprintf(buffer, "%d\n", SYS2 );     //Gget IP2
   UARTport.print(buffer);
   UARTport.flush();
   newData = false;
   delay(50);
-  GetUARTdata();
+  GetUARTdata(UARTport);
   if (newData == true) {
     IP2 = atoi(receivedChars);
 
-    Serial.print("IP2: ");
-    Serial.println(IP2);
+    DEBUG_PRINT(1, "IP2: ");
+    DEBUG_PRINTLN(1, IP2);
   }
   sprintf(buffer, "%d\n", SYS3 );     //Gget IP3
   UARTport.print(buffer);
   UARTport.flush();
   newData = false;
   delay(50);
-  GetUARTdata();
+  GetUARTdata(UARTport);
   if (newData == true) {
     IP3 = atoi(receivedChars);
 
-    Serial.print("IP3: ");
-    Serial.println(IP3);
+    DEBUG_PRINT(1, "IP3: ");
+    DEBUG_PRINTLN(1, IP3);
   }
   sprintf(buffer, "%d\n", SYS4 );     //Gget IP4
   UARTport.print(buffer);
   UARTport.flush();
   newData = false;
   delay(50);
-  GetUARTdata();
+  GetUARTdata(UARTport);
   if (newData == true) {
     IP4 = atoi(receivedChars);
 
-    Serial.print("IP4: ");
-    Serial.println(IP4);
+    DEBUG_PRINT(1, "IP4: ");
+    DEBUG_PRINTLN(1, IP4);
   }
 
   sprintf(buffer, "%d\n", SYS6 );     //Gget IPGW      the server gatway
@@ -1186,12 +1197,12 @@ void  GetIP() {
   UARTport.flush();
   newData = false;
   delay(50);
-  GetUARTdata();
+  GetUARTdata(UARTport);
   if (newData == true) {
     IPGW = atoi(receivedChars);
 
-    Serial.print("IPGW: ");
-    Serial.println(IPGW);
+    DEBUG_PRINT(1, "IPGW: ");
+    DEBUG_PRINTLN(1, IPGW);
   }
 
   sprintf(buffer, "%d\n", SYS5 );     //Gget UDPport
@@ -1199,147 +1210,345 @@ void  GetIP() {
   UARTport.flush();
   newData = false;
   delay(50);
-  GetUARTdata();
+  GetUARTdata(UARTport);
   if (newData == true) {
     UDP = atoi(receivedChars);
 
-    Serial.print("UDPport: ");
-    Serial.println(UDP);
+    DEBUG_PRINT(1, "UDPport: ");
+    DEBUG_PRINTLN(1, UDP);
   }
 }
 
 void ReadInPTpos() {                             //Read in the Absolute position request PT only
   //Convert Pan back to Dec Degrees for input
 
-  Serial.print("NumHex7: ");
-  Serial.println(NumHex7);
-  Serial.print("NumHex8: ");
-  Serial.println(NumHex8);
-  Serial.print("NumHex9: ");
-  Serial.println(NumHex9);
-  Serial.print("NumHex10: ");
-  Serial.println(NumHex10);
+  DEBUG_PRINT(2, "NumHex7: ");
+  DEBUG_PRINTLN(2, NumHex7);
+  DEBUG_PRINT(2, "NumHex8: ");
+  DEBUG_PRINTLN(2, NumHex8);
+  DEBUG_PRINT(2, "NumHex9: ");
+  DEBUG_PRINTLN(2, NumHex9);
+  DEBUG_PRINT(2, "NumHex10: ");
+  DEBUG_PRINTLN(2, NumHex10);
   char buffer[30];
   sprintf(buffer, "0x%s%s%s%s", NumHex7, NumHex8, NumHex9, NumHex10);
   String Hstring = (buffer);
-  Serial.println(Hstring);
+  DEBUG_PRINTLN(2, Hstring);
 
   char H_array[7];
   Hstring.toCharArray(H_array, 7);
   int x;
   char *endptr;
   x = strtol(H_array, &endptr, 16);
-  Serial.println(x, HEX);
-  Serial.println(x, DEC);
+  DEBUG_PRINTLN(2, x, HEX);
+  DEBUG_PRINTLN(2, x, DEC);
 
   if ( x >= 23090) {                          //If the move is negatvie
     PAngleIn = (x - 23090);                   //Stored int16_t to provide a signed 2's value NOT REQUIRED
     PAngleIn = 180 - ((PAngleIn / 235.9) );
     PAngleIn = (PAngleIn - (PAngleIn * 2));   //Sign it as negative
-    Serial.print("PAngleIn: ");
-    Serial.println(PAngleIn);
+    DEBUG_PRINT(2, "PAngleIn: ");
+    DEBUG_PRINTLN(2, PAngleIn);
   } else {
     PAngleIn = x;
     PAngleIn = ((PAngleIn / 117.95));
 
-    Serial.print("PAngleIn: ");
-    Serial.println(PAngleIn);
+    DEBUG_PRINT(2, "PAngleIn: ");
+    DEBUG_PRINTLN(2, PAngleIn);
   }
 
 
   //Convert Tilt back to Dec Degrees for input
 
-  Serial.print("NumHex11: ");
-  Serial.println(NumHex11);
-  Serial.print("NumHex12: ");
-  Serial.println(NumHex12);
-  Serial.print("NumHex13: ");
-  Serial.println(NumHex13);
-  Serial.print("NumHex14: ");
-  Serial.println(NumHex14);
+  DEBUG_PRINT(2, "NumHex11: ");
+  DEBUG_PRINTLN(2, NumHex11);
+  DEBUG_PRINT(2, "NumHex12: ");
+  DEBUG_PRINTLN(2, NumHex12);
+  DEBUG_PRINT(2, "NumHex13: ");
+  DEBUG_PRINTLN(2, NumHex13);
+  DEBUG_PRINT(2, "NumHex14: ");
+  DEBUG_PRINTLN(2, NumHex14);
   //char buffer[30];
   sprintf(buffer, "0x%s%s%s%s", NumHex11, NumHex12, NumHex13, NumHex14); //Send the requested PT vMix position to the head
   Hstring = (buffer);
-  Serial.println(Hstring);
+  DEBUG_PRINTLN(2, Hstring);
 
   //char H_array[7];
   Hstring.toCharArray(H_array, 7);
   x;
   //char *endptr;
   x = strtol(H_array, &endptr, 16);
-  Serial.println(x, HEX);
-  Serial.println(x, DEC);
+  DEBUG_PRINTLN(2, x, HEX);
+  DEBUG_PRINTLN(2, x, DEC);
   TAngleIn = x;                                //Stored int16_t to provide a signed 2's value not required
   if (TAngleIn > 43000) {                      //Then the move is negative down
     TAngleIn = (x - 23090);                   //Stored int16_t to provide a signed 2's value
     TAngleIn = 180 - ((TAngleIn / 235.9) );
     TAngleIn = (TAngleIn - (TAngleIn * 2));     //Sign it as negative
-    Serial.print("TAngleIn: ");
-    Serial.println(TAngleIn);
+    DEBUG_PRINT(2, "TAngleIn: ");
+    DEBUG_PRINTLN(2, TAngleIn);
   } else {
     TAngleIn = ((TAngleIn / 235.9));
-    Serial.print("TAngleIn: ");
-    Serial.println(TAngleIn);
+    DEBUG_PRINT(2, "TAngleIn: ");
+    DEBUG_PRINTLN(2, TAngleIn);
   }
 }
 void ReadInZoomFocus() {                             //Read in the Absolute position request PT only
   //Convert Zoom back to % of Zoom
 
-  Serial.print("NumHex4: ");
-  Serial.println(NumHex4);
-  Serial.print("NumHex5: ");
-  Serial.println(NumHex5);
-  Serial.print("NumHex6: ");
-  Serial.println(NumHex6);
-  Serial.print("NumHex7: ");
-  Serial.println(NumHex7);
+  DEBUG_PRINT(2, "NumHex4: ");
+  DEBUG_PRINTLN(2, NumHex4);
+  DEBUG_PRINT(2, "NumHex5: ");
+  DEBUG_PRINTLN(2, NumHex5);
+  DEBUG_PRINT(2, "NumHex6: ");
+  DEBUG_PRINTLN(2, NumHex6);
+  DEBUG_PRINT(2, "NumHex7: ");
+  DEBUG_PRINTLN(2, NumHex7);
   char buffer[30];
   sprintf(buffer, "0x%s%s%s%s", NumHex4, NumHex5, NumHex6, NumHex7); //Send the vMix zoom request to the head
   String Hstring = (buffer);
-  Serial.println(Hstring);
+  DEBUG_PRINTLN(2, Hstring);
 
   char H_array[7];
   Hstring.toCharArray(H_array, 7);
   int x;
   char *endptr;
   x = strtol(H_array, &endptr, 16);
-  Serial.println(x, HEX);
-  Serial.println(x, DEC);
+  DEBUG_PRINTLN(2, x, HEX);
+  DEBUG_PRINTLN(2, x, DEC);
 
   ZAngleIn = x;
   ZAngleIn = ZAngleIn / 60;
 
-  Serial.print("ZAngleIn: ");
-  Serial.println(ZAngleIn);
+  DEBUG_PRINT(2, "ZAngleIn: ");
+  DEBUG_PRINTLN(2, ZAngleIn);
 
 
 
   //Convert Focus back to % of focus for input
 
-  Serial.print("NumHex8: ");
-  Serial.println(NumHex8);
-  Serial.print("NumHex9: ");
-  Serial.println(NumHex9);
-  Serial.print("NumHex10: ");
-  Serial.println(NumHex10);
-  Serial.print("NumHex11: ");
-  Serial.println(NumHex11);
+  DEBUG_PRINT(2, "NumHex8: ");
+  DEBUG_PRINTLN(2, NumHex8);
+  DEBUG_PRINT(2, "NumHex9: ");
+  DEBUG_PRINTLN(2, NumHex9);
+  DEBUG_PRINT(2, "NumHex10: ");
+  DEBUG_PRINTLN(2, NumHex10);
+  DEBUG_PRINT(2, "NumHex11: ");
+  DEBUG_PRINTLN(2, NumHex11);
   //char buffer[30];
   sprintf(buffer, "0x%s%s%s%s", NumHex8, NumHex9, NumHex10, NumHex11);    //Send the focus position to the head
   Hstring = (buffer);
-  Serial.println(Hstring);
+  DEBUG_PRINTLN(2, Hstring);
 
   //char H_array[7];
   Hstring.toCharArray(H_array, 7);
   x;
 
   x = strtol(H_array, &endptr, 16);
-  Serial.println(x, HEX);
-  Serial.println(x, DEC);
+  DEBUG_PRINTLN(2, x, HEX);
+  DEBUG_PRINTLN(2, x, DEC);
   FAngleIn = x;                                //Stored int16_t to provide a signed 2's value not required
   FAngleIn = (FAngleIn - 1000) / 604.5;        //Convert bake to % of posible move
 
 
-  Serial.print("FAngleIn: ");
-  Serial.println(FAngleIn);
+  DEBUG_PRINT(2, "FAngleIn: ");
+  DEBUG_PRINTLN(2, FAngleIn);
+}
+
+// Runs in the UDP task: copies the packet for loop() and stamps its arrival
+void OnViscaPacket(AsyncUDPPacket& udpPacket, uint8_t listener) {
+  if (udpPacket.length() == 0 || udpPacket.length() > VISCA_MAX_PACKET) {
+    return;                                               //Not VISCA
+  }
+  ViscaPacket packet;
+  packet.received_us = micros();
+  memcpy(packet.data, udpPacket.data(), udpPacket.length());
+  packet.size = udpPacket.length();
+  packet.ip = udpPacket.remoteIP();
+  packet.port = udpPacket.remotePort();
+  packet.local_port = udpPacket.localPort();
+  packet.listener = listener;
+  if (xQueueSend(packetQueue, &packet, 0) != pdTRUE) {
+    droppedPackets++;                                     //loop() is behind, the oldest commands win
+  }
+}
+
+// Controllers match replies on the port they sent to, so answer from the listener that took the packet
+void SendReply(const byte* message, size_t len, uint8_t listener, IPAddress ip, uint16_t port) {
+  Udp[listener].writeTo(message, len, ip, port);
+}
+
+// Replies go back to whoever sent the command, as the camera that was asked, 0x90 for camera 1
+void SendAddressedReply(byte* message, size_t len) {
+  message[0] = 0x80 | (currentAddress << 4);
+  SendReply(message, len, current.listener, IPAddress(current.ip), current.port);
+}
+
+void SendInquiryReply(const byte* reply, size_t len) {
+  byte message[12];
+  RouteState& state = States[currentRoute];
+  portENTER_CRITICAL(&state.lock);
+  memcpy(message, reply, len);
+  portEXIT_CRITICAL(&state.lock);
+  SendAddressedReply(message, len);
+}
+
+// Confirm, acknowledge and complete, sent with the camera address of the route the command took
+void SendCommandReply(const byte* reply, size_t len) {
+  byte message[12];
+  memcpy(message, reply, len);
+  SendAddressedReply(message, len);
+}
+
+// Starts a listener on a port, once per port
+void Listen(uint16_t port) {
+  static uint16_t ports[ROUTES + 1];
+  static int listeners = 0;
+  for (int i = 0; i < listeners; i++) {
+    if (ports[i] == port) {
+      return;
+    }
+  }
+  if (listeners < ROUTES + 1 && Udp[listeners].listen(port)) {
+    uint8_t listener = listeners;
+    Udp[listeners].onPacket([listener](AsyncUDPPacket& udpPacket) {
+      OnViscaPacket(udpPacket, listener);
+    });
+    ports[listeners++] = port;
+  }
+}
+
+// Camera address of a packet, 0 if it has none. Plain VISCA starts with it, VISCA over IP after an 8 byte header
+uint8_t PacketAddress(const uint8_t* data, int size) {
+  if (size > 0 && data[0] >= 0x81 && data[0] <= 0x87) {
+    return data[0] - 0x80;
+  }
+  if (size > 8 && data[8] >= 0x81 && data[8] <= 0x87) {
+    return data[8] - 0x80;
+  }
+  return 0;
+}
+
+int FindRoute(uint8_t address, uint16_t port) {
+  for (int i = 0; i < ROUTES; i++) {
+    if ((Routes[i].address == 0 || Routes[i].address == address) && (Routes[i].port == 0 || Routes[i].port == port)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Hands a command line to the current packet's head, its task sends it
+void ForwardToHead(const char* line) {
+  HeadLine headLine;
+  strncpy(headLine.text, line, sizeof(headLine.text) - 1);
+  headLine.text[sizeof(headLine.text) - 1] = '\0';
+  headLine.received_us = current.received_us;
+  if (xQueueSend(States[currentRoute].queue, &headLine, 0) != pdTRUE) {
+    RouteState& state = States[currentRoute];
+    portENTER_CRITICAL(&state.lock);
+    state.dropped++;
+    portEXIT_CRITICAL(&state.lock);
+  }
+}
+
+void RequestPosition() {
+  HeadLine headLine;
+  headLine.text[0] = '\0';
+  headLine.received_us = 0;
+  xQueueSend(States[currentRoute].queue, &headLine, 0);
+}
+
+void RouteTask(void* parameter) {
+  int route = (int)(intptr_t)parameter;
+  ViscaRoute& out = Routes[route];
+  RouteState& state = States[route];
+  HeadLine headLine;
+  char frame[sizeof(ESPNOW_VISCA_TAG) + sizeof(headLine.text)];
+  while (true) {
+    if (xQueueReceive(state.queue, &headLine, portMAX_DELAY) != pdTRUE) {
+      continue;
+    }
+    if (headLine.text[0] == '\0') {
+      if (out.output == ROUTE_UART) {
+        delay(20);                                        //Give the head time to stop
+        listenForUART(route);
+      }
+      continue;
+    }
+    if (out.output == ROUTE_UART) {
+      out.uart->print(headLine.text);
+    } else {
+      int len = snprintf(frame, sizeof(frame), "%s%s", ESPNOW_VISCA_TAG, headLine.text);
+      esp_now_send(out.peer, (const uint8_t*)frame, len);
+    }
+    uint32_t latency = micros() - headLine.received_us;
+    portENTER_CRITICAL(&state.lock);
+    state.latencyCount++;
+    state.latencyTotal += latency;
+    if (latency > state.latencyMax) {
+      state.latencyMax = latency;
+    }
+    portEXIT_CRITICAL(&state.lock);
+  }
+}
+
+void StartRoutes() {
+  queryLock = xSemaphoreCreateMutex();
+  bool espnow = false;
+  for (int i = 0; i < ROUTES; i++) {
+    if (Routes[i].output == ROUTE_UART && Routes[i].uart != &UARTport) {
+      Routes[i].uart->begin(9600, SERIAL_8N1, Routes[i].rx_pin, Routes[i].tx_pin);
+    }
+    espnow = espnow || Routes[i].output == ROUTE_ESPNOW;
+  }
+  if (espnow) {
+    WiFi.mode(WIFI_STA);
+    if (esp_now_init() != ESP_OK) {
+      Serial.println("ESP-NOW init failed");
+    }
+  }
+  for (int i = 0; i < ROUTES; i++) {
+    if (Routes[i].output == ROUTE_ESPNOW) {
+      esp_now_peer_info_t peer = {};
+      memcpy(peer.peer_addr, Routes[i].peer, 6);
+      peer.channel = 0;
+      peer.encrypt = false;
+      esp_now_add_peer(&peer);
+    }
+    memcpy(States[i].PTposition, PTposition, sizeof(PTposition));
+    memcpy(States[i].ZoomPosition, ZoomPosition, sizeof(ZoomPosition));
+    memcpy(States[i].FocusPosition, FocusPosition, sizeof(FocusPosition));
+    States[i].queue = xQueueCreate(HEAD_QUEUE, sizeof(HeadLine));
+    xTaskCreatePinnedToCore(RouteTask, "route", 4096, (void*)(intptr_t)i, 2, NULL, 1);
+  }
+}
+
+void ReportLatency() {
+  if (millis() - latencyReportMs < LATENCY_REPORT_MS) {
+    return;
+  }
+  latencyReportMs = millis();
+  if (droppedPackets != 0 || unroutedPackets != 0) {
+    Serial.printf("\nVISCA packets dropped %lu, not routed %lu", (unsigned long)droppedPackets, (unsigned long)unroutedPackets);
+    droppedPackets = 0;
+    unroutedPackets = 0;
+  }
+  for (int i = 0; i < ROUTES; i++) {
+    RouteState& state = States[i];
+    portENTER_CRITICAL(&state.lock);
+    uint32_t count = state.latencyCount;
+    uint32_t total = state.latencyTotal;
+    uint32_t worst = state.latencyMax;
+    uint32_t dropped = state.dropped;
+    state.latencyCount = 0;
+    state.latencyTotal = 0;
+    state.latencyMax = 0;
+    state.dropped = 0;
+    portEXIT_CRITICAL(&state.lock);
+    if (count != 0 || dropped != 0) {
+      Serial.printf("\nVISCA to head %d: %lu commands, average %lu us, max %lu us, %lu dropped", i, (unsigned long)count,
+                    (unsigned long)(count ? total / count : 0), (unsigned long)worst, (unsigned long)dropped);
+    }
+  }
 }
@@ -253,6 +253,20 @@ int Nextion_play;
 int But_Com;
 int TpsM;
 
+//3D scan, the turntable leads and the slider follows row by row, see Start_Scan()
+int ScanRows = 0;                                    //Rows in the scan grid, one per slider position
+int ScanShots = 0;                                   //Shots per row over a full turn, or over the IN-OUT arc if one is set
+const long Rev_Steps = 15840;                        //Steps for one full turn of the platter at 16 microsteps, edit to match your gearing
+const int SCAN_SETTLE_MS = 150;                      //Encoder must stay still this long before a shot is taken
+const int SCAN_SETTLE_TIMEOUT = 3000;                //Take the shot anyway if the platter never settles
+const int SCAN_ROW_ESTIMATE = 3000;                  //Allowance per slider row change in the time estimate
+const int SCAN_SPEED = 1500;                         //Speed and acceleration between shots
+const int SCAN_ACCEL = 1500;
+const unsigned long SCAN_SLIDER_TIMEOUT = 30000;     //Abort the scan if the slider never reports the row
+int Scan_row = 0;                                    //Row the slider is asked to be on, 0 when not scanning
+int Scan_acked = 0;                                  //Row the slider last reported it has settled on
+int Scan_shot = 0;                                   //Shots taken so far
+
 int ResetEncoder = 0;
 int Sld;                                             //Is the Sld  present 1 or 0
 int TT = 1;                                          //Is the turntable present 1 or 0
@@ -440,6 +454,8 @@ typedef struct struct_message {
   int UDP;
   int TLY;
   long BD;
+  int ScR;                                                //3D scan rows from the controller, row to be on from the turntable
+  int ScS;                                                //3D scan shots per row from the controller, shot taken from the turntable
   //int mess;
 } struct_message;
 
@@ -640,7 +656,9 @@ void loop() {
     } else {                                                 //System is at the start and ready to play
       SetSpeed();
       delay(20);
-      if (Tps == 0) {                                       //No timelapse
+      if (ScanRows > 0 && ScanShots > 0) {                  //3D scan
+        Start_Scan();
+      } else if (Tps == 0) {                                //No timelapse
         digitalWrite(CAM, HIGH);                             //Start camera
         delay (200);
         digitalWrite(CAM, LOW);                              //Start camera
@@ -1464,7 +1482,8 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData,  int L
   char buffer[ESP_NOW_MAX_DATA_LEN + 1];
   // int msgLen = min(ESP_NOW_MAX_DATA_LEN, dataLen);
 
-  memcpy(&incomingValues, incomingData, sizeof(incomingValues));
+  memset(&incomingValues, 0, sizeof(incomingValues));
+  memcpy(&incomingValues, incomingData, min((int)sizeof(incomingValues), Len));   //Devices on older firmware send a shorter message
   //memcpy(&incomingValues, Data, sizeof(incomingValues));
 
   //Read all current Nextion values
@@ -1501,9 +1520,12 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData,  int L
       Sld = int(incomingValues.Sld);            //Slider available 1 or 0
       JB = int(incomingValues.JB);               //Turntable available 1 or 0
       PT = int(incomingValues.PT);               //Pan Tilt available 1 or 0
+      ScanRows = int(incomingValues.ScR);        //3D scan grid, 0 when not scanning
+      ScanShots = int(incomingValues.ScS);
       break;
     case 2:
       Sld = int(incomingValues.Sld);            //Slider available 1 or 0
+      Scan_acked = int(incomingValues.ScR);     //3D scan row the slider has settled on
       break;
     case 3:
       PT = int(incomingValues.PT);               //Pan Tilt available 1 or 0
@@ -1660,6 +1682,8 @@ void SendNextionValues() {                  //Remember any value you fail to sen
   //  NextionValues.a5 = a5;
   //  NextionValues.a6 = a6;
   NextionValues.SMC = SMC;                  //Stop motion counter
+  NextionValues.ScR = Scan_row;             //3D scan row the slider should be on
+  NextionValues.ScS = Scan_shot;            //3D scan shot just taken
 
   uint8_t broadcastAddress[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
   esp_now_send(broadcastAddress, (uint8_t *) &NextionValues, sizeof(NextionValues));
@@ -2001,6 +2025,139 @@ void Start_7() {
     Start_1();
   }
 }
+//**********************************************3D scan*******************************************
+//Photogrammetry grid of ScanRows slider positions by ScanShots turntable angles. Rows are shot as a serpentine,
+//every other row runs the angles backwards, so a row change costs only the slider move instead of a full rewind
+//of the turntable. Each shot waits for the encoder to show the platter has stopped instead of a fixed delay.
+//Handshake with the slider: ScR in our messages is the row it should be on, it answers Sld = 2 with the same row
+//in its ScR once it has settled there. The request is repeated until that answer comes back, and the scan is
+//abandoned if it never does. TT = 2 while the shutter is open, as for a timelapse.
+long Scan_Angle(int shot) {
+  if (out_position == in_position) {                                  //No arc set, spread the shots over a full turn
+    return in_position + (Rev_Steps * shot) / ScanShots;
+  }
+  if (ScanShots == 1) {
+    return in_position;
+  }
+  return in_position + ((out_position - in_position) * shot) / (ScanShots - 1);
+}
+
+unsigned long Scan_MoveMs(long dist) {                                 //Trapezoid or triangle at the scan speed and accel
+  float d = abs(dist);
+  float ramp = float(SCAN_SPEED) * SCAN_SPEED / SCAN_ACCEL;           //Distance taken by both ramps together
+  if (d >= ramp) {
+    return 1000 * (d / SCAN_SPEED + float(SCAN_SPEED) / SCAN_ACCEL);
+  }
+  return 1000 * 2 * sqrt(d / SCAN_ACCEL);
+}
+
+void Scan_Settle() {                                                   //Wait for the encoder to stop changing
+  while (stepper1->isRunning()) {
+    delay(5);
+  }
+  unsigned long start = millis();
+  unsigned long still = millis();
+  long last = S_position;
+  while (millis() - still < SCAN_SETTLE_MS && millis() - start < SCAN_SETTLE_TIMEOUT) {
+    delay(10);
+    if (abs(S_position - last) > 1) {
+      still = millis();
+      last = S_position;
+    }
+  }
+}
+
+bool Scan_Slider(int row) {                                            //Ask the slider for a row and wait until it is there
+  Scan_row = row;
+  if (Sld == 0) {
+    return true;
+  }
+  Sld = 1;
+  unsigned long start = millis();
+  unsigned long sent = millis();
+  SendNextionValues();
+  while (!(Sld == 2 && Scan_acked == row) && stopM_cancel != 1) {
+    delay(20);
+    if (millis() - start > SCAN_SLIDER_TIMEOUT) {
+      Serial.printf("\n3D scan slider did not report row %d, scan aborted\n", row);
+      Sld = 1;
+      return false;
+    }
+    if (millis() - sent > 2000) {                                      //Repeat the request in case it was lost
+      sent = millis();
+      SendNextionValues();
+    }
+  }
+  Sld = 1;
+  return stopM_cancel != 1;
+}
+
+void Start_Scan() {
+  digitalWrite(StepD, LOW);
+  int shutter = TpsD >= 200 ? TpsD : 300;
+  long total = (long)ScanRows * ScanShots;
+  stepper1->setSpeedInHz(SCAN_SPEED);
+  stepper1->setAcceleration(SCAN_ACCEL);
+
+  //Plan: time for every move of the serpentine, and what a row by row sweep rewinding to the first angle would take
+  unsigned long estimate = 0;
+  unsigned long rewind = 0;
+  long at = stepper1->getCurrentPosition();
+  for (int row = 0; row < ScanRows; row++) {
+    for (int i = 0; i < ScanShots; i++) {
+      int shot = (row % 2 == 0) ? i : ScanShots - 1 - i;
+      estimate += Scan_MoveMs(Scan_Angle(shot) - at) + SCAN_SETTLE_MS + shutter;
+      at = Scan_Angle(shot);
+    }
+    if (row > 0) {
+      estimate += SCAN_ROW_ESTIMATE;
+      rewind += Scan_MoveMs(Scan_Angle(ScanShots - 1) - Scan_Angle(0));
+    }
+  }
+  Serial.printf("\n3D scan %d rows x %d shots, estimated %lu s, serpentine saves %lu s over row by row\n",
+                ScanRows, ScanShots, estimate / 1000, rewind / 1000);
+
+  unsigned long started = millis();
+  Scan_shot = 0;
+  Tps = total;
+  bool ready = Scan_Slider(1);
+  for (int row = 0; row < ScanRows && ready && stopM_cancel != 1; row++) {
+    if (row > 0) {
+      ready = Scan_Slider(row + 1);                                   //The turntable stays where the last row ended
+      if (!ready) {
+        break;
+      }
+    }
+    for (int i = 0; i < ScanShots && stopM_cancel != 1; i++) {
+      int shot = (row % 2 == 0) ? i : ScanShots - 1 - i;
+      stepper1->moveTo(Scan_Angle(shot));
+      Scan_Settle();
+      Scan_shot++;
+      TT = 2;                                                         //Shutter open, the slider fires its camera too
+      SendNextionValues();
+      digitalWrite(CAM, HIGH);
+      delay(shutter);
+      digitalWrite(CAM, LOW);
+      TT = 1;
+      Tps = total - Scan_shot;
+      But_Com = 7;                                                    //Tell the nextion to update the frame counter
+      SendNextionValues();
+      But_Com = 0;
+    }
+  }
+  Scan_row = 0;
+  if (Sld != 0) {
+    Sld = 1;                                                          //Drop any late answer from the slider
+  }
+  unsigned long taken = (millis() - started) / 1000;
+  Serial.printf("\n3D scan %ld of %ld shots in %lu s, estimated %lu s\n", (long)Scan_shot, total, taken, estimate / 1000);
+  Tps = 0;
+  But_Com = 5;                                                        //Tell the nextion to stop the timer
+  SendNextionValues();
+  But_Com = 0;
+  Start_1();                                                          //Back to the start
+}
+
 //**********************************************Sequencer*******************************************
 void Find_KeyDist() {
   if (KeyB >= 0 && KeyA >= 0) {
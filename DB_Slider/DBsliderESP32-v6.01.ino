@@ -55,6 +55,7 @@
 #include <AS5600.h>
 
 #include <esp_now.h>
+#include "PosSubscribers.h"
 //#include <trigger.h>
 #include <WiFi.h>
 //#include <WiFiUdp.h>
@@ -207,6 +208,31 @@ long loopcount = 0;
 long  S_lastPosition = 0;
 float factor;
 
+//Encoder speed regulation for slow moves, see RegulateSpeed()
+const long REG_MAX_SPEED = 400;               //Moves slower than this in steps/s are regulated
+const int REG_PERIOD = 10;                    //Regulate every 10th encoder pass, ~10Hz
+const int REG_WINDOW = 50;                    //Velocity estimate over the last 50 regulation samples, ~5s
+const float REG_KP = 0.2;                     //Steps/s of correction per step of position error
+const float REG_KI = 0.01;                    //Steps/s per step*second of accumulated error
+const float REG_MAX_TRIM = 0.05;              //Never move more than 5% away from the planned speed
+const float REG_MAX_SLEW = 0.002;             //and change by no more than 0.2% of it per update
+const unsigned long REG_LOG_MS = 10000;       //Tracking error log interval
+volatile int Reg_active = 0;                  //1 while a regulated move is running, 2 once it is tracking, 3 once handed back to the ramp
+long Reg_target;                              //Where the move ends
+float Reg_nominal;                            //Planned speed in steps/s, signed with the direction of travel
+float Reg_rate;                               //Speed currently commanded
+volatile uint32_t Reg_mHz;                    //Trimmed speed waiting for the move loop to apply it, 0 if none
+float Reg_integral;
+long Reg_startPos;                            //Encoder position and time tracking started at
+unsigned long Reg_startMs;
+long Reg_window[REG_WINDOW];                  //Encoder positions for the velocity estimate
+int Reg_samples;
+int Reg_count;
+unsigned long Reg_lastLog;
+float Reg_errSquares;                         //Tracking statistics for the end of move report
+float Reg_errMax;
+long Reg_updates;
+
 long Rail_Length = 500;                     //Edit this to use any rail length you require in mm
 long Max_Steps = 0;                         //Variable used to set the max number of steps for the given leangth of rail
 long set_speed = 0;
@@ -252,6 +278,17 @@ int Nextion_play;
 int But_Com;
 int TpsM;
 
+//3D scan, the turntable leads and the slider moves row by row, see Start_Scan()
+int ScanRows = 0;                          //Rows in the scan grid, spread from IN to OUT
+int ScanShots = 0;                         //Shots per row
+volatile int Scan_row = 0;                 //Row the turntable wants us on, 0 when not scanning
+volatile int Scan_shot = 0;                //Shots the turntable has taken
+volatile int Scan_request = 0;             //Counts row requests from the turntable, each one gets an answer
+int Scan_at = 0;                           //Row we have settled on, sent back in ScR so the turntable can match it
+const int SCAN_SETTLE_MS = 150;            //Encoder must stay still this long before we report the row reached
+const int SCAN_SETTLE_TIMEOUT = 3000;
+const unsigned long SCAN_TIMEOUT = 30000;  //Give up if the turntable goes quiet
+
 int ResetEncoder = 0;
 int Sld = 1;                               //Is the Slider  present 1 or 0
 int TT;                                    //Is the turntable present 1 or 0
@@ -440,12 +477,26 @@ typedef struct struct_message {
   int UDP;
   int TLY;
   long BD;
+  int ScR;                                                //3D scan rows from the controller, row to be on from the turntable
+  int ScS;                                                //3D scan shots per row from the controller, shot taken from the turntable
   //int mess;
 } struct_message;
 
 struct_message NextionValues;                             //Define structure for sending values to remote Nextion Control
 struct_message incomingValues;                            //Define structure for receiving values from remote Nextion control
 
+//Position stream for the point of interest lock on the heads, subscribed as described in PosSubscribers.h.
+//Must match SliderSample on the head
+typedef struct slider_sample {
+  char tag[4];                                            //"SPOS"
+  uint32_t sequence;
+  float position_mm;                                      //Carriage position from home
+  float velocity_mm_s;                                    //Signed with the direction of travel
+} slider_sample;
+
+const float Steps_mm = 58 / 2.0;                          //Carriage steps per mm, as used for Max_Steps
+PosSubscribers Pos_heads;
+
 int WIFIOUT[8];                                           //set up 5 element array for sendinf values to pantilt
 #define RXD2 16                                           //Hardware Serial2 on ESP32 Dev (must also be a common earth between nextion and esp32)
 #define TXD2 17
@@ -640,7 +691,9 @@ void loop() {
     } else {                                                 //System is at the start and ready to play
       SetSpeed();
       delay(20);
-      if (Tps == 0) {                                       //No timelapse
+      if (ScanRows > 0 && ScanShots > 0 && TT != 0) {       //3D scan, the turntable leads
+        Start_Scan();
+      } else if (Tps == 0) {                                //No timelapse
         digitalWrite(CAM, HIGH);                             //Start camera
         delay (200);
         digitalWrite(CAM, LOW);                              //Start camera
@@ -799,6 +852,8 @@ void loop() {
 void core1assignments( void * pvParameters ) {
   for (;;) {
     StartEncoder();
+    RegulateSpeed();
+    StreamPosition();
     vTaskDelay(10);
     BatCheck();
   }
@@ -832,6 +887,121 @@ void StartEncoder() {
   //Serial.println(S_position);
 }
 
+//******Position stream for the heads' target lock, runs in the encoder task***********
+void StreamPosition() {
+  bool moving = stepper1 != NULL && stepper1->isRunning();
+  if (!Pos_heads.due(moving) || stepper1 == NULL) {
+    return;
+  }
+
+  slider_sample sample;
+  memcpy(sample.tag, "SPOS", 4);
+  sample.sequence = Pos_heads.nextSequence();
+  sample.position_mm = stepper1->getCurrentPosition() / Steps_mm;
+  sample.velocity_mm_s = moving ? stepper1->getCurrentSpeedInMilliHz() / 1000.0 / Steps_mm : 0;
+  Pos_heads.send(&sample, sizeof(sample));
+}
+
+//******Closed loop speed for slow moves***********
+//Belt stretch and load on an incline make the open loop step rate show as speed wobble on hyperlapses lasting hours.
+//Once the stepper has ramped up, the encoder position is compared with where the carriage should be at the planned
+//speed and the step rate is trimmed by a PI loop on that error. Working on position instead of a differentiated
+//velocity keeps the encoder quantisation out of the loop at a few steps per second.
+void RegulateBegin(long target) {
+  if (step_speed <= 0 || step_speed > REG_MAX_SPEED) {
+    return;
+  }
+  Reg_target = target;
+  Reg_nominal = (target >= stepper1->getCurrentPosition()) ? step_speed : -step_speed;
+  Reg_rate = step_speed;
+  Reg_mHz = 0;
+  Reg_integral = 0;
+  Reg_samples = 0;
+  Reg_count = 0;
+  Reg_errSquares = 0;
+  Reg_errMax = 0;
+  Reg_updates = 0;
+  Reg_active = 1;                                              //Waits for the ramp up in RegulateSpeed()
+}
+
+void RegulateEnd() {
+  if (Reg_active == 0) {
+    return;
+  }
+  if (Reg_active >= 2 && Reg_updates > 0) {
+    Serial.printf("\nRegulated move done: %lu s, rms error %.1f steps, max error %.1f steps\n",
+                  (millis() - Reg_startMs) / 1000, sqrt(Reg_errSquares / Reg_updates), Reg_errMax);
+  }
+  Reg_active = 0;
+}
+
+//Called from the loop waiting on the move, so only the task that started the move ever changes the stepper's speed
+void ApplyRegulation() {
+  uint32_t mhz = Reg_mHz;
+  if (mhz == 0 || Reg_active != 2) {
+    return;
+  }
+  Reg_mHz = 0;
+  stepper1->setSpeedInMilliHz(mhz);
+  stepper1->applySpeedAcceleration();
+}
+
+//Runs in the encoder task after StartEncoder(), works out the trim and leaves it for ApplyRegulation()
+void RegulateSpeed() {
+  if (Reg_active == 0 || Reg_active == 3 || stepper1 == NULL || ++Reg_count < REG_PERIOD) {
+    return;
+  }
+  Reg_count = 0;
+  long pos = S_position;
+  uint8_t ramp = stepper1->rampState() & RAMP_STATE_MASK;
+  if (Reg_active == 1) {
+    if (ramp != RAMP_STATE_COAST) {
+      return;                                                  //Let the stepper finish its ramp up first
+    }
+    Reg_active = 2;
+    Reg_startPos = pos;
+    Reg_startMs = millis();
+    Reg_lastLog = Reg_startMs;
+  }
+
+  //Hand the end of the move back to the stepper ramp
+  float accel = Ease_Value > 0 ? Ease_Value : 1;
+  float braking = (Reg_rate * Reg_rate) / (2 * accel) + Reg_rate;
+  if (abs(Reg_target - stepper1->getCurrentPosition()) <= braking || ramp == RAMP_STATE_IDLE) {
+    Reg_active = 3;                                            //RegulateEnd() reports once the move is over
+    return;
+  }
+
+  unsigned long now = millis();
+  float elapsed = (now - Reg_startMs) / 1000.0;
+  float error = (pos - Reg_startPos) - Reg_nominal * elapsed;  //Steps ahead of the planned position
+  if (Reg_nominal < 0) {
+    error = -error;
+  }
+  float trim = abs(Reg_nominal) * REG_MAX_TRIM;
+  float integral_limit = trim / REG_KI;                        //The integral alone may not ask for more than the trim, so long holds can not wind it up
+  Reg_integral = constrain(Reg_integral + error * REG_PERIOD * 0.01, -integral_limit, integral_limit);
+  float wanted = abs(Reg_nominal) - REG_KP * error - REG_KI * Reg_integral;
+  wanted = constrain(wanted, abs(Reg_nominal) - trim, abs(Reg_nominal) + trim);
+  float slew = abs(Reg_nominal) * REG_MAX_SLEW;
+  Reg_rate += constrain(wanted - Reg_rate, -slew, slew);
+  Reg_mHz = (uint32_t)(Reg_rate * 1000);
+
+  Reg_updates++;
+  Reg_errSquares += error * error;
+  if (abs(error) > Reg_errMax) {
+    Reg_errMax = abs(error);
+  }
+  Reg_window[Reg_samples % REG_WINDOW] = pos;
+  Reg_samples++;
+  if (now - Reg_lastLog >= REG_LOG_MS && Reg_samples > REG_WINDOW) {
+    Reg_lastLog = now;
+    float velocity = abs(pos - Reg_window[Reg_samples % REG_WINDOW]) / (REG_WINDOW * REG_PERIOD * 0.01);
+    Serial.printf("\nRegulated move: planned %.2f steps/s, measured %.2f, commanded %.2f, error %.1f steps\n",
+                  abs(Reg_nominal), velocity, Reg_rate, error);
+  }
+}
+
 
 
 
@@ -1489,7 +1659,13 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData,  int L
   char buffer[ESP_NOW_MAX_DATA_LEN + 1];
   // int msgLen = min(ESP_NOW_MAX_DATA_LEN, dataLen);
 
-  memcpy(&incomingValues, incomingData, sizeof(incomingValues));
+  if (Len == 4 && memcmp(incomingData, "SSUB", 4) == 0) {   //Position stream request from a head, not a struct_message
+    Pos_heads.subscribe(macAddr);
+    return;
+  }
+
+  memset(&incomingValues, 0, sizeof(incomingValues));
+  memcpy(&incomingValues, incomingData, min((int)sizeof(incomingValues), Len));   //Devices on older firmware send a shorter message
   //memcpy(&incomingValues, Data, sizeof(incomingValues));
 
  
@@ -1519,12 +1695,19 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData,  int L
       JB = int(incomingValues.JB);            //Slider available 1 or 0
       TT = int(incomingValues.TT);               //Turntable available 1 or 0
       PT = int(incomingValues.PT);               //Pan Tilt available 1 or 0
+      ScanRows = int(incomingValues.ScR);        //3D scan grid, 0 when not scanning
+      ScanShots = int(incomingValues.ScS);
       break;
     case 3:
       PT = int(incomingValues.PT);               //Pan Tilt available 1 or 0
       break;
     case 4:
       TT = int(incomingValues.TT);               //Turntable available 1 or 0
+      Scan_row = int(incomingValues.ScR);        //3D scan row request and shot count
+      Scan_shot = int(incomingValues.ScS);
+      if (Scan_row != 0 && incomingValues.TT != 2 && incomingValues.But == 0) {
+        Scan_request++;                          //A row request or a repeat of one, not a shot message
+      }
       break;
     case 5:
       JB = int(incomingValues.JB);               //Turntable available 1 or 0
@@ -1654,6 +1837,7 @@ void SendNextionValues() {                  //Remember any value you fail to sen
   NextionValues.InP = InP;                  // Inpoint button state 0-2
   NextionValues.OutP = OutP;                // Outpoint button state 0-2
   NextionValues.Sld = Sld;                  // Slider present 0-1
+  NextionValues.ScR = Scan_at;              // 3D scan row we have settled on
   //NextionValues.PT = PT;                  // Pan Tilt present 0-1,2
   //NextionValues.TT = TT;                  // Turntable present 0-1
   NextionValues.CA = PTZ_Cam;               //Send back confirmation regarding current PTZ
@@ -1684,6 +1868,86 @@ void SendNextionValues() {                  //Remember any value you fail to sen
 
 
 
+//**********************************************3D scan*******************************************
+//The turntable plans the grid and shoots each row, we only follow. Whenever its messages ask for another row we
+//move there, wait for the encoder to settle and answer Sld = 2 with the row in ScR. A repeated request for the row
+//we are already on is answered again, as our first answer may have been lost. TT = 2 means the turntable has the
+//shutter open, so the camera fires from here as well in case it is plugged into the slider.
+long Scan_Position(int row) {
+  if (ScanRows <= 1) {
+    return in_position;
+  }
+  return in_position + ((out_position - in_position) * (row - 1)) / (ScanRows - 1);
+}
+
+void Start_Scan() {
+  digitalWrite(StepD, LOW);
+  stepper1->setSpeedInHz(2000);
+  stepper1->setAcceleration(2000);
+  int shutter = TpsD >= 200 ? TpsD : 300;
+  int row = 0;
+  int answered = Scan_request;
+  int lastTT = TT;
+  unsigned long lastChange = millis();
+  Serial.printf("\n3D scan following turntable, %d rows\n", ScanRows);
+
+  while (stopM_cancel != 1 && millis() - lastChange < SCAN_TIMEOUT) {
+    int wanted = Scan_row;
+    int request = Scan_request;
+    if (wanted == 0 && row != 0) {                                    //Turntable has finished
+      break;
+    }
+    if (wanted != 0 && wanted == row && request != answered) {        //Asked again for the row we are on
+      answered = request;
+      Sld = 2;
+      SendNextionValues();
+      delay(50);
+      Sld = 1;
+      lastChange = millis();
+    }
+    if (wanted != 0 && wanted != row) {
+      row = wanted;
+      answered = request;
+      stepper1->moveTo(Scan_Position(row));
+      while (stepper1->isRunning()) {                                 //delay until move complete (block)
+        if (digitalRead(home_switch) == LOW) {
+          stepper1->forceStopAndNewPosition(5);                  //Stops dead error if the home switch is triggered unexpectadly
+          ESP.restart();
+        }
+        delay(5);
+      }
+      unsigned long start = millis();                                 //Wait for the carriage to stop wobbling
+      unsigned long still = millis();
+      long last = S_position;
+      while (millis() - still < SCAN_SETTLE_MS && millis() - start < SCAN_SETTLE_TIMEOUT) {
+        delay(10);
+        if (abs(S_position - last) > 1) {
+          still = millis();
+          last = S_position;
+        }
+      }
+      Scan_at = row;
+      Sld = 2;                                                        //Tell the turntable we are there
+      SendNextionValues();
+      delay(50);
+      Sld = 1;
+      lastChange = millis();
+    }
+    if (TT == 2 && lastTT != 2) {                                     //Turntable opened the shutter
+      digitalWrite(CAM, HIGH);
+      delay(shutter);
+      digitalWrite(CAM, LOW);
+      lastChange = millis();
+    }
+    lastTT = TT;
+    delay(5);
+  }
+  Serial.printf("\n3D scan done after %d shots\n", (int)Scan_shot);
+  Scan_row = 0;
+  Scan_at = 0;
+  Start_1();                                                          //Back to the start
+}
+
 //*********************************************ARM The SLIDER READY TO START**************************************************
 void Start_1() {
 
@@ -1746,13 +2010,16 @@ void Start_2() {
   stepper1->setAcceleration(Ease_Value);
   delay(2);                                               //Timed to start with PanTilt head
   stepper1->moveTo(out_position);
+  RegulateBegin(out_position);
   while (stepper1->isRunning()) {                         //delay until move complete (block)
+    ApplyRegulation();
     if (digitalRead(home_switch) == LOW) {
       stepper1->forceStopAndNewPosition(5);                  //Stops dead error if the home switch is triggered unexpectadly
       ESP.restart();
     }
     delay(2);
   }
+  RegulateEnd();
   //******************************************RUN THE SEQUENCE with Bounce************************************************
   //*************************Formally start_3 which ran into watchdog problems looping between two functions********************
   if (Bounce >= 1 ) {
@@ -1771,8 +2038,11 @@ void Start_2() {
       PT = 1;
     }
 
+    stepper1->setSpeedInHz(step_speed);                   //Back to the planned speed, regulation may have trimmed it
     stepper1->moveTo(in_position);
+    RegulateBegin(in_position);
     while (stepper1->isRunning()) {                         //delay until move complete (block)
+      ApplyRegulation();
 
       if (digitalRead(home_switch) == LOW) {
         stepper1->forceStopAndNewPosition(5);                  //Stops dead error if the home switch is triggered unexpectadly
@@ -1781,6 +2051,7 @@ void Start_2() {
 
       delay(2);
     }
+    RegulateEnd();
 
     if (PT == 0) {                                          //Only take charge of the counting if no PT
       Bounce = Bounce - 1;
@@ -0,0 +1,96 @@
+#ifndef POS_SUBSCRIBERS_H
+#define POS_SUBSCRIBERS_H
+
+#include <esp_now.h>
+
+// Position stream subscribers
+//
+// The slider and the jib stream their position to DB3 heads for the point of interest lock, see TargetLock.h in DB3.
+// A head asks with a 4 byte "SSUB" sent to the device alone and renews that every second, one that stops renewing
+// is dropped after RENEW_MS. Samples go to each subscriber directly, never by broadcast, as older devices take any
+// message for a struct_message. The encoder task asks due() on every pass, which paces samples at ~50Hz while
+// moving and ~4Hz standing still, and answers a new subscriber straight away as heads wait for a sample when they
+// mark the target. The same file sits in DB_Slider and Mini Jib, keep the copies in step.
+class PosSubscribers {
+public:
+  static const int MAX = 4;
+  static const unsigned long RENEW_MS = 3000;
+  static const int PERIOD_MOVING = 2;             // Encoder passes between samples
+  static const int PERIOD_IDLE = 25;
+
+private:
+  uint8_t mac[MAX][6];
+  unsigned long heard[MAX];
+  bool active[MAX] = {};
+  volatile bool fresh = false;                    // A head just asked
+  int count = 0;
+  uint32_t sequence = 0;
+  portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+  uint8_t heads[MAX][6];                          // Copied by due() for send(), outside the lock
+  int headCount = 0;
+
+public:
+  // From the receive callback
+  void subscribe(const uint8_t* macAddr) {
+    unsigned long now = millis();
+    portENTER_CRITICAL(&lock);
+    int slot = -1;
+    for (int i = 0; i < MAX; i++) {
+      if (active[i] && memcmp(mac[i], macAddr, 6) == 0) {
+        slot = i;                                 // Renewal
+        break;
+      }
+      if (slot < 0 && (!active[i] || now - heard[i] > RENEW_MS)) {
+        slot = i;
+      }
+    }
+    if (slot >= 0) {
+      memcpy(mac[slot], macAddr, 6);
+      heard[slot] = now;
+      active[slot] = true;
+      fresh = true;
+    }
+    portEXIT_CRITICAL(&lock);
+  }
+
+  // From the encoder task, true when a sample is due and some head is still subscribed
+  bool due(bool moving) {
+    if (!fresh && ++count < (moving ? PERIOD_MOVING : PERIOD_IDLE)) {
+      return false;
+    }
+    count = 0;
+    fresh = false;
+
+    headCount = 0;
+    unsigned long now = millis();
+    portENTER_CRITICAL(&lock);
+    for (int i = 0; i < MAX; i++) {
+      if (active[i] && now - heard[i] > RENEW_MS) {
+        active[i] = false;
+      }
+      if (active[i]) {
+        memcpy(heads[headCount++], mac[i], 6);
+      }
+    }
+    portEXIT_CRITICAL(&lock);
+    return headCount > 0;
+  }
+
+  uint32_t nextSequence() {
+    return ++sequence;
+  }
+
+  // To every head due() found
+  void send(const void* sample, size_t len) {
+    for (int i = 0; i < headCount; i++) {
+      if (!esp_now_is_peer_exist(heads[i])) {
+        esp_now_peer_info_t peerInfo = {};
+        memcpy(&peerInfo.peer_addr, heads[i], 6);
+        esp_now_add_peer(&peerInfo);
+      }
+      esp_now_send(heads[i], (const uint8_t*)sample, len);
+    }
+  }
+};
+
+#endif // POS_SUBSCRIBERS_H
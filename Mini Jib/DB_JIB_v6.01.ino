@@ -52,6 +52,7 @@
 #include <AS5600.h>
 
 #include <esp_now.h>
+#include "PosSubscribers.h"
 //#include <trigger.h>
 #include <WiFi.h>
 #include <WiFiUdp.h>
@@ -451,6 +452,48 @@ struct_message NextionValues;                             //Define structure for
 struct_message incomingValues;                            //Define structure for receiving values from remote Nextion control
 
 int WIFIOUT[8];                                           //set up 5 element array for sendinf values to pantilt
+
+//*****************************Straight camera paths, see JibPathTick()*****************************
+//Change these values to match your jib, straight paths stay off while either is 0
+const float Jib_Arm_mm = 0;                               //Pivot to the tilt axis of the head on the end of the arm
+const float Jib_Steps_Degree = 0;                         //Arm stepper steps per degree of swing
+long Jib_Level_Steps = 0;                                 //Stepper position with the arm level, set with JIB_LEVEL_POSE
+bool Jib_Level_Set = false;                               //Homing ends on the end stop, not level, so it has to be taught
+const float Jib_Target_Distance = 0;                      //Point the head keeps the camera on, mm out from the pivot. 0 holds the horizon
+const float Jib_Target_Height = 0;                        //and mm above the pivot
+
+const int JIB_IK_POSE = 107;                              //Pose requests switching A-B moves to a straight camera path and back to the arc
+const int JIB_ARC_POSE = 108;
+const int JIB_LEVEL_POSE = 109;                           //Jog the arm level, then request this to store the level position
+int Jib_IK = 0;                                           //1 while A-B moves run as straight camera paths, kept in SysMemory
+const int JIB_LUT = 256;                                  //Table steps per 90 degrees, or per 0-1 for the atan table
+float Jib_Sin[JIB_LUT + 1];                               //sin over 0-90 degrees
+float Jib_Atan[JIB_LUT + 1];                              //atan over 0-1 in degrees
+const int JIB_PATH_MS = 10;                               //Path task period, 100Hz
+const float JIB_PATH_KP = 5.0;                            //Steps/s of correction per step behind the path
+const uint32_t JIB_PATH_ACCEL = 2000;                     //Stepper ramp while following, steeper than the path itself asks for
+volatile int Jib_Path_active = 0;
+float Jib_Path_z0;                                        //Camera height above the pivot at the start and end
+float Jib_Path_z1;
+unsigned long Jib_Path_startMs;
+unsigned long Jib_Path_ms;
+float Jib_Path_ramp;                                      //Share of the move spent on each ramp
+long Jib_Path_target;
+int32_t Jib_Path_applied;                                 //Last speed handed to the stepper in mHz
+float Jib_Path_errMax;
+long Jib_Path_ticks;
+TaskHandle_t C3;
+
+//Head tilt stream for a DB3 head riding the jib, subscribed as described in PosSubscribers.h.
+//Must match JibSample on the head
+typedef struct jib_sample {
+  char tag[4];                                            //"JPOS"
+  uint32_t sequence;
+  float tilt_deg;                                         //Head tilt holding the horizon or target, up to a constant
+  float tilt_deg_s;
+} jib_sample;
+
+PosSubscribers Pos_heads;
 #define RXD2 16                                           //Hardware Serial2 on ESP32 Dev (must also be a common earth between nextion and esp32)
 #define TXD2 17
 
@@ -535,6 +578,16 @@ void setup() {
   lastPTZ_ID = PTZ_ID;                                           //set last PTZ_ID for comparison when changing ID
   // Serial.printf("PTZ_ID is set to: %d \n", PTZ_ID);
   Load_SysMemory();
+  SysMemory.begin("JibPath", true);
+  Jib_IK = SysMemory.getUInt("IK", 0);
+  Jib_Level_Set = SysMemory.isKey("level");
+  Jib_Level_Steps = SysMemory.getLong("level", 0);
+  SysMemory.end();
+  if (!JibConfigured()) {
+    Jib_IK = 0;
+  }
+  JibTables();
+  xTaskCreatePinnedToCore(jibPathTask, "JibPath", 4096, NULL, 2, &C3, 1);
   SendNextionValues();
   homeStepper();
 }
@@ -801,11 +854,206 @@ void loop() {
 void coreas1signments( void * pvParameters ) {
   for (;;) {
     StartEncoder();
+    StreamTilt();
     vTaskDelay(10);
     BatCheck();
   };
 }
 
+//******************************Straight camera paths*********************************
+//The arm swings on an arc, so an A-B move at a steady step rate lifts the camera fast at first and slowly near the
+//top while the horizon tilts with the arm. In IK mode the camera height follows a straight line from A to B with
+//the move's ease instead, solved for the arm angle every 10ms and tracked with speed updates. A head on the end of
+//the arm is streamed the tilt that keeps the horizon, or the target, where it was framed. The trig runs off
+//interpolated tables so the per tick work stays a handful of multiplies.
+void JibTables() {
+  for (int i = 0; i <= JIB_LUT; i++) {
+    Jib_Sin[i] = sin(i * (HALF_PI / JIB_LUT));
+    Jib_Atan[i] = atan((float)i / JIB_LUT) * RAD_TO_DEG;
+  }
+}
+
+float JibSin(float deg) {
+  float a = constrain(fabs(deg), 0, 90) * (JIB_LUT / 90.0);
+  int i = min((int)a, JIB_LUT - 1);
+  float v = Jib_Sin[i] + (Jib_Sin[i + 1] - Jib_Sin[i]) * (a - i);
+  return deg < 0 ? -v : v;
+}
+
+float JibCos(float deg) {
+  return JibSin(90 - fabs(deg));
+}
+
+//Arm angle in degrees for a sine ratio, by searching the sine table
+float JibAsin(float ratio) {
+  float r = constrain(fabs(ratio), 0, 1);
+  int lo = 0;
+  int hi = JIB_LUT;
+  while (hi - lo > 1) {
+    int mid = (lo + hi) / 2;
+    if (Jib_Sin[mid] <= r) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  float span = Jib_Sin[hi] - Jib_Sin[lo];
+  float deg = (lo + (span > 0 ? (r - Jib_Sin[lo]) / span : 0)) * (90.0 / JIB_LUT);
+  return ratio < 0 ? -deg : deg;
+}
+
+float JibAtan2(float y, float x) {
+  float ax = fabs(x);
+  float ay = fabs(y);
+  if (ax == 0 && ay == 0) {
+    return 0;
+  }
+  float t = (ax >= ay ? ay / ax : ax / ay) * JIB_LUT;
+  int i = min((int)t, JIB_LUT - 1);
+  float deg = Jib_Atan[i] + (Jib_Atan[i + 1] - Jib_Atan[i]) * (t - i);
+  if (ax < ay) deg = 90 - deg;
+  if (x < 0) deg = 180 - deg;
+  return y < 0 ? -deg : deg;
+}
+
+bool JibConfigured() {
+  return Jib_Arm_mm > 0 && Jib_Steps_Degree > 0 && Jib_Level_Set;
+}
+
+float JibAngle(long steps) {
+  return (steps - Jib_Level_Steps) / Jib_Steps_Degree;
+}
+
+//Head tilt that holds the horizon or looks at the target with the arm at angle, and its rate for the arm's rate.
+//The head's tilt axis turns with the arm, so the arm angle comes off whatever the camera should look at
+float JibHeadTilt(float angle, float rate, float &tilt_rate) {
+  if (Jib_Target_Distance == 0) {
+    tilt_rate = -rate;
+    return -angle;
+  }
+  float s = JibSin(angle);
+  float c = JibCos(angle);
+  float dx = Jib_Target_Distance - Jib_Arm_mm * c;
+  float dz = Jib_Target_Height - Jib_Arm_mm * s;
+  float look = JibAtan2(dz, dx);
+  float look_per_arm = -Jib_Arm_mm * (dx * c + dz * s) / (dx * dx + dz * dz);
+  tilt_rate = (look_per_arm - 1) * rate;
+  return look - angle;
+}
+
+//Starts a straight camera path from where the arm is to target over ms. False if an end is outside +-90 degrees
+//from level, where the height no longer gives a single arm angle, the caller then makes the plain move
+bool JibPathStart(long target, unsigned long ms) {
+  float from = JibAngle(stepper1->getCurrentPosition());
+  float to = JibAngle(target);
+  if (fabs(from) > 90 || fabs(to) > 90) {
+    Serial.printf("\nCamera path from %.1f to %.1f degrees is past vertical, moving on the arc\n", from, to);
+    return false;
+  }
+  Jib_Path_z0 = Jib_Arm_mm * JibSin(JibAngle(stepper1->getCurrentPosition()));
+  Jib_Path_z1 = Jib_Arm_mm * JibSin(JibAngle(target));
+  Jib_Path_target = target;
+  Jib_Path_ms = max(ms, 1000UL);
+  switch (ease_InOut) {                                        //Longer ramps for more ease, as SetSpeed() does
+    case 1: Jib_Path_ramp = 0.1; break;
+    case 2: Jib_Path_ramp = 0.2; break;
+    case 3: Jib_Path_ramp = 0.3; break;
+    default: Jib_Path_ramp = 0.02; break;
+  }
+  Jib_Path_applied = 0;
+  Jib_Path_errMax = 0;
+  Jib_Path_ticks = 0;
+  stepper1->setAcceleration(JIB_PATH_ACCEL);
+  Jib_Path_startMs = millis();
+  Jib_Path_active = 1;
+  Serial.printf("\nCamera path from %.0f mm to %.0f mm in %lu ms\n", Jib_Path_z0, Jib_Path_z1, Jib_Path_ms);
+  return true;
+}
+
+void JibPathTick() {
+  float t = (millis() - Jib_Path_startMs) / (float)Jib_Path_ms;
+  if (t >= 1) {
+    stepper1->setSpeedInHz(step_speed);                        //Leave speed mode at the move's own speed and ease
+    stepper1->setAcceleration(Ease_Value);
+    stepper1->moveTo(Jib_Path_target);                         //The stepper ramp lands the last few steps
+    Jib_Path_active = 0;
+    Serial.printf("\nCamera path done, max error %.1f steps over %ld ticks\n", Jib_Path_errMax, Jib_Path_ticks);
+    return;
+  }
+
+  //Trapezoid in normalised time: ramp up over r, cruise, ramp down over r
+  float r = Jib_Path_ramp;
+  float vmax = 1 / (1 - r);
+  float p, v;
+  if (t < r) {
+    p = vmax * t * t / (2 * r);
+    v = vmax * t / r;
+  } else if (t < 1 - r) {
+    p = vmax * (t - r / 2);
+    v = vmax;
+  } else {
+    float u = 1 - t;
+    p = 1 - vmax * u * u / (2 * r);
+    v = vmax * u / r;
+  }
+  float z = Jib_Path_z0 + (Jib_Path_z1 - Jib_Path_z0) * p;
+  float z_rate = (Jib_Path_z1 - Jib_Path_z0) * v / (Jib_Path_ms / 1000.0);
+  float angle = JibAsin(z / Jib_Arm_mm);
+  float c = max(JibCos(angle), 0.05f);                         //Arm never gets near vertical, keep the rate finite
+  float angle_rate = z_rate / (Jib_Arm_mm * c) * RAD_TO_DEG;
+
+  float error = Jib_Level_Steps + angle * Jib_Steps_Degree - stepper1->getCurrentPosition();
+  if (fabs(error) > Jib_Path_errMax) {
+    Jib_Path_errMax = fabs(error);
+  }
+  int32_t mhz = (angle_rate * Jib_Steps_Degree + JIB_PATH_KP * error) * 1000;
+  if (abs(mhz) < 1000) {                                       //Below 1Hz the step would come late anyway
+    if (Jib_Path_applied != 0) {
+      stepper1->stopMove();
+      Jib_Path_applied = 0;
+    }
+  } else {
+    bool start = Jib_Path_applied == 0 || (mhz > 0) != (Jib_Path_applied > 0);
+    stepper1->setSpeedInMilliHz(abs(mhz));
+    if (start) {
+      if (mhz > 0) {
+        stepper1->runForward();
+      } else {
+        stepper1->runBackward();
+      }
+    } else {
+      stepper1->applySpeedAcceleration();
+    }
+    Jib_Path_applied = mhz;
+  }
+  Jib_Path_ticks++;
+}
+
+void jibPathTask(void * pvParameters) {
+  TickType_t last_wake = xTaskGetTickCount();
+  for (;;) {
+    vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(JIB_PATH_MS));
+    if (Jib_Path_active) {
+      JibPathTick();
+    }
+  }
+}
+
+//******Head tilt stream for the target lock on a DB3 head, runs in the encoder task***********
+void StreamTilt() {
+  bool moving = stepper1 != NULL && stepper1->isRunning();
+  if (!Pos_heads.due(moving) || stepper1 == NULL || !JibConfigured()) {
+    return;
+  }
+
+  float rate = moving ? stepper1->getCurrentSpeedInMilliHz() / 1000.0 / Jib_Steps_Degree : 0;
+  jib_sample sample;
+  memcpy(sample.tag, "JPOS", 4);
+  sample.sequence = Pos_heads.nextSequence();
+  sample.tilt_deg = JibHeadTilt(JibAngle(stepper1->getCurrentPosition()), rate, sample.tilt_deg_s);
+  Pos_heads.send(&sample, sizeof(sample));
+}
+
 //**********************************Homing at Start**********************************
 
 void homeStepper() {
@@ -957,6 +1205,30 @@ void OUTpointSet() {
 void PTZ_MoveP() {
   lastPTZ_Pose = PTZ_Pose;
   delay(10);
+  if (lastPTZ_Pose == JIB_LEVEL_POSE) {
+    Jib_Level_Steps = stepper1->getCurrentPosition();
+    Jib_Level_Set = true;
+    SysMemory.begin("JibPath", false);
+    SysMemory.putLong("level", Jib_Level_Steps);
+    SysMemory.end();
+    Serial.printf("\nArm level at %ld steps\n", Jib_Level_Steps);
+    PTZ_Pose = 0;
+    return;
+  }
+  if (lastPTZ_Pose == JIB_IK_POSE && !JibConfigured()) {
+    Serial.printf("\nStraight camera path needs Jib_Arm_mm, Jib_Steps_Degree and the level position set first\n");
+    PTZ_Pose = 0;
+    return;
+  }
+  if (lastPTZ_Pose == JIB_IK_POSE || lastPTZ_Pose == JIB_ARC_POSE) {   //A DB3 head on the arm takes 107 as follow the jib
+    Jib_IK = (lastPTZ_Pose == JIB_IK_POSE) ? 1 : 0;
+    SysMemory.begin("JibPath", false);
+    SysMemory.putUInt("IK", Jib_IK);
+    SysMemory.end();
+    Serial.printf("\nA-B moves run %s\n", Jib_IK ? "as a straight camera path" : "on the arm's arc");
+    PTZ_Pose = 0;
+    return;
+  }
 
   switch (lastPTZ_Pose) {
     case 1:
@@ -1432,6 +1704,11 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData,  int L
   char buffer[ESP_NOW_MAX_DATA_LEN + 1];
   // int msgLen = min(ESP_NOW_MAX_DATA_LEN, dataLen);
 
+  if (Len == 4 && memcmp(incomingData, "SSUB", 4) == 0) {   //Tilt stream request from a head, not a struct_message
+    Pos_heads.subscribe(macAddr);
+    return;
+  }
+
   memcpy(&incomingValues, incomingData, sizeof(incomingValues));
   //memcpy(&incomingValues, Data, sizeof(incomingValues));
 
@@ -1692,8 +1969,10 @@ Pause = BD;
   stepper1->setSpeedInHz(step_speed);
   stepper1->setAcceleration(Ease_Value);
   delay(2);                                               //Timed to start with PanTilt head
-  stepper1->moveTo(out_position);
-  while (stepper1->isRunning()) {                         //delay until move complete (block)
+  if (Jib_IK != 1 || !JibPathStart(out_position, Crono_time * 1000UL)) {
+    stepper1->moveTo(out_position);
+  }
+  while (stepper1->isRunning() || Jib_Path_active) {      //delay until move complete (block)
     if (digitalRead(home_switch) == LOW) {
       stepper1->forceStopAndNewPosition(5);                  //Stops dead error if the home switch is triggered unexpectadly
       ESP.restart();
@@ -1718,8 +1997,10 @@ Pause = BD;
       PT = 1;
     }
 
-    stepper1->moveTo(in_position);
-    while (stepper1->isRunning()) {                         //delay until move complete (block)
+    if (Jib_IK != 1 || !JibPathStart(in_position, Crono_time * 1000UL)) {
+      stepper1->moveTo(in_position);
+    }
+    while (stepper1->isRunning() || Jib_Path_active) {      //delay until move complete (block)
 
       if (digitalRead(home_switch) == LOW) {
         stepper1->forceStopAndNewPosition(5);                  //Stops dead error if the home switch is triggered unexpectadly
@@ -38,6 +38,8 @@ This was the same problem for Ease values on last update. Only the ESP32 in your
 
 #include <esp_now.h>
 #include <EasyNextionLibrary.h>
+#include "NextionQueue.h"
+#include "JoystickSampler.h"
 #include <trigger.h>
 #include <WiFi.h>
 
@@ -64,6 +66,8 @@ int DollyPath;              //0=straight 1=Curved
 int Dolly360;               //0= a-b on curve 1= full 360 move
 
 int ThreeDscanSetup;        //0= Dolly & Slider     1= Dolly and Jib    3= Slider and Turntable
+int ScanRows = 1;           //3D scan rows, one per slider position
+int ScanShots = 24;         //3D scan shots per turntable revolution
 
 int PanS;                   //Pan joystick speed multiplier
 int TiltS;                  //Tilt joystick speed multiplier
@@ -351,6 +355,8 @@ typedef struct struct_message {
   int UDP;
   int TLY;
   int BD;
+  int ScR;                                                //3D scan rows from the controller, row to be on from the turntable
+  int ScS;                                                //3D scan shots per row from the controller, shot taken from the turntable
   //int mess;
 } struct_message;
 
@@ -361,18 +367,18 @@ int WIFIOUT[8];                   //set up 5 element array for sendinf values to
 #define RXD2 16                   //Hardware Serial2 on ESP32 Dev (must also be a common earth between nextion and esp32)
 #define TXD2 17
 EasyNex myNex(Serial2);           // Create an object of EasyNex class with the name < myNex >
+NextionQueue nexQueue(myNex, Serial2);  // All display writes go through here, drained from loop()
 #define Nextion_Dim_Time 400
 hw_timer_t * timer = NULL;
+volatile bool Nextion_Dim_Request = false;
 
 
 void IRAM_ATTR Nextion_Dim() {
-  String dims = "dims=" + String(5);  // set display brightness to 100%
-  myNex.writeStr(dims.c_str());
-
+  Nextion_Dim_Request = true;             // Dimmed from loop(), the UART is not ours in an interrupt
 }
 void Nextion_Wake() {
   String dims = "dims=" + String(100);  // set display brightness to 100%
-  myNex.writeStr(dims.c_str());
+  nexQueue.writeStr(dims.c_str());
 }
 
 //Joystick control
@@ -382,6 +388,19 @@ const int slidS_PIN = 35;                   // Slider joy
 const int focusS_PIN = 39;                  // Focus joy
 const int zoomS_PIN = 36;                   // Zoom joy
 const int masterA_PIN = 33;                 // Master pot
+const JoyChannelConfig JoyChannels[JOY_CHANNELS] = {
+  // ADC1 channel,  pin,         centred, threshold
+  { ADC1_CHANNEL_4, tiltS_PIN,   true,    300 },   // Tilt GPIO32
+  { ADC1_CHANNEL_6, panS_PIN,    true,    300 },   // Pan GPIO34
+  { ADC1_CHANNEL_3, focusS_PIN,  true,    400 },   // Focus GPIO39
+  { ADC1_CHANNEL_0, zoomS_PIN,   true,    300 },   // Zoom GPIO36
+  { ADC1_CHANNEL_7, slidS_PIN,   true,    300 },   // Slider GPIO35
+  { ADC1_CHANNEL_5, masterA_PIN, false,   0 },     // Master pot GPIO33
+};
+JoystickSampler joystick(JoyChannels);        // Sticks are sampled by DMA in the background
+uint32_t Joy_Frame;                         // Last sample frame ReadAnalog handled
+unsigned long Joy_Sent_ms;
+#define JOY_SEND_MS 400                     // Resend a held stick at most this often
 const int NexBat = 4;                       //Battery monitoring pin
 //PTZ Play button
 #define CAM 2                               // Record button
@@ -412,12 +431,11 @@ void setup() {
 
   //**********************Prepair Nextion***********************************//
   String dims = "dims=" + String(100);  // set display brightness to 100%
-  myNex.writeStr(dims.c_str());
+  nexQueue.writeStr(dims.c_str());
 
 
-  myNex.writeStr("t9.txt", String(DBFirmwareVersion));
-  delay(100);
-  myNex.writeStr("t2.txt", "10");                                 //set seconds deay at 2
+  nexQueue.writeStr("t9.txt", String(DBFirmwareVersion));
+  nexQueue.writeStr("t2.txt", "10");                              //set seconds deay at 2
 
   //********************Setup Radio**********************************//
   WiFi.mode(WIFI_STA);
@@ -449,15 +467,13 @@ void setup() {
 
   pinMode(CAM, INPUT_PULLUP);                           //Camera switch pulled high
   pinMode(LED, OUTPUT);
+  joystick.begin();
   InitialValues();                                              //onboard Joystick calobration
 
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
-
-
-  pinMode(masterA_PIN, INPUT);
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
 
 
-  String NexMenu = myNex.readStr("menu.txt");
+  String NexMenu = nexQueue.readStr("menu.txt");
   Serial.printf("\nNextion Menu is currently %d \n", NexMenu.toInt());
 
   Load_SysMemory();
@@ -487,10 +503,10 @@ void loop() {
     long unsigned int currTime = millis();
     if (currTime - prevTime > 50) {
       if (usejoy) {                               //If usejoy is on
-        myNex.writeNum("b0.pic", 43);             //Turn it off
+        nexQueue.writeNum("b0.pic", 43);          //Turn it off
         usejoy = 0;
       } else {                                    //else turn it on
-        myNex.writeNum("b0.pic", 44);
+        nexQueue.writeNum("b0.pic", 44);
         usejoy = 1;
       }
 
@@ -505,15 +521,22 @@ void loop() {
   //*************************************Listen for Nextion LCD comands*******************************************
   myNex.NextionListen();   // nextion_message.NextionListen(); //check for message from Nextion touchscreen
 
+  if (Nextion_Dim_Request) {
+    Nextion_Dim_Request = false;
+    String dims = "dims=" + String(5);  // set display brightness to 5%
+    nexQueue.writeStr(dims.c_str());
+  }
+
 
   //*********************StopMotion Canceled***********************************
   if (SC == 1) {
-    myNex.writeStr("SMC_counter.txt", "CANCEL");        //Move canceled
-    delay(1000);
-    myNex.writeStr("SMC_counter.txt", String(Tps));        //Send counter back to start
-    delay(20);
+    nexQueue.writeStr("SMC_counter.txt", "CANCEL");     //Move canceled
+    nexQueue.writeStr("SMC_counter.txt", String(Tps), 1000);  //Send counter back to start after a second
     SMC = Tps;
     SC = 0;
+    if (ThreeDscanSetup == 3) {                            //Scan canceled, stop asking for one
+      ThreeDscanSetup = 0;
+    }
     SendNextionValues();
     delay(20);
   }
@@ -523,19 +546,12 @@ void loop() {
   //Serial.printf("IPR is set to %d\n", IPR);
   if (IPR == 2) {           //Process the IP data from the device and pass it on to the Nextion
     Serial.print(IPR);
-    delay(500);
-    myNex.writeStr("IP1.txt", String(IP1));
-    delay(20);
-    myNex.writeStr("IP2.txt", String(IP2));
-    delay(20);
-    myNex.writeStr("IP3.txt", String(IP3));
-    delay(20);
-    myNex.writeStr("IP4.txt", String(IP4));
-    delay(20);
-    myNex.writeStr("IPGW.txt", String(IPGW));
-    delay(20);
-    myNex.writeStr("UDP.txt", String(UDP));
-    delay(20);
+    nexQueue.writeStr("IP1.txt", String(IP1));
+    nexQueue.writeStr("IP2.txt", String(IP2));
+    nexQueue.writeStr("IP3.txt", String(IP3));
+    nexQueue.writeStr("IP4.txt", String(IP4));
+    nexQueue.writeStr("IPGW.txt", String(IPGW));
+    nexQueue.writeStr("UDP.txt", String(UDP));
     IPR = 0;
   } else {
     //Serial.println(IPR);
@@ -564,42 +580,36 @@ void loop() {
         break;
       case 4:
         //delay(5);
-        myNex.writeNum("rewind.val", 0);                 //zero the nextion timer
-        delay(20);
-        myNex.writeNum("TimerStop.val", 1);              // timer Start
+        nexQueue.writeNum("rewind.val", 0);              //zero the nextion timer
+        nexQueue.writeNum("TimerStop.val", 1);           // timer Start
         But_Com = 0;
         break;
       case 5:
         // Serial.printf("\nBut_Com  %d \n", But_Com);
 
-        myNex.writeNum("TimerStop.val", 0);                  //Stop nextion timer
-        delay(100);
+        nexQueue.writeNum("TimerStop.val", 0);               //Stop nextion timer
         digitalWrite(LED, LOW);                              //Turn off the button LED
-        myNex.writeNum("Play.pic", 8);                     //Turn play yellow
-        delay(50);
-        myNex.writeNum("b5.pic", 8);                     //Turn play yellow
+        nexQueue.writeNum("Play.pic", 8);                  //Turn play yellow
+        nexQueue.writeNum("b5.pic", 8);                  //Turn play yellow
+        if (ThreeDscanSetup == 3) {                      //3D scan finished, the next play is a normal move
+          ThreeDscanSetup = 0;
+        }
         But_Com = 0;
-        delay(1000);
 
 
 
       case 6:
-        delay(5);
-        myNex.writeStr("bounce.txt", String(Bounce));        //update Bounce counter main
-        delay(5);
-        myNex.writeStr("Bounce.txt", String(Bounce));        //update Bounce counter SEQ
+        nexQueue.writeStr("bounce.txt", String(Bounce));     //update Bounce counter main
+        nexQueue.writeStr("Bounce.txt", String(Bounce));     //update Bounce counter SEQ
         But_Com = 0;
         break;
       case 7:
-        delay(5);
-        myNex.writeStr("tlps.txt", String(Tps));            //update timlapse counter
-        delay(5);
+        nexQueue.writeStr("tlps.txt", String(Tps));         //update timlapse counter
         if (Tps == 0) {
           crono_seconds = 10;
           Crono_time = 10;
           SendNextionValues();
-          delay(5);
-          myNex.writeStr("sec.txt", String(crono_seconds));
+          nexQueue.writeStr("sec.txt", String(crono_seconds));
           But_Com = 0;
         }
         But_Com = 0;
@@ -607,18 +617,14 @@ void loop() {
       case 8:                                                           //Stop Motion counter update
         delay(30);
         if (SMC != 0) {
-          myNex.writeStr("SMC_counter.txt", String(SMC));              //Update Nextion frame counter
-          delay(50);
+          nexQueue.writeStr("SMC_counter.txt", String(SMC));           //Update Nextion frame counter
           digitalWrite(LED, LOW);                                     //Turn OFF the button LED
-          myNex.writeNum("Play.pic", 8);                              //Turn play yellow
-          delay(50);
+          nexQueue.writeNum("Play.pic", 8);                           //Turn play yellow
         } else {
           digitalWrite(LED, LOW);                                     //Turn OFF the button LED
-          myNex.writeStr("SMC_counter.txt", "Complete");        //Update Nextion frame counter
-          delay(10);
-          myNex.writeStr("SMC_counter.txt", String(Tps));        //Send counter back to start
+          nexQueue.writeStr("SMC_counter.txt", "Complete");     //Update Nextion frame counter
+          nexQueue.writeStr("SMC_counter.txt", String(Tps));     //Send counter back to start
 
-          delay(20);
 
         }
         But_Com = 0;
@@ -626,6 +632,7 @@ void loop() {
     }
   }
 
+  nexQueue.run();                                     //Send whatever the display updates above left queued
 
 } //end loop
 
@@ -635,48 +642,48 @@ void loop() {
 //***************************Nextion Button Press Functions*****************************//
 
 void trigger1() {                              //Nextion m0 Hours
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 0;
   SendNextionValues();
   UpdateSEQ();
 }
 void trigger2() {                             //Nextion m1 Min
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 1;
   SendNextionValues();
 }
 
 void trigger3() {                             // Nextion m2 Sec
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 2;
   SendNextionValues();
 }
 
 void trigger4() {                             //Nextion m3 Ease
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 3;
   SendNextionValues();
 }
 
 void trigger5() {                             //Nextion m4 Bounce
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 4;
   SendNextionValues();
 }
 
 void trigger6() {                            //Nextion m5 Tps
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Func = 5;
   SendNextionValues();
 }
 
 void trigger7() {                            //Nextion m6 InPoint
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 6;
   ++InP;
@@ -693,7 +700,7 @@ void trigger7() {                            //Nextion m6 InPoint
 
 void trigger8() {                            // Nextion m7 OutPoint
 
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 7;
   ++OutP;
@@ -709,45 +716,45 @@ void trigger8() {                            // Nextion m7 OutPoint
 }
 
 void trigger9() {                                                                // Nextion m7 Play
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   if (stopMactive == 1) {
     stopMactive = 0;
-    myNex.writeStr("tlps.txt", "0");
+    nexQueue.writeStr("tlps.txt", "0");
     Tps = 0;
   }
   Nextion_Wake();
   Nextion_play = 1;
   SendNextionValues();
   digitalWrite(LED, HIGH);                                                       //Turn on LED
-  myNex.writeNum("Play.pic", 7);                                                 //Turn play red
+  nexQueue.writeNum("Play.pic", 7);                                              //Turn play red
   delay(200);
   Nextion_play = 0;                                                              //Reset the button
 }
 
 
 void trigger10() {                                                               // Nextion Up arrow 0A hex
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   switch (Nextion_Func) {
 
     case 0:                                                                      // + time Hours on nextion
       if (crono_hours >= 0 && crono_hours <= 23) {                               //limit hours that can be set between 0 & 24
         crono_hours = crono_hours + 1;                                           // increase by 1
-        myNex.writeStr("hours.txt", String(crono_hours));
+        nexQueue.writeStr("hours.txt", String(crono_hours));
         Crono_time = ((crono_hours * 3600) + (crono_minutes * 60) + crono_seconds);
       }
       break;
     case 1:                                                                      // + time Minuts on nextion
       if (crono_minutes >= 0 && crono_hours <= 59) {                             //limit Minuits that can be set between 0 & 60
         crono_minutes = crono_minutes + 1;                                       // increase by 1
-        myNex.writeStr("min.txt", String(crono_minutes));
+        nexQueue.writeStr("min.txt", String(crono_minutes));
         Crono_time = ((crono_hours * 3600) + (crono_minutes * 60) + crono_seconds);
       }
       break;
     case 2:                                                                      // + time Seconds on nextion
       if (crono_seconds >= 0 && crono_seconds <= 59) {                           //limit seconds that can be set between 0 & 60
         crono_seconds = crono_seconds + 1;                                       // increase by 1
-        myNex.writeStr("sec.txt", String(crono_seconds));
+        nexQueue.writeStr("sec.txt", String(crono_seconds));
         Crono_time = ((crono_hours * 3600) + (crono_minutes * 60) + crono_seconds);
       }
       if (Tps > 0) {
@@ -757,62 +764,72 @@ void trigger10() {
     case 3:                                                                     // + Ease value
       if (Ease_Value >= 0 && Ease_Value <= 2) {                                 //limit Ease that can be set between 0 & 3
         Ease_Value = Ease_Value + 1;                                            // increase  by 1
-        myNex.writeStr("ease.txt", String(Ease_Value));
+        nexQueue.writeStr("ease.txt", String(Ease_Value));
       }
       break;
     case 4:                                                                     //+Bounce Value Func
       if (Bounce <= 10 && Bounce != 500) {
         Bounce = Bounce + 1;                                                    // increase  by 1
-        myNex.writeStr("bounce.txt", String(Bounce));                           // display value in t4 Bounce box on Nextion
-        myNex.writeStr("bounce.txt", String(Bounce));
+        nexQueue.writeStr("bounce.txt", String(Bounce));                        // display value in t4 Bounce box on Nextion
+        nexQueue.writeStr("bounce.txt", String(Bounce));
       } else {
         Bounce = 500;                                                           //If greater than ten assume infinity 500 bring it down again to 10
-        myNex.writeStr("bounce.txt", "Inf");
-        myNex.writeStr("bounce.txt", "Inf");
+        nexQueue.writeStr("bounce.txt", "Inf");
+        nexQueue.writeStr("bounce.txt", "Inf");
       }
       break;
     case 5:                                                                     // + Tps on nextion
       if (Tps >= 0 ) {
         Tps = Tps + 25;                                                         // increase Tps by 25
-        myNex.writeStr("tlps.txt", String(Tps));                                // display seconds in t2 box on Nextion
+        nexQueue.writeStr("tlps.txt", String(Tps));                             // display seconds in t2 box on Nextion
         if (Tps != 0) {
           timelapse_projected = (5 + (Tps * 2.501));
           crono_seconds = 2;
-          myNex.writeStr("sec.txt", "2");   //set seconds deay at 2
-          myNex.writeStr("min.txt", "0");   //set min at 0
-          myNex.writeStr("hours.txt", "0");   //set hours at 0
-          myNex.writeStr("t8.txt", String(timelapse_projected));
+          nexQueue.writeStr("sec.txt", "2");   //set seconds deay at 2
+          nexQueue.writeStr("min.txt", "0");   //set min at 0
+          nexQueue.writeStr("hours.txt", "0");   //set hours at 0
+          nexQueue.writeStr("t8.txt", String(timelapse_projected));
         }
       }
       break;
     case 20:
       MSeqTime++;                                                          //Add a second to SequenceTime
-      myNex.writeStr("SeqTime.txt", String(MSeqTime));                     //Update Nextion
+      nexQueue.writeStr("SeqTime.txt", String(MSeqTime));                  //Update Nextion
       Tps = (MSeqTime * FPS);
-      myNex.writeStr("SMC_counter.txt", String(Tps));
-      delay(20);
+      nexQueue.writeStr("SMC_counter.txt", String(Tps));
       break;
     case 21:
       TpsD = (TpsD + 1000);
-      myNex.writeStr("shutterT.txt", String(TpsD / 1000));                  //Update Nextion
+      nexQueue.writeStr("shutterT.txt", String(TpsD / 1000));               //Update Nextion
       break;
     case 22:
       FPS++;
-      myNex.writeStr("fps.txt", String(FPS));                               //Motion control FPS add
+      nexQueue.writeStr("fps.txt", String(FPS));                            //Motion control FPS add
       Tps = (MSeqTime * FPS);
-      myNex.writeStr("SMC_counter.txt", String(Tps));
-      delay(20);
+      nexQueue.writeStr("SMC_counter.txt", String(Tps));
       break;
     case 23:                                                                // + time Minuts on nextion
       if (PanS >= 0 && PanS <= 5) {                                         //limit Minuits that can be set between 0 & 60
         PanS = PanS + 1;                                                    // increase by 1
-        myNex.writeStr("PanS.txt", String(PanS));
+        nexQueue.writeStr("PanS.txt", String(PanS));
       }
       break;
     case 24:                                                                // + time Minuts on nextion
       if (TiltS >= 0 && TiltS <= 5) {                                       //limit Minuits that can be set between 0 & 60
         TiltS = TiltS + 1;                                                  // increase by 1
-        myNex.writeStr("TiltS.txt", String(TiltS));
+        nexQueue.writeStr("TiltS.txt", String(TiltS));
+      }
+      break;
+    case 32:                                                                // + 3D scan rows
+      if (ScanRows < 20) {
+        ScanRows = ScanRows + 1;
+        nexQueue.writeStr("rows.txt", String(ScanRows));
+      }
+      break;
+    case 33:                                                                // + 3D scan shots per revolution
+      if (ScanShots < 120) {
+        ScanShots = ScanShots + 4;
+        nexQueue.writeStr("shots.txt", String(ScanShots));
       }
       break;
   }
@@ -823,60 +840,60 @@ void trigger10() {
 }
 
 void trigger11() {                                                         // Nextion Down arrow
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   switch (Nextion_Func) {
 
     case 0:                                                                    // + time Hours on nextion
       if (crono_hours >= 1) {                                                   //limit hours that can be set between 0 & 24
         crono_hours = crono_hours - 1;                                          // increase by 1
-        myNex.writeStr("hours.txt", String(crono_hours));
+        nexQueue.writeStr("hours.txt", String(crono_hours));
         Crono_time = ((crono_hours * 3600) + (crono_minutes * 60) + crono_seconds);
       }
       break;
     case 1:                                                                     // - time Minuts on nextion
       if (crono_minutes >= 1) {                                                 //limit Minuits that can be set between 0 & 60
         crono_minutes = crono_minutes - 1;
-        myNex.writeStr("min.txt", String(crono_minutes));
+        nexQueue.writeStr("min.txt", String(crono_minutes));
         Crono_time = ((crono_hours * 3600) + (crono_minutes * 60) + crono_seconds);
       }
       break;
     case 2:                                                                    // + time Seconds on nextion
       if (crono_seconds >= 1) {                                                 //limit seconds that can be set between 0 & 60
         crono_seconds = crono_seconds - 1;
-        myNex.writeStr("sec.txt", String(crono_seconds));
+        nexQueue.writeStr("sec.txt", String(crono_seconds));
         Crono_time = ((crono_hours * 3600) + (crono_minutes * 60) + crono_seconds);
       }
       break;
     case 3:                                                                      // + Ease value
       if (Ease_Value >= 1) {                                                    //limit Ease that can be set between 0 & 3
         Ease_Value = Ease_Value - 1;                                            // increase  by 1
-        myNex.writeStr("ease.txt", String(Ease_Value));
+        nexQueue.writeStr("ease.txt", String(Ease_Value));
       }
       break;
     case 4:                                                                     //-Bounce Value Func
       if (Bounce <= 10 && Bounce != 500 && Bounce != 0) {
         Bounce = Bounce - 1;
-        myNex.writeStr("bounce.txt", String(Bounce));                           // display value in t4 Bounce box on Nextion
-        myNex.writeStr("bounce.txt", String(Bounce));
+        nexQueue.writeStr("bounce.txt", String(Bounce));                        // display value in t4 Bounce box on Nextion
+        nexQueue.writeStr("bounce.txt", String(Bounce));
       } else {
         Bounce = 10;                                                            //If greater than ten assume infinity 500 bring it down again to 10
-        myNex.writeStr("bounce.txt", String(Bounce));
-        myNex.writeStr("bounce.txt", String(Bounce));
+        nexQueue.writeStr("bounce.txt", String(Bounce));
+        nexQueue.writeStr("bounce.txt", String(Bounce));
       }
       break;
     case 5:                                                                    // + Tps on nextion
       if (Tps > 0 ) {
         Tps = Tps - 25;                                                        // increase Tps by 25
-        myNex.writeStr("tlps.txt", String(Tps));                               // display seconds in t2 box on Nextion
+        nexQueue.writeStr("tlps.txt", String(Tps));                            // display seconds in t2 box on Nextion
         if (Tps == 0) {
           timelapse_projected = 0;
           crono_seconds = 10;
           Crono_time = 10;
-          myNex.writeStr("t8.txt", String(timelapse_projected));
-          myNex.writeStr("sec.txt", "10");   //set seconds deay at 2
-          myNex.writeStr("min.txt", "0");   //set min at 0
-          myNex.writeStr("hours.txt", "0");   //set hours at 0
+          nexQueue.writeStr("t8.txt", String(timelapse_projected));
+          nexQueue.writeStr("sec.txt", "10");   //set seconds deay at 2
+          nexQueue.writeStr("min.txt", "0");   //set min at 0
+          nexQueue.writeStr("hours.txt", "0");   //set hours at 0
 
         }
       }
@@ -885,10 +902,9 @@ void trigger11() {                                                         // Ne
     case 20:
       if (MSeqTime >= 1) {
         MSeqTime = (MSeqTime - 1);                                      //Subtract a second from SequenceTime
-        myNex.writeStr("SeqTime.txt", String(MSeqTime));                //Update Nextion
+        nexQueue.writeStr("SeqTime.txt", String(MSeqTime));             //Update Nextion
         Tps = (MSeqTime * FPS);
-        myNex.writeStr("SMC_counter.txt", String(Tps));
-        delay(20);
+        nexQueue.writeStr("SMC_counter.txt", String(Tps));
 
       }
       break;
@@ -901,62 +917,68 @@ void trigger11() {                                                         // Ne
     case 21:
       if (TpsD >= 1000) {
         TpsD = (TpsD - 1000);
-        myNex.writeStr("shutterT.txt", String(TpsD / 1000));         //Update Nextion
+        nexQueue.writeStr("shutterT.txt", String(TpsD / 1000));      //Update Nextion
       }
       break;
     case 22:
       FPS = FPS - 1;
-      myNex.writeStr("fps.txt", String(FPS));                       //Motion control FPS add
+      nexQueue.writeStr("fps.txt", String(FPS));                    //Motion control FPS add
       Tps = (MSeqTime * FPS);
-      myNex.writeStr("SMC_counter.txt", String(Tps));
-      delay(20);
+      nexQueue.writeStr("SMC_counter.txt", String(Tps));
       break;
 
     case 23:                                                                      // + time Minuts on nextion
       if (PanS >= 1) {                             //limit Minuits that can be set between 0 & 60
         PanS = PanS - 1;                                       // increase by 1
-        myNex.writeStr("PanS.txt", String(PanS));
+        nexQueue.writeStr("PanS.txt", String(PanS));
       }
       break;
     case 24:                                                                      // + time Minuts on nextion
       if (TiltS >= 1) {                             //limit Minuits that can be set between 0 & 60
         TiltS = TiltS - 1;                                       // increase by 1
-        myNex.writeStr("TiltS.txt", String(TiltS));
+        nexQueue.writeStr("TiltS.txt", String(TiltS));
+      }
+      break;
+    case 32:                                                                      // - 3D scan rows
+      if (ScanRows > 1) {
+        ScanRows = ScanRows - 1;
+        nexQueue.writeStr("rows.txt", String(ScanRows));
+      }
+      break;
+    case 33:                                                                      // - 3D scan shots per revolution
+      if (ScanShots > 4) {
+        ScanShots = ScanShots - 4;
+        nexQueue.writeStr("shots.txt", String(ScanShots));
       }
       break;
 
     case 25:
       //IP adress 1
       IP1 = IP1 - 1;                                          // Reduce by 1 for down arrow
-      myNex.writeStr("IP1.txt", String(IP1));
-      delay(20);
+      nexQueue.writeStr("IP1.txt", String(IP1));
       break;
     case 26:
       //IP adress 1
       IP2 = IP2 - 1;                                          // Reduce by 1 for down arrow
-      myNex.writeStr("IP2.txt", String(IP2));
-      delay(20);
+      nexQueue.writeStr("IP2.txt", String(IP2));
       break;
     case 27:
       //IP adress 1
       IP3 = IP3 - 1;                                          // Reduce by 1 for down arrow
-      myNex.writeStr("IP3.txt", String(IP3));
-      delay(20);
+      nexQueue.writeStr("IP3.txt", String(IP3));
       break;
     case 28:
       //IP adress 1
       IP4 = IP4 - 1;                                          // Reduce by 1 for down arrow
-      myNex.writeStr("IP4.txt", String(IP4));
-      delay(20);
+      nexQueue.writeStr("IP4.txt", String(IP4));
       break;
 
 
     case 29:
       if (UDP == 5678) {                                                   //IP adress 1
         UDP = 1259;                                          // Reduce by 1 for down arrow
-        myNex.writeStr("UDP.txt", String(UDP));
+        nexQueue.writeStr("UDP.txt", String(UDP));
       }
-      delay(20);
       break;
   }
   SC = 1;
@@ -967,7 +989,7 @@ void trigger11() {                                                         // Ne
 
 //********************************************sequencer************************************************************
 void trigger12() {                            //Nextion K1 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 12;
   ++P1;
@@ -982,7 +1004,7 @@ void trigger12() {                            //Nextion K1 Set
   }
 }
 void trigger13() {                            //Nextion K2 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 13;
   ++P2;
@@ -997,7 +1019,7 @@ void trigger13() {                            //Nextion K2 Set
   }
 }
 void trigger14() {                            //Nextion K3 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 14;
   ++P3;
@@ -1012,7 +1034,7 @@ void trigger14() {                            //Nextion K3 Set
   }
 }
 void trigger15() {                         //Nextion K4 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 15;
   ++P4;
@@ -1027,7 +1049,7 @@ void trigger15() {                         //Nextion K4 Set
   }
 }
 void trigger16() {                            //Nextion K5 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 16;
   ++P5;
@@ -1042,7 +1064,7 @@ void trigger16() {                            //Nextion K5 Set
   }
 }
 void trigger17() {                            //Nextion K6 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 17;
   ++P6;
@@ -1057,10 +1079,10 @@ void trigger17() {                            //Nextion K6 Set
   }
 }
 void trigger18() {                         //Nextion Clear key
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 18;
-  String k4String = myNex.readStr("k4t.txt");
+  String k4String = nexQueue.readStr("k4t.txt");
   if (k4String.toInt() == 0) {
     s4 = 0;
     s5 = 0;
@@ -1070,7 +1092,7 @@ void trigger18() {                         //Nextion Clear key
     P6 = 0;
     SendNextionValues();
   } else {
-    String k5String = myNex.readStr("k5t.txt");
+    String k5String = nexQueue.readStr("k5t.txt");
     if (k5String.toInt() == 0) {
       s5 = 0;
       s6 = 0;
@@ -1079,7 +1101,7 @@ void trigger18() {                         //Nextion Clear key
       SendNextionValues();
     }
     else {
-      String k6String = myNex.readStr("k5t.txt");
+      String k6String = nexQueue.readStr("k5t.txt");
       if (k6String.toInt() == 0) {
         s6 = 0;
         P6 = 0;
@@ -1089,43 +1111,43 @@ void trigger18() {                         //Nextion Clear key
   }
 }
 void trigger19() {                                                             //Nextion sequencer play
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 19;
   Nextion_play = 2;
   SendNextionValues();
   delay(200);
   digitalWrite(LED, HIGH);                                                   //Turn on LED
-  myNex.writeNum("b5.pic", 7);                                                //Turn play red
+  nexQueue.writeNum("b5.pic", 7);                                             //Turn play red
   Nextion_play = 0;                                                          //Reset the button
 }
 
 void trigger20() {                                                            // Sequencer Up arrow
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
 
   switch (Nextion_Func) {
     case 4:                                                                   //+Bounce Value Func
       if (Bounce <= 10 && Bounce != 500) {
         Bounce = Bounce + 1;                                                  // increase  by 1
-        myNex.writeStr("t4.txt", String(Bounce));                             // display value in t4 Bounce box on Nextion
-        myNex.writeStr("Bounce.txt", String(Bounce));
+        nexQueue.writeStr("t4.txt", String(Bounce));                          // display value in t4 Bounce box on Nextion
+        nexQueue.writeStr("Bounce.txt", String(Bounce));
       } else {
         Bounce = 500;                                                          //If greater than ten assume infinity 500 bring it down again to 10
-        myNex.writeStr("t4.txt", "Inf");
-        myNex.writeStr("Bounce.txt", "Inf");
+        nexQueue.writeStr("t4.txt", "Inf");
+        nexQueue.writeStr("Bounce.txt", "Inf");
       }
       break;
     case 12:                                                                  //K1 Set
       if (SE == 0) {                                                          //If speed selected
         if (s1 <= 95) {
           s1 = s1 + 5;
-          myNex.writeStr("k1t.txt", String(s1));
+          nexQueue.writeStr("k1t.txt", String(s1));
         }
       } else {
         if (a1 <= 2) {
           a1 = a1 + 1;
-          myNex.writeStr("a1.txt", String(a1));
+          nexQueue.writeStr("a1.txt", String(a1));
         }
       }
 
@@ -1134,12 +1156,12 @@ void trigger20() {                                                            //
       if (SE == 0) {                                                          //If speed selected
         if (s2 <= 95) {
           s2 = s2 + 5;
-          myNex.writeStr("k2t.txt", String(s2));
+          nexQueue.writeStr("k2t.txt", String(s2));
         }
       } else {
         if (a2 <= 2) {
           a2 = a2 + 1;
-          myNex.writeStr("a2.txt", String(a2));
+          nexQueue.writeStr("a2.txt", String(a2));
         }
       }
 
@@ -1148,12 +1170,12 @@ void trigger20() {                                                            //
       if (SE == 0) {                                                          //If speed selected
         if (s3 <= 95) {
           s3 = s3 + 5;
-          myNex.writeStr("k3t.txt", String(s3));
+          nexQueue.writeStr("k3t.txt", String(s3));
         }
       } else {
         if (a3 <= 2) {
           a3 = a3 + 1;
-          myNex.writeStr("a3.txt", String(a3));
+          nexQueue.writeStr("a3.txt", String(a3));
         }
       }
 
@@ -1162,12 +1184,12 @@ void trigger20() {                                                            //
       if (SE == 0) {                                                          //If speed selected
         if (s4 <= 95) {
           s4 = s4 + 5;
-          myNex.writeStr("k4t.txt", String(s4));
+          nexQueue.writeStr("k4t.txt", String(s4));
         }
       } else {
         if (a4 <= 2) {
           a4 = a4 + 1;
-          myNex.writeStr("a4.txt", String(a4));
+          nexQueue.writeStr("a4.txt", String(a4));
         }
       }
 
@@ -1176,13 +1198,13 @@ void trigger20() {                                                            //
       if (SE == 0) {                                                          //If speed selected
         if (s5 <= 95) {
           s5 = s5 + 5;
-          myNex.writeStr("k5t.txt", String(s5));
+          nexQueue.writeStr("k5t.txt", String(s5));
           break;
         }
       } else {
         if (a5 <= 2) {
           a5 = a5 + 1;
-          myNex.writeStr("a5.txt", String(a5));
+          nexQueue.writeStr("a5.txt", String(a5));
           break;
         }
       }
@@ -1191,12 +1213,12 @@ void trigger20() {                                                            //
       if (SE == 0) {                                                          //If speed selected
         if (s6 <= 95) {
           s6 = s6 + 5;
-          myNex.writeStr("k6t.txt", String(s6));
+          nexQueue.writeStr("k6t.txt", String(s6));
         }
       } else {
         if (a6 <= 2) {
           a6 = a6 + 1;
-          myNex.writeStr("a6.txt", String(a6));
+          nexQueue.writeStr("a6.txt", String(a6));
         }
       }
 
@@ -1208,19 +1230,19 @@ void trigger20() {                                                            //
   SendNextionValues();
 }
 void trigger21() {                                                            // Sequencer Down arrow
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   switch (Nextion_Func) {
 
     case 4:
       if (Bounce <= 10 && Bounce != 500 && Bounce != 0) {
         Bounce = Bounce - 1;                                                  // increase  by 1
-        myNex.writeStr("t4.txt", String(Bounce));                             // display value in t4 Bounce box on Nextion
-        myNex.writeStr("Bounce.txt", String(Bounce));
+        nexQueue.writeStr("t4.txt", String(Bounce));                          // display value in t4 Bounce box on Nextion
+        nexQueue.writeStr("Bounce.txt", String(Bounce));
       } else {
         Bounce = 10;                                                          //If greater than ten assume infinity 500 bring it down again to 10
-        myNex.writeStr("t4.txt", String(Bounce));
-        myNex.writeStr("Bounce.txt", String(Bounce));
+        nexQueue.writeStr("t4.txt", String(Bounce));
+        nexQueue.writeStr("Bounce.txt", String(Bounce));
       }
       break;
 
@@ -1228,12 +1250,12 @@ void trigger21() {                                                            //
       if (SE == 0) {                                                          //If speed selected
         if (s1 >= 5) {
           s1 = s1 - 5;
-          myNex.writeStr("k1t.txt", String(s1));
+          nexQueue.writeStr("k1t.txt", String(s1));
         }
       } else {
         if (a1 > 0) {
           a1 = a1 - 1;
-          myNex.writeStr("a1.txt", String(a1));
+          nexQueue.writeStr("a1.txt", String(a1));
         }
       }
 
@@ -1242,12 +1264,12 @@ void trigger21() {                                                            //
       if (SE == 0) {                                                          //If speed selected
         if (s2 >= 5) {
           s2 = s2 - 5;
-          myNex.writeStr("k2t.txt", String(s2));
+          nexQueue.writeStr("k2t.txt", String(s2));
         }
       } else {
         if (a2 > 0) {
           a2 = a2 - 1;
-          myNex.writeStr("a2.txt", String(a2));
+          nexQueue.writeStr("a2.txt", String(a2));
         }
       }
 
@@ -1256,12 +1278,12 @@ void trigger21() {                                                            //
       if (SE == 0) {                                                          //If speed selected
         if (s3 >= 5) {
           s3 = s3 - 5;
-          myNex.writeStr("k3t.txt", String(s3));
+          nexQueue.writeStr("k3t.txt", String(s3));
         }
       } else {
         if (a3 > 0) {
           a3 = a3 - 1;
-          myNex.writeStr("a3.txt", String(a3));
+          nexQueue.writeStr("a3.txt", String(a3));
         }
       }
 
@@ -1270,12 +1292,12 @@ void trigger21() {                                                            //
       if (SE == 0) {                                                          //If speed selected
         if (s4 >= 5) {
           s4 = s4 - 5;
-          myNex.writeStr("k4t.txt", String(s4));
+          nexQueue.writeStr("k4t.txt", String(s4));
         }
       } else {
         if (a4 > 0) {
           a4 = a4 - 1;
-          myNex.writeStr("a4.txt", String(a4));
+          nexQueue.writeStr("a4.txt", String(a4));
         }
       }
 
@@ -1284,12 +1306,12 @@ void trigger21() {                                                            //
       if (SE == 0) {                                                          //If speed selected
         if (s5 >= 5) {
           s5 = s5 - 5;
-          myNex.writeStr("k5t.txt", String(s5));
+          nexQueue.writeStr("k5t.txt", String(s5));
         }
       } else {
         if (a5 > 0) {
           a5 = a5 - 1;
-          myNex.writeStr("a5.txt", String(a5));
+          nexQueue.writeStr("a5.txt", String(a5));
         }
       }
 
@@ -1298,12 +1320,12 @@ void trigger21() {                                                            //
       if (SE == 0) {                                                          //If speed selected
         if (s6 >= 5) {
           s6 = s6 - 5;
-          myNex.writeStr("k6t.txt", String(s6));
+          nexQueue.writeStr("k6t.txt", String(s6));
         }
       } else {
         if (a6 > 0) {
           a6 = a6 - 1;
-          myNex.writeStr("a6.txt", String(a6));
+          nexQueue.writeStr("a6.txt", String(a6));
         }
       }
 
@@ -1321,21 +1343,20 @@ void trigger22() {                                                            //
 }
 
 void trigger23() {                                                            // Sequencer add key
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
-  delay(20);
-  String k4String = myNex.readStr("k4t.txt");
+  String k4String = nexQueue.readStr("k4t.txt");
   s4 = k4String.toInt();
-  String k5String = myNex.readStr("k5t.txt");
+  String k5String = nexQueue.readStr("k5t.txt");
   s5 = k5String.toInt();
-  String k6String = myNex.readStr("k6t.txt");
+  String k6String = nexQueue.readStr("k6t.txt");
   s6 = k6String.toInt();
   SendNextionValues();
 }
 
 //***********************PTZ CAMERA SETUPS*******************************************************************//
 void trigger24() {                            //PTZ cam1
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Cam = 1;
 
@@ -1351,7 +1372,7 @@ void trigger24() {                            //PTZ cam1
 }
 
 void trigger25() {                            //PTZ cam2
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Cam = 2;
 
@@ -1366,7 +1387,7 @@ void trigger25() {                            //PTZ cam2
 
 }
 void trigger26() {                            //PTZ cam3
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Cam = 3;
   if ( Cam3_RecordBut == 1) {
@@ -1383,7 +1404,7 @@ void trigger26() {                            //PTZ cam3
 
 
 void trigger75() {                            //PTZ cam4 Hex 4B
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Cam = 4;
 
@@ -1398,7 +1419,7 @@ void trigger75() {                            //PTZ cam4 Hex 4B
 }
 
 void trigger27() {                                                  //PTZ Pos1 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Pose = 1;
   Serial.printf("\nPTZ_Pose set to  %d \n", PTZ_Pose);
@@ -1409,7 +1430,7 @@ void trigger27() {                                                  //PTZ Pos1 S
 }
 
 void trigger28() {                                                  //PTZ Pos2 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Pose = 2;
   Serial.printf("\nPTZ_Pose set to  %d \n", PTZ_Pose);
@@ -1420,7 +1441,7 @@ void trigger28() {                                                  //PTZ Pos2 S
 }
 
 void trigger29() {                                                  //PTZ Pos3 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Pose = 3;
   Serial.printf("\nPTZ_Pose set to  %d \n", PTZ_Pose);
@@ -1431,7 +1452,7 @@ void trigger29() {                                                  //PTZ Pos3 S
 }
 
 void trigger30() {                                                  //PTZ Pos4 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Pose = 4;
   Serial.printf("\nPTZ_Pose set to  %d \n", PTZ_Pose);
@@ -1442,7 +1463,7 @@ void trigger30() {                                                  //PTZ Pos4 S
 }
 
 void trigger31() {                                                  //PTZ Pos5 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Pose = 5;
   Serial.printf("\nPTZ_Pose set to  %d \n", PTZ_Pose);
@@ -1453,7 +1474,7 @@ void trigger31() {                                                  //PTZ Pos5 S
 }
 
 void trigger32() {                                                  //PTZ Pos6 Set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Pose = 6;
   Serial.printf("\nPTZ_Pose set to  %d \n", PTZ_Pose);
@@ -1464,7 +1485,7 @@ void trigger32() {                                                  //PTZ Pos6 S
 }
 
 void trigger76() {                                                  //PTZ Pos7 Set Hex4C
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Pose = 7;
   Serial.printf("\nPTZ_Pose set to  %d \n", PTZ_Pose);
@@ -1475,7 +1496,7 @@ void trigger76() {                                                  //PTZ Pos7 S
 }
 
 void trigger77() {                                                  //PTZ Pos8 Set Hex4D
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Pose = 8;
   Serial.printf("\nPTZ_Pose set to  %d \n", PTZ_Pose);
@@ -1486,7 +1507,7 @@ void trigger77() {                                                  //PTZ Pos8 S
 }
 
 void trigger78() {                                                  //PTZ Pos9 Set Hex4E
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Pose = 9;
   Serial.printf("\nPTZ_Pose set to  %d \n", PTZ_Pose);
@@ -1497,7 +1518,7 @@ void trigger78() {                                                  //PTZ Pos9 S
 }
 //*******************************************************SET HARDWARE CAMERA ID*************************//
 void trigger33() {                                                  //PTZ cam1 ID set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_ID = 1;
   SendNextionValues();
@@ -1506,7 +1527,7 @@ void trigger33() {                                                  //PTZ cam1 I
 }
 
 void trigger34() {                                                  //PTZ cam2 ID set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_ID = 2;
   SendNextionValues();
@@ -1514,14 +1535,14 @@ void trigger34() {                                                  //PTZ cam2 I
 }
 
 void trigger35() {                                                  //PTZ cam3 ID set
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_ID = 3;
   SendNextionValues();
   PTZ_ID = 0;
 }
 void trigger79() {                                                  //PTZ cam4 ID set hex 4F
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_ID = 4;
   SendNextionValues();
@@ -1529,7 +1550,7 @@ void trigger79() {                                                  //PTZ cam4 I
 }
 
 void trigger36() {                                                  //PTZ Active true
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Active = 1;
   PTZ_Cam = 1;
@@ -1537,7 +1558,7 @@ void trigger36() {                                                  //PTZ Active
 }
 
 void trigger37() {                                                  //Home button
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Active = 0;
   PTZ_Cam = 0;
@@ -1548,7 +1569,7 @@ void trigger37() {                                                  //Home butto
 }
 
 void trigger38() {                                                  //PTZ Save Pose
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_SaveP = 1;
   SendNextionValues();
@@ -1565,26 +1586,26 @@ void trigger39() {                                                  //Stop motio
 }
 
 void trigger40() {                                                  //Stop motion cancel command
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   SC = 1;
   SendNextionValues();
 
 }
 void trigger41() {                                                  //Nextion Stop Motion SeqTime
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Func = 20;
 
 }
 
 void trigger42() {                                                  // Stop Motion Shutter open time
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 21;
 }
 
 void trigger43() {                                                  // Stop Motion FPS 2B
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 22;
 
@@ -1628,7 +1649,7 @@ void trigger48() {                                                   //Finished
 }
 
 void trigger49() {                                                   //Camera 0 set ID hex 31
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_ID = 5;
   SendNextionValues();
@@ -1666,12 +1687,12 @@ void trigger55() {                                                   //New trigg
 
 void trigger56() {                                                   //Number of Vertical slider moves  Hex38
   Serial.println("\nTrigger56 active\n");
-  Nextion_Func = 23;
+  Nextion_Func = 32;                                                 //23 and 24 are the joystick speed multipliers
 }
 
 void trigger57() {                                                   //Number of scan shots per revolution Hex39
   Serial.println("\nTrigger57 active\n");
-  Nextion_Func = 24;
+  Nextion_Func = 33;
 }
 
 void trigger58() {                                                   //New trigger Hex3A
@@ -1684,37 +1705,37 @@ void trigger59() {                                                   //New trigg
 
 void trigger60() {                                                   //IP1 trigger Hex3C
   Serial.println("\nIP1 set\n");
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 25;
 }
 void trigger61() {                                                   //IP2 trigger Hex3D
   Serial.println("\nIP2 set\n");
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 26;
 }
 void trigger62() {                                                   //IP3 trigger Hex3E
   Serial.println("\nIP3 set\n");
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 27;
 }
 void trigger63() {                                                   //IP4 trigger Hex3F
   Serial.println("\nIP4 set \n");
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 28;
 }
 void trigger64() {                                                   //UDP trigger Hex40
   Serial.println("\nUDP set\n");
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 29;
 }
 void trigger65() {                                                   //Set IP address trigger Hex41
   Serial.println("\nSet New IP Values\n");
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   IPR = 3;
   SendNextionValues();
@@ -1722,7 +1743,7 @@ void trigger65() {                                                   //Set IP ad
 }
 void trigger66() {                                                   //Send  requesting for current IPvalues IP address trigger Hex42
   Serial.println("\nGet current device IP Values\n");
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   IPR = 1;
   SendNextionValues();
@@ -1732,51 +1753,44 @@ void trigger66() {                                                   //Send  req
 }
 void trigger67() {                                                   //IP UP arror address trigger Hex43
   Serial.println("\nGet current device IP Values\n");
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   switch (Nextion_Func) {
 
     case 25:
       IP1 = IP1 + 1;                                           // Up arrow +1
-      myNex.writeStr("IP1.txt", String(IP1));
-      delay(20);
+      nexQueue.writeStr("IP1.txt", String(IP1));
       break;
     case 26:
       //IP adress 1
       IP2 = IP2 + 1;                                          // Up arrow +1
-      myNex.writeStr("IP2.txt", String(IP2));
-      delay(20);
+      nexQueue.writeStr("IP2.txt", String(IP2));
       break;
     case 27:
       IP3 = IP3 + 1;                                          // Up arrow +1
-      myNex.writeStr("IP3.txt", String(IP3));
-      delay(20);
+      nexQueue.writeStr("IP3.txt", String(IP3));
       break;
     case 28:
       //IP adress 1
       IP4 = IP4 + 1;                                          // Up arrow +1
-      myNex.writeStr("IP4.txt", String(IP4));
-      delay(20);
+      nexQueue.writeStr("IP4.txt", String(IP4));
       break;
     case 29:
       if (UDP == 1259) {
         UDP = 5678;                                          // Up arrow +1
-        myNex.writeStr("UDP.txt", String(UDP));
+        nexQueue.writeStr("UDP.txt", String(UDP));
       }
-      delay(20);
       break;
     case 30:
       //IP adress 1
       IPGW = IPGW + 1;                                          // Up arrow +1
-      myNex.writeStr("IPGW.txt", String(IPGW));
-      delay(20);
+      nexQueue.writeStr("IPGW.txt", String(IPGW));
       break;
     case 31:                                                    //Delay bounce/Return time
       //Delay down
       if (BD < 10) {
         BD = BD + 1;                                          // Up arrow +1
-        myNex.writeStr("delaytime.txt", String(BD));
-        delay(20);
+        nexQueue.writeStr("delaytime.txt", String(BD));
         SysMemory.begin("BD", false);
         SysMemory.putUInt("BD", BD);
         SysMemory.end();
@@ -1787,51 +1801,44 @@ void trigger67() {                                                   //IP UP arr
 }
 void trigger68() {                                                   //IP down arror address trigger Hex44
   Serial.println("\nGet current device IP Values\n");
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   switch (Nextion_Func) {
 
     case 25:
       IP1 = IP1 - 1;                                           // Reduce by 1 for down arrow
-      myNex.writeStr("IP1.txt", String(IP1));
-      delay(20);
+      nexQueue.writeStr("IP1.txt", String(IP1));
       break;
     case 26:
       //IP adress 1
       IP2 = IP2 - 1;                                          // Reduce by 1 for down arrow
-      myNex.writeStr("IP2.txt", String(IP2));
-      delay(20);
+      nexQueue.writeStr("IP2.txt", String(IP2));
       break;
     case 27:
       IP3 = IP3 - 1;                                          // Reduce by 1 for down arrow
-      myNex.writeStr("IP3.txt", String(IP3));
-      delay(20);
+      nexQueue.writeStr("IP3.txt", String(IP3));
       break;
     case 28:
       //IP adress 1
       IP4 = IP4 - 1;                                          // Reduce by 1 for down arrow
-      myNex.writeStr("IP4.txt", String(IP4));
-      delay(20);
+      nexQueue.writeStr("IP4.txt", String(IP4));
       break;
     case 29:
       if (UDP == 5678) {                                                   //IP adress 1
         UDP = 1259;                                          // Reduce by 1 for down arrow
-        myNex.writeStr("UDP.txt", String(UDP));
+        nexQueue.writeStr("UDP.txt", String(UDP));
       }
-      delay(20);
       break;
     case 30:
       //IP adress 1
       IPGW = IPGW - 1;                                          // Reduce by 1 for down arrow
-      myNex.writeStr("IPGW.txt", String(IPGW));
-      delay(20);
+      nexQueue.writeStr("IPGW.txt", String(IPGW));
       break;
     case 31:
       //Delay down
       if (BD > 1) {
         BD = BD - 1;                                          // Reduce by 1 for down arrow
-        myNex.writeStr("delaytime.txt", String(BD));
-        delay(20);
+        nexQueue.writeStr("delaytime.txt", String(BD));
         SysMemory.begin("BD", false);
         SysMemory.putUInt("BD", BD);
         SysMemory.end();
@@ -1842,25 +1849,25 @@ void trigger68() {                                                   //IP down a
 }
 void trigger69() {                                                   //IPGW trigger Hex45
   Serial.println("\nIPGW set\n");
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 30;
 }
 
 void trigger70() {                                                   //Pan Joy speed Hex46
 
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 23;
 }
 void trigger71() {                                                   //Tilt Joy speed Hex47
 
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Nextion_Func = 24;
 }
 void trigger72() {                                                   //Tally On  Hex48
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   if (TLY == 0) {
     TLY = 1;
@@ -1869,7 +1876,7 @@ void trigger72() {                                                   //Tally On
 }
 
 void trigger73() {                                                   //Tally Off Hex49
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   if (TLY == 1) {
     TLY = 0;
@@ -1878,9 +1885,9 @@ void trigger73() {                                                   //Tally Off
 }
 void trigger74() {                                                   //Slider length Hex4A
 
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
-  String SLDLstring = myNex.readStr("SLDL.txt");
+  String SLDLstring = nexQueue.readStr("SLDL.txt");
   if (SLDLstring.toInt() != 0) {
     SLDL = SLDLstring.toInt();
     SendNextionValues();
@@ -1888,7 +1895,7 @@ void trigger74() {                                                   //Slider le
 }
 
 void trigger80() {                                                   //A_B programmed move from PTZ pose 15 Hex50
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Pose = 15;
   Serial.printf("\nPTZ_Pose set to  %d \n", PTZ_Pose);
@@ -1897,7 +1904,7 @@ void trigger80() {                                                   //A_B progr
   PTZ_Pose = 0;
 }
 void trigger81() {                                                   //Sequencer programmed move from PTZ pose 16 Hex51
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   PTZ_Pose = 16;
   Serial.printf("\nPTZ_Pose set to  %d \n", PTZ_Pose);
@@ -1906,14 +1913,14 @@ void trigger81() {                                                   //Sequencer
   PTZ_Pose = 0;
 }
 void trigger82() {                                                   //PTZ porogramed move bounce ON   HEX52
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Bounce = 1000;
   SendNextionValues();
 
 }
 void trigger83() {                                                   //PTZ porogramed move bounce OFF   HEX53
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Bounce = 0;
   SendNextionValues();
@@ -1921,15 +1928,14 @@ void trigger83() {                                                   //PTZ porog
 }
 void trigger84() {                                                   //Delay Bounce Return Hex54
   Serial.println("\nDelay set\n");
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
-  delay(20);
-  myNex.writeStr("delaytime.txt", String(BD));
+  nexQueue.writeStr("delaytime.txt", String(BD));
   Nextion_Func = 31;
 }
 
 void trigger85() {                                                   //All to Pose   HEX55
-  myNex.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
+  nexQueue.writeStr("t10.txt", "Bat:" + String(NexBatV) + "v");
   Nextion_Wake();
   Bounce = 0;
   PTZ_Pose = Last_PTZ_Pose;
@@ -1966,7 +1972,8 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData,  int L
   char buffer[ESP_NOW_MAX_DATA_LEN + 1];
   // int msgLen = min(ESP_NOW_MAX_DATA_LEN, dataLen);
 
-  memcpy(&incomingValues, incomingData, sizeof(incomingValues));
+  memset(&incomingValues, 0, sizeof(incomingValues));
+  memcpy(&incomingValues, incomingData, min((int)sizeof(incomingValues), Len));   //Devices on older firmware send a shorter message
   //memcpy(&incomingValues, Data, sizeof(incomingValues));
   //Read all current Nextion values
 
@@ -2017,12 +2024,12 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData,  int L
   //  Serial.print(But_Com);
   //  Serial.println("**SMC**");
   //  Serial.print(SMC);
-  myNex.writeStr("bounce.txt", String(Bounce));    //Bounce counter
-  myNex.writeStr("out.txt", String(out_position));
-  myNex.writeStr("in.txt", String(in_position));
-  myNex.writeStr("tlps.txt", String(Tps));
-  myNex.writeStr("ease .txt", String(Ease_Value));
-  //myNex.writeStr("mess.txt", String(mess));
+  nexQueue.writeStr("bounce.txt", String(Bounce)); //Bounce counter
+  nexQueue.writeStr("out.txt", String(out_position));
+  nexQueue.writeStr("in.txt", String(in_position));
+  nexQueue.writeStr("tlps.txt", String(Tps));
+  nexQueue.writeStr("ease .txt", String(Ease_Value));
+  //nexQueue.writeStr("mess.txt", String(mess));
 
 
   //  strncpy(buffer, (const char *)data, msgLen);
@@ -2180,6 +2187,13 @@ void SendNextionValues() {
   NextionValues.UDP = UDP;
   NextionValues.TLY = TLY;                      //Tally light active 1 inative 0
   NextionValues.BD = BD;                         //Bounce / return delay in seconds
+  if (ThreeDscanSetup == 3) {                    //Slider and turntable 3D scan, played by the turntable
+    NextionValues.ScR = ScanRows;
+    NextionValues.ScS = ScanShots;
+  } else {
+    NextionValues.ScR = 0;
+    NextionValues.ScS = 0;
+  }
   //Serial.print("\na1=");
   //Serial.print(NextionValues.a1);
 
@@ -2189,85 +2203,78 @@ void SendNextionValues() {
 
 void UpdateSEQ() {
   Nextion_Wake();
-  delay(800);
-  myNex.writeStr("k1t.txt", String(s1));
-  myNex.writeStr("k2t.txt", String(s2));
-  myNex.writeStr("k3t.txt", String(s3));
-  myNex.writeStr("k4t.txt", String(s4));
-  myNex.writeStr("k5t.txt", String(s5));
-  myNex.writeStr("k6t.txt", String(s6));
+  nexQueue.writeStr("k1t.txt", String(s1), 800);                //Give the sequencer page time to load
+  nexQueue.writeStr("k2t.txt", String(s2), 800);
+  nexQueue.writeStr("k3t.txt", String(s3), 800);
+  nexQueue.writeStr("k4t.txt", String(s4), 800);
+  nexQueue.writeStr("k5t.txt", String(s5), 800);
+  nexQueue.writeStr("k6t.txt", String(s6), 800);
 }
 
 //*************************************** Joystick contro s********************************************
 void ReadAnalog() {                                  //Read joystick positions
-  tiltS = analogRead(tiltS_PIN);
-  panS = analogRead(panS_PIN);
-  focusS = analogRead(focusS_PIN);
-  zoomS = analogRead(zoomS_PIN);
-  slidS = analogRead(slidS_PIN);
-
-  masterA = analogRead(masterA_PIN);
-  Serial.println(masterA);          //GPIO33
+  if (joystick.frameCount() == Joy_Frame) {          //Nothing new sampled since the last pass
+    return;
+  }
+  Joy_Frame = joystick.frameCount();
+  tiltS = joystick.command(JOY_TILT);                //Centred, filtered and 0 inside the dead band
+  panS = joystick.command(JOY_PAN);
+  focusS = joystick.command(JOY_FOCUS);
+  zoomS = joystick.command(JOY_ZOOM);
+  slidS = joystick.command(JOY_SLIDE);
+
+  masterA = joystick.command(JOY_MASTER);
   masterA = constrain(masterA, 900, 4000);
 
 
 
-
-  tiltS = (tiltS - tilt_AVG);
-  panS = (panS - pan_AVG);
-  focusS = (focusS - foc_AVG);
-  zoomS = (zoomS - zoom_AVG);
-  slidS = (slidS - slid_AVG);
-
-
-
   //**Tilt Control**
-  if ( tiltS > 300) {                               //Tilt moving forwards send update
+  if ( tiltS > 0) {                                 //Tilt moving forwards send update
     Tilt_J_Speed = (tiltS);
     sendjoy = true;
   }
-  if (tiltS < -300) {                             //Tilt moving Backwards send update
+  if (tiltS < 0) {                                //Tilt moving Backwards send update
     Tilt_J_Speed = (tiltS);
     sendjoy = true;
   }
   //**Pan Control**
-  if ( panS > 200 && (panS>(panShld +800)) ) {                               //Pan moving forwards send update
+  if ( panS > 0 && (panS>(panShld +800)) ) {                               //Pan moving forwards send update
     Pan_J_Speed = (panS / 4);
     sendjoy = true;
   panShld=PanS;
   }
-  if (panS < -300 && (panS<(panShld -800))) {                             //Pan moving Backwards send update
+  if (panS < 0 && (panS<(panShld -800))) {                             //Pan moving Backwards send update
     Pan_J_Speed = (panS / 2) ;
     sendjoy = true;
    panShld=PanS;
   }
   //**Focus Control**
-  if ( focusS > 400) {                               //Focus moving forwards send update
+  if ( focusS > 0) {                                 //Focus moving forwards send update
     Foc_J_Speed = (focusS);
     sendjoy = true;
   }
-  if (focusS < -400) {                                //Focus moving Backwards send update
+  if (focusS < 0) {                                   //Focus moving Backwards send update
     Foc_J_Speed = (focusS) ;
     sendjoy = true;
   }
 
-  if (slidS > 300) {                            //Slider moving forwards send update
+  if (slidS > 0) {                              //Slider moving forwards send update
     Slid_J_Speed = (slidS - 100);
     sendjoy = true;
   }
-  if (slidS < -300) {                         //Slider moving Backwards send update
+  if (slidS < 0) {                            //Slider moving Backwards send update
     Slid_J_Speed = (slidS - 200) ;
     sendjoy = true;
   }
   //  **Zoom Control**
-  if (zoomS > 300) {                              //Zoom moving forwards send update
+  if (zoomS > 0) {                                //Zoom moving forwards send update
     //Serial.println("ZoomStepper move forward");
 
     Zoom_J_Speed = (zoomS);
     //Serial.println(Zoom_J_Speed);
     sendjoy = true;
   }
-  if (zoomS < -300) {                              //Zoom moving Backwards send update
+  if (zoomS < 0) {                                 //Zoom moving Backwards send update
     //Serial.println("ZoomStepper move Backwards");
     Zoom_J_Speed = (zoomS);
     //Serial.println(Zoom_J_Speed);
@@ -2276,20 +2283,21 @@ void ReadAnalog() {                                  //Read joystick positions
 
   //*********Wright out all the above values here******************
   if (sendjoy ) {
-     delay(400);
-    SendNextionValues();                             //Send all values
+    if (!joypass || millis() - Joy_Sent_ms >= JOY_SEND_MS) {   //First deflection goes straight out
+      SendNextionValues();                             //Send all values
+      Joy_Sent_ms = millis();
+      joypass = true;
+    }
     //Serial.println(JB);
     sendjoy = false;
-    joypass = true;
   
   } else {                                           //send a final stopmove
-    if (joypass && panS !=0) {
+    if (joypass) {
       Slid_J_Speed = 0;
       Pan_J_Speed = 0;
       Tilt_J_Speed = 0; 
       Foc_J_Speed = 0;
       Zoom_J_Speed = 0;
-      delay(20);
       SendNextionValues();                             //Send all values
       //Serial.println("slid_Accel");
       //Serial.println(slidA);
@@ -2307,24 +2315,13 @@ void InitialValues() {
   int temp_zoom = 0;
   int temp_slid = 0;
 
-  for (int i = 0; i < 100; i++) {
-    temp_tilt += analogRead(tiltS_PIN);
-    delay(10); //allowing a little time between two readings
-  }
-  for (int i = 0; i < 100; i++) {
-    temp_pan += analogRead(panS_PIN);
-    delay(10); //allowing a little time between two readings
-  }
-  for (int i = 0; i < 100; i++) {
-    temp_slid += analogRead(slidS_PIN);
-    delay(10); //allowing a little time between two readings
-  }
-  for (int i = 0; i < 100; i++) {
-    temp_foc += analogRead(focusS_PIN);
-    delay(10); //allowing a little time between two readings
-  }
-  for (int i = 0; i < 100; i++) {
-    temp_zoom += analogRead(zoomS_PIN);
+  delay(100);                              //Let the sampler filters settle
+  for (int i = 0; i < 100; i++) {          //All sticks are sampled together now
+    temp_tilt += joystick.reading(JOY_TILT);
+    temp_pan += joystick.reading(JOY_PAN);
+    temp_slid += joystick.reading(JOY_SLIDE);
+    temp_foc += joystick.reading(JOY_FOCUS);
+    temp_zoom += joystick.reading(JOY_ZOOM);
     delay(10); //allowing a little time between two readings
   }
 
@@ -2334,6 +2331,11 @@ void InitialValues() {
   slid_AVG = temp_slid / 100;
   foc_AVG = temp_foc / 100;
   zoom_AVG = temp_zoom / 100;
+  joystick.setCentre(JOY_TILT, tilt_AVG);
+  joystick.setCentre(JOY_PAN, pan_AVG);
+  joystick.setCentre(JOY_SLIDE, slid_AVG);
+  joystick.setCentre(JOY_FOCUS, foc_AVG);
+  joystick.setCentre(JOY_ZOOM, zoom_AVG);
 
 
 
@@ -2399,7 +2401,7 @@ void RecordButLog() {
       }
     } else {
 
-      String NexMenu = myNex.readStr("menu.txt");
+      String NexMenu = nexQueue.readStr("menu.txt");
       switch (NexMenu.toInt()) {
         case 1:                                             //Nextion menu is home
           //But_Com = 1;                                    //If we are in the home menu Send the home screen play command
@@ -2412,19 +2414,17 @@ void RecordButLog() {
           delay(200);
           Nextion_play = 0;                                 //Reset the button
           lastRecordBut = RecordBut;
-          myNex.writeNum("b5.pic", 7);                      //Turn play red
+          nexQueue.writeNum("b5.pic", 7);                   //Turn play red
           break;
         case 6:                                             //Nextion menu is stopmotion
           trigger39();
           lastRecordBut = RecordBut;
-          myNex.writeNum("Play.pic", 7);                     //Turn play red
+          nexQueue.writeNum("Play.pic", 7);                  //Turn play red
           break;
         case 7:                                             //Nextion menu is Setup
-          myNex.writeNum("Tally.val", TLY);                 //Set the tally button to on or off 0 or 1
-          delay(20);
-          myNex.writeNum("PanS.txt", PanS);                 //Set the nextion button to the current value
-          delay(20);
-          myNex.writeNum("TiltS.txt", TiltS);               //Set the nextion button to the current value
+          nexQueue.writeNum("Tally.val", TLY);              //Set the tally button to on or off 0 or 1
+          nexQueue.writeNum("PanS.txt", PanS);              //Set the nextion button to the current value
+          nexQueue.writeNum("TiltS.txt", TiltS);            //Set the nextion button to the current value
           break;
       }
     }
@@ -0,0 +1,220 @@
+#ifndef JOYSTICK_SAMPLER_H
+#define JOYSTICK_SAMPLER_H
+
+#include <driver/adc.h>
+
+// Analog inputs of the controller, in the order they sit in the sampler
+enum JoyChannel { JOY_TILT = 0, JOY_PAN, JOY_FOCUS, JOY_ZOOM, JOY_SLIDE, JOY_MASTER, JOY_CHANNELS };
+
+struct JoyChannelConfig {
+  adc1_channel_t channel;                         // All inputs are on ADC1, the only unit that runs next to WiFi
+  int pin;                                        // GPIO of the channel, for analogRead when DMA will not start
+  bool centred;                                   // Stick with a rest position, false for the master pot
+  int threshold;                                  // Smallest value sent outside the dead band, what the receivers expect
+};
+
+// Joystick sampling
+//
+// The ADC runs in continuous mode and DMA hands over a frame of conversions of all channels every few ms, so
+// loop() no longer waits on analogRead. A task on core 0 averages each frame per channel, takes the median of the
+// last three frames to drop spikes and smooths the result with an IIR filter. Centred sticks get a dead band sized
+// from the noise measured while they rest, so a quiet stick starts responding earlier; outside it the value is
+// scaled so the receivers still see their old minimum speed at the edge of the dead band. If the driver refuses
+// continuous mode the task polls the pins with analogRead instead, a frame every 8ms through the same filters.
+class JoystickSampler {
+public:
+  static const int FULL = 2048;                   // 12 bit reading either side of the centre
+
+private:
+  struct ChannelState {
+    int history[3];                               // Last frame averages, for the median
+    int32_t filtered;                             // Raw reading in 1/16
+    int32_t noise;                                // Mean deviation at rest in 1/16
+    int centre;
+    int deadband;
+  };
+
+  const JoyChannelConfig* config;
+  ChannelState channels[JOY_CHANNELS];
+  volatile int value[JOY_CHANNELS];               // Written by the task, one word each so loop() never sees half of one
+  volatile int raw[JOY_CHANNELS];
+  volatile uint32_t frames;
+  TaskHandle_t task;
+  bool polled;                                    // DMA did not start, the task reads with analogRead
+
+  static const uint32_t SAMPLE_HZ = 24000;        // All channels together, 4kHz each
+  static const int PER_FRAME = 32;                // Conversions of each channel in one DMA frame, a frame every 8ms
+  static_assert(SAMPLE_HZ >= SOC_ADC_SAMPLE_FREQ_THRES_LOW, "continuous mode will not run this slow");
+  static const int PER_POLL = 4;                  // analogRead calls of each channel in a polled frame
+  static const TickType_t POLL_TICKS = pdMS_TO_TICKS(8);
+  static const uint32_t FRAME_BYTES = PER_FRAME * JOY_CHANNELS * SOC_ADC_DIGI_RESULT_BYTES;
+  static const int IIR_DIVISOR = 4;               // Each frame moves the output a quarter of the way
+  static const int NOISE_DIVISOR = 32;
+  static const int NOISE_FACTOR = 4;              // Dead band is this many times the rest noise
+  static const int MIN_DEADBAND = 60;
+
+  static void taskEntry(void* parameter) {
+    ((JoystickSampler*)parameter)->run();
+  }
+
+  static int median(const int* h) {
+    return max(min(h[0], h[1]), min(max(h[0], h[1]), h[2]));
+  }
+
+  // Dead band zero, then the rest of the travel from the threshold to full scale
+  int scale(const JoyChannelConfig& c, const ChannelState& s, int reading) {
+    if (!c.centred) return reading;
+    int x = reading - s.centre;
+    int magnitude = abs(x);
+    if (magnitude <= s.deadband) return 0;
+    int out = c.threshold + 1 + (long)(magnitude - s.deadband) * (FULL - c.threshold) / (FULL - s.deadband);
+    return x > 0 ? out : -out;
+  }
+
+  void filter(int index, int average) {
+    const JoyChannelConfig& c = config[index];
+    ChannelState& s = channels[index];
+    s.history[0] = s.history[1];
+    s.history[1] = s.history[2];
+    s.history[2] = average;
+    s.filtered += (median(s.history) * 16 - s.filtered) / IIR_DIVISOR;
+    int reading = s.filtered / 16;
+    if (c.centred && abs(reading - s.centre) < c.threshold) {
+      int32_t deviation = abs(average * 16 - s.filtered);
+      s.noise += (deviation - s.noise) / NOISE_DIVISOR;
+      s.deadband = constrain(MIN_DEADBAND + NOISE_FACTOR * s.noise / 16, MIN_DEADBAND, c.threshold);
+    }
+    raw[index] = reading;
+    value[index] = scale(c, s, reading);
+  }
+
+  bool startDma() {
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = FRAME_BYTES * 4;
+    init.conv_num_each_intr = FRAME_BYTES;
+    for (int i = 0; i < JOY_CHANNELS; i++) {
+      init.adc1_chan_mask |= BIT(config[i].channel);
+    }
+    if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+    adc_digi_pattern_config_t pattern[JOY_CHANNELS] = {};
+    for (int i = 0; i < JOY_CHANNELS; i++) {
+      pattern[i].atten = ADC_ATTEN_DB_11;         // Full 0-3.3V range, as analogRead had it
+      pattern[i].channel = config[i].channel;
+      pattern[i].unit = 0;
+      pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+    adc_digi_configuration_t digi = {};
+    digi.conv_limit_en = true;                    // The ESP32 needs the conversion limit on in single unit mode
+    digi.conv_limit_num = 250;
+    digi.pattern_num = JOY_CHANNELS;
+    digi.adc_pattern = pattern;
+    digi.sample_freq_hz = SAMPLE_HZ;
+    digi.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digi.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    if (adc_digi_controller_configure(&digi) != ESP_OK || adc_digi_start() != ESP_OK) {
+      adc_digi_deinitialize();                    // Hand the unit back to analogRead
+      return false;
+    }
+    return true;
+  }
+
+  void poll() {
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+      for (int c = 0; c < JOY_CHANNELS; c++) {
+        int32_t sum = 0;
+        for (int i = 0; i < PER_POLL; i++) {
+          sum += analogRead(config[c].pin);
+        }
+        filter(c, sum / PER_POLL);
+      }
+      frames++;
+      vTaskDelayUntil(&wake, POLL_TICKS);
+    }
+  }
+
+  void run() {
+    if (polled) {
+      poll();
+    }
+    uint8_t frame[FRAME_BYTES];
+    for (;;) {
+      uint32_t length = 0;
+      if (adc_digi_read_bytes(frame, FRAME_BYTES, &length, 100) != ESP_OK) {
+        continue;                                 // Timeout, or the driver dropped a frame it had no room for
+      }
+      int32_t sum[JOY_CHANNELS] = {};
+      int count[JOY_CHANNELS] = {};
+      for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t* d = (const adc_digi_output_data_t*)&frame[i];
+        for (int c = 0; c < JOY_CHANNELS; c++) {
+          if (d->type1.channel != config[c].channel) continue;
+          sum[c] += d->type1.data;
+          count[c]++;
+          break;
+        }
+      }
+      for (int c = 0; c < JOY_CHANNELS; c++) {
+        if (count[c] > 0) filter(c, sum[c] / count[c]);
+      }
+      frames++;
+    }
+  }
+
+public:
+  JoystickSampler(const JoyChannelConfig* aconfig) : config(aconfig), frames(0), task(NULL), polled(false) {
+    for (int i = 0; i < JOY_CHANNELS; i++) {
+      ChannelState& s = channels[i];
+      s.history[0] = s.history[1] = s.history[2] = FULL;
+      s.filtered = FULL * 16;
+      s.noise = 0;
+      s.centre = FULL;
+      s.deadband = config[i].threshold;
+      value[i] = 0;
+      raw[i] = FULL;
+    }
+  }
+
+  // False when continuous mode would not start and the sticks are polled instead
+  bool begin() {
+    polled = !startDma();
+    if (polled) {
+      for (int i = 0; i < JOY_CHANNELS; i++) {
+        pinMode(config[i].pin, INPUT);
+      }
+    }
+    xTaskCreatePinnedToCore(taskEntry, "Joystick", 4096, this, 2, &task, 0);
+    if (polled) {
+      Serial.println("\nJoystick ADC would not start, polling the sticks with analogRead");
+    } else {
+      Serial.printf("\nJoystick sampling %d channels at %lu Hz each\n", JOY_CHANNELS, (unsigned long)(SAMPLE_HZ / JOY_CHANNELS));
+    }
+    return !polled;
+  }
+
+  // Rest position of a stick, from InitialValues()
+  void setCentre(int channel, int centre) {
+    ChannelState& s = channels[channel];
+    s.centre = centre;
+    s.noise = (config[channel].threshold - MIN_DEADBAND) * 16 / NOISE_FACTOR;   // Start wide and let the measured noise narrow it
+    s.deadband = config[channel].threshold;
+  }
+
+  // Filtered reading, 0..4095
+  int reading(int channel) const {
+    return raw[channel];
+  }
+
+  // Centred sticks: 0 in the dead band, else signed command. Master pot: filtered reading
+  int command(int channel) const {
+    return value[channel];
+  }
+
+  // Counts DMA frames, so the sender can tell a fresh sample from one it already handled
+  uint32_t frameCount() const {
+    return frames;
+  }
+};
+
+#endif // JOYSTICK_SAMPLER_H
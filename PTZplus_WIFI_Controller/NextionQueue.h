@@ -0,0 +1,180 @@
+#ifndef NEXTION_QUEUE_H
+#define NEXTION_QUEUE_H
+
+#include <HardwareSerial.h>
+#include <EasyNextionLibrary.h>
+
+// Queued Nextion output
+//
+// The sketch never writes to the display directly. A write only lands in a small table; writing the same
+// component again before it went out replaces the pending value, deferred ones included, so a counter stepped ten times in one loop()
+// sends one update. run() is polled from loop() and sends whatever is due as one burst, no larger than the UART
+// can take without blocking, at most every PACE_MS. Writes can be deferred, which replaces the delay() that used
+// to hold a message on screen. Reads still go through EasyNex and push pending writes out first, so the display
+// answers with what the sketch last wrote.
+class NextionQueue {
+public:
+  static const int SLOTS = 32;
+
+private:
+  enum WriteKind : uint8_t { WRITE_TEXT, WRITE_NUMBER, WRITE_COMMAND };
+
+  struct PendingWrite {
+    char component[24];                           // Component and attribute, or the whole command
+    char value[40];
+    WriteKind kind;
+    uint32_t due_ms;
+    bool deferred;
+  };
+
+  EasyNex& nex;
+  HardwareSerial& serial;
+  PendingWrite slots[SLOTS];                      // In the order they were queued
+  int count;
+  unsigned long last_burst_ms;
+
+  static const uint32_t PACE_MS = 20;             // The display needs about this long to take a burst in
+  static const size_t BURST_MAX = 128;            // One UART FIFO
+
+  // Command text as the display expects it, 0 if it does not fit
+  static size_t format(const PendingWrite& w, uint8_t* out, size_t room) {
+    int len;
+    switch (w.kind) {
+      case WRITE_TEXT:
+        len = snprintf((char*)out, room, "%s=\"%s\"", w.component, w.value);
+        break;
+      case WRITE_NUMBER:
+        len = snprintf((char*)out, room, "%s=%s", w.component, w.value);
+        break;
+      default:
+        len = snprintf((char*)out, room, "%s", w.component);
+        break;
+    }
+    if (len < 0 || (size_t)len + 3 > room) return 0;
+    out[len++] = 0xFF;
+    out[len++] = 0xFF;
+    out[len++] = 0xFF;
+    return len;
+  }
+
+  void remove(int index) {
+    memmove(&slots[index], &slots[index + 1], (count - index - 1) * sizeof(PendingWrite));
+    count--;
+  }
+
+  // Commands are keyed on what they set, so dims=5 replaces a pending dims=100
+  static bool sameTarget(const PendingWrite& w, const char* component, WriteKind kind, size_t key) {
+    if (w.kind != kind || strncmp(w.component, component, key) != 0) return false;
+    return w.component[key] == '\0' || w.component[key] == '=';
+  }
+
+  void queue(const char* component, const char* value, WriteKind kind, uint32_t delay_ms) {
+    // A write supersedes what is pending for the same component. An immediate one replaces the first immediate
+    // write and drops any deferred ones, which would otherwise overwrite it later with an older value. A deferred
+    // one only drops earlier deferred ones, so a CANCEL still shows before the counter comes back.
+    size_t key = kind == WRITE_COMMAND ? strcspn(component, "=") : strlen(component);
+    int keep = -1;
+    int i = 0;
+    while (i < count) {
+      PendingWrite& w = slots[i];
+      if (!sameTarget(w, component, kind, key) || (delay_ms > 0 && !w.deferred)) {
+        i++;
+        continue;
+      }
+      if (delay_ms == 0 && !w.deferred && keep < 0) {
+        keep = i++;
+        continue;
+      }
+      remove(i);
+    }
+    if (keep >= 0) {
+      strlcpy(slots[keep].component, component, sizeof(slots[keep].component));
+      strlcpy(slots[keep].value, value, sizeof(slots[keep].value));
+      return;
+    }
+    if (count == SLOTS) {
+      sync();
+      if (count == SLOTS) {
+        Serial.printf("\nNextion queue full, %s dropped\n", component);
+        return;
+      }
+    }
+    PendingWrite& w = slots[count++];
+    strlcpy(w.component, component, sizeof(w.component));
+    strlcpy(w.value, value, sizeof(w.value));
+    w.kind = kind;
+    w.due_ms = millis() + delay_ms;
+    w.deferred = delay_ms > 0;
+  }
+
+  // Sends due writes in queue order until room runs out
+  void send(size_t room) {
+    uint8_t burst[BURST_MAX];
+    size_t len = 0;
+    unsigned long now = millis();
+    int i = 0;
+    while (i < count) {
+      PendingWrite& w = slots[i];
+      if ((int32_t)(now - w.due_ms) < 0) {
+        i++;
+        continue;
+      }
+      size_t n = format(w, burst + len, min(room, BURST_MAX) - len);
+      if (n == 0) {
+        if (len == 0) remove(i);                  // Longer than a whole burst, it would never go out
+        break;
+      }
+      len += n;
+      remove(i);
+    }
+    if (len > 0) {
+      serial.write(burst, len);
+    }
+  }
+
+public:
+  NextionQueue(EasyNex& anex, HardwareSerial& aserial)
+    : nex(anex), serial(aserial), count(0), last_burst_ms(0) {
+  }
+
+  // Same calls as EasyNex. A one argument writeStr is a raw command such as "dims=100"
+  void writeStr(const String& component, const String& txt = "cmd", uint32_t delay_ms = 0) {
+    if (txt == "cmd") {
+      queue(component.c_str(), "", WRITE_COMMAND, delay_ms);
+    } else {
+      queue(component.c_str(), txt.c_str(), WRITE_TEXT, delay_ms);
+    }
+  }
+
+  void writeNum(const String& component, uint32_t val, uint32_t delay_ms = 0) {
+    char value[12];
+    snprintf(value, sizeof(value), "%lu", (unsigned long)val);
+    queue(component.c_str(), value, WRITE_NUMBER, delay_ms);
+  }
+
+  String readStr(const String& component) {
+    sync();
+    return nex.readStr(component);
+  }
+
+  // Polled from loop(), never waits on the UART
+  void run() {
+    if (count == 0 || millis() - last_burst_ms < PACE_MS) return;
+    size_t room = serial.availableForWrite();
+    if (room == 0) return;
+    send(room);
+    last_burst_ms = millis();
+  }
+
+  // Pushes every due write out now, for code that is about to wait on a reply anyway
+  void sync() {
+    int left = count + 1;
+    while (left != count) {
+      left = count;
+      send(BURST_MAX);
+    }
+    last_burst_ms = millis();
+  }
+};
+
+#endif // NEXTION_QUEUE_H